@@ -84,8 +84,10 @@ public:
 
   static constexpr size_t kHistoryDepth = 64;
   static constexpr int kMaxByteBeatParameters = 12;
+  // Samples per Render(); with four channels, one of them renders per tick
+  static constexpr int kBlockSize = 4;
 
-  void Init(OC::DigitalInput default_trigger);
+  void Init(OC::DigitalInput default_trigger, int block_phase);
 
   OC::DigitalInput get_trigger_input() const {
     return static_cast<OC::DigitalInput>(values_[BYTEBEAT_SETTING_TRIGGER_INPUT]);
@@ -272,8 +274,42 @@ public:
      segments[mapping - BYTEBEAT_CV_MAPPING_FIRST] += (cvs[cv_setting - BYTEBEAT_SETTING_CV1] * 65536) >> bytebeat_cv_rshift;
   }
 
+  // Gates are collected a tick at a time, and the equation runs a block at a
+  // time once kBlockSize ticks are in, with the settings and CV of that tick.
+  // The DAC plays the previous block meanwhile, so output lags kBlockSize
+  // ticks behind its gates.
   void Update(uint32_t triggers, const int32_t cvs[4], DAC_CHANNEL dac_channel) {
 
+    OC::DigitalInput trigger_input = get_trigger_input();
+    uint8_t gate_state = 0;
+    if (triggers & DIGITAL_INPUT_MASK(trigger_input))
+      gate_state |= peaks::CONTROL_GATE_RISING;
+
+    bool gate_raised = OC::DigitalInputs::read_immediate(trigger_input);
+    if (gate_raised)
+      gate_state |= peaks::CONTROL_GATE;
+    else if (gate_raised_)
+      gate_state |= peaks::CONTROL_GATE_FALLING;
+    gate_raised_ = gate_raised;
+
+    control_[block_pos_] = gate_state;
+    // TODO Scale range or offset?
+    uint16_t b = block_[block_pos_];
+    #ifdef NORTHERNLIGHT
+      uint32_t value = OC::DAC::get_zero_offset(dac_channel) + b;
+    #else
+      uint32_t value = OC::DAC::get_zero_offset(dac_channel) + (int16_t)b;
+    #endif
+    OC::DAC::set(dac_channel, value);
+
+    b >>= 8;
+    if (b != history_.last()) // This make the effect a bit different
+      history_.Push(b);
+
+    if (++block_pos_ < kBlockSize)
+      return;
+    block_pos_ = 0;
+
     int32_t s[kMaxByteBeatParameters];
     s[0] = SCALE8_16(static_cast<int32_t>(get_equation() << 4));
     s[1] = SCALE8_16(static_cast<int32_t>(get_speed()));
@@ -299,32 +335,7 @@ public:
     }
 
     bytebeat_.Configure(s, get_step_mode(), get_loop_mode()) ;
-
-    OC::DigitalInput trigger_input = get_trigger_input();
-    uint8_t gate_state = 0;
-    if (triggers & DIGITAL_INPUT_MASK(trigger_input))
-      gate_state |= peaks::CONTROL_GATE_RISING;
-
-    bool gate_raised = OC::DigitalInputs::read_immediate(trigger_input);
-    if (gate_raised)
-      gate_state |= peaks::CONTROL_GATE;
-    else if (gate_raised_)
-      gate_state |= peaks::CONTROL_GATE_FALLING;
-    gate_raised_ = gate_raised;
-
-    // TODO Scale range or offset?
-    uint16_t b = bytebeat_.ProcessSingleSample(gate_state);
-    #ifdef NORTHERNLIGHT
-      uint32_t value = OC::DAC::get_zero_offset(dac_channel) + b;
-    #else
-      uint32_t value = OC::DAC::get_zero_offset(dac_channel) + (int16_t)b;
-    #endif
-    OC::DAC::set(dac_channel, value);
-
-
-    b >>= 8;
-    if (b != history_.last()) // This make the effect a bit different
-      history_.Push(b);
+    bytebeat_.Render(control_, block_, kBlockSize);
   }
 
   inline void ReadHistory(uint8_t *history) const {
@@ -334,6 +345,9 @@ public:
 private:
   peaks::ByteBeat bytebeat_;
   bool gate_raised_;
+  int block_pos_;
+  uint8_t control_[kBlockSize];
+  uint16_t block_[kBlockSize];
   int32_t s_[kMaxByteBeatParameters];
 
   int num_enabled_settings_;
@@ -342,11 +356,14 @@ private:
   util::History<uint8_t, kHistoryDepth> history_;
 };
 
-void ByteBeat::Init(OC::DigitalInput default_trigger) {
+void ByteBeat::Init(OC::DigitalInput default_trigger, int block_phase) {
   InitDefaults();
   apply_value(BYTEBEAT_SETTING_TRIGGER_INPUT, default_trigger);
   bytebeat_.Init();
   gate_raised_ = false;
+  block_pos_ = block_phase % kBlockSize;
+  memset(control_, 0, sizeof(control_));
+  memset(block_, 0, sizeof(block_));
   update_enabled_settings();
   history_.Init(0);
 }
@@ -393,9 +410,10 @@ public:
   // QuadBouncingBalls = QuadByteBeats, bbgen = bytebeatgen, BBGEN = BYTEBEATGEN
 
   void Init() {
+    // Each channel's block ends on a different tick, so one renders per tick
     int input = OC::DIGITAL_INPUT_1;
     for (auto &bytebeat : bytebeats_) {
-      bytebeat.Init(static_cast<OC::DigitalInput>(input));
+      bytebeat.Init(static_cast<OC::DigitalInput>(input), input - OC::DIGITAL_INPUT_1);
       ++input;
     }
 
@@ -613,33 +613,21 @@ public:
         next_applet[h] = index;
     }
 
-#if defined(__IMXRT1062__)
-  #if defined(ARDUINO_TEENSY41)
-    template <typename T1, typename T2, typename T3>
-    void ProcessMIDI(T1 &device, T2 &next_device, T3 &dev3) {
-  #else
-    template <typename T1, typename T2>
-    void ProcessMIDI(T1 &device, T2 &next_device) {
-  #endif
-#else
-    template <typename T1>
-    void ProcessMIDI(T1 &device) {
-#endif
+    void ProcessMIDI() {
         HS::IOFrame &f = HS::frame;
 
-        while (device.read()) {
-            const uint8_t message = device.getType();
-            const uint8_t data1 = device.getData1();
-            const uint8_t data2 = device.getData2();
+        HS::midi_in.Poll(true);
+        HS::midi_in.Drain([&](const HS::TimedMIDIMessage &m) {
+            const uint8_t message = m.msg.message;
 
             if (message == usbMIDI.SystemExclusive) {
                 ReceiveManagerSysEx();
-                continue;
+                return;
             }
 
             if (message == usbMIDI.ProgramChange
-            && (device.getChannel() == f.MIDIState.pc_channel || f.MIDIState.pc_channel == f.MIDIState.PC_OMNI)) {
-                uint8_t slot = device.getData1();
+            && (m.msg.channel == f.MIDIState.pc_channel || f.MIDIState.pc_channel == f.MIDIState.PC_OMNI)) {
+                uint8_t slot = m.msg.data1;
                 if (slot < HEM_NR_OF_PRESETS) {
                   if (HS::clock_m.IsRunning()) {
                     queued_preset = slot;
@@ -648,33 +636,17 @@ public:
                   else
                     LoadFromPreset(slot);
                 }
-                //continue;
+                //return;
             }
 
-            f.MIDIState.ProcessMIDIMsg({device.getChannel(), message, data1, data2});
-#if defined(__IMXRT1062__)
-            next_device.send(message, data1, data2, device.getChannel(), 0);
-  #if defined(ARDUINO_TEENSY41)
-            dev3.send((midi::MidiType)message, data1, data2, device.getChannel());
-  #endif
-#endif
-        }
+            f.MIDIState.ProcessMIDIMsg(m.msg, m.cycles);
+            HS::midi_in.Thru(m);
+        });
     }
 
     void Controller() {
         // top-level MIDI-to-CV handling - alters frame outputs
-#if defined(__IMXRT1062__)
-  #if defined(ARDUINO_TEENSY41)
-        ProcessMIDI(usbMIDI, usbHostMIDI, MIDI1);
-        ProcessMIDI(usbHostMIDI, usbMIDI, MIDI1);
-        ProcessMIDI(MIDI1, usbMIDI, usbHostMIDI);
-  #else
-        ProcessMIDI(usbMIDI, usbHostMIDI);
-        ProcessMIDI(usbHostMIDI, usbMIDI);
-  #endif
-#else
-        ProcessMIDI(usbMIDI);
-#endif
+        ProcessMIDI();
 
         // Clock Setup applet handles internal clock duties
         ClockSetup_instance.Controller();
@@ -1665,7 +1637,10 @@ void HEMISPHERE_handleAppEvent(OC::AppEvent event) {
     }
 }
 
-void HEMISPHERE_loop() {} // Essentially deprecated in favor of ISR
+void HEMISPHERE_loop() {
+    // timestamp incoming MIDI between ticks
+    HS::midi_in.Poll();
+} // Essentially deprecated in favor of ISR
 
 void HEMISPHERE_menu() {
     manager.View();
@@ -269,6 +269,7 @@ public:
         for (int i = 0; i < MIDIMAP_MAX; ++i) {
           frame.MIDIState.mapping[i].function = HEM_MIDI_NOOP;
         }
+        frame.MIDIState.UpdateMidiChannelFilter();
 #ifdef __IMXRT1062__
 #else
         // Go through all the Setups and change the default high ranges to G9
@@ -360,6 +361,7 @@ public:
             break;
           default: break;
         }
+        if (input) frame.MIDIState.UpdateMidiChannelFilter();
 #else
         change_value(cursor.cursor_pos(), dir);
         ConstrainRangeValue(cursor.cursor_pos());
@@ -464,6 +466,7 @@ public:
             Out(ch, 0);
         }
         frame.MIDIState.clock_count = 0;
+        frame.MIDIState.UpdateMidiChannelFilter();
     }
 
     void Panic() {
@@ -396,42 +396,36 @@ public:
         next_applet_index[h] = index;
     }
 
-    template <typename T1, typename T2, typename T3>
-    void ProcessMIDI(T1 &device, T2 &next_device, T3 &dev3) {
+    void ProcessMIDI() {
         HS::IOFrame &f = HS::frame;
         int load_slot = -1;
 
-        while (timeout < 40 && device.read()) {
-            const uint8_t message = device.getType();
-            const uint8_t data1 = device.getData1();
-            const uint8_t data2 = device.getData2();
+        HS::midi_in.Poll(true);
+        HS::midi_in.Drain([&](const HS::TimedMIDIMessage &m) {
+            const uint8_t message = m.msg.message;
 
             if (message == usbMIDI.SystemExclusive) {
                 QuadrantSysExHandler();
-                continue;
+                return;
             }
 
             if (message == usbMIDI.ProgramChange
-            && (device.getChannel() == f.MIDIState.pc_channel || f.MIDIState.pc_channel == f.MIDIState.PC_OMNI)) {
-                load_slot = device.getData1();
-                //continue;
+            && (m.msg.channel == f.MIDIState.pc_channel || f.MIDIState.pc_channel == f.MIDIState.PC_OMNI)) {
+                load_slot = m.msg.data1;
+                //return;
             }
 
-            f.MIDIState.ProcessMIDIMsg({device.getChannel(), message, data1, data2});
-            next_device.send(message, data1, data2, device.getChannel(), 0);
-            dev3.send((midi::MidiType)message, data1, data2, device.getChannel());
-        }
+            f.MIDIState.ProcessMIDIMsg(m.msg, m.cycles);
+            HS::midi_in.Thru(m);
+        });
         if (load_slot >= 0 && load_slot < QUAD_PRESET_COUNT) {
             QueuePresetLoad(load_slot);
         }
     }
 
     void Controller() {
-        timeout = 0;
         // top-level MIDI-to-CV handling - alters frame outputs
-        ProcessMIDI(usbMIDI, usbHostMIDI, MIDI1);
-        ProcessMIDI(usbHostMIDI, usbMIDI, MIDI1);
-        ProcessMIDI(MIDI1, usbMIDI, usbHostMIDI);
+        ProcessMIDI();
 
         // Clock Setup applet handles internal clock duties
         ClockSetup_instance.Controller();
@@ -1022,8 +1016,6 @@ private:
     uint16_t mask = 0;
     uint16_t last_mask = 0;
 
-    elapsedMicros timeout = 0;
-
     // State machine
     enum QuadrantsView {
       APPLETS,
@@ -1498,6 +1490,8 @@ void QUADRANTS_handleAppEvent(OC::AppEvent event) {
 }
 
 void QUADRANTS_loop() {
+  // timestamp incoming MIDI between ticks
+  HS::midi_in.Poll();
   audio_app.mainloop();
 } // Essentially deprecated in favor of ISR
 
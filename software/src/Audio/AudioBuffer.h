@@ -23,8 +23,7 @@ public:
   }
 
   T ReadSample(size_t samples_back) {
-    int read_ix = (NumSamples + write_ix - samples_back) % NumSamples;
-    return buffer[read_ix];
+    return buffer[IndexFromSamplesAgo(samples_back)];
   }
 
   void Write(const audio_block_t* block) {
@@ -84,7 +83,7 @@ public:
     // TODO: This can read past the write head. It should stop reading at the
     // write head instead and return the number of samples read.
     size_t read = 0;
-    size_t read_ix = (write_ix - samples_back + NumSamples) % NumSamples;
+    size_t read_ix = IndexFromSamplesAgo(samples_back);
     while (N - read + read_ix > NumSamples) {
       std::copy_n(buffer + read_ix, NumSamples - read_ix, data + read);
       read += NumSamples - read_ix;
@@ -103,7 +102,7 @@ public:
     // TODO: This can read past the write head. It should stop reading at the
     // write head instead and return the number of samples read.
     size_t read = 0;
-    size_t read_ix = (write_ix - samples_back + NumSamples) % NumSamples;
+    size_t read_ix = IndexFromSamplesAgo(samples_back);
     while (size - read + read_ix > NumSamples) {
       std::copy_n(buffer + read_ix, NumSamples - read_ix, data + read);
       read += NumSamples - read_ix;
@@ -112,6 +111,20 @@ public:
     std::copy_n(buffer + read_ix, size - read, data + read);
   }
 
+  // Like ReadFromSamplesAgo, but first moves the start back to a cache line
+  // boundary so the copy is made of whole line bursts, which matters when the
+  // buffer is in PSRAM. data needs room for size + CACHE_LINE_SAMPLES - 1.
+  // Returns how many samples earlier than samples_back data[0] is.
+  size_t ReadLinesFromSamplesAgo(size_t samples_back, T* data, size_t size) {
+    const size_t ix = IndexFromSamplesAgo(samples_back);
+    size_t lead = (reinterpret_cast<uintptr_t>(buffer + ix) % CACHE_LINE_BYTES)
+      / sizeof(T);
+    // Lines don't continue across the wrap
+    if (lead > ix || samples_back + lead > NumSamples) lead = 0;
+    ReadFromSamplesAgo(samples_back + lead, data, size + lead);
+    return lead;
+  }
+
   // TODO:: This is prett innefficient for reading sequences. We should read
   // based on an array of ts instead, reducing dup reads and calcs
   float ReadInterp(float samples_back) {
@@ -130,9 +143,21 @@ public:
     );
   }
 
+  static constexpr size_t CACHE_LINE_BYTES = 32;
+  static constexpr size_t CACHE_LINE_SAMPLES = CACHE_LINE_BYTES / sizeof(T);
+
 protected:
   T* buffer;
   size_t write_ix = 0;
+
+  // Up to two buffer lengths back, without a division
+  size_t IndexFromSamplesAgo(size_t samples_back) {
+    ptrdiff_t ix = static_cast<ptrdiff_t>(write_ix)
+      - static_cast<ptrdiff_t>(samples_back);
+    if (ix < 0) ix += NumSamples;
+    if (ix < 0) ix += NumSamples;
+    return static_cast<size_t>(ix);
+  }
 };
 
 template <typename T = int16_t>
@@ -48,29 +48,17 @@ public:
     buffer.Release();
   }
 
+  // The delay setters are called from the control ISR, which can preempt
+  // update(). They only leave a request; update() applies the latest at the
+  // start of each block, so a whole block renders from one set of delays.
   void delay(size_t tap, float secs) {
     CONSTRAIN(secs, MIN_DELAY_SECS, MAX_DELAY_SECS);
-    delay_secs[tap] = secs;
-    if (delay_secs[tap].Read() == 0.0f) delay_secs[tap].Reset();
+    delay_requests[tap].Set(secs);
   }
 
   void cf_delay(size_t tap, float secs) {
     CONSTRAIN(secs, MIN_DELAY_SECS, MAX_DELAY_SECS);
-    auto& t = target_delay[tap];
-    if (t.phase >= CrossfadeSamples && t.target != secs) {
-      // 0.0005f comes from variation
-      // I observed a <0.0005 noise in detecting internal clock signal. External
-      // I saw a bit larger with faster clocks. 0.001 seems reasonable, though
-      // it means, with full delay, <12ms changes will be ignored.
-      if (abs(t.target - secs) / t.target < 0.001f) {
-        return;
-      }
-      t.phase = 0;
-      t.target = secs;
-      // t.phase_inc = 1;
-      // size_t samples = secs * AUDIO_SAMPLE_RATE_EXACT;
-      // t.phase_inc = CrossfadeSamples / samples + 1;
-    }
+    cf_requests[tap].Set(secs);
   }
 
   void taps(size_t num) {
@@ -83,6 +71,7 @@ public:
 
   void update(void) override {
     if (!buffer.IsReady()) return;
+    ApplyRequests();
     audio_block_t* in_block = receiveWritable();
 
     if (in_block == NULL) {
@@ -92,22 +81,33 @@ public:
       std::fill(in_block->data, in_block->data + AUDIO_BLOCK_SAMPLES, 0);
     }
 
-    audio_block_t* outs[Taps];
+    audio_block_t* outs[Taps] = {};
     for (uint_fast8_t tap = 0; tap < taps_; tap += 1) outs[tap] = allocate();
 
     q15_t temp_buff[ChunkSize];
+
+    // Taps that only read what was written before this block are rendered
+    // whole, from a copy in internal RAM. The rest read the buffer a chunk at
+    // a time, between the writes their short delays depend on.
+    bool staged[Taps] = {};
+    for (uint_fast8_t tap = 0; tap < taps_; tap++) {
+      staged[tap] = StageTap(tap);
+      if (!staged[tap]) continue;
+      for (uint_fast8_t chunk_start = 0; chunk_start < AUDIO_BLOCK_SAMPLES;
+           chunk_start += ChunkSize) {
+        StageReader reader{stages, buffer, chunk_start};
+        ReadChunk(reader, tap, outs[tap]->data + chunk_start, temp_buff);
+      }
+    }
+
     for (uint_fast8_t chunk_start = 0; chunk_start < AUDIO_BLOCK_SAMPLES;
          chunk_start += ChunkSize) {
       auto* in_chunk = in_block->data + chunk_start;
       for (uint_fast8_t tap = 0; tap < taps_; tap++) {
-        auto& tap_delay = delay_secs[tap];
-        auto& target = target_delay[tap];
         auto* chunk_out = outs[tap]->data + chunk_start;
-
-        if (tap_delay.Done() || target.phase < CrossfadeSamples) {
-          ReadCrossfadeChunk(delay_secs[tap], target, chunk_out, temp_buff);
-        } else {
-          ReadStretchChunk(tap_delay, chunk_out);
+        if (!staged[tap]) {
+          BufferReader reader{buffer};
+          ReadChunk(reader, tap, chunk_out, temp_buff);
         }
         q15_t f = float_to_q15(fb[tap].ReadNext());
         arm_scale_q15(chunk_out, f, 0, temp_buff, ChunkSize);
@@ -123,6 +123,96 @@ public:
   }
 
 private:
+  // Room for a block's reads plus about 100 samples of delay modulation, and
+  // the lead ReadLinesFromSamplesAgo adds
+  static constexpr size_t STAGE_SAMPLES = 256;
+  static constexpr size_t STAGE_SPAN
+    = STAGE_SAMPLES - ExtAudioBuffer<int16_t>::CACHE_LINE_SAMPLES + 1;
+
+  // A run of the buffer copied out at the start of a block; data[0] was
+  // oldest samples back from the write head then
+  struct Stage {
+    int16_t data[STAGE_SAMPLES];
+    size_t oldest = 0;
+    size_t length = 0;
+  };
+
+  struct BufferReader {
+    ExtAudioBuffer<int16_t>& buffer;
+
+    void Read(size_t samples_back, int16_t* out) {
+      buffer.ReadFromSamplesAgo(samples_back, out, ChunkSize);
+    }
+    float ReadInterp(float samples_back) {
+      return buffer.ReadInterp(samples_back);
+    }
+  };
+
+  // Reads from the stages as the buffer would look chunk_start samples into
+  // the block. Anything not staged comes from the buffer, which is still as
+  // it was at the start of the block.
+  struct StageReader {
+    std::array<Stage, 2>& stages;
+    ExtAudioBuffer<int16_t>& buffer;
+    size_t chunk_start;
+
+    // Samples back from where the write head was at the start of the block.
+    // Samples this block writes aren't there yet. Taps are staged from the
+    // delays update() applied, so they shouldn't ask for any, but if one did
+    // it gets the newest samples rather than a wrapped index.
+    size_t Back(size_t samples_back, size_t newest) {
+      return samples_back < chunk_start + newest ? newest
+                                                 : samples_back - chunk_start;
+    }
+
+    const int16_t* Find(size_t back, size_t n) {
+      for (auto& stage : stages) {
+        if (back <= stage.oldest && stage.oldest - back + n <= stage.length) {
+          return stage.data + stage.oldest - back;
+        }
+      }
+      return nullptr;
+    }
+
+    void Read(size_t samples_back, int16_t* out) {
+      const size_t back = Back(samples_back, ChunkSize);
+      const int16_t* data = Find(back, ChunkSize);
+      if (data) std::copy_n(data, ChunkSize, out);
+      else buffer.ReadFromSamplesAgo(back, out, ChunkSize);
+    }
+
+    float ReadInterp(float samples_back) {
+      float back = samples_back - chunk_start;
+      if (back < 2.0f) back = 2.0f;
+      size_t back_int = static_cast<size_t>(back);
+      const int16_t* data = Find(back_int + 2, 4);
+      if (!data) return buffer.ReadInterp(back);
+      float t = 1.0f - (back - back_int);
+      return InterpHermite(data[0], data[1], data[2], data[3], t);
+    }
+  };
+
+  // Latest value from the ISR. count goes up after secs is written, so
+  // reading count first never misses a value, at worst applies one twice.
+  struct Request {
+    volatile float secs = 0.0f;
+    volatile uint32_t count = 0;
+    uint32_t applied = 0;
+
+    void Set(float s) {
+      secs = s;
+      count = count + 1;
+    }
+
+    bool Take(float& s) {
+      const uint32_t c = count;
+      if (c == applied) return false;
+      s = secs;
+      applied = c;
+      return true;
+    }
+  };
+
   // 20 hz to be just below human hearing frequency.
   // Empirically most stuff sounds pretty good at this, but high pitched sine
   // waves will crackle a bit with modulation
@@ -141,16 +231,100 @@ private:
   std::array<Interpolated, Taps> fb;
   ExtAudioBuffer<int16_t> buffer;
   size_t taps_ = Taps;
+  std::array<Stage, 2> stages;
+  std::array<Request, Taps> delay_requests;
+  std::array<Request, Taps> cf_requests;
+
+  void ApplyRequests() {
+    for (size_t tap = 0; tap < Taps; tap++) {
+      float secs;
+      if (delay_requests[tap].Take(secs)) {
+        delay_secs[tap] = secs;
+        if (delay_secs[tap].Read() == 0.0f) delay_secs[tap].Reset();
+      }
+      if (cf_requests[tap].Take(secs)) {
+        auto& t = target_delay[tap];
+        if (t.phase >= CrossfadeSamples && t.target != secs) {
+          // 0.0005f comes from variation
+          // I observed a <0.0005 noise in detecting internal clock signal.
+          // External I saw a bit larger with faster clocks. 0.001 seems
+          // reasonable, though it means, with full delay, <12ms changes will
+          // be ignored.
+          if (abs(t.target - secs) / t.target < 0.001f) continue;
+          t.phase = 0;
+          t.target = secs;
+        }
+      }
+    }
+  }
 
+  // Copies everything the tap will read this block into stages: the span its
+  // delay moves over, and the crossfade target. Fails, leaving the tap to
+  // read the buffer directly, if that would include samples this block
+  // writes or not fit.
+  bool StageTap(size_t tap) {
+    float lo, hi;
+    delay_secs[tap].Bounds(lo, hi);
+    // Hermite reads reach 2 samples older and 1 newer, and chunks read
+    // ChunkSize samples on from up to a block later; 1 more for rounding
+    const int newest = static_cast<int>(lo * AUDIO_SAMPLE_RATE)
+      - AUDIO_BLOCK_SAMPLES - 1;
+    const int oldest = static_cast<int>(hi * AUDIO_SAMPLE_RATE) + 3;
+    if (newest < 1 || static_cast<size_t>(oldest - newest + 1) > STAGE_SPAN) {
+      return false;
+    }
+    Stage& span = stages[0];
+    span.length = oldest - newest + 1;
+    const size_t lead = buffer.ReadLinesFromSamplesAgo(
+      oldest, span.data, span.length
+    );
+    span.oldest = oldest + lead;
+    span.length += lead;
+
+    Stage& xfade = stages[1];
+    xfade.length = 0;
+    auto& target = target_delay[tap];
+    if (target.phase < CrossfadeSamples) {
+      const size_t back
+        = static_cast<size_t>(target.target * AUDIO_SAMPLE_RATE);
+      if (back < AUDIO_BLOCK_SAMPLES + 1) return false;
+      const size_t lead = buffer.ReadLinesFromSamplesAgo(
+        back, xfade.data, AUDIO_BLOCK_SAMPLES
+      );
+      xfade.oldest = back + lead;
+      xfade.length = AUDIO_BLOCK_SAMPLES + lead;
+    }
+    return true;
+  }
+
+  template <typename Reader>
+  void ReadChunk(
+    Reader& reader, size_t tap, int16_t* chunk_out, int16_t* temp_buff
+  ) {
+    auto& tap_delay = delay_secs[tap];
+    auto& target = target_delay[tap];
+    if (tap_delay.Done() || target.phase < CrossfadeSamples) {
+      ReadCrossfadeChunk(reader, tap_delay, target, chunk_out, temp_buff);
+    } else {
+      ReadStretchChunk(reader, tap_delay, chunk_out);
+    }
+  }
+
+  template <typename Reader>
   void ReadCrossfadeChunk(
+    Reader& reader,
     OnePole<Interpolated>& tap_delay,
     CrossfadeTarget& target,
     int16_t* chunk_out,
     int16_t* temp_buff
   ) {
-    buffer.ReadFromSecondsAgo(tap_delay.Read(), chunk_out, ChunkSize);
+    reader.Read(
+      static_cast<size_t>(tap_delay.Read() * AUDIO_SAMPLE_RATE), chunk_out
+    );
     if (target.phase < CrossfadeSamples) {
-      buffer.ReadFromSecondsAgo(target.target, temp_buff, ChunkSize);
+      reader.Read(
+        static_cast<size_t>(target.target * AUDIO_SAMPLE_RATE), temp_buff
+      );
       arm_mult_q15(
         temp_buff, xfade_in_scalars + target.phase, temp_buff, ChunkSize
       );
@@ -184,9 +358,12 @@ private:
 
   // Bunch of attempts at doing faster pitch shifting modulation, but just doing
   // sample by sample is shockingly faster than all of them...
-  void ReadStretchChunk(OnePole<Interpolated>& tap_delay, int16_t* chunk_out) {
+  template <typename Reader>
+  void ReadStretchChunk(
+    Reader& reader, OnePole<Interpolated>& tap_delay, int16_t* chunk_out
+  ) {
     for (uint_fast8_t sample = 0; sample < ChunkSize; sample++) {
-      chunk_out[sample] = Clip16(buffer.ReadInterp(
+      chunk_out[sample] = Clip16(reader.ReadInterp(
         tap_delay.ReadNext() * AUDIO_SAMPLE_RATE_EXACT - sample
       ));
     }
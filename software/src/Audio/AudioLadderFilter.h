@@ -0,0 +1,206 @@
+#pragma once
+
+#include <Audio.h>
+#include <math.h>
+
+// A four pole transistor ladder lowpass, after the Teensy Audio library's
+// AudioFilterLadder (Huovilainen's model with a saturating input stage), with
+// the parameters it takes from the applet and nothing else.
+//
+// The cost is mostly in three choices, all made once per block:
+// - the filter runs at 1 or 2 times the audio rate. The input is linearly
+//   interpolated up and the output averaged back down, which the four poles
+//   make up for; 2x takes the saturator's aliasing down by some 16 dB and
+//   lets the cutoff go past 8 kHz. Going further with these cheap up and
+//   down stages buys only a couple more dB, so there is no 4x.
+// - the saturator is a rational or a cubic approximation of tanh; neither
+//   calls into libm. An accurate tanh costs an exp and a divide, twice per
+//   sample at 2x, for a curve the ear can't tell from these.
+// - coefficients are worked out for the end of each block and ramped to
+//   linearly, rather than recomputed every sample.
+enum LadderSaturation : uint8_t {
+  // x (27 + x^2) / (27 + 9 x^2), within 2% of tanh and exactly +/-1 at +/-3
+  LADDER_SATURATION_RATIONAL,
+  // x - 4 x^3 / 27, exactly +/-1 from +/-1.5; a little harder, no division
+  LADDER_SATURATION_POLYNOMIAL,
+};
+
+namespace ladder {
+
+inline float SaturateRational(float x) {
+  if (x > 3.0f) return 1.0f;
+  if (x < -3.0f) return -1.0f;
+  const float x2 = x * x;
+  return x * (27.0f + x2) / (27.0f + 9.0f * x2);
+}
+
+inline float SaturatePolynomial(float x) {
+  if (x > 1.5f) return 1.0f;
+  if (x < -1.5f) return -1.0f;
+  return x - (4.0f / 27.0f) * x * x * x;
+}
+
+} // namespace ladder
+
+class AudioLadderFilter : public AudioStream {
+public:
+  static constexpr int MAX_OVERSAMPLING = 2;
+
+  AudioLadderFilter() : AudioStream(1, inputQueueArray) {
+    Targets(alpha, k, drive);
+  }
+
+  // Hz; at 1x, tops out around 8 kHz
+  void frequency(float hz) {
+    cutoff = hz;
+  }
+
+  // 0..1.8; self oscillates from about 1
+  void resonance(float res) {
+    res_ = constrain(res, 0.0f, 1.8f);
+  }
+
+  // 0..4; above 1 drives the saturator harder
+  void inputDrive(float drv) {
+    drive_ = constrain(drv, 0.0f, 4.0f);
+  }
+
+  // 0..0.5; puts back the passband level resonance takes away
+  void passbandGain(float pbg) {
+    pbg_ = constrain(pbg, 0.0f, 0.5f);
+  }
+
+  // 1 or 2
+  void oversampling(int factor) {
+    os = factor >= 2 ? 2 : 1;
+  }
+
+  void saturation(LadderSaturation s) {
+    saturation_ = s;
+  }
+
+  virtual void update(void) override {
+    audio_block_t* in = receiveReadOnly(0);
+    if (!in && Quiet()) {
+      // Rung out; zeroed so the states never go denormal
+      Clear();
+      return;
+    }
+    audio_block_t* out = allocate();
+    if (!out) {
+      if (in) release(in);
+      return;
+    }
+    // Rings on into silence
+    static const int16_t zeros[AUDIO_BLOCK_SAMPLES] = {};
+    const int16_t* x = in ? in->data : zeros;
+    const bool poly = saturation_ == LADDER_SATURATION_POLYNOMIAL;
+    if (os == 2) {
+      if (poly) Process<2, ladder::SaturatePolynomial>(x, out->data);
+      else Process<2, ladder::SaturateRational>(x, out->data);
+    } else {
+      if (poly) Process<1, ladder::SaturatePolynomial>(x, out->data);
+      else Process<1, ladder::SaturateRational>(x, out->data);
+    }
+    if (in) release(in);
+    transmit(out);
+    release(out);
+  }
+
+private:
+  audio_block_t* inputQueueArray[1];
+
+  // Set from mainloop, picked up at the next block
+  volatile float cutoff = 1000.0f;
+  volatile float res_ = 0.0f;
+  volatile float drive_ = 1.0f;
+  volatile float pbg_ = 0.5f;
+  volatile uint8_t os = MAX_OVERSAMPLING;
+  volatile LadderSaturation saturation_ = LADDER_SATURATION_RATIONAL;
+
+  // Where the last block's ramps ended
+  float alpha;
+  float k;
+  float drive;
+
+  // Stage outputs, and each stage's last input for its zero
+  float stage[4] = {0};
+  float stage_in[4] = {0};
+  float last_x = 0.0f;
+
+  // The one pole coefficient for the cutoff at the oversampled rate: the
+  // polynomial fit from the Teensy library, which tunes the four stages and
+  // their zeros together. Past wc of 1.2 it stops tracking, so the cutoff is
+  // held there.
+  void Targets(float& a, float& res, float& drv) const {
+    float wc = 2.0f * 3.14159265f * cutoff / (os * AUDIO_SAMPLE_RATE_EXACT);
+    wc = constrain(wc, 0.0f, 1.2f);
+    const float wc2 = wc * wc;
+    a = 0.9892f * wc - 0.4324f * wc2 + 0.1381f * wc * wc2 - 0.0202f * wc2 * wc2;
+    res = 4.0f * res_;
+    drv = drive_;
+  }
+
+  void Clear() {
+    for (int i = 0; i < 4; ++i) stage[i] = stage_in[i] = 0.0f;
+    last_x = 0.0f;
+  }
+
+  bool Quiet() const {
+    float energy = fabsf(last_x);
+    for (int i = 0; i < 4; ++i) energy += fabsf(stage[i]) + fabsf(stage_in[i]);
+    return energy < 1e-6f;
+  }
+
+  template <int OS, float (*Saturate)(float)>
+  void Process(const int16_t* in, int16_t* out) {
+    float a1, k1, d1;
+    Targets(a1, k1, d1);
+    const float da = (a1 - alpha) / AUDIO_BLOCK_SAMPLES;
+    const float dk = (k1 - k) / AUDIO_BLOCK_SAMPLES;
+    const float dd = (d1 - drive) / AUDIO_BLOCK_SAMPLES;
+    const float p = pbg_;
+    float a = alpha;
+    float res = k;
+    float drv = drive;
+    float s0 = stage[0], s1 = stage[1], s2 = stage[2], s3 = stage[3];
+    float i0 = stage_in[0], i1 = stage_in[1], i2 = stage_in[2], i3 = stage_in[3];
+    float prev = last_x;
+
+    for (int n = 0; n < AUDIO_BLOCK_SAMPLES; ++n) {
+      a += da;
+      res += dk;
+      drv += dd;
+      const float x = in[n] * (1.0f / 32768.0f) * drv;
+      float sum = 0.0f;
+      for (int j = 1; j <= OS; ++j) {
+        const float xj = OS == 1 ? x : prev + (x - prev) * (static_cast<float>(j) / OS);
+        const float u = Saturate(xj - res * (s3 - p * xj));
+        // Each stage: a zero at 0.3 behind the pole, as the Teensy model
+        float f = u * (1.0f / 1.3f) + i0 * (0.3f / 1.3f);
+        i0 = u;
+        s0 += a * (f - s0);
+        f = s0 * (1.0f / 1.3f) + i1 * (0.3f / 1.3f);
+        i1 = s0;
+        s1 += a * (f - s1);
+        f = s1 * (1.0f / 1.3f) + i2 * (0.3f / 1.3f);
+        i2 = s1;
+        s2 += a * (f - s2);
+        f = s2 * (1.0f / 1.3f) + i3 * (0.3f / 1.3f);
+        i3 = s2;
+        s3 += a * (f - s3);
+        sum += s3;
+      }
+      prev = x;
+      const float y = sum * (32767.0f / OS);
+      out[n] = static_cast<int16_t>(constrain(y, -32768.0f, 32767.0f));
+    }
+
+    alpha = a1;
+    k = k1;
+    drive = d1;
+    stage[0] = s0, stage[1] = s1, stage[2] = s2, stage[3] = s3;
+    stage_in[0] = i0, stage_in[1] = i1, stage_in[2] = i2, stage_in[3] = i3;
+    last_x = prev;
+  }
+};
@@ -3,6 +3,7 @@
 #include "AudioParam.h"
 #include "arm_math.h"
 #include "dsputils.h"
+#include "q15_kernels.h"
 #include <Audio.h>
 
 template <size_t NumChannels>
@@ -16,40 +17,81 @@ public:
   }
 
   virtual void update(void) {
-    float aux[AUDIO_BLOCK_SAMPLES];
-    float out[AUDIO_BLOCK_SAMPLES];
-    bool out_filled = false;
-
-    // Originally I had this scaling and mixing all with q15 but that has much
-    // less desirable saturation behavior with phase correlated material.
+    // Silent and zero gain inputs are dropped up front; a lone one at unity
+    // goes straight through
+    audio_block_t* in[NumChannels];
+    float gain[NumChannels];
+    size_t live = 0;
     for (size_t channel = 0; channel < NumChannels; channel++) {
-      auto* in = receiveReadOnly(channel);
-      if (in) {
-        float gain = gains[channel];
-        if (!out_filled) {
-          arm_fill_f32(0.0f, out, AUDIO_BLOCK_SAMPLES);
-          out_filled = true;
-        }
-        if (gain != 0.0f) {
-          arm_q15_to_float(in->data, aux, AUDIO_BLOCK_SAMPLES);
-          if (gain != 1.0f) {
-            arm_scale_f32(aux, gain, aux, AUDIO_BLOCK_SAMPLES);
-          }
-          arm_add_f32(aux, out, out, AUDIO_BLOCK_SAMPLES);
+      in[channel] = receiveReadOnly(channel);
+      gain[channel] = gains[channel];
+      if (in[channel] && gain[channel] == 0.0f) {
+        release(in[channel]);
+        in[channel] = NULL;
+      }
+      if (in[channel]) live++;
+    }
+    if (!live) return;
+    if (live == 1) {
+      for (size_t channel = 0; channel < NumChannels; channel++) {
+        if (in[channel] && gain[channel] == 1.0f) {
+          transmit(in[channel]);
+          release(in[channel]);
+          return;
         }
-        release(in);
       }
     }
 
-    if (out_filled) {
-      audio_block_t* out_block = allocate();
-      arm_float_to_q15(out, out_block->data, AUDIO_BLOCK_SAMPLES);
-      transmit(out_block);
-      release(out_block);
+    audio_block_t* out_block = allocate();
+    // Originally I had this scaling and mixing all with q15 but that has much
+    // less desirable saturation behavior with phase correlated material, so
+    // either way the sum is saturated only once, at the end.
+#if defined(__ARM_ARCH_7EM__)
+    int32_t acc[AUDIO_BLOCK_SAMPLES];
+    bool first = true;
+    for (size_t channel = 0; channel < NumChannels; channel++) {
+      if (!in[channel]) continue;
+      if (out_block) {
+        q15::MixInto(
+          acc,
+          in[channel]->data,
+          q15::GainToQ16(gain[channel], GAIN_LIMIT),
+          first,
+          AUDIO_BLOCK_SAMPLES
+        );
+        first = false;
+      }
+      release(in[channel]);
+    }
+    if (!out_block) return;
+    q15::Saturate(acc, out_block->data, AUDIO_BLOCK_SAMPLES);
+#else
+    float aux[AUDIO_BLOCK_SAMPLES];
+    float out[AUDIO_BLOCK_SAMPLES];
+    arm_fill_f32(0.0f, out, AUDIO_BLOCK_SAMPLES);
+    for (size_t channel = 0; channel < NumChannels; channel++) {
+      if (!in[channel]) continue;
+      if (out_block) {
+        arm_q15_to_float(in[channel]->data, aux, AUDIO_BLOCK_SAMPLES);
+        if (gain[channel] != 1.0f) {
+          arm_scale_f32(aux, gain[channel], aux, AUDIO_BLOCK_SAMPLES);
+        }
+        arm_add_f32(aux, out, out, AUDIO_BLOCK_SAMPLES);
+      }
+      release(in[channel]);
     }
+    if (!out_block) return;
+    arm_float_to_q15(out, out_block->data, AUDIO_BLOCK_SAMPLES);
+#endif
+    transmit(out_block);
+    release(out_block);
   }
 
 private:
   audio_block_t* inputQueueArray[NumChannels];
+#if defined(__ARM_ARCH_7EM__)
+  // Q16.16, small enough that the sum of every channel fits an int32
+  static const int32_t GAIN_LIMIT = q15::GAIN_LIMIT / NumChannels;
+#endif
   std::array<float, NumChannels> gains = {0.0f};
 };
@@ -61,6 +61,9 @@ public:
   inline T Read() {
     return value;
   }
+  inline T Target() {
+    return value;
+  }
   inline Param& operator=(const T& newValue) {
     value = newValue;
     return *this;
@@ -108,6 +111,16 @@ public:
     return lp_value == Read() && param.Done();
   }
 
+  // Everything ReadNext() can return until the next assignment lies within
+  // [lo, hi], as the filter only ever moves towards the param
+  inline void Bounds(float& lo, float& hi) {
+    lo = hi = lp_value;
+    for (float v : {param.Read(), param.Target()}) {
+      if (v < lo) lo = v;
+      if (v > hi) hi = v;
+    }
+  }
+
 private:
   P param;
   float coeff;
@@ -145,6 +158,10 @@ public:
     return value;
   }
 
+  inline float Target() {
+    return target;
+  }
+
   inline void Reset() {
     value = target;
   }
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "WavStream.h"
+#include <Audio.h>
+
+// Plays a WavStream at any rate, backwards too, with linear interpolation.
+// Mono files come out of both outputs.
+//
+// open(), play(), retrigger(), setPlayStart() and prefetch() may touch the
+// card and belong in mainloop; the rest is safe anywhere.
+class AudioPlayWavStream : public AudioStream {
+public:
+  AudioPlayWavStream() : AudioStream(0, nullptr) {}
+
+  bool open(const char* path) {
+    stop();
+    play_start = 0;
+    return stream.Open(path);
+  }
+
+  // With the header and first frames already in memory; see WavStream
+  bool open(
+    const char* path,
+    const WavInfo& info,
+    const int16_t* cached,
+    uint32_t cached_frames
+  ) {
+    stop();
+    play_start = 0;
+    return stream.Open(path, info, cached, cached_frames);
+  }
+
+  void close() {
+    stop();
+    stream.Close();
+  }
+
+  bool isOpen() {
+    return stream.IsOpen();
+  }
+
+  // From the play start, or from the end when playing backwards
+  void play() {
+    if (!stream.IsOpen()) return;
+    Jump(step < 0 ? stream.Frames() - 1 : play_start);
+    playing = true;
+  }
+
+  void stop() {
+    playing = false;
+  }
+
+  bool isPlaying() {
+    return playing;
+  }
+
+  void retrigger() {
+    if (playing) play();
+  }
+
+  // Where play() and retrigger() go; those frames are kept resident so the
+  // jump is instant
+  void setPlayStart(uint32_t frame) {
+    play_start = frame;
+    stream.SetCue(frame);
+  }
+
+  uint32_t playStart() {
+    return play_start;
+  }
+
+  // 1.0 is the file's own speed, negative is backwards
+  void setPlaybackRate(float rate) {
+    const float ratio
+      = static_cast<float>(stream.SampleRate()) / AUDIO_SAMPLE_RATE_EXACT;
+    const int64_t s = static_cast<int64_t>(rate * ratio * (1LL << 32));
+    __disable_irq();
+    step = s;
+    __enable_irq();
+  }
+
+  // Keeps the card reads ahead of the play head; call from mainloop
+  void prefetch() {
+    __disable_irq();
+    const int64_t p = pos;
+    const bool forward = step >= 0;
+    __enable_irq();
+    stream.Prefetch(static_cast<uint32_t>(p >> 32), forward);
+  }
+
+  uint32_t positionFrames() {
+    __disable_irq();
+    const int64_t p = pos;
+    __enable_irq();
+    return static_cast<uint32_t>(p >> 32);
+  }
+
+  uint32_t positionMillis() {
+    if (!stream.SampleRate()) return 0;
+    return static_cast<uint32_t>(
+      static_cast<uint64_t>(positionFrames()) * 1000 / stream.SampleRate()
+    );
+  }
+
+  // Moves the play head by up to max_frames towards a multiple of
+  // grid_frames from the play start, to pull it back in phase with a clock
+  void nudgeToGrid(float grid_frames, uint32_t max_frames) {
+    if (grid_frames < 1.0f) return;
+    const float frame = static_cast<float>(positionFrames()) - play_start;
+    const float off = frame - grid_frames * roundf(frame / grid_frames);
+    if (off == 0.0f || fabsf(off) > max_frames) return;
+    __disable_irq();
+    pos -= static_cast<int64_t>(off * (1LL << 32));
+    __enable_irq();
+  }
+
+  uint32_t lengthFrames() {
+    return stream.Frames();
+  }
+
+  uint32_t sampleRate() {
+    return stream.SampleRate();
+  }
+
+  // Blocks that needed a frame the card hadn't delivered yet
+  uint32_t underruns() {
+    return underrun_count;
+  }
+
+  void resetUnderruns() {
+    underrun_count = 0;
+  }
+
+  virtual void update(void) override {
+    if (!playing || !stream.IsOpen()) return;
+    audio_block_t* left = allocate();
+    if (!left) return;
+    audio_block_t* right = NULL;
+    const bool stereo = stream.Channels() > 1;
+    if (stereo && !(right = allocate())) {
+      release(left);
+      return;
+    }
+
+    const int64_t end = static_cast<int64_t>(stream.Frames()) << 32;
+    const int64_t last = end - (1LL << 32);
+    int64_t p = pos;
+    const int64_t s = step;
+    bool missed = false;
+    int i = 0;
+    for (; i < AUDIO_BLOCK_SAMPLES; i++) {
+      if (p < 0 || p >= end) break;
+      const uint32_t frame = static_cast<uint32_t>(p >> 32);
+      // 15 bits, so the difference times t fits in an int32
+      const int32_t t = static_cast<int32_t>((p >> 17) & 0x7FFF);
+      int16_t a[2] = {0, 0};
+      int16_t b[2] = {0, 0};
+      missed |= !stream.Read(frame, a);
+      if (t && p < last) missed |= !stream.Read(frame + 1, b);
+      else b[0] = a[0], b[1] = a[1];
+      left->data[i] = a[0] + (((b[0] - a[0]) * t) >> 15);
+      if (right) right->data[i] = a[1] + (((b[1] - a[1]) * t) >> 15);
+      p += s;
+    }
+    if (i < AUDIO_BLOCK_SAMPLES) {
+      // Ran off either end
+      for (; i < AUDIO_BLOCK_SAMPLES; i++) {
+        left->data[i] = 0;
+        if (right) right->data[i] = 0;
+      }
+      playing = false;
+    }
+    pos = p;
+    if (missed) underrun_count++;
+
+    transmit(left, 0);
+    transmit(right ? right : left, 1);
+    release(left);
+    if (right) release(right);
+  }
+
+private:
+  WavStream stream;
+  volatile bool playing = false;
+  // Q32.32 frames
+  volatile int64_t pos = 0;
+  volatile int64_t step = 1LL << 32;
+  uint32_t play_start = 0;
+  volatile uint32_t underrun_count = 0;
+
+  void Jump(uint32_t frame) {
+    __disable_irq();
+    pos = static_cast<int64_t>(frame) << 32;
+    __enable_irq();
+  }
+};
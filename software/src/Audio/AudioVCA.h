@@ -1,5 +1,6 @@
 #pragma once
 
+#include "q15_kernels.h"
 #include <Audio.h>
 #include <cfloat>
 
@@ -20,35 +21,74 @@ public:
 
   virtual void update(void) {
     auto* signal = receiveReadOnly(0);
-    if (signal == NULL) return;
-    float signal_f32[AUDIO_BLOCK_SAMPLES];
-    arm_q15_to_float(signal->data, signal_f32, AUDIO_BLOCK_SAMPLES);
-    release(signal);
-
-    float mod[AUDIO_BLOCK_SAMPLES];
-    arm_fill_f32(bias_, mod, AUDIO_BLOCK_SAMPLES);
-    if (level_ != 0.0f) {
-      auto* cv = receiveReadOnly(1);
-      if (cv) {
-        float cv_f32[AUDIO_BLOCK_SAMPLES];
-        arm_q15_to_float(cv->data, cv_f32, AUDIO_BLOCK_SAMPLES);
-        release(cv);
-        arm_scale_f32(cv_f32, level_, cv_f32, AUDIO_BLOCK_SAMPLES);
-        arm_add_f32(cv_f32, mod, mod, AUDIO_BLOCK_SAMPLES);
-      }
+    // Always taken, so it isn't left holding a block at level 0
+    auto* cv = receiveReadOnly(1);
+    const float level = level_;
+    if (cv && level == 0.0f) {
+      release(cv);
+      cv = NULL;
     }
-    if (rectify_) {
-      // Alas, no generalized arm_clip_f32(). Hopefully the compiler can vectorize this...
-      for (float& x : mod) {
-        if (x < 0.0f) x = 0.0f;
-      }
+    if (signal == NULL) {
+      if (cv) release(cv);
+      return;
+    }
+
+    // Constant gain: nothing out is silence, as with the Teensy amplifier,
+    // and unity passes the block on
+    const float bias = bias_;
+    const float gain = rectify_ && bias < 0.0f ? 0.0f : bias;
+    if (!cv && (gain == 0.0f || gain == 1.0f)) {
+      if (gain == 1.0f) transmit(signal);
+      release(signal);
+      return;
     }
 
-    arm_mult_f32(mod, signal_f32, signal_f32, AUDIO_BLOCK_SAMPLES);
     auto* out = allocate();
+    if (!out) {
+      if (cv) release(cv);
+      release(signal);
+      return;
+    }
+#if defined(__ARM_ARCH_7EM__)
+    if (cv) {
+      q15::Modulate(
+        signal->data,
+        cv->data,
+        q15::GainToQ16(bias),
+        q15::GainToQ16(level),
+        rectify_,
+        out->data,
+        AUDIO_BLOCK_SAMPLES
+      );
+    } else {
+      q15::Scale(signal->data, q15::GainToQ16(gain), out->data, AUDIO_BLOCK_SAMPLES);
+    }
+#else
+    float signal_f32[AUDIO_BLOCK_SAMPLES];
+    arm_q15_to_float(signal->data, signal_f32, AUDIO_BLOCK_SAMPLES);
+    if (cv) {
+      float mod[AUDIO_BLOCK_SAMPLES];
+      float cv_f32[AUDIO_BLOCK_SAMPLES];
+      arm_fill_f32(bias, mod, AUDIO_BLOCK_SAMPLES);
+      arm_q15_to_float(cv->data, cv_f32, AUDIO_BLOCK_SAMPLES);
+      arm_scale_f32(cv_f32, level, cv_f32, AUDIO_BLOCK_SAMPLES);
+      arm_add_f32(cv_f32, mod, mod, AUDIO_BLOCK_SAMPLES);
+      if (rectify_) {
+        // Alas, no generalized arm_clip_f32(). Hopefully the compiler can vectorize this...
+        for (float& x : mod) {
+          if (x < 0.0f) x = 0.0f;
+        }
+      }
+      arm_mult_f32(mod, signal_f32, signal_f32, AUDIO_BLOCK_SAMPLES);
+    } else {
+      arm_scale_f32(signal_f32, gain, signal_f32, AUDIO_BLOCK_SAMPLES);
+    }
     arm_float_to_q15(signal_f32, out->data, AUDIO_BLOCK_SAMPLES);
+#endif
     transmit(out);
     release(out);
+    if (cv) release(cv);
+    release(signal);
   }
 
 private:
@@ -57,4 +97,3 @@ private:
   float bias_ = 0.0f;
   bool rectify_ = false;
 };
-
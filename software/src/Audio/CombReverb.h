@@ -0,0 +1,307 @@
+#pragma once
+
+#include "q15_kernels.h"
+#include <Audio.h>
+#include <imxrt.h>
+#include <string.h>
+
+// Parallel feedback combs with one-pole damping, summed into a chain of
+// allpasses: the network behind both Freeverb and the Schroeder/Moorer reverb,
+// which differ only in their ReverbTuning.
+//
+// Delay lines are q15 and each is run over a whole block before the next
+// (structure of arrays, one line's state in registers at a time). Gains are
+// Q15 for the feedback paths and Q16.16 elsewhere, as in q15_kernels.h.
+
+enum AllpassForm : uint8_t {
+  // Freeverb's: stores in + g * delayed, outputs (delayed - in) / 2. Not
+  // quite allpass, but what everyone knows Freeverb to sound like.
+  ALLPASS_FREEVERB,
+  // Textbook: z = in - g * delayed is stored, delayed + g * z is output;
+  // products truncated towards zero, as in the combs
+  ALLPASS_SCHROEDER,
+};
+
+struct ReverbTuning {
+  static constexpr int COMBS = 8;
+  static constexpr int ALLPASSES = 4;
+
+  uint16_t comb_lengths[COMBS];
+  uint16_t allpass_lengths[ALLPASSES];
+  AllpassForm allpass_form;
+  int16_t allpass_gain; // Q15
+  // Q16.16; the input is attenuated to leave the combs headroom to ring,
+  // and the output makes up for it
+  int32_t input_gain;
+  // Q16.16, on the sum of all COMBS combs; fewer are scaled up to match
+  int32_t comb_gain;
+  int32_t output_gain;
+  // Added to every line length for the right channel, to decorrelate it
+  uint16_t stereo_spread;
+
+  // Delay line samples each channel's network needs
+  constexpr size_t LineSamples(int channels = 1) const {
+    size_t n = 0;
+    for (int i = 0; i < COMBS; ++i) n += comb_lengths[i];
+    for (int i = 0; i < ALLPASSES; ++i) n += allpass_lengths[i];
+    if (channels > 1) n += (COMBS + ALLPASSES) * stereo_spread;
+    return n;
+  }
+
+  // Mean comb delay, in samples
+  constexpr float AverageComb() const {
+    float n = 0.0f;
+    for (int i = 0; i < COMBS; ++i) n += comb_lengths[i];
+    return n / COMBS;
+  }
+};
+
+// As the Teensy Audio library's AudioEffectFreeverb
+static constexpr ReverbTuning FREEVERB_TUNING = {
+  {1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617},
+  {556, 441, 341, 225},
+  ALLPASS_FREEVERB,
+  16384,
+  4369,     // 1/15
+  15729,    // 0.24
+  30 << 16,
+  23,
+};
+
+// As AudioEffectReverbSchroeder always was
+static constexpr ReverbTuning SCHROEDER_TUNING = {
+  {1319, 1493, 1559, 1613, 1747, 1873, 2017, 2153},
+  {221, 75, 366, 556}, // 5, 1.7, 8.3, 12.6 ms
+  ALLPASS_SCHROEDER,
+  16384,
+  4096,                // 1/16
+  8192,                // mean of the combs
+  (1 << 16) * 16 * 6 / 10,
+  23,
+};
+
+// One channel of the network, over lines in a pool of Samples
+template <size_t Samples>
+class CombAllpassNetwork {
+public:
+  // spread is added to every line length
+  void Init(const ReverbTuning& t, uint16_t spread = 0) {
+    tuning = &t;
+    int16_t* line = lines;
+    for (int i = 0; i < ReverbTuning::COMBS; ++i) {
+      comb_len[i] = t.comb_lengths[i] + spread;
+      comb_line[i] = line;
+      line += comb_len[i];
+    }
+    for (int i = 0; i < ReverbTuning::ALLPASSES; ++i) {
+      ap_len[i] = t.allpass_lengths[i] + spread;
+      ap_line[i] = line;
+      line += ap_len[i];
+    }
+    Clear();
+  }
+
+  void Clear() {
+    memset(lines, 0, sizeof(lines));
+    for (int i = 0; i < ReverbTuning::COMBS; ++i) {
+      comb_ix[i] = 0;
+      comb_filter[i] = 0;
+    }
+    for (int i = 0; i < ReverbTuning::ALLPASSES; ++i) ap_ix[i] = 0;
+  }
+
+  // Q15
+  void Feedback(int16_t g) {
+    feedback = g;
+  }
+  // Q15 weight of each comb's filter state against its newest sample
+  void Damping(int16_t d) {
+    damp = d;
+  }
+
+  // Runs only the first n combs, for a cheaper and sparser tail. Combs that
+  // come back start from silence.
+  void CombCount(int n) {
+    n = constrain(n, 1, ReverbTuning::COMBS);
+    for (int i = combs; i < n; ++i) {
+      memset(comb_line[i], 0, comb_len[i] * sizeof(int16_t));
+      comb_ix[i] = 0;
+      comb_filter[i] = 0;
+    }
+    combs = n;
+  }
+
+  int CombCount() const {
+    return combs;
+  }
+
+  void Process(const int16_t* in, int16_t* out) {
+    const ReverbTuning& t = *tuning;
+    int16_t x[AUDIO_BLOCK_SAMPLES];
+    int32_t sum[AUDIO_BLOCK_SAMPLES] = {0};
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; ++i) {
+      x[i] = q15::saturate(q15::mul(t.input_gain, in[i]));
+    }
+
+    const int32_t fb = feedback;
+    const int32_t d1 = damp;
+    const int32_t d2 = 32768 - damp;
+    for (int c = 0; c < combs; ++c) {
+      int16_t* line = comb_line[c];
+      const uint16_t len = comb_len[c];
+      uint16_t ix = comb_ix[c];
+      int32_t filter = comb_filter[c];
+      // The filter state keeps 15 more bits than the line, and the feedback
+      // product is truncated towards zero: floored, the error adds up to a DC
+      // offset in a long tail; rounded, the tail never dies away
+      for (int i = 0; i < AUDIO_BLOCK_SAMPLES; ++i) {
+        const int32_t y = line[ix];
+        filter = y * d2 + static_cast<int32_t>((static_cast<int64_t>(filter) * d1) >> 15);
+        line[ix] = q15::saturate(x[i] + static_cast<int32_t>(
+          static_cast<int64_t>(filter) * fb / (1 << 30)
+        ));
+        sum[i] += y;
+        if (++ix == len) ix = 0;
+      }
+      comb_ix[c] = ix;
+      comb_filter[c] = filter;
+    }
+
+    const int32_t comb_gain = t.comb_gain * ReverbTuning::COMBS / combs;
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; ++i) {
+      x[i] = q15::saturate(
+        static_cast<int32_t>((static_cast<int64_t>(sum[i]) * comb_gain) >> 16)
+      );
+    }
+
+    const int32_t g = t.allpass_gain;
+    for (int a = 0; a < ReverbTuning::ALLPASSES; ++a) {
+      int16_t* line = ap_line[a];
+      const uint16_t len = ap_len[a];
+      uint16_t ix = ap_ix[a];
+      if (t.allpass_form == ALLPASS_FREEVERB) {
+        for (int i = 0; i < AUDIO_BLOCK_SAMPLES; ++i) {
+          const int32_t delayed = line[ix];
+          line[ix] = q15::saturate(x[i] + ((delayed * g) >> 15));
+          x[i] = q15::saturate((delayed - x[i]) >> 1);
+          if (++ix == len) ix = 0;
+        }
+      } else {
+        for (int i = 0; i < AUDIO_BLOCK_SAMPLES; ++i) {
+          const int32_t delayed = line[ix];
+          const int32_t z = q15::saturate(x[i] - delayed * g / 32768);
+          line[ix] = z;
+          x[i] = q15::saturate(delayed + z * g / 32768);
+          if (++ix == len) ix = 0;
+        }
+      }
+      ap_ix[a] = ix;
+    }
+
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; ++i) {
+      out[i] = q15::saturate(
+        static_cast<int32_t>((static_cast<int64_t>(x[i]) * t.output_gain) >> 16)
+      );
+    }
+  }
+
+private:
+
+  const ReverbTuning* tuning = &FREEVERB_TUNING;
+  int16_t feedback = 0;
+  int16_t damp = 0;
+  int combs = ReverbTuning::COMBS;
+
+  int16_t* comb_line[ReverbTuning::COMBS];
+  uint16_t comb_len[ReverbTuning::COMBS];
+  uint16_t comb_ix[ReverbTuning::COMBS];
+  // In 1/32768ths of a sample
+  int32_t comb_filter[ReverbTuning::COMBS];
+  int16_t* ap_line[ReverbTuning::ALLPASSES];
+  uint16_t ap_len[ReverbTuning::ALLPASSES];
+  uint16_t ap_ix[ReverbTuning::ALLPASSES];
+
+  int16_t lines[Samples] __attribute__((aligned(4)));
+};
+
+// Wet only. Every input is summed into one network per output, the right
+// one's lines longer by the tuning's stereo spread.
+template <int Channels, size_t Samples>
+class AudioEffectCombReverb : public AudioStream {
+public:
+  explicit AudioEffectCombReverb(const ReverbTuning& tuning)
+    : AudioStream(Channels, inputQueueArray) {
+    for (int ch = 0; ch < Channels; ++ch) {
+      net[ch].Init(tuning, ch ? tuning.stereo_spread : 0);
+    }
+  }
+
+  // Comb feedback, 0..1
+  void combFeedback(float g) {
+    const int16_t q = static_cast<int16_t>(constrain(g, 0.0f, 0.9999f) * 32768.0f);
+    __disable_irq();
+    for (auto& n : net) n.Feedback(q);
+    __enable_irq();
+  }
+
+  // How much of each comb's filter state carries over, 0 (bright) to 1
+  void combDamping(float d) {
+    const int16_t q = static_cast<int16_t>(constrain(d, 0.0f, 0.99f) * 32768.0f);
+    __disable_irq();
+    for (auto& n : net) n.Damping(q);
+    __enable_irq();
+  }
+
+  void combCount(int n) {
+    __disable_irq();
+    for (auto& c : net) c.CombCount(n);
+    __enable_irq();
+  }
+
+  void reset() {
+    __disable_irq();
+    for (auto& n : net) n.Clear();
+    __enable_irq();
+  }
+
+  virtual void update(void) override {
+    audio_block_t* in[Channels];
+    bool any = false;
+    for (int ch = 0; ch < Channels; ++ch) {
+      in[ch] = receiveReadOnly(ch);
+      any |= in[ch] != nullptr;
+    }
+
+    int16_t mono[AUDIO_BLOCK_SAMPLES];
+    if (Channels == 1 && in[0]) {
+      memcpy(mono, in[0]->data, sizeof(mono));
+    } else if (any) {
+      // Summed at half each, so a centred source is unchanged
+      for (int i = 0; i < AUDIO_BLOCK_SAMPLES; ++i) {
+        int32_t s = 0;
+        for (int ch = 0; ch < Channels; ++ch) {
+          if (in[ch]) s += in[ch]->data[i];
+        }
+        mono[i] = static_cast<int16_t>(s / Channels);
+      }
+    } else {
+      // The tail rings on without input
+      memset(mono, 0, sizeof(mono));
+    }
+    for (int ch = 0; ch < Channels; ++ch) {
+      if (in[ch]) release(in[ch]);
+    }
+
+    for (int ch = 0; ch < Channels; ++ch) {
+      audio_block_t* out = allocate();
+      if (!out) return;
+      net[ch].Process(mono, out->data);
+      transmit(out, ch);
+      release(out);
+    }
+  }
+
+private:
+  audio_block_t* inputQueueArray[Channels];
+  CombAllpassNetwork<Samples> net[Channels];
+};
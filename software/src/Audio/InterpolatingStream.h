@@ -3,24 +3,91 @@
 #include "OC_config.h"
 #include "dsputils.h"
 #include <Audio.h>
+#include <algorithm>
+#include <array>
 
+// Values pushed at the core ISR rate (OC_CORE_ISR_FREQ), resampled to the
+// audio rate.
+//
+// All in fixed point: the read position and step are Q16.16 input samples.
+// Each block, the step is the measured ratio of pushes to audio samples,
+// smoothed over a second or so, plus a correction that steers the read
+// position to a fixed distance behind the newest value. So the latency is
+// whatever LatencySamples() says instead of wherever the two clocks happened
+// to leave it, and drift between them is tracked without the step hunting.
 enum InterpolationMethod {
   INTERPOLATION_ZOH,
   INTERPOLATION_LINEAR,
-  INTERPOLATION_HERMITE
+  INTERPOLATION_HERMITE,
+  // 8-tap windowed sinc, cut off just under the input Nyquist
+  INTERPOLATION_POLYPHASE,
 };
 
+namespace interpolation {
+
+static constexpr int TAPS = 8;
+static constexpr int PHASE_BITS = 6;
+static constexpr int PHASES = 1 << PHASE_BITS;
+
+// Q15 taps for x[i - 3] ... x[i + 4], for positions i + phase / PHASES; one
+// more phase than needed so the last can interpolate towards i + 1. Each
+// phase sums to exactly unity, so constant CV comes out unchanged.
+inline const std::array<std::array<int16_t, TAPS>, PHASES + 1>& SincTable() {
+  static const auto table = [] {
+    std::array<std::array<int16_t, TAPS>, PHASES + 1> t;
+    const float pi = 3.14159265f;
+    const float cutoff = 0.9f; // of the input Nyquist
+    for (int p = 0; p <= PHASES; ++p) {
+      const float f = static_cast<float>(p) / PHASES;
+      float h[TAPS];
+      float sum = 0.0f;
+      for (int k = 0; k < TAPS; ++k) {
+        const float x = (k - (TAPS / 2 - 1)) - f;
+        const float s
+          = x == 0.0f ? 1.0f : sinf(pi * cutoff * x) / (pi * cutoff * x);
+        // Blackman
+        const float w = 0.42f + 0.5f * cosf(pi * x / (TAPS / 2))
+                      + 0.08f * cosf(2.0f * pi * x / (TAPS / 2));
+        h[k] = s * w;
+        sum += h[k];
+      }
+      int32_t total = 0;
+      int largest = 0;
+      for (int k = 0; k < TAPS; ++k) {
+        t[p][k] = static_cast<int16_t>(roundf(h[k] / sum * 32768.0f));
+        total += t[p][k];
+        if (abs(t[p][k]) > abs(t[p][largest])) largest = k;
+      }
+      t[p][largest] += 32768 - total;
+    }
+    return t;
+  }();
+  return table;
+}
+
+} // namespace interpolation
+
 template <size_t BufferSize = AUDIO_BLOCK_SAMPLES>
 class InterpolatingStream : public AudioStream {
+  static_assert(
+    (BufferSize & (BufferSize - 1)) == 0, "BufferSize must be a power of 2"
+  );
+
 public:
   InterpolatingStream(float approx_input_rate = OC_CORE_ISR_FREQ)
     : AudioStream(0, nullptr)
-    , delta(approx_input_rate / AUDIO_SAMPLE_RATE_EXACT) {}
+    , nominal_ratio(static_cast<int32_t>(
+        approx_input_rate / AUDIO_SAMPLE_RATE_EXACT * (1 << RATIO_BITS)
+      ))
+    , ratio(nominal_ratio) {}
 
   void Acquire() {
     if (buffer == nullptr) {
+      interpolation::SincTable();
       buffer = static_cast<int16_t*>(calloc(BufferSize, sizeof(int16_t)));
-      Push(0.0f);
+      ratio = nominal_ratio;
+      synced = false;
+      Push(0);
     }
   }
 
@@ -33,103 +100,221 @@ public:
 
   void Push(int16_t value) {
     if (buffer == nullptr) return;
-    buffer[write_ix++] = value;
-    write_ix %= AUDIO_BLOCK_SAMPLES;
+    buffer[write_ix] = value;
+    write_ix = (write_ix + 1) & (BufferSize - 1);
+    pushes = pushes + 1;
   }
 
+  // Input samples between the read position and the newest value
   inline float Length() const {
-    float w = static_cast<float>(write_ix);
-    return w > read_ix ? w - read_ix : w + BufferSize - read_ix;
+    return Distance(write_ix) / 65536.0f;
   }
 
   void Method(InterpolationMethod val) {
     method = val;
   }
 
+  // How far, in input samples, the output runs behind the newest pushed value
+  // at the end of each block, on top of what the method needs to look ahead.
+  // With the default of 0 it stays as close as it can, and as the number of
+  // pushes per block varies by one, the step is clipped every few blocks to
+  // keep from reading ahead of the data. 1 leaves room for that.
+  void Latency(uint8_t samples) {
+    latency = constrain(samples, 0, MaxLatency());
+  }
+
+  // Total input samples behind the newest value at the end of each block
+  uint8_t LatencySamples() const {
+    return latency + Lookahead(method);
+  }
+
+  // Measured input samples per audio sample
+  float Ratio() const {
+    return static_cast<float>(ratio) / (1 << RATIO_BITS);
+  }
+
   void update(void) override {
-    int padding;
-    switch (method) {
+    if (buffer == nullptr) return;
+    const uint32_t w = write_ix;
+    const uint32_t n = pushes;
+    const uint32_t pushed = n - last_pushes;
+    last_pushes = n;
+    // Nothing new (e.g. the core ISR is held off); hold the last value rather
+    // than replaying stale ones
+    if (pushed == 0) {
+      audio_block_t* out = allocate();
+      if (!out) return;
+      std::fill(out->data, out->data + AUDIO_BLOCK_SAMPLES, last_out);
+      transmit(out);
+      release(out);
+      return;
+    }
+    if (pushed < BufferSize) {
+      const int32_t measured
+        = static_cast<int32_t>(pushed << RATIO_BITS) / AUDIO_BLOCK_SAMPLES;
+      ratio += (measured - ratio) >> RATIO_SMOOTHING;
+    } else {
+      synced = false; // lapped
+    }
+
+    const InterpolationMethod m = method;
+    // Distance(w) is one more than the samples behind the newest value
+    const int32_t lookahead = (Lookahead(m) + 1) << 16;
+    const int32_t nominal = ratio >> (RATIO_BITS - 16);
+    // Where the read position should be after this block
+    const int32_t target = (latency << 16) + lookahead;
+    int32_t dist = Distance(w);
+    // The step that would land exactly on target this block, eased towards
+    int32_t step = (dist - target) / AUDIO_BLOCK_SAMPLES;
+    if (!synced || step < 0 || step > 2 * nominal) {
+      // Too far off to steer smoothly; jump
+      pos = ((w << 16) - target - nominal * AUDIO_BLOCK_SAMPLES) & POS_MASK;
+      dist = Distance(w);
+      step = nominal;
+      synced = true;
+    } else {
+      step = nominal + (step - nominal) / CORRECTION;
+    }
+    // Never read past the newest value
+    const int32_t max_step
+      = (dist - lookahead - 1) / (AUDIO_BLOCK_SAMPLES - 1);
+    step = constrain(step, 0, max_step);
+
+    audio_block_t* out = allocate();
+    if (!out) return;
+    switch (m) {
       case INTERPOLATION_ZOH:
-        padding = 0;
+        UpdateZOH(step, out);
         break;
       case INTERPOLATION_LINEAR:
-        padding = 1;
+        UpdateLinear(step, out);
         break;
       case INTERPOLATION_HERMITE:
+        UpdateHermite(step, out);
+        break;
+      case INTERPOLATION_POLYPHASE:
       default:
-        padding = 3;
+        UpdatePolyphase(step, out);
         break;
     }
-    float l = Length();
-    if (buffer == nullptr || l < padding + 1) return;
-    // These should be boundary deltas that would result in consuming too many
-    // or too few samples.
-    float hi = floorf(l - (padding - 1)) / AUDIO_BLOCK_SAMPLES;
-    float lo = ceilf(l - (padding + 1)) / AUDIO_BLOCK_SAMPLES;
-    // I messed with various of ways of having delta adapt to the true relative
-    // sample rates, but turns out better not to mess with it. The sample rates
-    // do seem to drift, but kind of oscillate, so trying to adapt never
-    // settles (or takes a really long time to). Just having it try to stick to
-    // the ideal except when it can't is simple and worked the best.
-    float d = constrain(delta, lo, hi);
-    audio_block_t* out = allocate();
-    switch (method) {
+    last_out = out->data[AUDIO_BLOCK_SAMPLES - 1];
+    transmit(out);
+    release(out);
+  }
+
+private:
+  // Q8.24 input samples per audio sample
+  static constexpr int RATIO_BITS = 24;
+  // Blocks the measured ratio is averaged over, as a power of 2; 256 blocks
+  // is ~0.75 s, so the odd late ISR barely moves it
+  static constexpr int RATIO_SMOOTHING = 8;
+  // Fraction of the latency error corrected per block
+  static constexpr int32_t CORRECTION = 8;
+  static constexpr uint32_t POS_MASK = (BufferSize << 16) - 1;
+  static constexpr uint32_t IX_MASK = BufferSize - 1;
+
+  int16_t* buffer = nullptr;
+  volatile uint32_t write_ix = 0;
+  volatile uint32_t pushes = 0;
+  uint32_t last_pushes = 0;
+  // Q16.16 input samples
+  uint32_t pos = 0;
+  const int32_t nominal_ratio;
+  int32_t ratio;
+  bool synced = false;
+  uint8_t latency = 0;
+  int16_t last_out = 0;
+  InterpolationMethod method = INTERPOLATION_ZOH;
+
+  // Input samples the read position has to stay (just) behind the newest
+  // value for the method to read only what's been pushed: one less than the
+  // samples it reads past x0
+  static int32_t Lookahead(InterpolationMethod m) {
+    switch (m) {
       case INTERPOLATION_ZOH:
-        UpdateZOH(d, out);
-        break;
       case INTERPOLATION_LINEAR:
-        UpdateLinear(d, out);
-        break;
+        return 0;
       case INTERPOLATION_HERMITE:
+        return 1;
+      case INTERPOLATION_POLYPHASE:
       default:
-        UpdateHermite(d, out);
-        break;
+        return interpolation::TAPS / 2 - 1;
     }
-    transmit(out);
-    release(out);
   }
 
-  void UpdateZOH(float d, audio_block_t* out) {
+  // Leaves room for a block's worth of reading and the widest kernel
+  static constexpr uint8_t MaxLatency() {
+    return BufferSize / 2 - interpolation::TAPS;
+  }
+
+  int32_t Distance(uint32_t w) const {
+    return static_cast<int32_t>(((w << 16) - pos) & POS_MASK);
+  }
+
+  int16_t At(uint32_t i) const {
+    return buffer[i & IX_MASK];
+  }
+
+  void UpdateZOH(int32_t step, audio_block_t* out) {
     for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
-      int read_int = static_cast<int>(read_ix);
-      out->data[i] = buffer[read_int];
-      read_ix += d;
-      if (read_ix >= BufferSize) read_ix -= BufferSize;
+      out->data[i] = At(pos >> 16);
+      pos = (pos + step) & POS_MASK;
     }
   }
 
-  void UpdateLinear(float d, audio_block_t* out) {
+  void UpdateLinear(int32_t step, audio_block_t* out) {
     for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
-      int read_int = static_cast<int>(read_ix);
-      float read_dec = read_ix - read_int;
-      out->data[i] = InterpLinear(
-        buffer[read_int], buffer[(read_int + 1) % BufferSize], read_dec
-      );
-      read_ix += d;
-      if (read_ix >= BufferSize) read_ix -= BufferSize;
+      const uint32_t ix = pos >> 16;
+      const int32_t t = (pos & 0xFFFF) >> 1; // Q15
+      const int32_t x0 = At(ix);
+      const int32_t x1 = At(ix + 1);
+      out->data[i] = x0 + (((x1 - x0) * t) >> 15);
+      pos = (pos + step) & POS_MASK;
     }
   }
 
-  void UpdateHermite(float d, audio_block_t* out) {
+  void UpdateHermite(int32_t step, audio_block_t* out) {
     for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
-      int read_int = static_cast<int>(read_ix);
-      float read_dec = read_ix - read_int;
-      out->data[i] = Clip16(InterpHermite(
-        buffer[read_int],
-        buffer[(read_int + 1) % BufferSize],
-        buffer[(read_int + 2) % BufferSize],
-        buffer[(read_int + 3) % BufferSize],
-        read_dec
-      ));
-      read_ix += d;
-      if (read_ix >= BufferSize) read_ix -= BufferSize;
+      const uint32_t ix = pos >> 16;
+      const int64_t t = (pos & 0xFFFF) >> 1; // Q15
+      const int32_t xm1 = At(ix - 1);
+      const int32_t x0 = At(ix);
+      const int32_t x1 = At(ix + 1);
+      const int32_t x2 = At(ix + 2);
+      // As InterpHermite(), times 2 to stay in integers
+      const int32_t c = x1 - xm1;
+      const int32_t v = 2 * (x0 - x1);
+      const int32_t w = c + v;
+      const int32_t a = w + v + (x2 - x0);
+      const int32_t b = w + a;
+      int64_t y = (a * t) >> 15;
+      y = ((y - b) * t) >> 15;
+      y = ((y + c) * t) >> 15;
+      out->data[i] = Clip16(static_cast<int32_t>((y >> 1) + x0));
+      pos = (pos + step) & POS_MASK;
     }
   }
 
-private:
-  int16_t* buffer = nullptr;
-  size_t write_ix = 0;
-  float read_ix = 0.0f;
-  float delta;
-  InterpolationMethod method = INTERPOLATION_ZOH;
+  void UpdatePolyphase(int32_t step, audio_block_t* out) {
+    const auto& table = interpolation::SincTable();
+    constexpr int FRAC_BITS = 16 - interpolation::PHASE_BITS;
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+      const uint32_t ix = pos >> 16;
+      const uint32_t phase = (pos & 0xFFFF) >> FRAC_BITS;
+      const int32_t g = pos & ((1 << FRAC_BITS) - 1);
+      const int16_t* ca = table[phase].data();
+      const int16_t* cb = table[phase + 1].data();
+      int32_t ya = 0;
+      int32_t yb = 0;
+      for (int k = 0; k < interpolation::TAPS; ++k) {
+        const int32_t x = At(ix + k - (interpolation::TAPS / 2 - 1));
+        ya += x * ca[k];
+        yb += x * cb[k];
+      }
+      ya >>= 15;
+      yb >>= 15;
+      out->data[i] = Clip16(ya + (((yb - ya) * g) >> FRAC_BITS));
+      pos = (pos + step) & POS_MASK;
+    }
+  }
 };
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "WavStream.h"
+
+#ifndef WAV_POOL_SLOTS
+#define WAV_POOL_SLOTS 12
+#endif
+
+// The headers and first frames of recently used numbered WAV files (000.WAV,
+// 001.WAV, ...) kept in PSRAM, so a WavStream can open one and start playing
+// without waiting on the card. The rest of the file streams in behind as
+// usual.
+//
+// Slots are recycled least recently used first. Preload() fills one in the
+// background, a few chunks per Service(), so mainloop never stalls for long;
+// Acquire() loads on the spot when it has to. Files that don't exist or
+// aren't playable are remembered too, so they aren't retried on every pass.
+//
+// Everything here is mainloop only.
+class WavSamplePool {
+public:
+  static constexpr int MAX_SLOTS = WAV_POOL_SLOTS;
+  // Matches the stream's cue cache, which covers the time it takes the ring
+  // to fill
+  static constexpr uint32_t HEAD_FRAMES = WavStream::CUE_FRAMES;
+  static constexpr int NO_FILE = -1;
+
+  struct Sample {
+    int file = NO_FILE;
+    bool playable = false;
+    WavInfo info;
+    int16_t* data = nullptr;
+    uint32_t frames = 0; // in data
+    uint32_t last_used = 0;
+    uint8_t users = 0;
+  };
+
+  // slots may be less than MAX_SLOTS, e.g. 0 without PSRAM
+  explicit WavSamplePool(int slots = MAX_SLOTS)
+    : slot_count(slots < MAX_SLOTS ? slots : MAX_SLOTS) {}
+
+  ~WavSamplePool() {
+    for (Sample& s : slots) {
+      if (s.data) extmem_free(s.data);
+    }
+  }
+
+  // name holds at least 8 chars
+  static void FileName(int file, char* name) {
+    strcpy(name, "000.WAV");
+    name[0] += file / 100;
+    name[1] += file / 10 % 10;
+    name[2] += file % 10;
+  }
+
+  // The playable sample for file, loaded now if need be, and held until
+  // Release(). Null if there's no such file, or nowhere to put it.
+  const Sample* Acquire(int file) {
+    ++requests;
+    Sample* s = Find(file);
+    if (s && s != loading) ++hits;
+    if (!s) s = Load(file);
+    if (!s) return nullptr;
+    if (s == loading) Finish();
+    Touch(*s);
+    if (!s->playable) return nullptr;
+    ++s->users;
+    return s;
+  }
+
+  void Release(const Sample* sample) {
+    for (Sample& s : slots) {
+      if (&s == sample && s.users) --s.users;
+    }
+  }
+
+  // Starts loading file in the background if it isn't already here, unless
+  // another load is under way. True if file is taken care of.
+  bool Preload(int file) {
+    if (file < 0 || file > 999) return true;
+    if (Find(file)) return true;
+    if (loading) return false;
+    return Load(file, false) != nullptr;
+  }
+
+  // Continues a background load; call every mainloop pass
+  void Service() {
+    if (loading) Step(WavStream::CHUNKS_PER_PREFETCH);
+  }
+
+  bool Busy() const {
+    return loading != nullptr;
+  }
+
+  bool Contains(int file) const {
+    for (int i = 0; i < slot_count; ++i) {
+      if (slots[i].file == file && &slots[i] != loading) return true;
+    }
+    return false;
+  }
+
+  // Of the Acquire() calls, the percentage that didn't have to wait
+  int HitPercent() const {
+    return requests ? static_cast<int>(100 * hits / requests) : 0;
+  }
+  uint32_t Requests() const {
+    return requests;
+  }
+  void ResetStats() {
+    hits = requests = 0;
+  }
+
+private:
+  Sample slots[MAX_SLOTS];
+  const int slot_count;
+  uint32_t clock = 0;
+  uint32_t hits = 0;
+  uint32_t requests = 0;
+
+  Sample* loading = nullptr;
+  File file;
+
+  Sample* Find(int file) {
+    for (int i = 0; i < slot_count; ++i) {
+      if (slots[i].file == file) return &slots[i];
+    }
+    return nullptr;
+  }
+
+  void Touch(Sample& s) {
+    s.last_used = ++clock;
+  }
+
+  // The least recently used slot nobody is playing from
+  Sample* Victim() {
+    Sample* victim = nullptr;
+    for (int i = 0; i < slot_count; ++i) {
+      Sample& s = slots[i];
+      if (s.users || &s == loading) continue;
+      if (s.file == NO_FILE) return &s;
+      if (!victim || s.last_used < victim->last_used) victim = &s;
+    }
+    return victim;
+  }
+
+  // Claims a slot for file and reads its header; the frames follow in Step().
+  // Unless background, they are all read now.
+  Sample* Load(int file_num, bool now = true) {
+    if (loading && now) Finish();
+    Sample* s = Victim();
+    if (!s) return nullptr;
+    if (!s->data) {
+      s->data = static_cast<int16_t*>(
+        extmem_malloc(HEAD_FRAMES * 2 * sizeof(int16_t))
+      );
+      if (!s->data) return nullptr;
+    }
+    char name[8];
+    FileName(file_num, name);
+    s->file = file_num;
+    s->frames = 0;
+    file = SD.open(name);
+    s->playable = file && s->info.Read(file);
+    Touch(*s);
+    if (!s->playable) {
+      if (file) file.close();
+      return s;
+    }
+    loading = s;
+    if (now) Finish();
+    return s;
+  }
+
+  void Finish() {
+    while (loading) Step(HEAD_FRAMES / WavStream::CHUNK_FRAMES);
+  }
+
+  void Step(int chunks) {
+    Sample& s = *loading;
+    uint32_t want = s.info.frames < HEAD_FRAMES ? s.info.frames : HEAD_FRAMES;
+    for (int i = 0; i < chunks && s.frames < want; ++i) {
+      uint32_t n = want - s.frames;
+      if (n > WavStream::CHUNK_FRAMES) n = WavStream::CHUNK_FRAMES;
+      n = s.info.ReadFrames(
+        file, s.frames, n, s.data + s.frames * s.info.channels
+      );
+      if (!n) {
+        // Shorter than it claimed; keep what there is
+        want = s.frames;
+        break;
+      }
+      s.frames += n;
+    }
+    if (s.frames >= want) {
+      file.close();
+      loading = nullptr;
+    }
+  }
+};
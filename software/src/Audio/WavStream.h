@@ -0,0 +1,308 @@
+#pragma once
+
+#include <SD.h>
+#include <imxrt.h>
+#include <smalloc.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" uint8_t external_psram_size;
+
+// Where the samples are in a WAV file, and how they are laid out
+struct WavInfo {
+  uint16_t channels = 1;
+  uint32_t sample_rate = 44100;
+  uint32_t frames = 0;
+  uint32_t data_offset = 0;
+
+  // From the RIFF header at the start of file. False unless it is mono or
+  // stereo 16-bit PCM.
+  bool Read(File& file) {
+    uint8_t head[12];
+    if (!file.seek(0) || file.read(head, 12) != 12) return false;
+    if (memcmp(head, "RIFF", 4) || memcmp(head + 8, "WAVE", 4)) return false;
+    bool fmt_ok = false;
+    uint32_t pos = 12;
+    uint8_t chunk[24];
+    while (file.seek(pos) && file.read(chunk, 8) == 8) {
+      const uint32_t size = LE(chunk + 4, 4);
+      if (!memcmp(chunk, "fmt ", 4)) {
+        if (size < 16 || file.read(chunk + 8, 16) != 16) return false;
+        const uint16_t format = LE(chunk + 8, 2);
+        channels = LE(chunk + 10, 2);
+        sample_rate = LE(chunk + 12, 4);
+        const uint16_t bits = LE(chunk + 22, 2);
+        fmt_ok = format == 1 && bits == 16 && (channels == 1 || channels == 2);
+      } else if (!memcmp(chunk, "data", 4)) {
+        if (!fmt_ok) return false;
+        data_offset = pos + 8;
+        frames = size / FrameBytes();
+        const uint32_t file_frames = (file.size() - data_offset) / FrameBytes();
+        if (frames > file_frames) frames = file_frames;
+        return true;
+      }
+      // Chunks are padded to even lengths
+      pos += 8 + size + (size & 1);
+    }
+    return false;
+  }
+
+  uint32_t FrameBytes() const {
+    return channels * sizeof(int16_t);
+  }
+
+  // Reads n frames from frame on into dest; returns how many were read
+  uint32_t ReadFrames(File& file, uint32_t frame, uint32_t n, int16_t* dest) const {
+    if (!file.seek(data_offset + frame * FrameBytes())) return 0;
+    const int got = file.read(dest, n * FrameBytes());
+    return got > 0 ? got / FrameBytes() : 0;
+  }
+
+private:
+  static uint32_t LE(const uint8_t* p, int bytes) {
+    uint32_t v = 0;
+    for (int i = bytes - 1; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+  }
+};
+
+// A 16-bit PCM WAV file on the SD card, streamed through PSRAM so the audio
+// interrupt never touches the card. Without PSRAM it streams through much
+// smaller buffers on the internal heap.
+//
+// mainloop() calls Prefetch() to keep a ring of frames ahead of the play head,
+// in whichever direction it is moving. The frames just after the cue point are
+// kept resident as well, so jumping back to the cue is instant. The audio
+// interrupt only ever calls Read(), which copies a frame out of either of
+// those or reports a miss.
+//
+// The ring is a window [lo, hi) of file frames; frame f lives in slot
+// f % ring_frames. Only mainloop moves lo and hi, always shrinking the window
+// before overwriting a slot and growing it after, so any point the interrupt
+// lands on sees a window whose slots are all valid.
+class WavStream {
+public:
+  // ~0.37 s of 44.1 kHz
+  static const uint32_t RING_FRAMES = 16384;
+  // ~0.19 s from the cue point
+  static const uint32_t CUE_FRAMES = 8192;
+  // Without PSRAM, ~93 ms and ~23 ms: 20 KiB of internal heap, not 96
+  static const uint32_t INTERNAL_RING_FRAMES = 4096;
+  static const uint32_t INTERNAL_CUE_FRAMES = 1024;
+  // Frames per card read; 1 or 2 KiB, whole sectors
+  static const uint32_t CHUNK_FRAMES = 256;
+  // Kept behind the play head, for interpolation and small jumps back
+  static const uint32_t BEHIND_FRAMES = 2 * CHUNK_FRAMES;
+  // Card reads per Prefetch(), so a refill doesn't stall mainloop; 8 chunks
+  // is ~46 ms of audio, far more than a mainloop pass takes
+  static const int CHUNKS_PER_PREFETCH = 8;
+
+  ~WavStream() {
+    Close();
+    if (ring) extmem_free(ring);
+    if (cue_cache) extmem_free(cue_cache);
+  }
+
+  // Opens path and fills the cue cache from frame 0. False, and closed, if it
+  // isn't a mono or stereo 16-bit PCM WAV.
+  bool Open(const char* path) {
+    Close();
+    file = SD.open(path);
+    if (!file || !info.Read(file) || !Allocate()) {
+      Close();
+      return false;
+    }
+    open = true;
+    SetCue(0);
+    return true;
+  }
+
+  // As above, for a file whose header has been read and whose first
+  // cached_frames frames are already in memory, e.g. from a WavSamplePool.
+  // cached is used in place while the cue is at 0, so must outlive this.
+  bool Open(
+    const char* path,
+    const WavInfo& wav,
+    const int16_t* cached,
+    uint32_t cached_frames
+  ) {
+    Close();
+    file = SD.open(path);
+    info = wav;
+    if (!file || !Allocate()) {
+      Close();
+      return false;
+    }
+    head = cached;
+    head_frames = cached_frames;
+    open = true;
+    SetCue(0);
+    return true;
+  }
+
+  // Buffers are kept for the next Open()
+  void Close() {
+    open = false;
+    cue_end = 0;
+    ResetWindow(0);
+    head = nullptr;
+    head_frames = 0;
+    if (file) file.close();
+  }
+
+  bool IsOpen() const {
+    return open;
+  }
+  uint16_t Channels() const {
+    return info.channels;
+  }
+  uint32_t SampleRate() const {
+    return info.sample_rate;
+  }
+  uint32_t Frames() const {
+    return info.frames;
+  }
+
+  // Loads the frames from frame on into the cue cache. Blocks on the card;
+  // mainloop only.
+  void SetCue(uint32_t frame) {
+    if (!open) return;
+    if (frame > info.frames) frame = info.frames;
+    cue_end = 0; // the interrupt stops using the cache
+    cue = frame;
+    uint32_t n = info.frames - frame;
+    if (frame == 0 && head) {
+      cue_src = head;
+      n = head_frames < n ? head_frames : n;
+    } else {
+      cue_src = cue_cache;
+      if (n > cue_frames) n = cue_frames;
+      n = ReadFrames(frame, n, cue_cache);
+    }
+    cue_end = cue + n;
+  }
+
+  uint32_t Cue() const {
+    return cue;
+  }
+
+  // Tops up the ring ahead of play_frame; mainloop only
+  void Prefetch(uint32_t play_frame, bool forward) {
+    if (!open) return;
+    if (forward) PrefetchForward(play_frame);
+    else PrefetchBackward(play_frame);
+  }
+
+  // Copies frame into out, one sample per channel; false, leaving out alone,
+  // if it isn't resident
+  bool Read(uint32_t frame, int16_t* out) {
+    const int16_t* src;
+    const uint16_t channels = info.channels;
+    if (frame >= cue && frame < cue_end) {
+      src = cue_src + (frame - cue) * channels;
+    } else if (frame >= lo && frame < hi) {
+      src = ring + (frame % ring_frames) * channels;
+    } else {
+      return false;
+    }
+    out[0] = src[0];
+    if (channels > 1) out[1] = src[1];
+    return true;
+  }
+
+  // Frames read from the card since Open(), for the curious
+  uint32_t CardFrames() const {
+    return card_frames;
+  }
+
+  // Frames the ring holds; RING_FRAMES, or INTERNAL_RING_FRAMES without PSRAM
+  uint32_t RingFrames() const {
+    return ring_frames;
+  }
+
+private:
+  File file;
+  WavInfo info;
+  bool open = false;
+  uint32_t card_frames = 0;
+
+  int16_t* ring = nullptr;
+  uint32_t ring_frames = RING_FRAMES;
+  volatile uint32_t lo = 0;
+  volatile uint32_t hi = 0;
+
+  int16_t* cue_cache = nullptr;
+  uint32_t cue_frames = CUE_FRAMES;
+  // Frames from the cue point; cue_cache, or head when the cue is at 0
+  const int16_t* volatile cue_src = nullptr;
+  const int16_t* head = nullptr;
+  uint32_t head_frames = 0;
+  volatile uint32_t cue = 0;
+  volatile uint32_t cue_end = 0;
+
+  // Sized for stereo, so any file fits. Without PSRAM extmem_malloc falls
+  // back to the internal heap, and these are never freed, so take less.
+  bool Allocate() {
+    if (!ring && !cue_cache) {
+      ring_frames = external_psram_size ? RING_FRAMES : INTERNAL_RING_FRAMES;
+      cue_frames = external_psram_size ? CUE_FRAMES : INTERNAL_CUE_FRAMES;
+    }
+    if (!ring) ring = static_cast<int16_t*>(
+      extmem_malloc(ring_frames * 2 * sizeof(int16_t))
+    );
+    if (!cue_cache) cue_cache = static_cast<int16_t*>(
+      extmem_malloc(cue_frames * 2 * sizeof(int16_t))
+    );
+    return ring && cue_cache;
+  }
+
+  // Empty at frame, via states that are all empty
+  void ResetWindow(uint32_t frame) {
+    lo = UINT32_MAX;
+    hi = frame;
+    lo = frame;
+  }
+
+  void PrefetchForward(uint32_t p) {
+    // The cue cache covers the start; fill from where it ends
+    if (p >= cue && p < cue_end) p = cue_end;
+    if (p < lo || p > hi) ResetWindow(p);
+    uint32_t target = p + ring_frames - BEHIND_FRAMES;
+    if (target > info.frames) target = info.frames;
+    for (int i = 0; i < CHUNKS_PER_PREFETCH && hi < target; i++) {
+      uint32_t n = CHUNK_FRAMES - hi % CHUNK_FRAMES;
+      if (n > target - hi) n = target - hi;
+      // Give up the slots the new frames go in, then claim them
+      if (hi + n > lo + ring_frames) lo = hi + n - ring_frames;
+      n = ReadFrames(hi, n, ring + (hi % ring_frames) * info.channels);
+      if (!n) return;
+      hi = hi + n;
+    }
+  }
+
+  void PrefetchBackward(uint32_t p) {
+    // Interpolation reads the frame after the head, too
+    p = p + 2 > info.frames ? info.frames : p + 2;
+    if (p < lo || p > hi) ResetWindow(p);
+    uint32_t target = p > ring_frames - BEHIND_FRAMES
+      ? p - (ring_frames - BEHIND_FRAMES)
+      : 0;
+    for (int i = 0; i < CHUNKS_PER_PREFETCH && lo > target; i++) {
+      uint32_t n = lo % CHUNK_FRAMES ? lo % CHUNK_FRAMES : CHUNK_FRAMES;
+      if (n > lo - target) n = lo - target;
+      const uint32_t from = lo - n;
+      if (hi > from + ring_frames) hi = from + ring_frames;
+      if (ReadFrames(from, n, ring + (from % ring_frames) * info.channels) != n) {
+        return;
+      }
+      lo = from;
+    }
+  }
+
+  // Ring reads stay within a chunk, and chunks tile the ring, so never wrap
+  uint32_t ReadFrames(uint32_t frame, uint32_t n, int16_t* dest) {
+    n = info.ReadFrames(file, frame, n, dest);
+    card_frames += n;
+    return n;
+  }
+};
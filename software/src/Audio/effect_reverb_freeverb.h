@@ -0,0 +1,30 @@
+#pragma once
+#include "CombReverb.h"
+
+// ---- Freeverb (wet only) ----
+// Jezar's Freeverb as the Teensy Audio library has it, on the shared
+// fixed-point network in CombReverb.h. Stereo takes the classic 23-sample
+// spread for the right channel.
+
+template <int Channels = 1>
+class AudioEffectReverbFreeverb
+  : public AudioEffectCombReverb<Channels, FREEVERB_TUNING.LineSamples(Channels)> {
+public:
+  AudioEffectReverbFreeverb()
+    : AudioEffectCombReverb<Channels, FREEVERB_TUNING.LineSamples(Channels)>(
+        FREEVERB_TUNING
+      ) {
+    roomsize(0.5f);
+    damping(0.5f);
+  }
+
+  // 0..1
+  void roomsize(float n) {
+    this->combFeedback(0.7f + 0.28f * constrain(n, 0.0f, 1.0f));
+  }
+
+  // 0..1
+  void damping(float n) {
+    this->combDamping(0.4f * constrain(n, 0.0f, 1.0f));
+  }
+};
@@ -0,0 +1,109 @@
+#pragma once
+// Block kernels on q15 samples with Q16.16 gains and a 32-bit accumulator,
+// for streams that only scale, modulate and sum. Gains are quantized to
+// 1/65536 and products round down, so results are within 1 LSB per term of
+// the float path. Saturation happens once at the end, as with float, so
+// correlated material summing past full scale still clips cleanly instead of
+// wrapping.
+//
+// On the Cortex-M7 the multiplies are SMULWB/SMLAWB/SMLAWT on two samples per
+// load; elsewhere they are plain C with the same rounding (floor). AudioVCA
+// and AudioMixer only use the block kernels there: on the host, float
+// vectorises and is the faster of the two.
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace q15 {
+
+static const int32_t UNITY = 1 << 16;
+// Keeps bias + level * cv, or a sum of gains, within an int32
+static const int32_t GAIN_LIMIT = (1 << 30) - 1;
+
+inline int32_t GainToQ16(float gain, int32_t limit = GAIN_LIMIT) {
+  float q = roundf(gain * UNITY);
+  if (q > limit) return limit;
+  if (q < -limit) return -limit;
+  return static_cast<int32_t>(q);
+}
+
+// (a * b) >> 16
+inline int32_t mul(int32_t a, int16_t b) {
+#if defined(__ARM_ARCH_7EM__)
+  int32_t out;
+  asm("smulwb %0, %1, %2" : "=r"(out) : "r"(a), "r"(b));
+  return out;
+#else
+  return static_cast<int32_t>((static_cast<int64_t>(a) * b) >> 16);
+#endif
+}
+
+inline int16_t saturate(int32_t x) {
+#if defined(__ARM_ARCH_7EM__)
+  int32_t out;
+  asm("ssat %0, #16, %1" : "=r"(out) : "r"(x));
+  return static_cast<int16_t>(out);
+#else
+  return static_cast<int16_t>(x > 32767 ? 32767 : (x < -32768 ? -32768 : x));
+#endif
+}
+
+// acc = in * gain, or acc += in * gain. n must be even.
+inline void MixInto(
+  int32_t* acc, const int16_t* in, int32_t gain, bool first, size_t n
+) {
+  if (gain == UNITY) {
+    if (first) {
+      for (size_t i = 0; i < n; i++) acc[i] = in[i];
+    } else {
+      for (size_t i = 0; i < n; i++) acc[i] += in[i];
+    }
+    return;
+  }
+#if defined(__ARM_ARCH_7EM__)
+  const uint32_t* pairs = reinterpret_cast<const uint32_t*>(in);
+  for (size_t i = 0; i < n; i += 2) {
+    uint32_t pair = *pairs++;
+    int32_t lo = first ? 0 : acc[i];
+    int32_t hi = first ? 0 : acc[i + 1];
+    asm("smlawb %0, %1, %2, %0" : "+r"(lo) : "r"(gain), "r"(pair));
+    asm("smlawt %0, %1, %2, %0" : "+r"(hi) : "r"(gain), "r"(pair));
+    acc[i] = lo;
+    acc[i + 1] = hi;
+  }
+#else
+  for (size_t i = 0; i < n; i++) {
+    acc[i] = (first ? 0 : acc[i]) + mul(gain, in[i]);
+  }
+#endif
+}
+
+inline void Saturate(const int32_t* acc, int16_t* out, size_t n) {
+  for (size_t i = 0; i < n; i++) out[i] = saturate(acc[i]);
+}
+
+// out = in * gain
+inline void Scale(const int16_t* in, int32_t gain, int16_t* out, size_t n) {
+  for (size_t i = 0; i < n; i++) out[i] = saturate(mul(gain, in[i]));
+}
+
+// out = in * (bias + level * cv), with the modulation clipped at 0 if rectify
+inline void Modulate(
+  const int16_t* in,
+  const int16_t* cv,
+  int32_t bias,
+  int32_t level,
+  bool rectify,
+  int16_t* out,
+  size_t n
+) {
+  for (size_t i = 0; i < n; i++) {
+    // cv is q15, so level * cv is (level * cv) >> 15
+    int32_t mod = bias + 2 * mul(level, cv[i]);
+    if (rectify && mod < 0) mod = 0;
+    out[i] = saturate(mul(mod, in[i]));
+  }
+}
+
+} // namespace q15
@@ -54,6 +54,14 @@ public:
           stereo_processor_pool[slot]
         );
     }
+    SetFootprints(mono_source_pool[0]);
+    SetFootprints(mono_source_pool[1]);
+    SetFootprints(stereo_source_pool);
+    for (size_t slot = 0; slot < Slots - 1; slot++) {
+      SetFootprints(mono_processor_pool[0][slot]);
+      SetFootprints(mono_processor_pool[1][slot]);
+      SetFootprints(stereo_processor_pool[slot]);
+    }
     selected_mono_applets[0].fill(0);
     selected_mono_applets[1].fill(0);
     selected_stereo_applets.fill(0);
@@ -63,14 +71,11 @@ public:
     for (size_t slot = 0; slot < Slots; slot++) {
       if (IsStereo(slot)) {
         get_selected_stereo_applet(slot).BaseStart(LEFT_HEMISPHERE);
-        ForEachSide(side) ConnectStereoToNext(side, slot);
       } else {
-        ForEachSide(side) {
-          get_selected_mono_applet(side, slot).BaseStart(side);
-          ConnectMonoToNext(side, slot);
-        }
+        ForEachSide(side) get_selected_mono_applet(side, slot).BaseStart(side);
       }
     }
+    RouteChain();
     peak_conns[0][0].connect(OC::AudioIO::InputStream(), 0, peaks[0][0], 0);
     peak_conns[1][0].connect(OC::AudioIO::InputStream(), 1, peaks[1][0], 0);
   }
@@ -100,6 +105,31 @@ public:
         get_selected_mono_applet(RIGHT_HEMISPHERE, slot).mainloop();
       }
     }
+
+    ForEachSide(side) {
+      if (BypassMask(side) != bypass_mask[side]) {
+        RouteChain();
+        break;
+      }
+    }
+
+    // Recall that unsigned substraction rolls over correclty, so when millis()
+    // rolls over, this will still work.
+    if (millis() - last_stats_update > 250) {
+      last_stats_update = millis();
+      UpdateStats();
+      GovernQuality();
+    }
+  }
+
+  // Audio interrupt load, in percent, above which applets are asked to step
+  // down to cheaper modes; 0 leaves them alone
+  void SetCpuCeiling(int percent) {
+    cpu_ceiling = constrain(percent, 0, 100);
+  }
+
+  int CpuCeiling() const {
+    return cpu_ceiling;
   }
 
   void View() {
@@ -119,31 +149,22 @@ public:
             ? 32
             : 64 * side;
           gfxInvert(x, y, 64, 9);
-        } else {
+        } else if (cursor[side] != CEILING_ROW) {
           gfxIcon(120 * side, y + 1, side ? LEFT_ICON : RIGHT_ICON);
         }
         for (uint_fast8_t slot = 0; slot < Slots + 1; slot++) {
           draw_peak(side, slot);
         }
+        for (uint_fast8_t slot = 0; slot < Slots; slot++) {
+          draw_cpu(side, slot);
+        }
 
         gfxPos(1 + 64 * side, 2);
         if (side) graphics.printf("MEM%3d%%) R", mem_percent);
+        else if (cursor[side] == CEILING_ROW) draw_ceiling();
         else graphics.printf("L (CPU%3d%%", cpu_percent);
       }
     }
-
-    // Recall that unsigned substraction rolls over correclty, so when millis()
-    // rolls over, this will still work.
-    if (millis() - last_stats_update > 250) {
-      last_stats_update = millis();
-      mem_percent = static_cast<int16_t>(
-        100 * static_cast<float>(AudioMemoryUsageMax())
-        / OC::AudioIO::AUDIO_MEMORY
-      );
-      cpu_percent = static_cast<int16_t>(AudioProcessorUsageMax());
-      AudioProcessorUsageMaxReset();
-      AudioMemoryUsageMaxReset();
-    }
   }
 
   // returns true to exit
@@ -151,6 +172,10 @@ public:
     if (event.type == UI::EVENT_BUTTON_PRESS) {
       switch (event.control) {
         case OC::CONTROL_BUTTON_A:
+          if (edit_ceiling) {
+            edit_ceiling = false;
+            break;
+          }
           if (MOVE_CURSOR == state[0])
             return true;
           state[0] = MOVE_CURSOR;
@@ -181,18 +206,13 @@ public:
       ForEachSide(side) {
         get_selected_mono_applet(side, c).Disconnect();
         get_selected_mono_applet(side, c).Unload();
-        ConnectStereoToNext(side, c);
-        if (c > 0) ConnectSlotToNext(side, c - 1);
       }
     } else {
       get_selected_stereo_applet(c).Disconnect();
       get_selected_stereo_applet(c).Unload();
-      ForEachSide(side) {
-        get_selected_mono_applet(side, c).BaseStart(side);
-        ConnectMonoToNext(side, c);
-        if (c > 0) ConnectSlotToNext(side, c - 1);
-      }
+      ForEachSide(side) get_selected_mono_applet(side, c).BaseStart(side);
     }
+    RouteChain();
   }
 
   void HandleEncoderButtonEvent(const UI::Event& event) {
@@ -220,6 +240,10 @@ public:
     int c = cursor[side];
     switch (state[side]) {
       case MOVE_CURSOR:
+        if (c == CEILING_ROW) {
+          edit_ceiling = !edit_ceiling;
+          break;
+        }
         candidate[side] = IsStereo(c) ? selected_stereo_applets[c]
                                       : selected_mono_applets[side][c];
         state[side] = SWITCH_APPLET;
@@ -242,11 +266,9 @@ public:
     get_selected_stereo_applet(slot).Unload();
     sel = ix;
     auto& app = get_selected_stereo_applet(slot);
+    app.SetQualityReduction(0);
     app.BaseStart(side);
-    ForEachSide(side) ConnectStereoToNext(side, slot);
-    if (slot > 0) {
-      ForEachSide(side) ConnectSlotToNext(side, slot - 1);
-    }
+    RouteChain();
   }
 
   void ChangeMonoApplet(HEM_SIDE side, size_t slot, int ix) {
@@ -256,9 +278,9 @@ public:
     get_selected_mono_applet(side, slot).Unload();
     sel = ix;
     auto& app = get_selected_mono_applet(side, slot);
+    app.SetQualityReduction(0);
     app.BaseStart(side);
-    ConnectMonoToNext(side, slot);
-    if (slot > 0) ConnectSlotToNext(side, slot - 1);
+    RouteChain();
   }
 
   void ForwardEncoderMove(HEM_SIDE side, size_t slot, int dir) {
@@ -279,7 +301,15 @@ public:
     int& c = cursor[side];
     switch (state[side]) {
       case MOVE_CURSOR:
-        c = constrain(c + dir, 0, static_cast<int>(Slots) - 1);
+        if (edit_ceiling && c == CEILING_ROW) {
+          SetCpuCeiling(cpu_ceiling + dir * CEILING_STEP);
+          break;
+        }
+        c = constrain(
+          c + dir,
+          side == LEFT_HEMISPHERE ? CEILING_ROW : 0,
+          static_cast<int>(Slots) - 1
+        );
         break;
       case SWITCH_APPLET: {
         int n = IsStereo(c) ? (c == 0 ? NumStereoSources : NumStereoProcessors)
@@ -293,48 +323,30 @@ public:
     }
   }
 
-  void ConnectSlotToNext(HEM_SIDE side, size_t slot) {
-    if (IsStereo(slot)) {
-      ConnectStereoToNext(side, slot);
-    } else {
-      ConnectMonoToNext(side, slot);
-    }
-  }
-
-  void ConnectMonoToNext(HEM_SIDE side, size_t slot) {
-    AudioStream* stream = get_selected_mono_applet(side, slot).OutputStream();
-    AudioConnection& conn = conns[side][slot];
-    conn.disconnect();
-    if (slot + 1 < Slots && !IsStereo(slot + 1)) {
-      conn.connect(
-        *stream, 0, *get_selected_mono_applet(side, slot + 1).InputStream(), 0
-      );
-    } else {
-      AudioStream* next_stream = slot + 1 < Slots
-        ? get_selected_stereo_applet(slot + 1).InputStream()
-        : &OC::AudioIO::OutputStream();
-      conn.connect(*stream, 0, *next_stream, side);
-    }
-    peak_conns[side][slot + 1].disconnect();
-    peak_conns[side][slot + 1].connect(*stream, 0, peaks[side][slot + 1], 0);
-  }
-
-  void ConnectStereoToNext(HEM_SIDE side, size_t slot) {
-    AudioStream* stream = get_selected_stereo_applet(slot).OutputStream();
-    AudioConnection& conn = conns[side][slot];
-    conn.disconnect();
-    if (slot + 1 < Slots && !IsStereo(slot + 1)) {
-      AudioStream* next_stream
-        = get_selected_mono_applet(side, slot + 1).InputStream();
-      conn.connect(*stream, side, *next_stream, 0);
-    } else {
-      AudioStream* next_stream = slot + 1 < Slots
-        ? get_selected_stereo_applet(slot + 1).InputStream()
-        : &OC::AudioIO::OutputStream();
-      conn.connect(*stream, side, *next_stream, side);
+  // Connects each slot's input to the output of the last slot before it that
+  // isn't bypassed, so blocks skip passthrough slots entirely. Only the
+  // connections whose ends changed are touched; a bypassed slot's input is
+  // left unconnected, so its streams have nothing to do.
+  void RouteChain() {
+    ForEachSide(side) {
+      bypass_mask[side] = BypassMask(side);
+      Tap from = {nullptr, 0};
+      for (size_t slot = 0; slot < Slots; slot++) {
+        if (!IsBypassed(side, slot)) from = OutputTap(side, slot);
+        const uint8_t ch = static_cast<uint8_t>(side);
+        Tap to = {nullptr, 0};
+        if (slot + 1 == Slots) to = {&OC::AudioIO::OutputStream(), ch};
+        else if (!IsBypassed(side, slot + 1)) to = InputTap(side, slot + 1);
+        Patch(conns[side][slot], routes[side][slot], from, to);
+        // A bypassed slot still meters what it passes on
+        Patch(
+          peak_conns[side][slot + 1],
+          peak_routes[side][slot + 1],
+          from,
+          {&peaks[side][slot + 1], 0}
+        );
+      }
     }
-    peak_conns[side][slot + 1].disconnect();
-    peak_conns[side][slot + 1].connect(*stream, side, peaks[side][slot + 1], 0);
   }
 
   // 3 bits, cannot be 0
@@ -346,7 +358,7 @@ public:
     STEREO_APPLET_PARAMS = 5,
   };
 
-  enum AudioConfigMainKeys : uint8_t { STEREO_MODE_FLAGS };
+  enum AudioConfigMainKeys : uint8_t { STEREO_MODE_FLAGS, CPU_CEILING };
 
   constexpr uint16_t key(uint8_t section, uint8_t key) const {
     return (section << 8) | key;
@@ -360,6 +372,9 @@ public:
     uint64_t oldstereo = stereo;
     PhzConfig::getValue(preset_key | key(MAIN, STEREO_MODE_FLAGS), data);
     stereo = data & 0xFFFFFFFF;
+    data = DEFAULT_CPU_CEILING;
+    PhzConfig::getValue(preset_key | key(MAIN, CPU_CEILING), data);
+    SetCpuCeiling(static_cast<int>(data));
 
     for (size_t slot = 0; slot < Slots; ++slot) {
 
@@ -417,6 +432,7 @@ public:
     uint16_t preset_key = id << 11;
 
     PhzConfig::setValue(preset_key | key(MAIN, STEREO_MODE_FLAGS), (uint64_t)stereo); // bitset
+    PhzConfig::setValue(preset_key | key(MAIN, CPU_CEILING), (uint64_t)cpu_ceiling);
     uint64_t applet_id = 0;
     for (size_t slot = 0; slot < Slots; ++slot) {
       auto& stereo_applet = get_selected_stereo_applet(slot);
@@ -474,6 +490,21 @@ protected:
     return (stereo >> slot) & 1;
   }
 
+  // The source slot always stays in the chain
+  bool IsBypassed(HEM_SIDE side, size_t slot) {
+    if (slot == 0) return false;
+    return IsStereo(slot) ? get_selected_stereo_applet(slot).Bypassed()
+                          : get_selected_mono_applet(side, slot).Bypassed();
+  }
+
+  uint32_t BypassMask(HEM_SIDE side) {
+    uint32_t mask = 0;
+    for (size_t slot = 1; slot < Slots; slot++) {
+      if (IsBypassed(side, slot)) mask |= 1 << slot;
+    }
+    return mask;
+  }
+
 private:
   static const size_t APPLET_CONFIG_SIZE = HemisphereAudioApplet::CONFIG_SIZE;
   array<array<HemisphereAudioApplet*, NumMonoSources>, 2> mono_input_applets;
@@ -487,9 +518,27 @@ private:
   array<array<int, Slots>, 2> selected_mono_applets;
   array<int, Slots> selected_stereo_applets;
 
+  // One end of an AudioConnection
+  struct Tap {
+    AudioStream* stream;
+    uint8_t channel;
+
+    bool operator==(const Tap& o) const {
+      return stream == o.stream && channel == o.channel;
+    }
+  };
+  struct Route {
+    Tap from;
+    Tap to;
+  };
+
   array<array<AudioConnection, Slots + 1>, 2> conns;
   array<array<AudioAnalyzePeak, Slots + 1>, 2> peaks;
   array<array<AudioConnection, Slots + 1>, 2> peak_conns;
+  // What conns and peak_conns are currently connected to
+  array<array<Route, Slots + 1>, 2> routes = {};
+  array<array<Route, Slots + 1>, 2> peak_routes = {};
+  uint32_t bypass_mask[2] = {0, 0};
   array<array<float, Slots + 1>, 2> lpf_peak_db;
 
   bool ready_for_press = false;
@@ -500,6 +549,21 @@ private:
   int16_t mem_percent = 0;
   int16_t cpu_percent = 0;
   uint32_t last_stats_update = 0;
+  // Per slot and side, the selected applet's share of cpu_percent
+  array<array<float, Slots>, 2> slot_cpu = {};
+
+  static const int DEFAULT_CPU_CEILING = 90;
+  // Quality comes back once the load has stayed this far under the ceiling
+  // for RESTORE_PERIODS stats updates in a row
+  static const int CPU_HEADROOM = 15;
+  static const int RESTORE_PERIODS = 8;
+  int cpu_ceiling = DEFAULT_CPU_CEILING;
+  int calm_periods = 0;
+  // Above the first slot, the left cursor reaches the CPU readout, which
+  // then shows the ceiling; the encoder button toggles editing it
+  static const int CEILING_ROW = -1;
+  static const int CEILING_STEP = 5;
+  bool edit_ceiling = false;
 
   enum EditState {
     MOVE_CURSOR,
@@ -541,6 +605,11 @@ private:
     return get_selected_mono_applet(side, slot);
   }
 
+  template <class... Cs>
+  static void SetFootprints(tuple<Cs...>& pool) {
+    std::apply([](Cs&... applets) { (applets.SetFootprint(sizeof(Cs)), ...); }, pool);
+  }
+
   template <size_t N>
   int get_applet_ix_by_id(
     array<HemisphereAudioApplet*, N> applets,
@@ -616,6 +685,108 @@ private:
     }
   }
 
+  Tap InputTap(HEM_SIDE side, size_t slot) {
+    if (IsStereo(slot)) {
+      return {
+        get_selected_stereo_applet(slot).InputStream(),
+        static_cast<uint8_t>(side)
+      };
+    }
+    return {get_selected_mono_applet(side, slot).InputStream(), 0};
+  }
+
+  Tap OutputTap(HEM_SIDE side, size_t slot) {
+    if (IsStereo(slot)) {
+      return {
+        get_selected_stereo_applet(slot).OutputStream(),
+        static_cast<uint8_t>(side)
+      };
+    }
+    return {get_selected_mono_applet(side, slot).OutputStream(), 0};
+  }
+
+  // Reconnects conn only if either end moved, so untouched slots keep the
+  // block already queued on them
+  void Patch(AudioConnection& conn, Route& route, Tap from, Tap to) {
+    if (!to.stream) from = {nullptr, 0};
+    if (route.from == from && route.to == to) return;
+    conn.disconnect();
+    route = {from, to};
+    if (from.stream && to.stream) {
+      conn.connect(*from.stream, from.channel, *to.stream, to.channel);
+    }
+  }
+
+  // f(applet, its usage at the last stats update)
+  template <typename F>
+  void ForEachSelectedApplet(F f) {
+    for (size_t slot = 0; slot < Slots; slot++) {
+      if (IsStereo(slot)) {
+        f(get_selected_stereo_applet(slot), slot_cpu[0][slot]);
+      } else {
+        ForEachSide(side) {
+          f(get_selected_mono_applet(side, slot), slot_cpu[side][slot]);
+        }
+      }
+    }
+  }
+
+  void UpdateStats() {
+    mem_percent = static_cast<int16_t>(
+      100 * static_cast<float>(AudioMemoryUsageMax())
+      / OC::AudioIO::AUDIO_MEMORY
+    );
+    cpu_percent = static_cast<int16_t>(AudioProcessorUsageMax());
+    AudioProcessorUsageMaxReset();
+    AudioMemoryUsageMaxReset();
+
+    for (size_t slot = 0; slot < Slots; slot++) {
+      if (IsStereo(slot)) {
+        auto& app = get_selected_stereo_applet(slot);
+        slot_cpu[0][slot] = slot_cpu[1][slot] = app.ProcessorUsageMax();
+        app.ProcessorUsageMaxReset();
+      } else {
+        ForEachSide(side) {
+          auto& app = get_selected_mono_applet(side, slot);
+          slot_cpu[side][slot] = app.ProcessorUsageMax();
+          app.ProcessorUsageMaxReset();
+        }
+      }
+    }
+  }
+
+  // Over the ceiling, the hungriest applet that can steps down one level.
+  // Well under it for long enough, the cheapest reduced applet steps back up.
+  void GovernQuality() {
+    if (!cpu_ceiling) return;
+    HemisphereAudioApplet* pick = nullptr;
+    float pick_usage = 0.0f;
+    if (cpu_percent > cpu_ceiling) {
+      calm_periods = 0;
+      ForEachSelectedApplet([&](HemisphereAudioApplet& app, float usage) {
+        if (app.QualityReduction() >= app.MaxQualityReduction()) return;
+        if (!pick || usage > pick_usage) {
+          pick = &app;
+          pick_usage = usage;
+        }
+      });
+      if (pick) pick->SetQualityReduction(pick->QualityReduction() + 1);
+    } else if (cpu_percent < cpu_ceiling - CPU_HEADROOM) {
+      if (++calm_periods < RESTORE_PERIODS) return;
+      calm_periods = 0;
+      ForEachSelectedApplet([&](HemisphereAudioApplet& app, float usage) {
+        if (!app.QualityReduction()) return;
+        if (!pick || usage < pick_usage) {
+          pick = &app;
+          pick_usage = usage;
+        }
+      });
+      if (pick) pick->SetQualityReduction(pick->QualityReduction() - 1);
+    } else {
+      calm_periods = 0;
+    }
+  }
+
   int peak_width(HEM_SIDE side, int slot) {
     AudioAnalyzePeak& p = peaks[side][slot];
     float& db = lpf_peak_db[side][slot];
@@ -630,4 +801,23 @@ private:
     if (y < 0) y = slot * 10 + 13;
     gfxInvert(side ? 64 : 64 - w, y, w, 1);
   }
+  // In place of "L (CPU nn%"
+  void draw_ceiling() {
+    if (cpu_ceiling) graphics.printf("L (max%3d%%", cpu_ceiling);
+    else graphics.print("L (max off");
+    if (edit_ceiling) gfxInvert(37, 1, 27, 9);
+    else gfxLine(37, 10, 63, 10);
+  }
+
+  // 2px per percent from the outer edge, under the peak meter; a stereo
+  // applet's share is split across the two sides
+  void draw_cpu(HEM_SIDE side, int slot) {
+    float usage = slot_cpu[side][slot];
+    if (IsStereo(slot)) usage *= 0.5f;
+    int w = constrain(static_cast<int>(usage * 2.0f), 0, 63);
+    if (!w) return;
+    int y = slot * 10 + 14;
+    if (side) gfxDottedLine(127 - w, y, 127, y);
+    else gfxDottedLine(0, y, w, y);
+  }
 };
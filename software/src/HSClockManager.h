@@ -28,6 +28,8 @@
 
 #include "OC_core.h"
 #include "HSMIDI.h"
+#include "HSMIDIOutput.h"
+#include "util/util_tempo_tracker.h"
 #include <functional>
 #include <vector>
 
@@ -58,9 +60,13 @@ public:
         NR_OF_CLOCKS
     };
 
+    using TempoTracker = util::TempoTracker<32>;
+    static constexpr int FRAC_BITS = TempoTracker::kFracBits;
+
     uint16_t tempo; // The set tempo, for display somewhere else
     uint16_t tempo_setting;
     uint32_t ticks_per_beat; // Based on the selected tempo in BPM
+    uint32_t beat_period; // ticks_per_beat with FRAC_BITS of sub-tick precision
     bool running = 0; // Specifies whether the clock is running for interprocess communication
     bool paused = 0; // Specifies whethr the clock is paused
     bool auto_reset = 0; // on clock start
@@ -69,6 +75,12 @@ public:
     bool tickno = 0;
     bool extsync = false; // locked into an external clock; will stop after timeout
     uint32_t clock_tick[2] = {0,0}; // previous ticks when a physical clock was received on DIGITAL 1
+
+    // External tempo tracking, in ticks with FRAC_BITS of sub-tick precision
+    TempoTracker pulse_tracker; // every pulse on DIGITAL 1
+    TempoTracker midi_tracker; // every MIDI Clock, at 24ppqn
+    uint32_t pulse_time = 0; // filtered time of the latest pulse on DIGITAL 1
+    uint32_t midi_clock_time = 0; // filtered time of the latest MIDI Clock
     uint32_t beat_tick = 0; // The tick to count from
     bool tock[NR_OF_CLOCKS] = {0,0,0,0,0,0,0,0,0}; // The current tock value
     int8_t tocks_per_beat[NR_OF_CLOCKS] = {0,0, 0,0, 0,0, 0,0, MIDI_OUT_PPQN}; // Multiplier
@@ -76,6 +88,14 @@ public:
     int8_t shuffle = 0; // 0 to 100
     int8_t shuffle_setting = 0;
 
+    // Tock schedule, rebuilt only when tempo, multipliers, shuffle or counts change
+    uint32_t next_tock[NR_OF_CLOCKS]; // tick at which each channel is next due
+    uint32_t next_event = 0; // earliest of next_tock[] over enabled channels
+    uint16_t enabled_mask = 0; // channels with a nonzero multiplier
+    uint16_t exceeded_mask = 0; // multipliers already past the end of the beat
+    uint16_t tock_mask = 0; // channels that fired on the last tick
+    bool schedule_dirty = true;
+
     int clock_ppqn = 4; // external clock multiple
     bool cycle = 0; // Alternates for each tock, for display purposes
 
@@ -84,6 +104,8 @@ public:
     std::queue<Task> syncfn_queue;
 
     ClockManager() {
+        pulse_tracker.Init();
+        midi_tracker.Init();
         SetTempoBPM(120);
     }
 
@@ -92,6 +114,7 @@ public:
 
     void SetMultiply(int multiply, int ch = 0) {
         multiply = constrain(multiply, CLOCK_MIN_MULTIPLE, CLOCK_MAX_MULTIPLE);
+        if (tocks_per_beat[ch] != multiply) schedule_dirty = true;
         tocks_per_beat[ch] = multiply;
     }
 
@@ -107,7 +130,9 @@ public:
     void SetTempoBPM(uint16_t bpm) {
         bpm = constrain(bpm, CLOCK_TEMPO_MIN, CLOCK_TEMPO_MAX);
         ticks_per_beat = 1000000 / bpm;
+        beat_period = ticks_per_beat << FRAC_BITS;
         tempo_setting = tempo = bpm;
+        schedule_dirty = true;
     }
     
     void SetTempoFromTaps(uint32_t *taps, int count) {
@@ -119,13 +144,18 @@ public:
         // update the tempo
         uint32_t clock_diff = total / count;
         ticks_per_beat = constrain(clock_diff, CLOCK_TICKS_MIN, CLOCK_TICKS_MAX); // time since last clock is new tempo
+        beat_period = ticks_per_beat << FRAC_BITS;
         tempo_setting = tempo = 1000000 / ticks_per_beat; // imprecise, for display purposes
+        schedule_dirty = true;
     }
 
     int8_t GetMultiply(int ch = 0) {return tocks_per_beat[ch];}
     int GetClockPPQN() { return clock_ppqn; }
 
-    void SetShuffle(int8_t sh_) { shuffle_setting = shuffle = constrain(sh_, 0, 99); }
+    void SetShuffle(int8_t sh_) {
+        shuffle_setting = shuffle = constrain(sh_, 0, 99);
+        schedule_dirty = true;
+    }
     int8_t GetShuffle() { return shuffle_setting; }
 
     /* Gets the current tempo. This can be used between client processes, like two different
@@ -167,6 +197,7 @@ public:
         }
 
         cycle = 1 - cycle;
+        schedule_dirty = true;
     }
 
     // Nudge - Used to align the internal clock with incoming clock pulses
@@ -175,6 +206,55 @@ public:
         if (diff > 0) diff--;
         if (diff < 0) diff++;
         beat_tick += diff;
+        schedule_dirty = true;
+    }
+
+    // Precompute when each channel is next due. Multiplier positions and
+    // shuffle are worked out from beat_period, so the fractional part of a
+    // tick is only dropped once, at the end.
+    void Reschedule() {
+        enabled_mask = exceeded_mask = 0;
+        bool first = true;
+        for (int ch = 0; ch < NR_OF_CLOCKS; ch++) {
+            const int mult = tocks_per_beat[ch];
+            if (mult == 0) continue;
+            enabled_mask |= (1 << ch);
+
+            uint32_t offset;
+            if (mult > 0) {
+                const uint32_t m = static_cast<uint32_t>(mult);
+                uint64_t pos = static_cast<uint64_t>(count[ch]) * beat_period / m;
+                if (shuffle && MIDI_CLOCK != ch && count[ch] % 2 == 1 && count[ch] < mult)
+                    pos += static_cast<uint64_t>(shuffle) * beat_period / (100 * m);
+                offset = static_cast<uint32_t>(pos >> FRAC_BITS);
+                if (count[ch] > mult) exceeded_mask |= (1 << ch);
+            } else {
+                offset = count[ch] ? (beat_period >> FRAC_BITS) : 0;
+            }
+            next_tock[ch] = beat_tick + offset;
+
+            if (first || static_cast<int32_t>(next_tock[ch] - next_event) < 0)
+                next_event = next_tock[ch];
+            first = false;
+        }
+        schedule_dirty = false;
+    }
+
+    // Every incoming MIDI Clock (24ppqn), with its arrival time from ARM_DWT_CYCCNT
+    void SyncMIDIClock(uint32_t cycles) {
+        static constexpr uint32_t CYCLES_PER_TICK = F_CPU / OC_CORE_ISR_FREQ;
+        uint32_t age = ARM_DWT_CYCCNT - cycles;
+        if (age > CYCLES_PER_TICK * 64) age = CYCLES_PER_TICK * 64;
+        const uint32_t time = (OC::CORE::ticks << FRAC_BITS) - (age << FRAC_BITS) / CYCLES_PER_TICK;
+        midi_clock_time = midi_tracker.Pulse(time) ? midi_tracker.phase() : time;
+    }
+
+    // The tracker for whichever external clock we're following
+    const TempoTracker &ActiveTracker() const {
+        return midi_out_enabled ? pulse_tracker : midi_tracker;
+    }
+    bool IsLocked() const {
+        return extsync && ActiveTracker().locked();
     }
 
     // call this on every tick when clock is running, before all Controllers
@@ -186,44 +266,53 @@ public:
         // don't sync to non-MIDI triggers if MIDI sync is active
         if (!midi_sync && !midi_out_enabled) clocked = false;
 
+        if (schedule_dirty) Reschedule();
+
         // Reset only when all multipliers have been met
         bool reset = 1;
         // Process beat sync actions when any multiplier is met
         bool beatsync = 0;
 
-        // count and calculate Tocks
-        for (int ch = 0; ch < NR_OF_CLOCKS; ch++) {
-            if (tocks_per_beat[ch] == 0) { // disabled
-                tock[ch] = 0; continue;
+        if (static_cast<int32_t>(now - next_event) < 0 || !enabled_mask) {
+            // nothing due; divisions can't have reached the beat yet
+            if (tock_mask) {
+                for (int ch = 0; ch < NR_OF_CLOCKS; ch++) tock[ch] = 0;
+                tock_mask = 0;
             }
-
-            if (tocks_per_beat[ch] > 0) { // multiply
-                uint32_t next_tock_tick = beat_tick + count[ch]*ticks_per_beat / static_cast<uint32_t>(tocks_per_beat[ch]);
-                if (shuffle && MIDI_CLOCK != ch && count[ch] % 2 == 1 && count[ch] < tocks_per_beat[ch])
-                    next_tock_tick += shuffle * ticks_per_beat / 100 / static_cast<uint32_t>(tocks_per_beat[ch]);
-
-                tock[ch] = now >= next_tock_tick;
-                if (tock[ch]) ++count[ch]; // increment multiplier counter
-
-                beatsync = beatsync || (count[ch] > tocks_per_beat[ch]); // multiplier has been exceeded
-                reset = reset && (count[ch] > tocks_per_beat[ch]);
-            } else { // division: -1 becomes /2, -2 becomes /3, etc.
-                int div = 1 - tocks_per_beat[ch];
-                uint32_t next_beat = beat_tick + (count[ch] ? ticks_per_beat : 0);
-                bool beat_exceeded = (now >= next_beat);
-                if (beat_exceeded) {
-                    ++count[ch];
-                    tock[ch] = (count[ch] % div) == 1;
+            beatsync = exceeded_mask;
+            reset = (exceeded_mask == enabled_mask);
+        } else {
+            // count and calculate Tocks
+            tock_mask = 0;
+            for (int ch = 0; ch < NR_OF_CLOCKS; ch++) {
+                if (tocks_per_beat[ch] == 0) { // disabled
+                    tock[ch] = 0; continue;
                 }
-                else
-                    tock[ch] = 0;
 
-                // resync on every beat
-                beatsync = beatsync || beat_exceeded;
-                reset = reset && beat_exceeded;
-                if (tock[ch]) count[ch] = 1;
+                const bool due = static_cast<int32_t>(now - next_tock[ch]) >= 0;
+                if (tocks_per_beat[ch] > 0) { // multiply
+                    tock[ch] = due;
+                    if (tock[ch]) ++count[ch]; // increment multiplier counter
+
+                    beatsync = beatsync || (count[ch] > tocks_per_beat[ch]); // multiplier has been exceeded
+                    reset = reset && (count[ch] > tocks_per_beat[ch]);
+                } else { // division: -1 becomes /2, -2 becomes /3, etc.
+                    int div = 1 - tocks_per_beat[ch];
+                    if (due) {
+                        ++count[ch];
+                        tock[ch] = (count[ch] % div) == 1;
+                    }
+                    else
+                        tock[ch] = 0;
+
+                    // resync on every beat
+                    beatsync = beatsync || due;
+                    reset = reset && due;
+                    if (tock[ch]) count[ch] = 1;
+                }
+                if (tock[ch]) tock_mask |= (1 << ch);
             }
-
+            schedule_dirty = true; // counts have moved on
         }
         if (reset) Reset(1); // skip the one we're already on
         if (beatsync && !syncfn_queue.empty())
@@ -238,20 +327,33 @@ public:
             if (ppqn * clock_diff > CLOCK_TICKS_MAX) {
                 clock_tick[0] = 0;
                 clock_tick[1] = 0;
+                if (!midi_sync) pulse_tracker.Init();
             }
+        }
+        // every pulse on DIGITAL 1 feeds the tracker; MIDI arrives via SyncMIDIClock()
+        if (clocked && !midi_sync) {
+            const uint32_t time = now << FRAC_BITS;
+            pulse_time = pulse_tracker.Pulse(time) ? pulse_tracker.phase() : time;
+        }
 
-            // if there are two previous clock ticks, update tempo and sync
-            if (clock_tick[1-tickno] && clock_diff) {
-                uint32_t avg_diff = (clock_diff + (clock_tick[tickno] - clock_tick[1-tickno])) / 2;
+        if (clocked && clock_tick[tickno] && ppqn) {
+            const TempoTracker &tracker = midi_sync ? midi_tracker : pulse_tracker;
+            const int tracker_ppqn = midi_sync ? MIDI_OUT_PPQN : ppqn;
 
+            // if the tracker has a period, update tempo and sync
+            if (clock_tick[1-tickno] && tracker.valid()) {
                 // update the tempo
-                ticks_per_beat = constrain(ppqn * avg_diff, CLOCK_TICKS_MIN, CLOCK_TICKS_MAX);
+                beat_period = constrain(tracker.period() * tracker_ppqn,
+                                        CLOCK_TICKS_MIN << FRAC_BITS, CLOCK_TICKS_MAX << FRAC_BITS);
+                ticks_per_beat = (beat_period + (1 << (FRAC_BITS - 1))) >> FRAC_BITS;
                 tempo_setting = tempo = 1000000 / ticks_per_beat; // imprecise, for display purposes
+                schedule_dirty = true;
 
                 int ticks_per_clock = ticks_per_beat / ppqn; // rounded down
 
-                // time since last beat
-                int tick_offset = now - beat_tick;
+                // time since last beat, to the filtered pulse rather than this tick
+                const uint32_t pulse = midi_sync ? midi_clock_time : pulse_time;
+                int tick_offset = static_cast<int32_t>(pulse - (beat_tick << FRAC_BITS)) >> FRAC_BITS;
 
                 // too long ago? time til next beat
                 if (tick_offset > ticks_per_clock / 2) tick_offset -= ticks_per_beat;
@@ -281,13 +383,7 @@ public:
         paused = p;
         auto_reset = !p;
         if (!p && midi_out_enabled) {
-            usbMIDI.sendRealTime(usbMIDI.Start);
-#if defined(__IMXRT1062__)
-            usbHostMIDI.sendRealTime(usbMIDI.Start);
-#ifdef ARDUINO_TEENSY41
-            MIDI1.sendRealTime(midi::MidiType(usbMIDI.Start));
-#endif
-#endif
+            midi_out.SendRealTime(usbMIDI.Start);
         }
     }
 
@@ -295,14 +391,10 @@ public:
         running = 0;
         paused = 0;
         extsync = false;
+        pulse_tracker.Init();
+        midi_tracker.Init();
         if (midi_out_enabled) {
-            usbMIDI.sendRealTime(usbMIDI.Stop);
-#if defined(__IMXRT1062__)
-            usbHostMIDI.sendRealTime(usbMIDI.Stop);
-#ifdef ARDUINO_TEENSY41
-            MIDI1.sendRealTime(midi::MidiType(usbMIDI.Stop));
-#endif
-#endif
+            midi_out.SendRealTime(usbMIDI.Stop);
         }
         EnableMIDIOut();
     }
@@ -310,9 +402,15 @@ public:
     void Pause() {paused = 1;}
 
     void Modulate(int tempo_diff, int shuffle_diff) {
-      shuffle = constrain(shuffle_setting + shuffle_diff, 0, 99);
-      tempo = constrain(tempo_setting + tempo_diff, CLOCK_TEMPO_MIN, CLOCK_TEMPO_MAX);
+      const int8_t new_shuffle = constrain(shuffle_setting + shuffle_diff, 0, 99);
+      const uint16_t new_tempo = constrain(tempo_setting + tempo_diff, CLOCK_TEMPO_MIN, CLOCK_TEMPO_MAX);
+      if (new_shuffle == shuffle && new_tempo == tempo) return;
+
+      shuffle = new_shuffle;
+      tempo = new_tempo;
       ticks_per_beat = 1000000 / tempo;
+      beat_period = ticks_per_beat << FRAC_BITS;
+      schedule_dirty = true;
     }
 
     bool IsRunning() {return (running && !paused);}
@@ -4,15 +4,19 @@
 #include "HSIOFrame.h"
 
 // arguments are raw data from MIDI system, so channel starts at 1 (not 0)
-void HS::MIDIFrame::ProcessMIDIMsg(const MIDIMessage msg) {
+void HS::MIDIFrame::ProcessMIDIMsg(const MIDIMessage msg, const uint32_t cycles) {
     const uint8_t m_ch = msg.channel - 1;
+    const int late = late_ticks(cycles);
 
     switch (msg.message) { // System Real Time messages
         case usbMIDI.Clock:
             clock_q = (clock_count % (24/MIDI_CLOCK_PPQN) == 0); // for internal sync @ 2ppqn
+            clock_m.SyncMIDIClock(cycles);
             ++clock_count;
-            for(int ch = 0; ch < MIDIMAP_MAX; ++ch) {
-                mapping[ch].ProcessClock(clock_count);
+            for (MIDIMapMask maps = clock_index; maps; maps &= maps - 1) {
+                MIDIMapping &map = mapping[__builtin_ctz(maps)];
+                map.late = late;
+                map.ProcessClock(clock_count, late);
             }
             if (clock_count == 24) clock_count = 0;
             return;
@@ -24,10 +28,12 @@ void HS::MIDIFrame::ProcessMIDIMsg(const MIDIMessage msg) {
             clock_count = 0;
             clock_run = true;
 
-            for(int ch = 0; ch < MIDIMAP_MAX; ++ch) {
-                if (mapping[ch].function == HEM_MIDI_START_OUT) {
-                    mapping[ch].ClockOut();
-                }
+            for (MIDIMapMask maps = start_index; maps; maps &= maps - 1) {
+                MIDIMapping &map = mapping[__builtin_ctz(maps)];
+                // the index is only a hint; the mapping may have changed since
+                if (map.function != HEM_MIDI_START_OUT) continue;
+                map.late = late;
+                map.ClockOut(late);
             }
 
             // UpdateLog(message, data1, data2);
@@ -64,23 +70,25 @@ void HS::MIDIFrame::ProcessMIDIMsg(const MIDIMessage msg) {
             break;
     }
 
-    bool log_skip = false;
-    uint8_t m_ch_prev = 255; // initialize to invalid channel
+    // at least one mapping listens on this channel
+    last_midi_channel = m_ch;
 
-    for(int ch = 0; ch < MIDIMAP_MAX; ++ch) {
-        MIDIMapping &map = mapping[ch];
-        if (map.function == HEM_MIDI_NOOP) continue;
+    // handle sustain pedal latch once for the channel; gate mappings react below
+    if (msg.message == usbMIDI.ControlChange && msg.data1 == 64) {
+        if (msg.data2 > 63) sustain_latch |= (1 << m_ch);
+        else ClearSustainLatch(m_ch);
+    }
 
+    bool logged = false; // prevent duplicate log entries
+    bool remap = false; // a mapping learned something; dispatch index is stale
+
+    for (MIDIMapMask maps = DispatchMask(msg); maps; maps &= maps - 1) {
+        MIDIMapping &map = mapping[__builtin_ctz(maps)];
+        if (map.function == HEM_MIDI_NOOP) continue;
         // skip unwanted MIDI Channels
         if (map.channel != m_ch && map.channel != 16) continue;
-
-        last_midi_channel = m_ch;
-
-        // prevent duplicate log entries
-        if (m_ch == m_ch_prev) log_skip = true;
-        else log_skip = false;
-        m_ch_prev = m_ch;
-
+        map.late = late;
+        const bool log_skip = logged;
         bool log_this = false;
 
         switch (msg.message) {
@@ -92,6 +100,7 @@ void HS::MIDIFrame::ProcessMIDIMsg(const MIDIMessage msg) {
                   map.function = HEM_MIDI_NOTE_OUT;
                   map.function_cc = 0;
                   map.channel = msg.channel - 1;
+                  remap = true;
                 }
                 if (!map.InRange(msg.data1)) break;
                 map.semitone_mask = map.semitone_mask | (1u << (msg.data1 % 12));
@@ -126,17 +135,15 @@ void HS::MIDIFrame::ProcessMIDIMsg(const MIDIMessage msg) {
                         if (note_buffer[m_ch].size() != 1) break;
                     case HEM_MIDI_TRIG_OUT:
                     case HEM_MIDI_TRIG_ALWAYS_OUT:
-                        map.ClockOut();
+                        map.ClockOut(late);
                         break;
 
                     case HEM_MIDI_GATE_OUT:
-                        map.output = PULSE_VOLTAGE * (12 << 7);
-                        break;
                     case HEM_MIDI_GATE_INV_OUT:
-                        map.output = 0;
+                        map.GateOn(late);
                         break;
                     case HEM_MIDI_GATE_POLY_OUT:
-                        if (CheckPolyVoice(map.dac_polyvoice)) map.output = PULSE_VOLTAGE * (12 << 7);
+                        if (CheckPolyVoice(map.dac_polyvoice)) map.GateOn(late);
                         break;
 
                     case HEM_MIDI_VEL_OUT:
@@ -185,15 +192,15 @@ void HS::MIDIFrame::ProcessMIDIMsg(const MIDIMessage msg) {
                     }
                 }
 
-                if (map.function == HEM_MIDI_TRIG_ALWAYS_OUT) map.ClockOut();
+                if (map.function == HEM_MIDI_TRIG_ALWAYS_OUT) map.ClockOut(late);
 
                 if (!CheckSustainLatch(m_ch)) {
                     if (!(note_buffer[m_ch].size() > 0)) { // turn mono gate off, only when all notes are off
-                        if (map.function == HEM_MIDI_GATE_OUT) map.output = 0;
-                        if (map.function == HEM_MIDI_GATE_INV_OUT) map.output = PULSE_VOLTAGE * (12 << 7);
+                        if (map.function == HEM_MIDI_GATE_OUT || map.function == HEM_MIDI_GATE_INV_OUT)
+                            map.GateOff(late);
                     }
                     if (map.function == HEM_MIDI_GATE_POLY_OUT) {
-                        if (!CheckPolyVoice(map.dac_polyvoice)) map.output = 0;
+                        if (!CheckPolyVoice(map.dac_polyvoice)) map.GateOff(late);
                     }
                 }
 
@@ -206,20 +213,15 @@ void HS::MIDIFrame::ProcessMIDIMsg(const MIDIMessage msg) {
                 break;
             }
             case usbMIDI.ControlChange: { // Modulation wheel or other CC
-                // handle sustain pedal
+                // sustain pedal released
                 if (msg.data1 == 64) {
-                    if (msg.data2 > 63) {
-                        if (!CheckSustainLatch(m_ch)) sustain_latch |= (1 << m_ch);
-                    } else {
-                        ClearSustainLatch(m_ch);
+                    if (msg.data2 <= 63) {
                         if (!(note_buffer[m_ch].size() > 0)) {
                             switch (map.function) {
                                 case HEM_MIDI_GATE_OUT:
                                 case HEM_MIDI_GATE_POLY_OUT:
-                                    map.output = 0;
-                                    break;
                                 case HEM_MIDI_GATE_INV_OUT:
-                                    map.output = PULSE_VOLTAGE * (12 << 7);
+                                    map.GateOff(late);
                                     break;
                             }
                         }
@@ -230,11 +232,13 @@ void HS::MIDIFrame::ProcessMIDIMsg(const MIDIMessage msg) {
                   map.function = HEM_MIDI_CC_OUT;
                   map.function_cc = msg.data1;
                   map.channel = msg.channel - 1;
+                  remap = true;
                 }
 
                 if (map.function == HEM_MIDI_CC_OUT) {
                     if (map.function_cc < 0) { // auto-learn CC#
                       map.function_cc = msg.data1;
+                      remap = true;
                     }
                     if (map.function_cc == msg.data1) {
                         map.output = Proportion(msg.data2, 127, HEMISPHERE_MAX_CV);
@@ -262,6 +266,7 @@ void HS::MIDIFrame::ProcessMIDIMsg(const MIDIMessage msg) {
                 if (map.function == HEM_MIDI_LEARN) {
                   map.function = HEM_MIDI_PB_OUT;
                   map.channel = msg.channel - 1;
+                  remap = true;
                 }
                 if (map.function == HEM_MIDI_PB_OUT) {
                     int data = (msg.data2 << 7) + msg.data1 - 8192;
@@ -271,8 +276,13 @@ void HS::MIDIFrame::ProcessMIDIMsg(const MIDIMessage msg) {
                 break;
             }
         }
-        if (log_this) UpdateLog(msg);
+        if (log_this) {
+            UpdateLog(msg);
+            logged = true;
+        }
     }
+
+    if (remap) UpdateMidiChannelFilter();
 }
 
 void HS::MIDIFrame::Send(const int *outvals) {
@@ -12,6 +12,7 @@
 #include <vector>
 #include "OC_config.h"
 #include "HSMIDI.h"
+#include "HSMIDIOutput.h"
 #include "HSUtils.h"
 #include "OC_DAC.h"
 #include "OC_ADC.h"
@@ -24,22 +25,15 @@ namespace HS {
 static constexpr int GATE_THRESHOLD = 15 << 7; // 1.25 volts
 #if defined(__IMXRT1062__)
 static constexpr int MIDIMAP_MAX = 32;
+using MIDIMapMask = uint32_t; // one bit per MIDIMapping
 #else
 static constexpr int MIDIMAP_MAX = 8;
+using MIDIMapMask = uint8_t; // one bit per MIDIMapping
 #endif
+static_assert(MIDIMAP_MAX <= sizeof(MIDIMapMask) * 8, "MIDIMapMask too narrow for MIDIMAP_MAX");
 static constexpr int TRIGMAP_MAX = OC::DIGITAL_INPUT_LAST + ADC_CHANNEL_COUNT + DAC_CHANNEL_COUNT + MIDIMAP_MAX;
 static constexpr int CVMAP_MAX = ADC_CHANNEL_COUNT + DAC_CHANNEL_COUNT + MIDIMAP_MAX;
 
-struct MIDIMessage {
-  // values expected from MIDI library, so channel starts at 1 (one), not zero
-  uint8_t channel, message, data1, data2;
-
-  const uint8_t chan() const { return channel - 1; }
-  const uint8_t note() const { return data1; }
-  const uint8_t vel() const { return data2; }
-  const bool IsNote() const { return message == HEM_MIDI_NOTE_ON; }
-};
-
 using MIDILogEntry = MIDIMessage;
 /*
 struct MIDILogEntry {
@@ -75,6 +69,9 @@ struct MIDIMapping : public MIDIMapSettings {
   int16_t trigout_countdown;
   uint16_t semitone_mask; // which notes are currently on
   int16_t output; // translated CV values
+  uint8_t late; // ticks the last message to reach this mapping waited in the input queue
+  uint8_t gate_late; // ... and the message that last opened its gate
+  int16_t gate_countdown; // ticks until a held-over gate closes
 
   const bool IsClock() const {
     return (function >= HEM_MIDI_CLOCK_OUT);
@@ -93,13 +90,34 @@ struct MIDIMapping : public MIDIMapSettings {
     if (function == HEM_MIDI_CLOCK_16_OUT) mod = 3;
     return mod;
   }
-  void ClockOut() {
-    trigout_countdown = HEMISPHERE_CLOCK_TICKS * HS::trig_length;
+  // late_ticks: how long the triggering message waited in the input queue,
+  // so the falling edge stays where it would have been
+  void ClockOut(int late_ticks = 0) {
+    trigout_countdown = max(1, HEMISPHERE_CLOCK_TICKS * HS::trig_length - late_ticks);
     output = HEMISPHERE_MAX_CV;
   }
-  void ProcessClock(int count) {
+  void ProcessClock(int count, int late_ticks = 0) {
     if ( IsClock() && ((count-1) % clock_mod() == 0) )
-      ClockOut();
+      ClockOut(late_ticks);
+  }
+  // Gates remember how late their opening message was. If the closing one
+  // waited less, the gate stays open for the difference, so a note keeps its
+  // length even when on and off are drained in the same tick.
+  int16_t GateOffValue() const {
+    return (function == HEM_MIDI_GATE_INV_OUT) ? PULSE_VOLTAGE * (12 << 7) : 0;
+  }
+  void GateOn(int late_ticks) {
+    output = (function == HEM_MIDI_GATE_INV_OUT) ? 0 : PULSE_VOLTAGE * (12 << 7);
+    gate_late = late_ticks;
+    gate_countdown = 0;
+  }
+  void GateOff(int late_ticks) {
+    const int hold = gate_late - late_ticks;
+    if (hold > 0) gate_countdown = hold;
+    else {
+      output = GateOffValue();
+      gate_countdown = 0;
+    }
   }
   const bool InRange(uint8_t note) const {
     return (note >= range_low && note <= range_high);
@@ -154,6 +172,22 @@ struct MIDIFrame {
     uint16_t midi_channel_filter = 0; // each bit state represents a channel. 1 means enabled. all 0's means Omni (no channel filter)
     bool any_channel_omni = false;
 
+    // Dispatch index, rebuilt by UpdateMidiChannelFilter() whenever mappings change.
+    // Each mask holds one bit per mapping[] entry that cares about a given message,
+    // so ProcessMIDIMsg only visits those instead of scanning all MIDIMAP_MAX.
+    enum MIDIDispatchType : uint8_t {
+      DISPATCH_NOTE, // every active mapping tracks semitone_mask
+      DISPATCH_CC,
+      DISPATCH_AT_POLY,
+      DISPATCH_AT_CHAN,
+      DISPATCH_PB,
+      DISPATCH_TYPE_COUNT
+    };
+    MIDIMapMask dispatch_index[DISPATCH_TYPE_COUNT][16];
+    MIDIMapMask cc_index[128]; // by CC#, intersected with dispatch_index[DISPATCH_CC]
+    MIDIMapMask clock_index; // clock outputs, for 24ppqn ticks
+    MIDIMapMask start_index; // start triggers
+
     // Clock/Start/Stop are handled by ClockSetup applet
     bool clock_run = 0;
     bool clock_q;
@@ -162,12 +196,21 @@ struct MIDIFrame {
     uint8_t clock_count; // MIDI clock counter (24ppqn)
     uint32_t last_msg_tick; // Tick of last received message
 
+    static constexpr uint32_t CYCLES_PER_TICK = F_CPU / OC_CORE_ISR_FREQ;
+
+    // Whole ticks between a message's arrival (ARM_DWT_CYCCNT) and now, up to 255
+    static int late_ticks(const uint32_t cycles) {
+      return min((ARM_DWT_CYCCNT - cycles) / CYCLES_PER_TICK, uint32_t(255));
+    }
+
     void Init() {
       // TODO: populate with some sensible defaults
       for (int ch = 0; ch < MIDIMAP_MAX; ++ch) {
         mapping[ch].function = HEM_MIDI_NOOP;
         mapping[ch].transpose = 0;
         mapping[ch].output = 0;
+        mapping[ch].late = mapping[ch].gate_late = 0;
+        mapping[ch].gate_countdown = 0;
         mapping[ch].dac_polyvoice = ch / 2 % DAC_CHANNEL_COUNT; // each quad is a unique voice
         mapping[ch].range_low = 0;
         mapping[ch].range_high = 127;
@@ -180,6 +223,7 @@ struct MIDIFrame {
         outmap[ch].range_high = 127;
       }
       clock_count = 0;
+      UpdateMidiChannelFilter();
     }
 
     // getters for access to mappings
@@ -209,6 +253,7 @@ struct MIDIFrame {
       return (note >= outmap[ch].range_low && note <= outmap[ch].range_high);
     }
 
+    // Call whenever a mapping's function, channel or CC# changes
     void UpdateMidiChannelFilter() {
         uint16_t filter = 0;
         bool omni = false;
@@ -219,6 +264,68 @@ struct MIDIFrame {
         }
         midi_channel_filter = filter;
         any_channel_omni = omni;
+
+        UpdateDispatchIndex();
+    }
+
+    void UpdateDispatchIndex() {
+        memset(dispatch_index, 0, sizeof(dispatch_index));
+        memset(cc_index, 0, sizeof(cc_index));
+        clock_index = 0;
+        start_index = 0;
+
+        for (int i = 0; i < MIDIMAP_MAX; ++i) {
+            const MIDIMapping &map = mapping[i];
+            if (map.function == HEM_MIDI_NOOP) continue;
+            const MIDIMapMask bit = MIDIMapMask(1) << i;
+
+            if (map.IsClock()) clock_index |= bit;
+            if (map.function == HEM_MIDI_START_OUT) start_index |= bit;
+
+            const bool learn = (map.function == HEM_MIDI_LEARN);
+            const bool gate = (map.function == HEM_MIDI_GATE_OUT
+                            || map.function == HEM_MIDI_GATE_POLY_OUT
+                            || map.function == HEM_MIDI_GATE_INV_OUT);
+            const bool cc = (map.function == HEM_MIDI_CC_OUT);
+
+            // CC dispatch is two-level: channel first, then CC#
+            if (learn || (cc && map.function_cc < 0)) {
+                for (auto &m : cc_index) m |= bit;
+            } else if (cc) {
+                cc_index[map.function_cc & 0x7F] |= bit;
+            }
+            if (gate) cc_index[64] |= bit; // sustain pedal release
+
+            for (int m_ch = 0; m_ch < 16; ++m_ch) {
+                if (map.channel != m_ch && map.channel != 16) continue;
+
+                dispatch_index[DISPATCH_NOTE][m_ch] |= bit;
+                if (learn || cc || gate) dispatch_index[DISPATCH_CC][m_ch] |= bit;
+                if (map.function == HEM_MIDI_AT_KEY_POLY_OUT) dispatch_index[DISPATCH_AT_POLY][m_ch] |= bit;
+                if (map.function == HEM_MIDI_AT_CHAN_OUT) dispatch_index[DISPATCH_AT_CHAN][m_ch] |= bit;
+                if (learn || map.function == HEM_MIDI_PB_OUT) dispatch_index[DISPATCH_PB][m_ch] |= bit;
+            }
+        }
+    }
+
+    // Which mappings need to see this Channel Voice message
+    MIDIMapMask DispatchMask(const MIDIMessage &msg) const {
+        const uint8_t m_ch = msg.chan() & 0x0F;
+        switch (msg.message) {
+            case HEM_MIDI_NOTE_ON:
+            case HEM_MIDI_NOTE_OFF:
+                return dispatch_index[DISPATCH_NOTE][m_ch];
+            case HEM_MIDI_CC:
+                return dispatch_index[DISPATCH_CC][m_ch] & cc_index[msg.data1 & 0x7F];
+            case HEM_MIDI_AFTERTOUCH_POLY:
+                return dispatch_index[DISPATCH_AT_POLY][m_ch];
+            case HEM_MIDI_AFTERTOUCH_CHANNEL:
+                return dispatch_index[DISPATCH_AT_CHAN][m_ch];
+            case HEM_MIDI_PITCHBEND:
+                return dispatch_index[DISPATCH_PB][m_ch];
+            default:
+                return 0;
+        }
     }
 
     bool CheckMidiChannelFilter(const uint8_t m_ch) {
@@ -441,48 +548,30 @@ struct MIDIFrame {
         UpdateLog({0, message, data1, data2});
     }
 
-    void ProcessMIDIMsg(const MIDIMessage msg);
+    // cycles is the message's arrival time, if it was queued
+    void ProcessMIDIMsg(const MIDIMessage msg, const uint32_t cycles = ARM_DWT_CYCCNT);
     void Send(const int *outvals);
 
+    // Outgoing messages are scheduled by HS::midi_out and flushed in IOFrame::Send()
     void SendAfterTouch(const uint8_t midi_ch, uint8_t val) {
-        usbMIDI.sendAfterTouch(val, midi_ch + 1);
-#ifdef ARDUINO_TEENSY41
-        usbHostMIDI.sendAfterTouch(val, midi_ch + 1);
-        MIDI1.sendAfterTouch(val, midi_ch + 1);
-#endif
+        midi_out.SendAfterTouch(midi_ch, val);
     }
     void SendPitchBend(const uint8_t midi_ch, uint16_t bend) {
-        usbMIDI.sendPitchBend(bend, midi_ch + 1);
-#ifdef ARDUINO_TEENSY41
-        usbHostMIDI.sendPitchBend(bend, midi_ch + 1);
-        MIDI1.sendPitchBend(bend, midi_ch + 1);
-#endif
+        midi_out.SendPitchBend(midi_ch, bend);
     }
 
     void SendCC(const uint8_t midi_ch, uint8_t ccnum, uint8_t val) {
-        usbMIDI.sendControlChange(ccnum, val, midi_ch + 1);
-#ifdef ARDUINO_TEENSY41
-        usbHostMIDI.sendControlChange(ccnum, val, midi_ch + 1);
-        MIDI1.sendControlChange(ccnum, val, midi_ch + 1);
-#endif
+        midi_out.SendCC(midi_ch, ccnum, val);
     }
     void SendNoteOn(const uint8_t midi_ch, uint8_t note = 255, uint8_t vel = 100) {
         if (note > 127) note = current_note[midi_ch];
         else current_note[midi_ch] = note;
 
-        usbMIDI.sendNoteOn(note, vel, midi_ch + 1);
-#ifdef ARDUINO_TEENSY41
-        usbHostMIDI.sendNoteOn(note, vel, midi_ch + 1);
-        MIDI1.sendNoteOn(note, vel, midi_ch + 1);
-#endif
+        midi_out.SendNoteOn(midi_ch, note, vel);
     }
     void SendNoteOff(const uint8_t midi_ch, uint8_t note = 255, uint8_t vel = 0) {
         if (note > 127) note = current_note[midi_ch];
-        usbMIDI.sendNoteOff(note, vel, midi_ch + 1);
-#ifdef ARDUINO_TEENSY41
-        usbHostMIDI.sendNoteOff(note, vel, midi_ch + 1);
-        MIDI1.sendNoteOff(note, vel, midi_ch + 1);
-#endif
+        midi_out.SendNoteOff(midi_ch, note, vel);
     }
 };
 
@@ -575,6 +664,8 @@ struct IOFrame {
         }
         // oh no, this is certainly broken now...
         if (autoMIDIOut) MIDIState.Send(outputs);
+
+        midi_out.Flush();
     }
 
 };
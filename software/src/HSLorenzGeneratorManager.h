@@ -22,24 +22,22 @@
 // It seemed like LowerRenz was crashing when two instances of it were running,
 // possibly because it was burdened with processing two Lorenz generators at
 // the same time. So this class creates a singleton instance to allow two
-// hemispheres to share a single Lorenz generator.
+// hemispheres to share a single attractor engine: one Lorenz system per
+// hemisphere, integrated every LORENZ_PROCESS_TICKS and interpolated to the
+// tick in between.
+
+#include "streams_attractor_engine.h"
 
 #define LORENZ_PROCESS_TICKS 16
 
 class LorenzGeneratorManager {
     static LorenzGeneratorManager *instance;
-    uint32_t freq[2]; // Frequency per hemisphere
-    bool reset[2]; // Reset per hemisphere
     uint32_t last_process_tick;
-    streams::LorenzGenerator lorenz;
+    streams::AttractorEngine<2, streams::ATTRACTOR_PRECISION_32> lorenz;
 
     LorenzGeneratorManager() {
-        lorenz.Init(0);
-        lorenz.Init(1);
-        lorenz.set_out_a(streams::LORENZ_OUTPUT_X1);
-        lorenz.set_out_b(streams::LORENZ_OUTPUT_Y1);
-        lorenz.set_out_c(streams::LORENZ_OUTPUT_X2);
-        lorenz.set_out_d(streams::LORENZ_OUTPUT_Y2);
+        static_assert(LORENZ_PROCESS_TICKS == 1 << 4, "decimation is a power of two");
+        lorenz.Init(4);
         last_process_tick = 0;
     }
 
@@ -49,29 +47,28 @@ public:
         return instance;
     }
 
+    // 0 = X1, 1 = Y1, 2 = X2, 3 = Y2
     int GetOut(int out) {
-        return lorenz.dac_code(out);
+        return static_cast<uint16_t>(lorenz.scaled(out >> 1, (out & 1) ? streams::ATTRACTOR_Y : streams::ATTRACTOR_X));
     }
 
     void SetRho(bool hemisphere, int16_t rho) {
-        if (hemisphere == 0) lorenz.set_rho1(rho);
-        else lorenz.set_rho2(rho);
+        lorenz.set_rho(hemisphere, rho);
     }
 
     void SetFreq(bool hemisphere, uint32_t freq_) {
-        freq[hemisphere] = freq_;
+        lorenz.set_rate(hemisphere, freq_ >> 8, 2);
     }
 
     void Reset(bool hemisphere) {
-        reset[hemisphere] = 1;
+        lorenz.Reset(hemisphere);
     }
 
+    // Called by every instance; the engine advances once per tick
     void Process() {
-        if (OC::CORE::ticks - last_process_tick >= LORENZ_PROCESS_TICKS) {
+        if (OC::CORE::ticks != last_process_tick) {
             last_process_tick = OC::CORE::ticks;
-            lorenz.Process(freq[0], freq[1], reset[0], reset[1], 2, 2);
-            reset[0] = 0;
-            reset[1] = 0;
+            lorenz.Process();
         }
     }
 };
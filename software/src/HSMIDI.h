@@ -36,9 +36,15 @@
 #if defined(__IMXRT1062__)
 #include <MIDI.h>
 #include <USBHost_t36.h>
+
+// DIN MIDI sends with running status; HS::MIDIOutScheduler budgets for it
+struct PhzMIDISettings : public midi::DefaultSettings {
+  static const bool UseRunningStatus = true;
+};
+
 extern USBHost thisUSB;
 extern MIDIDevice_BigBuffer usbHostMIDI;
-extern midi::MidiInterface<midi::SerialMIDI<HardwareSerial> > MIDI1;
+extern midi::MidiInterface<midi::SerialMIDI<HardwareSerial>, PhzMIDISettings> MIDI1;
 #endif
 
 namespace HS {
@@ -50,12 +56,35 @@ enum HemMidiType {
   HEM_MIDI_AFTERTOUCH_CHANNEL = usbMIDI.AfterTouchChannel,
   HEM_MIDI_AFTERTOUCH_POLY = usbMIDI.AfterTouchPoly,
   HEM_MIDI_PITCHBEND = usbMIDI.PitchBend,
+  HEM_MIDI_PROGRAM_CHANGE = usbMIDI.ProgramChange,
   HEM_MIDI_SYSEX = usbMIDI.SystemExclusive,
   HEM_MIDI_CLOCK = usbMIDI.Clock,
   HEM_MIDI_START = usbMIDI.Start,
   HEM_MIDI_STOP = usbMIDI.Stop,
 };
 
+enum MIDIPort : uint8_t {
+  MIDI_PORT_USB, // usbMIDI
+#if defined(__IMXRT1062__)
+  MIDI_PORT_HOST, // usbHostMIDI
+#if defined(ARDUINO_TEENSY41)
+  MIDI_PORT_DIN, // MIDI1
+#endif
+#endif
+  MIDI_PORT_COUNT
+};
+static constexpr uint8_t MIDI_PORTS_ALL = (1 << MIDI_PORT_COUNT) - 1;
+
+struct MIDIMessage {
+  // values expected from MIDI library, so channel starts at 1 (one), not zero
+  uint8_t channel, message, data1, data2;
+
+  const uint8_t chan() const { return channel - 1; }
+  const uint8_t note() const { return data1; }
+  const uint8_t vel() const { return data2; }
+  const bool IsNote() const { return message == HEM_MIDI_NOTE_ON; }
+};
+
 const char* const midi_note_numbers[128] = {
     "C-1","C#-1","D-1","D#-1","E-1","F-1","F#-1","G-1","G#-1","A-1","A#-1","B-1",
     "C0","C#0","D0","D#0","E0","F0","F#0","G0","G#0","A0","A#0","B0",
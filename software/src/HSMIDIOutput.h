@@ -0,0 +1,278 @@
+/* Copyright (c) 2024 Nicholas J. Michalek
+ *
+ * MIDIOutScheduler
+ *   - everything MIDIFrame sends goes through here, and is flushed once
+ *     per tick from IOFrame::Send()
+ *   - CC, Pitch Bend and Channel Aftertouch are coalesced: only the latest
+ *     value per channel (and CC#) goes out
+ *   - DIN MIDI gets a byte budget matching 31.25 kbaud, so the ISR never
+ *     blocks on a full UART; real-time and notes go before CC when it's tight
+ *   - running status on DIN, with Note Off sent as zero-velocity Note On
+ *
+ */
+
+#pragma once
+
+#include "HSMIDI.h"
+#include "OC_config.h"
+
+namespace HS {
+
+class MIDIOutScheduler {
+public:
+  static constexpr int kNoteQueueSize = 32; // pow2, <= 256
+  static constexpr int kCCSlots = 16;
+
+  // DIN: 31250 baud, 10 bits per byte = 3125 bytes/s, in 16.16 per tick
+  static constexpr int32_t kDinBytesPerTick = (3125 << 16) / OC_CORE_ISR_FREQ;
+  // don't let credit pile up beyond what fits in the UART transmit buffer
+  static constexpr int32_t kDinBurstBytes = 16 << 16;
+
+  uint32_t coalesced_count = 0; // continuous updates replaced before they went out
+  uint32_t overflow_count = 0; // notes sent immediately because the queue was full
+
+  void Init() {
+    note_write_ = note_read_ = 0;
+    for (auto &slot : cc_) slot.ports = 0;
+    for (int ch = 0; ch < 16; ++ch) bend_ports_[ch] = at_ports_[ch] = 0;
+    din_credit_ = kDinBurstBytes;
+    din_status_ = 0;
+  }
+
+  // Channels are 0-based here, like MIDIFrame.
+  // These are meant to be called from the ISR, between Flush() calls.
+  void Send(uint8_t message, uint8_t midi_ch, uint8_t data1, uint8_t data2, uint8_t ports = MIDI_PORTS_ALL) {
+    if (!ports) return;
+    if (message >= 0xF0) { // System messages don't have a channel
+      SendSystem(message, data1, data2, ports);
+      return;
+    }
+    switch (message) {
+      case HEM_MIDI_CC:
+        SendCC(midi_ch, data1, data2, ports);
+        break;
+      case HEM_MIDI_PITCHBEND:
+        SendPitchBend(midi_ch, (data2 << 7) + data1 - 8192, ports);
+        break;
+      case HEM_MIDI_AFTERTOUCH_CHANNEL:
+        SendAfterTouch(midi_ch, data1, ports);
+        break;
+      default:
+        Enqueue({message, midi_ch, data1, data2, ports});
+        break;
+    }
+  }
+  void SendNoteOn(uint8_t midi_ch, uint8_t note, uint8_t vel, uint8_t ports = MIDI_PORTS_ALL) {
+    Enqueue({HEM_MIDI_NOTE_ON, midi_ch, note, vel, ports});
+  }
+  void SendNoteOff(uint8_t midi_ch, uint8_t note, uint8_t vel, uint8_t ports = MIDI_PORTS_ALL) {
+    Enqueue({HEM_MIDI_NOTE_OFF, midi_ch, note, vel, ports});
+  }
+  void SendCC(uint8_t midi_ch, uint8_t ccnum, uint8_t val, uint8_t ports = MIDI_PORTS_ALL) {
+    CCSlot *free_slot = nullptr;
+    for (auto &slot : cc_) {
+      if (!slot.ports) {
+        if (!free_slot) free_slot = &slot;
+        continue;
+      }
+      if (slot.channel == midi_ch && slot.ccnum == ccnum) {
+        if (slot.ports & ports) ++coalesced_count;
+        slot.value = val;
+        slot.ports |= ports;
+        return;
+      }
+    }
+    if (free_slot) {
+      *free_slot = {midi_ch, ccnum, val, ports};
+      return;
+    }
+    // every slot busy with other CCs; ride along with the notes
+    Enqueue({HEM_MIDI_CC, midi_ch, ccnum, val, ports});
+  }
+  // bend is passed through as-is to the MIDI libraries
+  void SendPitchBend(uint8_t midi_ch, int bend, uint8_t ports = MIDI_PORTS_ALL) {
+    midi_ch &= 0x0F;
+    if (bend_ports_[midi_ch] & ports) ++coalesced_count;
+    bend_[midi_ch] = bend;
+    bend_ports_[midi_ch] |= ports;
+  }
+  void SendAfterTouch(uint8_t midi_ch, uint8_t val, uint8_t ports = MIDI_PORTS_ALL) {
+    midi_ch &= 0x0F;
+    if (at_ports_[midi_ch] & ports) ++coalesced_count;
+    at_[midi_ch] = val;
+    at_ports_[midi_ch] |= ports;
+  }
+
+  // Clock, Start, Stop: never queued or coalesced
+  void SendRealTime(uint8_t type, uint8_t ports = MIDI_PORTS_ALL) {
+    if (ports & (1 << MIDI_PORT_USB)) usbMIDI.sendRealTime(type);
+#if defined(__IMXRT1062__)
+    if (ports & (1 << MIDI_PORT_HOST)) usbHostMIDI.sendRealTime(type);
+#if defined(ARDUINO_TEENSY41)
+    if (ports & DIN_BIT) {
+      MIDI1.sendRealTime(midi::MidiType(type));
+      din_credit_ -= (1 << 16);
+    }
+#endif
+#endif
+  }
+
+  // Once per tick. USB ports get everything; DIN gets what the budget allows,
+  // in priority order: notes, then bend, aftertouch, CC.
+  void Flush() {
+#if defined(ARDUINO_TEENSY41)
+    din_credit_ = min(din_credit_ + kDinBytesPerTick, kDinBurstBytes);
+    bool din_ok = true;
+#endif
+
+    for (uint8_t i = note_read_; i != note_write_; ++i) {
+      QueuedEvent &e = notes_[i & (kNoteQueueSize - 1)];
+      SendUSB(e.message, e.channel, e.data1, e.data2, e.ports);
+#if defined(ARDUINO_TEENSY41)
+      // keep DIN in order: once one note has to wait, the rest wait too
+      if (din_ok && (e.ports & DIN_BIT)) din_ok = SendDIN(e.message, e.channel, e.data1, e.data2);
+      if (din_ok) e.ports &= ~DIN_BIT;
+#endif
+      e.ports &= DIN_BIT;
+    }
+    while (note_read_ != note_write_ && !notes_[note_read_ & (kNoteQueueSize - 1)].ports)
+      ++note_read_;
+
+    for (int ch = 0; ch < 16; ++ch) {
+      if (bend_ports_[ch]) {
+        SendUSB(HEM_MIDI_PITCHBEND, ch, 0, 0, bend_ports_[ch]);
+#if defined(ARDUINO_TEENSY41)
+        if (!(bend_ports_[ch] & DIN_BIT) || SendDIN(HEM_MIDI_PITCHBEND, ch, 0, 0))
+          bend_ports_[ch] &= ~DIN_BIT;
+#endif
+        bend_ports_[ch] &= DIN_BIT;
+      }
+    }
+    for (int ch = 0; ch < 16; ++ch) {
+      if (at_ports_[ch]) {
+        SendUSB(HEM_MIDI_AFTERTOUCH_CHANNEL, ch, at_[ch], 0, at_ports_[ch]);
+#if defined(ARDUINO_TEENSY41)
+        if (!(at_ports_[ch] & DIN_BIT) || SendDIN(HEM_MIDI_AFTERTOUCH_CHANNEL, ch, at_[ch], 0))
+          at_ports_[ch] &= ~DIN_BIT;
+#endif
+        at_ports_[ch] &= DIN_BIT;
+      }
+    }
+    for (auto &slot : cc_) {
+      if (slot.ports) {
+        SendUSB(HEM_MIDI_CC, slot.channel, slot.ccnum, slot.value, slot.ports);
+#if defined(ARDUINO_TEENSY41)
+        if (!(slot.ports & DIN_BIT) || SendDIN(HEM_MIDI_CC, slot.channel, slot.ccnum, slot.value))
+          slot.ports &= ~DIN_BIT;
+#endif
+        slot.ports &= DIN_BIT;
+      }
+    }
+  }
+
+private:
+  struct QueuedEvent {
+    uint8_t message, channel, data1, data2, ports;
+  };
+  struct CCSlot {
+    uint8_t channel, ccnum, value, ports;
+  };
+
+#if defined(ARDUINO_TEENSY41)
+  static constexpr uint8_t DIN_BIT = (1 << MIDI_PORT_DIN);
+#else
+  static constexpr uint8_t DIN_BIT = 0;
+#endif
+
+  QueuedEvent notes_[kNoteQueueSize];
+  uint8_t note_write_ = 0, note_read_ = 0;
+  CCSlot cc_[kCCSlots];
+  int16_t bend_[16];
+  uint8_t at_[16];
+  uint8_t bend_ports_[16] = {0};
+  uint8_t at_ports_[16] = {0};
+
+  int32_t din_credit_ = kDinBurstBytes; // 16.16 bytes
+  uint8_t din_status_ = 0; // last Channel Voice status byte sent on DIN
+
+  // System Common goes out immediately, like Real-Time
+  void SendSystem(uint8_t message, uint8_t data1, uint8_t data2, uint8_t ports) {
+    if (message >= 0xF8) {
+      SendRealTime(message, ports);
+      return;
+    }
+    if (ports & (1 << MIDI_PORT_USB)) usbMIDI.send(message, data1, data2, 0, 0);
+#if defined(__IMXRT1062__)
+    if (ports & (1 << MIDI_PORT_HOST)) usbHostMIDI.send(message, data1, data2, 0, 0);
+#if defined(ARDUINO_TEENSY41)
+    if (ports & DIN_BIT) {
+      MIDI1.send(midi::MidiType(message), data1, data2, 0);
+      din_credit_ -= (3 << 16);
+      din_status_ = 0; // System Common cancels running status
+    }
+#endif
+#endif
+  }
+
+  void Enqueue(const QueuedEvent &e) {
+    if (!e.ports) return;
+    if (uint8_t(note_write_ - note_read_) >= kNoteQueueSize) {
+      // full - fall back to sending right away
+      ++overflow_count;
+      SendUSB(e.message, e.channel, e.data1, e.data2, e.ports);
+#if defined(ARDUINO_TEENSY41)
+      if (e.ports & DIN_BIT) SendDIN(e.message, e.channel, e.data1, e.data2, true);
+#endif
+      return;
+    }
+    notes_[note_write_ & (kNoteQueueSize - 1)] = e;
+    ++note_write_;
+  }
+
+  void SendUSB(uint8_t message, uint8_t midi_ch, uint8_t data1, uint8_t data2, uint8_t ports) {
+    const uint8_t chan = midi_ch + 1;
+    if (ports & (1 << MIDI_PORT_USB)) {
+      switch (message) {
+        case HEM_MIDI_PITCHBEND: usbMIDI.sendPitchBend(bend_[midi_ch], chan); break;
+        case HEM_MIDI_AFTERTOUCH_CHANNEL: usbMIDI.sendAfterTouch(data1, chan); break;
+        default: usbMIDI.send(message, data1, data2, chan, 0); break;
+      }
+    }
+#if defined(__IMXRT1062__)
+    if (ports & (1 << MIDI_PORT_HOST)) {
+      switch (message) {
+        case HEM_MIDI_PITCHBEND: usbHostMIDI.sendPitchBend(bend_[midi_ch], chan); break;
+        case HEM_MIDI_AFTERTOUCH_CHANNEL: usbHostMIDI.sendAfterTouch(data1, chan); break;
+        default: usbHostMIDI.send(message, data1, data2, chan, 0); break;
+      }
+    }
+#endif
+  }
+
+#if defined(ARDUINO_TEENSY41)
+  // Returns false, without sending, if the DIN byte budget is used up
+  bool SendDIN(uint8_t message, uint8_t midi_ch, uint8_t data1, uint8_t data2, bool force = false) {
+    // zero-velocity Note On shares running status with the Note Ons around it
+    if (message == HEM_MIDI_NOTE_OFF && data2 == 0) message = HEM_MIDI_NOTE_ON;
+
+    const uint8_t status = message | midi_ch;
+    int32_t cost = (message == HEM_MIDI_AFTERTOUCH_CHANNEL || message == HEM_MIDI_PROGRAM_CHANGE) ? 2 : 3;
+    if (status == din_status_) --cost;
+    if (!force && din_credit_ < (cost << 16)) return false;
+
+    din_credit_ -= (cost << 16);
+    din_status_ = status;
+    const uint8_t chan = midi_ch + 1;
+    switch (message) {
+      case HEM_MIDI_PITCHBEND: MIDI1.sendPitchBend(bend_[midi_ch], chan); break;
+      case HEM_MIDI_AFTERTOUCH_CHANNEL: MIDI1.sendAfterTouch(data1, chan); break;
+      default: MIDI1.send(midi::MidiType(message), data1, data2, chan); break;
+    }
+    return true;
+  }
+#endif
+};
+
+extern MIDIOutScheduler midi_out;
+
+} // namespace HS
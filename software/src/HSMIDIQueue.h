@@ -0,0 +1,111 @@
+/* Copyright (c) 2024 Nicholas J. Michalek
+ *
+ * MIDIInputQueue
+ *   - timestamps incoming MIDI from every port with the cycle counter
+ *     as soon as it's read, instead of once per ISR tick
+ *   - the app ISR drains it with a bounded budget per tick, so a burst
+ *     spreads over a few ticks rather than stalling one
+ *
+ */
+
+#pragma once
+
+#include "HSMIDI.h"
+#include "HSMIDIOutput.h"
+#include "util/util_ringbuffer.h"
+
+namespace HS {
+
+struct TimedMIDIMessage {
+  uint32_t cycles; // ARM_DWT_CYCCNT when read from the port
+  MIDIMessage msg;
+  uint8_t port;
+};
+
+class MIDIInputQueue {
+public:
+#if defined(__IMXRT1062__)
+  static constexpr size_t kSize = 128;
+#else
+  static constexpr size_t kSize = 32;
+#endif
+  static constexpr int kBudgetPerTick = 16;
+
+  uint32_t overflow_count = 0; // polls that left messages waiting in a port because the queue was full
+
+  void Init() {
+    queue_.Init();
+    sysex_hold_ = 0;
+    overflow_count = 0;
+  }
+
+  // Pull everything waiting on the ports into the queue.
+  // Call from the app's loop() for sub-tick timestamps, and from the ISR
+  // before Drain() so nothing waits on a busy main loop.
+  void Poll(bool from_isr = false) {
+    Capture(usbMIDI, MIDI_PORT_USB, from_isr);
+#if defined(__IMXRT1062__)
+    Capture(usbHostMIDI, MIDI_PORT_HOST, from_isr);
+#if defined(ARDUINO_TEENSY41)
+    Capture(MIDI1, MIDI_PORT_DIN, from_isr);
+#endif
+#endif
+  }
+
+  // ISR only. handler(const TimedMIDIMessage &) is called in arrival order.
+  // SysEx stays in its port's buffer until the handler returns, so it can
+  // still be fetched with getSysExArray().
+  template <typename F>
+  void Drain(F handler, int budget = kBudgetPerTick) {
+    while (budget-- > 0 && queue_.readable()) {
+      const TimedMIDIMessage m = queue_.Read();
+      handler(m);
+      if (m.msg.message == HEM_MIDI_SYSEX)
+        sysex_hold_ &= ~(1 << m.port);
+    }
+  }
+
+  size_t pending() const {
+    return queue_.readable();
+  }
+
+  // MIDI Thru: echo a message to every other port, via the output scheduler
+  void Thru(const TimedMIDIMessage &m) {
+    const MIDIMessage &msg = m.msg;
+    midi_out.Send(msg.message, msg.chan(), msg.data1, msg.data2,
+                  MIDI_PORTS_ALL & ~(1 << m.port));
+  }
+
+private:
+  util::RingBuffer<TimedMIDIMessage, kSize> queue_;
+  volatile uint8_t sysex_hold_ = 0; // ports with an unconsumed SysEx dump
+
+  template <typename T>
+  void Capture(T &device, const uint8_t port, const bool from_isr) {
+    for (;;) {
+      // the ISR polls the same ports; keep it out while we read one message
+      if (!from_isr) noInterrupts();
+
+      bool got = false;
+      if (!(sysex_hold_ & (1 << port))) {
+        if (!queue_.writable()) {
+          ++overflow_count;
+        } else if (device.read()) {
+          const uint8_t message = device.getType();
+          queue_.Write({ ARM_DWT_CYCCNT,
+                         { device.getChannel(), message, device.getData1(), device.getData2() },
+                         port });
+          if (message == HEM_MIDI_SYSEX) sysex_hold_ |= (1 << port);
+          got = true;
+        }
+      }
+
+      if (!from_isr) interrupts();
+      if (!got) break;
+    }
+  }
+};
+
+extern MIDIInputQueue midi_in;
+
+} // namespace HS
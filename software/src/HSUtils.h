@@ -132,12 +132,14 @@ namespace HS {
   };
   struct QuantEngine : public QuantEngineSettings {
     braids::Quantizer quantizer;
+    braids::QuantizerTable table;
 
     QuantEngine() {
       scale = OC::Scales::SCALE_SEMI;
       mask = 0xffff;
       quantizer.Init();
       Reconfig();
+      quantizer.AttachTable(&table);
     }
 
     void Reconfig() {
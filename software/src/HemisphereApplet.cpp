@@ -1,6 +1,8 @@
 #include "HemisphereApplet.h"
 
 HS::IOFrame HS::frame;
+HS::MIDIInputQueue HS::midi_in;
+HS::MIDIOutScheduler HS::midi_out;
 HS::ClockManager HS::clock_m;
 
 int HemisphereApplet::cursor_countdown[APPLET_CURSOR_COUNT];
@@ -112,6 +114,9 @@ void HS::IOFrame::Load() {
         if (m.trigout_countdown > 0) {
             if (--m.trigout_countdown == 0) m.output = 0;
         }
+        if (m.gate_countdown > 0) {
+            if (--m.gate_countdown == 0) m.output = m.GateOffValue();
+        }
     }
 
     // pre-calculate clock triggers
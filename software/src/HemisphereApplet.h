@@ -44,6 +44,7 @@
 
 #include "HSUtils.h"
 #include "HSIOFrame.h"
+#include "HSMIDIQueue.h"
 #include <cstdint>
 #include <variant>
 
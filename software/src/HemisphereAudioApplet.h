@@ -33,6 +33,11 @@ public:
 
   AudioConnection* cables = nullptr;
   size_t cable_count;
+  // The streams PatchCable has fed, and the applet's own streams it has read
+  // from, for CPU accounting. Shared streams, such as the I2S input, are
+  // left to whoever owns them.
+  AudioStream** streams = nullptr;
+  size_t stream_count = 0;
 
   // If applet_name() can return different things at different times, you
   // *must* override this or saving and loading won't work!
@@ -80,6 +85,14 @@ public:
     }
 
     cables[cable_count++].connect(source, s_ch, dest, d_ch);
+    if (IsMember(&source)) AddStream(&source);
+    AddStream(&dest);
+  }
+
+  // sizeof the applet's own class, so PatchCable can tell its member streams
+  // from shared ones; the subapp sets it for every applet in its pools
+  void SetFootprint(size_t size) {
+    footprint = size;
   }
 
   void Disconnect() {
@@ -87,6 +100,62 @@ public:
       cables[i].disconnect();
     }
     cable_count = 0;
+    stream_count = 0;
+  }
+
+  // Percent of the audio interrupt spent in this applet's streams, in the
+  // busiest update since the last reset, as AudioProcessorUsageMax()
+  float ProcessorUsageMax() {
+    float usage = 0.0f;
+    for (size_t i = 0; i < stream_count; ++i) {
+      usage += streams[i]->processorUsageMax();
+    }
+    // Applets that are a single stream have no cables
+    if (!stream_count) {
+      AudioStream* in = InputStream();
+      AudioStream* out = OutputStream();
+      if (in) usage += in->processorUsageMax();
+      if (out && out != in) usage += out->processorUsageMax();
+    }
+    return usage;
+  }
+
+  void ProcessorUsageMaxReset() {
+    for (size_t i = 0; i < stream_count; ++i) {
+      streams[i]->processorUsageMaxReset();
+    }
+    if (!stream_count) {
+      AudioStream* in = InputStream();
+      AudioStream* out = OutputStream();
+      if (in) in->processorUsageMaxReset();
+      if (out) out->processorUsageMaxReset();
+    }
+  }
+
+  // A bypassed applet's output is its input, so the subapp routes around it
+  // and leaves its streams unfed. Checked every mainloop, so this may change
+  // at any time.
+  virtual bool Bypassed() {
+    return false;
+  }
+
+  // Applets that can run cheaper when the audio interrupt is overloaded
+  // return how many steps down they have and apply them in
+  // OnQualityReduction; 0 is always full quality.
+  virtual uint8_t MaxQualityReduction() {
+    return 0;
+  }
+  virtual void OnQualityReduction(uint8_t level) {}
+
+  uint8_t QualityReduction() const {
+    return quality_reduction;
+  }
+
+  void SetQualityReduction(uint8_t level) {
+    if (level > MaxQualityReduction()) level = MaxQualityReduction();
+    if (level == quality_reduction) return;
+    quality_reduction = level;
+    OnQualityReduction(level);
   }
 
   void gfxPrintTuningIndicator(int16_t pitch) {
@@ -121,4 +190,23 @@ public:
     if (db < LVL_MIN_DB) gfxPrint("   - ");
     else graphics.printf("%3ddB", db);
   }
+
+private:
+  uint8_t quality_reduction = 0;
+  size_t footprint = 0;
+
+  bool IsMember(const AudioStream* stream) const {
+    const char* p = reinterpret_cast<const char*>(stream);
+    const char* self = reinterpret_cast<const char*>(this);
+    return p >= self && p < self + footprint;
+  }
+
+  void AddStream(AudioStream* stream) {
+    if (!streams) streams = new AudioStream*[MAX_CABLES];
+    for (size_t i = 0; i < stream_count; ++i) {
+      if (streams[i] == stream) return;
+    }
+    // Past MAX_CABLES streams the rest just go uncounted
+    if (stream_count < MAX_CABLES) streams[stream_count++] = stream;
+  }
 };
@@ -43,6 +43,7 @@
 #include "util/util_debugpins.h"
 #include "VBiasManager.h"
 #include "HSMIDI.h"
+#include "HSMIDIQueue.h"
 
 #if defined(__IMXRT1062__)
 #include "PhzConfig.h"
@@ -52,7 +53,7 @@ USBHub hub1(thisUSB);
 MIDIDevice_BigBuffer usbHostMIDI(thisUSB);
 
 #if defined(ARDUINO_TEENSY41)
-MIDI_CREATE_INSTANCE(HardwareSerial, Serial8, MIDI1);
+MIDI_CREATE_CUSTOM_INSTANCE(HardwareSerial, Serial8, MIDI1, PhzMIDISettings);
 #include "AudioIO.h"
 #endif
 
@@ -173,6 +174,9 @@ void setup() {
   OC::ui.Init();
   OC::ui.configure_encoders(OC::calibration_data.encoder_config());
 
+  HS::midi_in.Init();
+  HS::midi_out.Init();
+
   SERIAL_PRINTLN("* CORE ISR @%luus", OC_CORE_TIMER_RATE);
   CORE_timer.begin(CORE_timer_ISR, OC_CORE_TIMER_RATE);
   CORE_timer.priority(OC_CORE_TIMER_PRIO);
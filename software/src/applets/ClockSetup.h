@@ -96,7 +96,7 @@ public:
 
         // ------------ //
         if (clock_m.IsRunning() && clock_m.MIDITock()) {
-            usbMIDI.sendRealTime(usbMIDI.Clock);
+            HS::midi_out.SendRealTime(usbMIDI.Clock);
         }
 
         // 4 internal clock flashers
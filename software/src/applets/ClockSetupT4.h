@@ -111,11 +111,7 @@ public:
 
         // ------------ //
         if (HS::clock_m.IsRunning() && HS::clock_m.MIDITock()) {
-          usbMIDI.sendRealTime(usbMIDI.Clock);
-          usbHostMIDI.sendRealTime(usbMIDI.Clock);
-#ifdef ARDUINO_TEENSY41
-          MIDI1.sendRealTime(midi::MidiType(usbMIDI.Clock));
-#endif
+          HS::midi_out.SendRealTime(usbMIDI.Clock);
         }
 
         // 8 internal clock flashers
@@ -402,9 +398,11 @@ private:
 
         // Tempo
         gfxPrint(22 + pad(100, clock_m.GetTempo()), y, clock_m.GetTempo());
-        if (cursor != SHUFFLE)
+        if (cursor != SHUFFLE) {
             gfxPrint(" BPM");
-        else {
+            // external sync: steady when locked, wavy while hunting
+            if (clock_m.extsync) gfxPrint(70, y, clock_m.IsLocked() ? "=" : "~");
+        } else {
             // Shuffle
             gfxIcon(44, y, METRO_R_ICON);
             gfxPrint(52 + pad(10, clock_m.GetShuffle()), y, clock_m.GetShuffle());
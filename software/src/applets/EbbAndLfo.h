@@ -23,6 +23,8 @@ public:
   void Start() {
     phase = 0;
     phase_extractor.Init();
+    shaper.Init();
+    disp_shaper.Init();
   }
 
   void Reset() {
@@ -112,7 +114,7 @@ public:
 
     // COMPUTE
     int s = constrain(slope_mod, 0, 65535);
-    ProcessSample(s, shape_mod, fold_mod, phase, sample);
+    shaper.Process(s, shape_mod, fold_mod, phase, sample);
 
     ForEachChannel(ch) {
       switch (output(ch)) {
@@ -155,8 +157,8 @@ public:
       int bottom = 32 + (h + 1) * ch;
       int last = bottom;
       for (int i = 0; i < w; i++) {
-        ProcessSample(slope_mod, shape_mod, fold_mod, 0xffffffff / w * i,
-                      disp_sample);
+        disp_shaper.Process(slope_mod, shape_mod, fold_mod, 0xffffffff / w * i,
+                            disp_sample);
         int next = 0;
         switch (output(ch)) {
         case UNIPOLAR:
@@ -422,6 +424,8 @@ private:
   uint8_t cv = 0b0001;  // Freq on 1, shape on 2
   TidesLiteSample disp_sample;
   TidesLiteSample sample;
+  TidesLiteShaper shaper;
+  TidesLiteShaper disp_shaper; // separate, so drawing doesn't thrash the cached factors
 
   int knob_accel = 1 << 8;
 
@@ -61,7 +61,7 @@ public:
             beats[ch] = 4 + ch*4;
             offset[ch] = 0;
             padding[ch] = ch*16;
-            pattern[ch] = EuclideanPattern(length[ch], beats[ch], offset[ch], padding[ch]);
+            pattern[ch] = EuclideanPattern64(length[ch], beats[ch], offset[ch], padding[ch]);
         }
         step = 0;
     }
@@ -84,12 +84,12 @@ public:
             ForEachChannel(cv_ch) {
                 switch (cv_dest[cv_ch] - ch * LENGTH2) { // this is dumb, but efficient
                 case LENGTH1:
-                    Modulate(actual_length[ch], ch, 2, 32);
+                    Modulate(actual_length[ch], ch, 2, kMaxEuclideanSteps);
 
                     if (actual_beats[ch] > actual_length[ch])
                         actual_beats[ch] = actual_length[ch];
-                    if (actual_padding[ch] > 32 - actual_length[ch])
-                        actual_padding[ch] = 32 - actual_length[ch];
+                    if (actual_padding[ch] > kMaxEuclideanSteps - actual_length[ch])
+                        actual_padding[ch] = kMaxEuclideanSteps - actual_length[ch];
                     if (actual_offset[ch] >= actual_length[ch] + actual_padding[ch])
                         actual_offset[ch] = actual_length[ch] + actual_padding[ch] - 1;
 
@@ -101,7 +101,7 @@ public:
                     Modulate(actual_offset[ch], ch, 0, actual_length[ch] + padding[ch]);
                     break;
                 case PADDING1:
-                    Modulate(actual_padding[ch], ch, 0, 32 - actual_length[ch]);
+                    Modulate(actual_padding[ch], ch, 0, kMaxEuclideanSteps - actual_length[ch]);
                     if (actual_offset[ch] >= actual_length[ch] + actual_padding[ch])
                         actual_offset[ch] = actual_length[ch] + actual_padding[ch] - 1;
                     break;
@@ -110,7 +110,7 @@ public:
             }
 
             // Store the pattern for display
-            pattern[ch] = EuclideanPattern(actual_length[ch], actual_beats[ch], actual_offset[ch], actual_padding[ch]);
+            pattern[ch] = EuclideanPattern64(actual_length[ch], actual_beats[ch], actual_offset[ch], actual_padding[ch]);
         }
 
         // Process triggers and step forward on clock
@@ -154,11 +154,11 @@ public:
         switch (cursor) {
         case LENGTH1:
         case LENGTH2:
-            actual_length[ch] = length[ch] = constrain(length[ch] + direction, 2, 32);
+            actual_length[ch] = length[ch] = constrain(length[ch] + direction, 2, kMaxEuclideanSteps);
             if (beats[ch] > length[ch])
                 beats[ch] = length[ch];
-            if (padding[ch] > 32 - length[ch])
-                padding[ch] = 32 - length[ch];
+            if (padding[ch] > kMaxEuclideanSteps - length[ch])
+                padding[ch] = kMaxEuclideanSteps - length[ch];
             if (offset[ch] >= length[ch] + padding[ch])
                 offset[ch] = length[ch] + padding[ch] - 1;
             break;
@@ -172,7 +172,7 @@ public:
             break;
         case PADDING1:
         case PADDING2:
-            padding[ch] = constrain(padding[ch] + direction, 0, 32 - length[ch]);
+            padding[ch] = constrain(padding[ch] + direction, 0, kMaxEuclideanSteps - length[ch]);
             if (offset[ch] >= length[ch] + padding[ch])
                 offset[ch] = length[ch] + padding[ch] - 1;
             break;
@@ -192,6 +192,7 @@ public:
         ForEachChannel(ch) {
             Pack(data, PackLocation {idx++ * PARAM_SIZE, PARAM_SIZE}, length[ch] - 1);
             Pack(data, PackLocation {idx++ * PARAM_SIZE, PARAM_SIZE}, beats[ch]);
+            Pack(data, PackLocation {61 + ch, 1}, beats[ch] >> PARAM_SIZE); // 64 beats
             Pack(data, PackLocation {idx++ * PARAM_SIZE, PARAM_SIZE}, offset[ch]);
             Pack(data, PackLocation {idx++ * PARAM_SIZE, PARAM_SIZE}, padding[ch]);
             Pack(data, PackLocation {idx++ * PARAM_SIZE, PARAM_SIZE}, cv_dest[ch]);
@@ -204,7 +205,8 @@ public:
         size_t idx = 0;
         ForEachChannel(ch) {
             actual_length[ch] = length[ch] = Unpack(data, PackLocation {idx++ * PARAM_SIZE, PARAM_SIZE}) + 1;
-            actual_beats[ch]  = beats[ch]  = Unpack(data, PackLocation {idx++ * PARAM_SIZE, PARAM_SIZE});
+            actual_beats[ch]  = beats[ch]  = Unpack(data, PackLocation {idx++ * PARAM_SIZE, PARAM_SIZE})
+                                           | (Unpack(data, PackLocation {61 + ch, 1}) << PARAM_SIZE);
             actual_offset[ch] = offset[ch] = Unpack(data, PackLocation {idx++ * PARAM_SIZE, PARAM_SIZE});
             actual_padding[ch] = padding[ch] = Unpack(data, PackLocation {idx++ * PARAM_SIZE, PARAM_SIZE});
             cv_dest[ch] = (EuclidXParam) Unpack(data, PackLocation {idx++ * PARAM_SIZE, PARAM_SIZE});
@@ -230,7 +232,7 @@ protected:
 private:
     int step;
     int cursor = LENGTH1; // EuclidXParam 
-    uint32_t pattern[2];
+    uint64_t pattern[2];
     bool gate_mode = false;
 
     // Settings
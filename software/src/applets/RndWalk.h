@@ -18,6 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include "../fastmath.h"
+
 #define PROB_UP 500
 #define PROB_DN 500
 
@@ -283,7 +285,7 @@ private:
 
     void UpdateAlpha() {
         // Use log mapping for better feeling
-        alpha = log(1+smoothness)/log(1+MAX_SMOOTH);
+        alpha = fastmath::Log2(1 + smoothness) / fastmath::Log2(1 + MAX_SMOOTH);
         // alpha = (float)smoothness/(float)MAX_SMOOTH;
     }
 };
@@ -70,8 +70,8 @@ public:
         );
         break;
     }
-    for (int tap = 0; tap < taps; tap++) {
-      float t = d * static_cast<float>(taps - tap) / taps;
+    for (int tap = 0; tap < active_taps; tap++) {
+      float t = d * static_cast<float>(active_taps - tap) / active_taps;
       CONSTRAIN(d, 0.0f, MAX_DELAY_SECS);
       switch (delay_mod_type) {
         case CROSSFADE:
@@ -87,7 +87,7 @@ public:
     // I'm not totally sure why equal amplitude feedback is necessary, but equal
     // power was resulting in divergence when the feedback setting would pass
     // the equal power coefficient. Thus, need equal amplitude instead.
-    float fb = constrain(total_feedback, 0.0, 2.0f) / taps;
+    float fb = constrain(total_feedback, 0.0, 2.0f) / active_taps;
 
     for (auto& ch : channels) {
       if (frozen) {
@@ -99,7 +99,7 @@ public:
       } else {
         ch.input_mixer.gain(0, 1.0f);
         for (int tap = 0; tap < 9; tap++) {
-          ch.delaystream.feedback(tap, tap < taps ? fb : 0.0f);
+          ch.delaystream.feedback(tap, tap < active_taps ? fb : 0.0f);
         }
       }
     }
@@ -112,7 +112,7 @@ public:
         // the square roots of equal power)
         ch.input_mixer.gain(
           PP_CH,
-          constrain(-total_feedback * EQUAL_POWER_EQUAL_MIX[taps], 0.0f, 2.0f)
+          constrain(-total_feedback * EQUAL_POWER_EQUAL_MIX[active_taps], 0.0f, 2.0f)
         );
       }
     }
@@ -315,6 +315,14 @@ public:
     UnpackPackables(data[1], delay_time_cv, feedback_cv, wet_cv, clock_source);
   }
 
+  // Each step halves the taps actually read, down to one
+  uint8_t MaxQualityReduction() override {
+    return 31 - __builtin_clz(taps);
+  }
+  void OnQualityReduction(uint8_t level) override {
+    set_taps(taps);
+  }
+
   AudioStream* InputStream() {
     return &input_stream;
   }
@@ -351,11 +359,13 @@ protected:
   void set_taps(size_t t) {
     taps = t;
     CONSTRAIN(taps, 1, 8);
-    float tap_gain = EQUAL_POWER_EQUAL_MIX[taps];
+    active_taps = taps >> QualityReduction();
+    if (active_taps < 1) active_taps = 1;
+    float tap_gain = EQUAL_POWER_EQUAL_MIX[active_taps];
     for (auto& ch : channels) {
-      for (int i = 0; i < taps; i++) ch.taps_mixer.gain(i, tap_gain);
-      for (int i = taps; i < 8; i++) ch.taps_mixer.gain(i, 0.0f);
-      ch.delaystream.taps(taps);
+      for (int i = 0; i < active_taps; i++) ch.taps_mixer.gain(i, tap_gain);
+      for (int i = active_taps; i < 8; i++) ch.taps_mixer.gain(i, 0.0f);
+      ch.delaystream.taps(active_taps);
     }
   }
 
@@ -406,6 +416,8 @@ private:
   int8_t wet = 50;
   CVInputMap wet_cv;
   uint8_t taps = 1;
+  // taps, less any quality reduction
+  uint8_t active_taps = 1;
   int8_t delay_mod_type = CROSSFADE;
 
   NoiseSuppressor delay_cv{
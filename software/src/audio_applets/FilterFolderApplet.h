@@ -36,7 +36,7 @@ public:
     const int bias = tiltmode ? tiltbias + res_cv.InRescaled(LVL_MAX_DB) : 0;
 
     for (int i = 0; i < Channels; i++) {
-      filtfolder[i].filter.frequency(PitchToRatio(pitch + pitch_cv.In()) * C3);
+      filtfolder[i].filter.frequency(PitchToHz(pitch + pitch_cv.In()));
       if (tiltmode) {
         filtfolder[i].filter.resonance(0.70);
       } else {
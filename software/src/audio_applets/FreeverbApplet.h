@@ -6,23 +6,30 @@
 #include "Audio/AudioMixer.h"
 #include "Audio/AudioPassthrough.h"
 #include "Audio/InterpolatingStream.h"
+#include "Audio/effect_reverb_freeverb.h"
 #include <Audio.h>
 
+template <AudioChannels Channels>
 class ReverbApplet : public HemisphereAudioApplet {
     public:
         const char* applet_name() override {
             return "Reverb";
         }
         void Start() override {
-            if (!reverb && OC::CORE::FreeRam() > (int)sizeof(AudioEffectFreeverb)) {
-              reverb = new AudioEffectFreeverb();
+            if (!reverb && OC::CORE::FreeRam() > (int)sizeof(Reverb)) {
+              reverb = new Reverb();
+            }
+            for (int ch = 0; ch < Channels; ++ch) {
+              PatchCable(input, ch, dry_wet_mixer[ch], 1);
+              PatchCable(dry_wet_mixer[ch], 0, output, ch);
             }
-            PatchCable(input, 0, dry_wet_mixer, 1);
             if (!reverb) return;
-            PatchCable(input, 0, *reverb, 0);
-            PatchCable(*reverb, 0, filter, 0);
-            PatchCable(filter, 0, dry_wet_mixer, 0);
-            filter.frequency(15000);
+            for (int ch = 0; ch < Channels; ++ch) {
+              PatchCable(input, ch, *reverb, ch);
+              PatchCable(*reverb, ch, filter[ch], 0);
+              PatchCable(filter[ch], 0, dry_wet_mixer[ch], 0);
+              filter[ch].frequency(15000);
+            }
         }
 
         void Controller() override {
@@ -30,18 +37,20 @@ class ReverbApplet : public HemisphereAudioApplet {
               reverb->roomsize((size * 0.01f) + size_cv.InF());
               reverb->damping((damp * 0.01f) + damp_cv.InF());
             } else {
-              dry_wet_mixer.gain(1, 1.0f);
+              for (auto& m : dry_wet_mixer) m.gain(1, 1.0f);
               return;
             }
 
             float freq = constrain(static_cast<float>(cutoff)
               + (cutoff_cv.InF() * abs(cutoff_cv.InF()) * 18000.0), 10.0f, 20000.0);
-            filter.frequency(freq);
+            for (auto& f : filter) f.frequency(freq);
 
             float m = constrain(static_cast<float>(mix) * 0.01f + mix_cv.InF(), 0.0f, 1.0f);
 
-            dry_wet_mixer.gain(0, m);
-            dry_wet_mixer.gain(1, 1.0f - m);
+            for (auto& mixer : dry_wet_mixer) {
+              mixer.gain(0, m);
+              mixer.gain(1, 1.0f - m);
+            }
         }
 
         void View() override {
@@ -153,7 +162,7 @@ class ReverbApplet : public HemisphereAudioApplet {
             return &input;
         }
         AudioStream* OutputStream() override {
-            return &dry_wet_mixer;
+            return &output;
         }
     protected:
         void SetHelp() override {}
@@ -171,12 +180,15 @@ class ReverbApplet : public HemisphereAudioApplet {
         };
 
         int8_t cursor = SIZE;
-        AudioPassthrough<MONO> input;
+        using Reverb = AudioEffectReverbFreeverb<Channels>;
+
+        AudioPassthrough<Channels> input;
 
-        AudioEffectFreeverb* reverb;
-        AudioFilterStateVariable filter;
+        Reverb* reverb = nullptr;
+        AudioFilterStateVariable filter[Channels];
 
-        AudioMixer<2> dry_wet_mixer;
+        AudioMixer<2> dry_wet_mixer[Channels];
+        AudioPassthrough<Channels> output;
 
         int8_t mix = 50;
         int8_t size = 50;
@@ -78,6 +78,8 @@ class HandSawApplet : public HemisphereAudioApplet {
           stackMixer.gain(1, 0.25f);
           stackMixer.gain(2, 0.25f);
           stackMixer.gain(3, 0.25f);
+
+          SetVoices();
         }
         void Unload() override {
           vca_level.Release();
@@ -88,7 +90,7 @@ class HandSawApplet : public HemisphereAudioApplet {
             float detuneValue = detune + (detune_cv.In() * 0.01f);
             float phaseValue = phase + (phase_cv.In() * 0.01f);
 
-            float freq1 = PitchToRatio(pitch1 + pitch_cv1.In()) * C3;
+            float freq1 = PitchToHz(pitch1 + pitch_cv1.In());
             // set the first 3 oscillators to freq1
             synth1.frequency(freq1);
             synth2.frequency(freq1 + (3 * detuneValue / detuneFactor));
@@ -97,7 +99,7 @@ class HandSawApplet : public HemisphereAudioApplet {
             synth2.phase((3 * phaseValue / phaseFactor));
             synth3.phase((2 * phaseValue / phaseFactor));
 
-            float freq2 = PitchToRatio(pitch2 + pitch_cv2.In()) * C3;
+            float freq2 = PitchToHz(pitch2 + pitch_cv2.In());
             // set the next 3 oscillators to freq2
             synth4.frequency(freq2 + (detuneValue / detuneFactor));
             synth5.frequency(freq2 + (4 * detuneValue / detuneFactor));
@@ -106,7 +108,7 @@ class HandSawApplet : public HemisphereAudioApplet {
             synth5.phase((4 * phaseValue / phaseFactor));
             synth6.phase((5 * phaseValue / phaseFactor));
 
-            float freq3 = PitchToRatio(pitch3 + pitch_cv3.In()) * C3;
+            float freq3 = PitchToHz(pitch3 + pitch_cv3.In());
             // set the last 3 oscillators to freq3
             synth7.frequency(freq3 - (detuneValue / detuneFactor));
             synth8.frequency(freq3 + (2 * detuneValue / detuneFactor));
@@ -115,7 +117,7 @@ class HandSawApplet : public HemisphereAudioApplet {
             synth8.phase((2 * phaseValue / phaseFactor));
             synth9.phase((3 * phaseValue / phaseFactor));
 
-            float freq4 = PitchToRatio(pitch4 + pitch_cv4.In()) * C3;
+            float freq4 = PitchToHz(pitch4 + pitch_cv4.In());
             // set the last 3 oscillators to freq4
             synth10.frequency(freq4 + (6 * detuneValue / detuneFactor));
             synth11.frequency(freq4 + (5 * detuneValue / detuneFactor));
@@ -301,6 +303,15 @@ class HandSawApplet : public HemisphereAudioApplet {
             }
         }
 
+        // Each step silences one more oscillator per stack, which the
+        // waveform then skips
+        uint8_t MaxQualityReduction() override {
+            return 2;
+        }
+        void OnQualityReduction(uint8_t level) override {
+            SetVoices();
+        }
+
         AudioStream* InputStream() override {
             return &input_stream;
         }
@@ -311,6 +322,24 @@ class HandSawApplet : public HemisphereAudioApplet {
         void SetHelp() override {}
     
     private:
+        void SetVoices() {
+            AudioSynthWaveform* stacks[4][3] = {
+                {&synth1, &synth2, &synth3},
+                {&synth4, &synth5, &synth6},
+                {&synth7, &synth8, &synth9},
+                {&synth10, &synth11, &synth12},
+            };
+            AudioMixer<3>* mixers[4] = {&mixer1, &mixer2, &mixer3, &mixer4};
+            const int voices = 3 - QualityReduction();
+            const float gain = voices == 3 ? 0.33f : 1.0f / voices;
+            for (int stack = 0; stack < 4; stack++) {
+                for (int v = 0; v < 3; v++) {
+                    stacks[stack][v]->amplitude(v < voices ? 1.0f : 0.0f);
+                    mixers[stack]->gain(v, v < voices ? gain : 0.0f);
+                }
+            }
+        }
+
         enum Cursor: int8_t {
             PITCH1,
             PITCH_CV1,
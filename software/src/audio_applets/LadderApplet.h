@@ -1,6 +1,7 @@
 #include "HSUtils.h"
 #include "HemisphereAudioApplet.h"
 #include "dsputils.h"
+#include "Audio/AudioLadderFilter.h"
 #include "Audio/AudioPassthrough.h"
 #include <Audio.h>
 
@@ -17,11 +18,12 @@ public:
       PatchCable(input, i, filters[i], 0);
       PatchCable(filters[i], 0, output, i);
     }
+    ApplyQuality();
   }
 
   void Controller() {
     for (int i = 0; i < Channels; i++) {
-      filters[i].frequency(PitchToRatio(pitch + pitch_cv.In()) * C3);
+      filters[i].frequency(PitchToHz(pitch + pitch_cv.In()));
       filters[i].resonance(0.01f * res + res_cv.InF());
       filters[i].inputDrive(0.01f * gain + gain_cv.InF());
       filters[i].passbandGain(0.01f * pb_gain);
@@ -58,6 +60,13 @@ public:
     graphics.printf("%3d", pb_gain);
     gfxEndCursor(cursor == 6);
 
+    gfxPrint(label_x, 55, "OS: ");
+    gfxStartCursor();
+    graphics.printf("%dx", 1 << os_shift);
+    gfxEndCursor(cursor == 7);
+    // Stepped down for CPU
+    if (EffectiveShift() < os_shift) graphics.printf("->%dx", 1 << EffectiveShift());
+
     gfxDisplayInputMapEditor();
   }
 
@@ -74,7 +83,7 @@ public:
 
   void OnEncoderMove(int direction) override {
     if (!EditMode()) {
-      MoveCursor(cursor, direction, 6);
+      MoveCursor(cursor, direction, 7);
       return;
     }
     if(EditSelectedInputMap(direction)) return;
@@ -100,17 +109,35 @@ public:
       case 6:
         pb_gain = constrain(pb_gain + direction, 0, 50);
         break;
+      case 7:
+        os_shift = constrain(os_shift + direction, 0, MAX_OS_SHIFT);
+        ApplyQuality();
+        break;
     }
   }
 
   void OnDataRequest(std::array<uint64_t, CONFIG_SIZE>& data) {
     data[0] = PackPackables(pitch, res, gain, pb_gain);
-    data[1] = PackPackables(pitch_cv, res_cv, gain_cv);
+    // As 2 - shift, so patches saved before there was a choice, or at 4x,
+    // load at 2x
+    uint8_t os_saved = 2 - os_shift;
+    data[1] = PackPackables(pitch_cv, res_cv, gain_cv, pack<2>(os_saved));
   }
 
   void OnDataReceive(const std::array<uint64_t, CONFIG_SIZE>& data) {
     UnpackPackables(data[0], pitch, res, gain, pb_gain);
-    UnpackPackables(data[1], pitch_cv, res_cv, gain_cv);
+    uint8_t os_saved = 0;
+    UnpackPackables(data[1], pitch_cv, res_cv, gain_cv, pack<2>(os_saved));
+    os_shift = constrain(2 - os_saved, 0, MAX_OS_SHIFT);
+    ApplyQuality();
+  }
+
+  // Oversampling is most of the filter's cost
+  uint8_t MaxQualityReduction() override {
+    return 1;
+  }
+  void OnQualityReduction(uint8_t) override {
+    ApplyQuality();
   }
 
   AudioStream* InputStream() override {
@@ -129,11 +156,32 @@ private:
   int16_t res = 0;
   int16_t gain = 100;
   int16_t pb_gain = 50;
+  // log2 of the oversampling
+  static const uint8_t MAX_OS_SHIFT = 1;
+  uint8_t os_shift = MAX_OS_SHIFT;
   CVInputMap pitch_cv;
   CVInputMap res_cv;
   CVInputMap gain_cv;
 
+  // Each quality step halves the oversampling, down to 1x, where the cutoff
+  // tops out around 8 kHz
+  uint8_t EffectiveShift() {
+    const uint8_t level = QualityReduction();
+    return os_shift > level ? os_shift - level : 0;
+  }
+
+  // Reduced, it also swaps the rational saturator for the cubic
+  void ApplyQuality() {
+    const uint8_t level = QualityReduction();
+    for (int i = 0; i < Channels; i++) {
+      filters[i].oversampling(1 << EffectiveShift());
+      filters[i].saturation(
+        level ? LADDER_SATURATION_POLYNOMIAL : LADDER_SATURATION_RATIONAL
+      );
+    }
+  }
+
   AudioPassthrough<Channels> input;
-  std::array<AudioFilterLadder, Channels> filters;
+  std::array<AudioLadderFilter, Channels> filters;
   AudioPassthrough<Channels> output;
 };
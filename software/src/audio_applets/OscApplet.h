@@ -45,7 +45,7 @@ public:
   }
 
   void Controller() override {
-    float freq = PitchToRatio(pitch + pitch_cv.In()) * C3;
+    float freq = PitchToHz(pitch + pitch_cv.In());
     synth.frequency(freq);
     synth.amplitude(1.0f);
     pwm_stream.Push(
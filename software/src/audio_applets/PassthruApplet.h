@@ -16,6 +16,9 @@ public:
   }
   void OnDataReceive(uint64_t data) override {}
   void OnEncoderMove(int direction) override {}
+  bool Bypassed() override {
+    return true;
+  }
 
   AudioStream* InputStream() override {
     return &passthru;
@@ -6,24 +6,31 @@
 #include "Audio/AudioMixer.h"
 #include "Audio/AudioPassthrough.h"
 #include "Audio/InterpolatingStream.h"
+#include "Audio/effect_reverb_schroeder.h"
 #include <Audio.h>
-#include <Audio/effect_reverb_schroeder.h>
 
+template <AudioChannels Channels>
 class BungverbApplet : public HemisphereAudioApplet {
     public:
         const char* applet_name() override {
             return "Bungverb";
         }
         void Start() override {
-            if (!reverb && OC::CORE::FreeRam() > (int)sizeof(AudioEffectReverbSchroeder)) {
-              reverb = new AudioEffectReverbSchroeder();
+            if (!reverb && OC::CORE::FreeRam() > (int)sizeof(Reverb)) {
+              reverb = new Reverb();
+            }
+            for (int ch = 0; ch < Channels; ++ch) {
+              PatchCable(input, ch, dry_wet_mixer[ch], 1);
+              PatchCable(dry_wet_mixer[ch], 0, output, ch);
             }
-            PatchCable(input, 0, dry_wet_mixer, 1);
             if (!reverb) return;
-            filter.frequency(15000);
-            PatchCable(input, 0, *reverb, 0);
-            PatchCable(*reverb, 0, filter, 0);
-            PatchCable(filter, 0, dry_wet_mixer, 0);
+            OnQualityReduction(QualityReduction());
+            for (int ch = 0; ch < Channels; ++ch) {
+              PatchCable(input, ch, *reverb, ch);
+              PatchCable(*reverb, ch, filter[ch], 0);
+              PatchCable(filter[ch], 0, dry_wet_mixer[ch], 0);
+              filter[ch].frequency(15000);
+            }
         }
 
         void Controller() override {
@@ -31,18 +38,20 @@ class BungverbApplet : public HemisphereAudioApplet {
               reverb->setDecayTime(decay_time + decay_time_cv.InF());
               reverb->setDamping(1.0f - ((damp * 0.01f) + damp_cv.InF()));
             } else {
-              dry_wet_mixer.gain(1, 1.0f);
+              for (auto& m : dry_wet_mixer) m.gain(1, 1.0f);
               return;
             }
 
             float freq = constrain(static_cast<float>(cutoff)
               + (cutoff_cv.InF() * abs(cutoff_cv.InF()) * 18000.0), 10.0f, 20000.0);
-            filter.frequency(freq);
+            for (auto& f : filter) f.frequency(freq);
 
             float m = constrain(static_cast<float>(mix) * 0.01f + mix_cv.InF(), 0.0f, 1.0f);
 
-            dry_wet_mixer.gain(0, m);
-            dry_wet_mixer.gain(1, 1.0f - m);
+            for (auto& mixer : dry_wet_mixer) {
+              mixer.gain(0, m);
+              mixer.gain(1, 1.0f - m);
+            }
         }
 
         void View() override {
@@ -152,11 +161,19 @@ class BungverbApplet : public HemisphereAudioApplet {
             }
         }
 
+        // Half the combs
+        uint8_t MaxQualityReduction() override {
+            return reverb ? 1 : 0;
+        }
+        void OnQualityReduction(uint8_t level) override {
+            if (reverb) reverb->setCombCount(level ? 4 : 8);
+        }
+
         AudioStream* InputStream() override {
             return &input;
         }
         AudioStream* OutputStream() override {
-            return &dry_wet_mixer;
+            return &output;
         }
     protected:
         void SetHelp() override {}
@@ -174,12 +191,15 @@ class BungverbApplet : public HemisphereAudioApplet {
         };
 
         int8_t cursor = DECAY_TIME;
-        AudioPassthrough<MONO> input;
+        using Reverb = AudioEffectReverbSchroeder<Channels>;
+
+        AudioPassthrough<Channels> input;
 
-        AudioEffectReverbSchroeder* reverb;
-        AudioFilterStateVariable filter;
+        Reverb* reverb = nullptr;
+        AudioFilterStateVariable filter[Channels];
 
-        AudioMixer<2> dry_wet_mixer;
+        AudioMixer<2> dry_wet_mixer[Channels];
+        AudioPassthrough<Channels> output;
 
         int8_t mix = 50;
         float decay_time = 1.0f;
@@ -57,9 +57,12 @@ public:
         gfxPrint("Lin");
         break;
       case INTERPOLATION_HERMITE:
-      default:
         gfxPrint("Spl");
         break;
+      case INTERPOLATION_POLYPHASE:
+      default:
+        gfxPrint("Snc");
+        break;
     }
     gfxEndCursor(cursor == 1);
 
@@ -105,7 +108,7 @@ public:
         input.ChangeSource(direction);
         break;
       case 1:
-        method = constrain(method + direction, 0, 2);
+        method = constrain(method + direction, 0, 3);
         interp_stream.Method(static_cast<InterpolationMethod>(method));
         break;
       case 2:
@@ -126,7 +129,7 @@ public:
     UnpackPackables(data[0], pack(gain), pack<1>(ac_couple), pack<2>(method));
     UnpackPackables(data[1], input, gain_cv);
     CONSTRAIN(gain, LVL_MIN_DB, LVL_MAX_DB);
-    CONSTRAIN(method, 0, 2);
+    CONSTRAIN(method, 0, 3);
   }
 
   AudioStream* InputStream() override {
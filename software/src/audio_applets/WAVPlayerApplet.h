@@ -8,7 +8,11 @@
  *   002.WAV
  *   ...
  *
- * Sync mode will automatically lock tempo with the internal clock.
+ * Sync mode will automatically lock tempo with the internal clock. A file's
+ * tempo is guessed from its length, as a whole number of 4/4 bars.
+ *
+ * The start of the current file and its neighbours is kept in a PSRAM pool
+ * shared by all players, so stepping through files starts them instantly.
  *
  */
 
@@ -16,7 +20,18 @@
 #include "CVInputMap.h"
 #include "HemisphereAudioApplet.h"
 #include "OC_gpio.h"
-#include <TeensyVariablePlayback.h>
+#include "Audio/AudioPlayWavStream.h"
+#include "Audio/WavSamplePool.h"
+
+extern "C" uint8_t external_psram_size;
+
+// Shared by every WAV player, so a file cached by one is a hit for the others
+inline WavSamplePool& SamplePool() {
+  static WavSamplePool pool(
+    external_psram_size ? WavSamplePool::MAX_SLOTS : 0
+  );
+  return pool;
+}
 
 template <AudioChannels Channels>
 class WavPlayerApplet : public HemisphereAudioApplet {
@@ -52,13 +67,11 @@ public:
     if (!SDcard_Ready) {
       Serial.println("Unable to access the SD card");
     }
-    else {
-      wavplayer.enableInterpolation(true);
-      wavplayer.setBufferInPSRAM(false);
-    }
   }
   void Unload() {
-    wavplayer.stop();
+    wavplayer.close();
+    SamplePool().Release(sample);
+    sample = nullptr;
     AllowRestart();
   }
 
@@ -117,18 +130,27 @@ public:
           retrig = false;
         }
         if (retrig) {
-          if (wavplayer.available()) {
+          if (wavplayer.isOpen()) {
             wavplayer.retrigger();
             loop_count = 0;
           }
           retrig = false;
         }
 
-
         if (tempo_sync && sync_trig) {
-          wavplayer.syncTrig();
+          // Only small drift is corrected, so the head stays in the
+          // prefetched window
+          wavplayer.nudgeToGrid(FileBeatFrames(), SYNC_MAX_FRAMES);
           sync_trig = false;
         }
+
+        wavplayer.prefetch();
+
+        // Then the neighbouring files, a little at a time
+        WavSamplePool& pool = SamplePool();
+        pool.Service();
+        if (!pool.Busy() && pool.Preload(wavplayer_select + 1))
+          pool.Preload(wavplayer_select - 1);
     }
   }
 
@@ -183,6 +205,9 @@ public:
 
       gfxPos(1, y);
       graphics.printf("%02lu:%02lu.%03lu", tmin, tsec, tmilli);
+    } else if (SamplePool().Requests()) {
+      gfxPos(1, y);
+      graphics.printf("Pool %3d%%", SamplePool().HitPercent());
     }
 
     y += 10;
@@ -346,7 +371,7 @@ private:
   bool retrig = false;
 
   AudioPassthrough<Channels> input;
-  AudioPlaySdResmp      wavplayer;
+  AudioPlayWavStream    wavplayer;
   AudioFilterStateVariable hpfilter[2];
   AudioMixer4           mixer[2];
   AudioPassthrough<Channels> output;
@@ -355,6 +380,8 @@ private:
   bool wavplayer_reload = true;
   bool wavplayer_playtrig = false;
   bool wavplayer_ready = false;
+  const WavSamplePool::Sample* sample = nullptr;
+  float file_bpm = 120.0f;
   uint16_t wavplayer_select = 1;
   uint8_t loop_length = 8;
   int8_t loop_count = 0;
@@ -363,11 +390,34 @@ private:
 
   // SD file player functions
   void FileLoad() {
-    char filename[] = "000.WAV";
-    filename[0] += wavplayer_select / 100;
-    filename[1] += wavplayer_select / 10 % 10;
-    filename[2] += wavplayer_select % 10;
-    wavplayer_ready = wavplayer.playWav(filename);
+    char filename[8];
+    WavSamplePool::FileName(wavplayer_select, filename);
+    // The stream plays from the pool's copy, so let go of it only after
+    wavplayer.close();
+    SamplePool().Release(sample);
+    sample = SamplePool().Acquire(wavplayer_select);
+    if (sample) {
+      wavplayer_ready = wavplayer.open(
+        filename, sample->info, sample->data, sample->frames
+      );
+    } else {
+      wavplayer_ready = wavplayer.open(filename);
+    }
+    loop_on = false;
+    file_bpm = EstimateBPM();
+  }
+  // The file as 2^k bars of 4/4, whichever puts it in [80, 160) BPM
+  float EstimateBPM() {
+    if (!wavplayer_ready || !wavplayer.lengthFrames()) return 120.0f;
+    const float secs
+      = static_cast<float>(wavplayer.lengthFrames()) / wavplayer.sampleRate();
+    float bpm = 240.0f / secs;
+    while (bpm < 80.0f) bpm *= 2.0f;
+    while (bpm >= 160.0f) bpm *= 0.5f;
+    return bpm;
+  }
+  float FileBeatFrames() {
+    return wavplayer.sampleRate() * 60.0f / file_bpm;
   }
   void StartPlaying() {
     wavplayer_playtrig = true;
@@ -379,7 +429,7 @@ private:
   void ToggleFilePlayer() {
     if (wavplayer.isPlaying()) {
       wavplayer.stop();
-      wavplayer.setPlayStart(play_start_sample);
+      wavplayer.setPlayStart(0);
       loop_on = false;
     } else if (SDcard_Ready) {
       StartPlaying();
@@ -388,19 +438,20 @@ private:
   void ToggleLoop() {
     if (loop_length && !loop_on) {
       const uint32_t start = wavplayer.isPlaying() ?
-                    wavplayer.getPosition() : 0;
-      wavplayer.setLoopStart( start );
-      wavplayer.setPlayStart(play_start_loop);
-      if (wavplayer.available())
+                    wavplayer.positionFrames() : 0;
+      wavplayer.setPlayStart(start);
+      if (wavplayer.isOpen())
         wavplayer.retrigger();
       loop_on = true;
       loop_count = 0;
     } else {
-      wavplayer.setPlayStart(play_start_sample);
+      wavplayer.setPlayStart(0);
       loop_on = false;
     }
   }
 
+  // Within the frames kept behind the play head
+  static constexpr uint32_t SYNC_MAX_FRAMES = WavStream::BEHIND_FRAMES;
   static constexpr int FILTER_MAX = (60 << 7); // 5V ~ 14.4khz
   void SetFilter(int scalar) {
     lowcut = (scalar < 0);
@@ -437,12 +488,12 @@ private:
     return wavplayer.positionMillis();
   }
   uint16_t GetFileBPM() {
-    return (uint16_t)wavplayer.getBPM();
+    return (uint16_t)(file_bpm + 0.5f);
   }
   void FileMatchTempo() {
-    wavplayer.matchTempo(
-      HS::clock_m.GetTempoFloat() * (playrate * 0.01f + playrate_cv.InF(0.0f))
-    );
+    const float bpm
+      = HS::clock_m.GetTempoFloat() * (playrate * 0.01f + playrate_cv.InF(0.0f));
+    wavplayer.setPlaybackRate(bpm / file_bpm);
   }
   void FileLevel(float lvl) {
     bool dry = (djfilter_mod < 2 && djfilter_mod > -2);
@@ -18,1330 +18,30 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 //
-// Bjorklund (Euclidean) patterns, generated by resources/bjorklund.py
+// Bjorklund (Euclidean) patterns
 
 #include "bjorklund.h"
 
-const uint32_t bjorklund_patterns[] = {
-// 2 step patterns
-//  0 beats 00
-//  1 beats 10
-//  2 beats 11
-//  3 beats 00
-//  4 beats 00
-//  5 beats 00
-//  6 beats 00
-//  7 beats 00
-//  8 beats 00
-//  9 beats 00
-// 10 beats 00
-// 11 beats 00
-// 12 beats 00
-// 13 beats 00
-// 14 beats 00
-// 15 beats 00
-// 16 beats 00
-// 17 beats 00
-// 18 beats 00
-// 19 beats 00
-// 20 beats 00
-// 21 beats 00
-// 22 beats 00
-// 23 beats 00
-// 24 beats 00
-// 25 beats 00
-// 26 beats 00
-// 27 beats 00
-// 28 beats 00
-// 29 beats 00
-// 30 beats 00
-// 31 beats 00
-// 32 beats 00
-0 , 1 , 3 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 3 step patterns
-//  0 beats 000
-//  1 beats 100
-//  2 beats 110
-//  3 beats 111
-//  4 beats 000
-//  5 beats 000
-//  6 beats 000
-//  7 beats 000
-//  8 beats 000
-//  9 beats 000
-// 10 beats 000
-// 11 beats 000
-// 12 beats 000
-// 13 beats 000
-// 14 beats 000
-// 15 beats 000
-// 16 beats 000
-// 17 beats 000
-// 18 beats 000
-// 19 beats 000
-// 20 beats 000
-// 21 beats 000
-// 22 beats 000
-// 23 beats 000
-// 24 beats 000
-// 25 beats 000
-// 26 beats 000
-// 27 beats 000
-// 28 beats 000
-// 29 beats 000
-// 30 beats 000
-// 31 beats 000
-// 32 beats 000
-0 , 1 , 3 , 7 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 4 step patterns
-//  0 beats 0000
-//  1 beats 1000
-//  2 beats 1010
-//  3 beats 1110
-//  4 beats 1111
-//  5 beats 0000
-//  6 beats 0000
-//  7 beats 0000
-//  8 beats 0000
-//  9 beats 0000
-// 10 beats 0000
-// 11 beats 0000
-// 12 beats 0000
-// 13 beats 0000
-// 14 beats 0000
-// 15 beats 0000
-// 16 beats 0000
-// 17 beats 0000
-// 18 beats 0000
-// 19 beats 0000
-// 20 beats 0000
-// 21 beats 0000
-// 22 beats 0000
-// 23 beats 0000
-// 24 beats 0000
-// 25 beats 0000
-// 26 beats 0000
-// 27 beats 0000
-// 28 beats 0000
-// 29 beats 0000
-// 30 beats 0000
-// 31 beats 0000
-// 32 beats 0000
-0 , 1 , 5 , 7 ,
-15 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 5 step patterns
-//  0 beats 00000
-//  1 beats 10000
-//  2 beats 10100
-//  3 beats 10101
-//  4 beats 11110
-//  5 beats 11111
-//  6 beats 00000
-//  7 beats 00000
-//  8 beats 00000
-//  9 beats 00000
-// 10 beats 00000
-// 11 beats 00000
-// 12 beats 00000
-// 13 beats 00000
-// 14 beats 00000
-// 15 beats 00000
-// 16 beats 00000
-// 17 beats 00000
-// 18 beats 00000
-// 19 beats 00000
-// 20 beats 00000
-// 21 beats 00000
-// 22 beats 00000
-// 23 beats 00000
-// 24 beats 00000
-// 25 beats 00000
-// 26 beats 00000
-// 27 beats 00000
-// 28 beats 00000
-// 29 beats 00000
-// 30 beats 00000
-// 31 beats 00000
-// 32 beats 00000
-0 , 1 , 5 , 21 ,
-15 , 31 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 6 step patterns
-//  0 beats 000000
-//  1 beats 100000
-//  2 beats 100100
-//  3 beats 101010
-//  4 beats 110110
-//  5 beats 111110
-//  6 beats 111111
-//  7 beats 000000
-//  8 beats 000000
-//  9 beats 000000
-// 10 beats 000000
-// 11 beats 000000
-// 12 beats 000000
-// 13 beats 000000
-// 14 beats 000000
-// 15 beats 000000
-// 16 beats 000000
-// 17 beats 000000
-// 18 beats 000000
-// 19 beats 000000
-// 20 beats 000000
-// 21 beats 000000
-// 22 beats 000000
-// 23 beats 000000
-// 24 beats 000000
-// 25 beats 000000
-// 26 beats 000000
-// 27 beats 000000
-// 28 beats 000000
-// 29 beats 000000
-// 30 beats 000000
-// 31 beats 000000
-// 32 beats 000000
-0 , 1 , 9 , 21 ,
-27 , 31 , 63 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 7 step patterns
-//  0 beats 0000000
-//  1 beats 1000000
-//  2 beats 1001000
-//  3 beats 1010100
-//  4 beats 1010101
-//  5 beats 1101101
-//  6 beats 1111110
-//  7 beats 1111111
-//  8 beats 0000000
-//  9 beats 0000000
-// 10 beats 0000000
-// 11 beats 0000000
-// 12 beats 0000000
-// 13 beats 0000000
-// 14 beats 0000000
-// 15 beats 0000000
-// 16 beats 0000000
-// 17 beats 0000000
-// 18 beats 0000000
-// 19 beats 0000000
-// 20 beats 0000000
-// 21 beats 0000000
-// 22 beats 0000000
-// 23 beats 0000000
-// 24 beats 0000000
-// 25 beats 0000000
-// 26 beats 0000000
-// 27 beats 0000000
-// 28 beats 0000000
-// 29 beats 0000000
-// 30 beats 0000000
-// 31 beats 0000000
-// 32 beats 0000000
-0 , 1 , 9 , 21 ,
-85 , 91 , 63 , 127 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 8 step patterns
-//  0 beats 00000000
-//  1 beats 10000000
-//  2 beats 10001000
-//  3 beats 10010010
-//  4 beats 10101010
-//  5 beats 10110110
-//  6 beats 11101110
-//  7 beats 11111110
-//  8 beats 11111111
-//  9 beats 00000000
-// 10 beats 00000000
-// 11 beats 00000000
-// 12 beats 00000000
-// 13 beats 00000000
-// 14 beats 00000000
-// 15 beats 00000000
-// 16 beats 00000000
-// 17 beats 00000000
-// 18 beats 00000000
-// 19 beats 00000000
-// 20 beats 00000000
-// 21 beats 00000000
-// 22 beats 00000000
-// 23 beats 00000000
-// 24 beats 00000000
-// 25 beats 00000000
-// 26 beats 00000000
-// 27 beats 00000000
-// 28 beats 00000000
-// 29 beats 00000000
-// 30 beats 00000000
-// 31 beats 00000000
-// 32 beats 00000000
-0 , 1 , 17 , 73 ,
-85 , 109 , 119 , 127 ,
-255 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 9 step patterns
-//  0 beats 000000000
-//  1 beats 100000000
-//  2 beats 100010000
-//  3 beats 100100100
-//  4 beats 101010100
-//  5 beats 101010101
-//  6 beats 110110110
-//  7 beats 111011101
-//  8 beats 111111110
-//  9 beats 111111111
-// 10 beats 000000000
-// 11 beats 000000000
-// 12 beats 000000000
-// 13 beats 000000000
-// 14 beats 000000000
-// 15 beats 000000000
-// 16 beats 000000000
-// 17 beats 000000000
-// 18 beats 000000000
-// 19 beats 000000000
-// 20 beats 000000000
-// 21 beats 000000000
-// 22 beats 000000000
-// 23 beats 000000000
-// 24 beats 000000000
-// 25 beats 000000000
-// 26 beats 000000000
-// 27 beats 000000000
-// 28 beats 000000000
-// 29 beats 000000000
-// 30 beats 000000000
-// 31 beats 000000000
-// 32 beats 000000000
-0 , 1 , 17 , 73 ,
-85 , 341 , 219 , 375 ,
-255 , 511 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 10 step patterns
-//  0 beats 0000000000
-//  1 beats 1000000000
-//  2 beats 1000010000
-//  3 beats 1001001000
-//  4 beats 1010010100
-//  5 beats 1010101010
-//  6 beats 1010110101
-//  7 beats 1101101101
-//  8 beats 1111011110
-//  9 beats 1111111110
-// 10 beats 1111111111
-// 11 beats 0000000000
-// 12 beats 0000000000
-// 13 beats 0000000000
-// 14 beats 0000000000
-// 15 beats 0000000000
-// 16 beats 0000000000
-// 17 beats 0000000000
-// 18 beats 0000000000
-// 19 beats 0000000000
-// 20 beats 0000000000
-// 21 beats 0000000000
-// 22 beats 0000000000
-// 23 beats 0000000000
-// 24 beats 0000000000
-// 25 beats 0000000000
-// 26 beats 0000000000
-// 27 beats 0000000000
-// 28 beats 0000000000
-// 29 beats 0000000000
-// 30 beats 0000000000
-// 31 beats 0000000000
-// 32 beats 0000000000
-0 , 1 , 33 , 73 ,
-165 , 341 , 693 , 731 ,
-495 , 511 , 1023 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 11 step patterns
-//  0 beats 00000000000
-//  1 beats 10000000000
-//  2 beats 10000100000
-//  3 beats 10001000100
-//  4 beats 10010010010
-//  5 beats 10101010100
-//  6 beats 10101010101
-//  7 beats 10110110110
-//  8 beats 11011101110
-//  9 beats 11110111101
-// 10 beats 11111111110
-// 11 beats 11111111111
-// 12 beats 00000000000
-// 13 beats 00000000000
-// 14 beats 00000000000
-// 15 beats 00000000000
-// 16 beats 00000000000
-// 17 beats 00000000000
-// 18 beats 00000000000
-// 19 beats 00000000000
-// 20 beats 00000000000
-// 21 beats 00000000000
-// 22 beats 00000000000
-// 23 beats 00000000000
-// 24 beats 00000000000
-// 25 beats 00000000000
-// 26 beats 00000000000
-// 27 beats 00000000000
-// 28 beats 00000000000
-// 29 beats 00000000000
-// 30 beats 00000000000
-// 31 beats 00000000000
-// 32 beats 00000000000
-0 , 1 , 33 , 273 ,
-585 , 341 , 1365 , 877 ,
-955 , 1519 , 1023 , 2047 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 12 step patterns
-//  0 beats 000000000000
-//  1 beats 100000000000
-//  2 beats 100000100000
-//  3 beats 100010001000
-//  4 beats 100100100100
-//  5 beats 101001010010
-//  6 beats 101010101010
-//  7 beats 101011010110
-//  8 beats 110110110110
-//  9 beats 111011101110
-// 10 beats 111110111110
-// 11 beats 111111111110
-// 12 beats 111111111111
-// 13 beats 000000000000
-// 14 beats 000000000000
-// 15 beats 000000000000
-// 16 beats 000000000000
-// 17 beats 000000000000
-// 18 beats 000000000000
-// 19 beats 000000000000
-// 20 beats 000000000000
-// 21 beats 000000000000
-// 22 beats 000000000000
-// 23 beats 000000000000
-// 24 beats 000000000000
-// 25 beats 000000000000
-// 26 beats 000000000000
-// 27 beats 000000000000
-// 28 beats 000000000000
-// 29 beats 000000000000
-// 30 beats 000000000000
-// 31 beats 000000000000
-// 32 beats 000000000000
-0 , 1 , 65 , 273 ,
-585 , 1189 , 1365 , 1717 ,
-1755 , 1911 , 2015 , 2047 ,
-4095 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 13 step patterns
-//  0 beats 0000000000000
-//  1 beats 1000000000000
-//  2 beats 1000001000000
-//  3 beats 1000100010000
-//  4 beats 1001001001000
-//  5 beats 1001010010100
-//  6 beats 1010101010100
-//  7 beats 1010101010101
-//  8 beats 1011010110101
-//  9 beats 1101101101101
-// 10 beats 1110111011101
-// 11 beats 1111101111101
-// 12 beats 1111111111110
-// 13 beats 1111111111111
-// 14 beats 0000000000000
-// 15 beats 0000000000000
-// 16 beats 0000000000000
-// 17 beats 0000000000000
-// 18 beats 0000000000000
-// 19 beats 0000000000000
-// 20 beats 0000000000000
-// 21 beats 0000000000000
-// 22 beats 0000000000000
-// 23 beats 0000000000000
-// 24 beats 0000000000000
-// 25 beats 0000000000000
-// 26 beats 0000000000000
-// 27 beats 0000000000000
-// 28 beats 0000000000000
-// 29 beats 0000000000000
-// 30 beats 0000000000000
-// 31 beats 0000000000000
-// 32 beats 0000000000000
-0 , 1 , 65 , 273 ,
-585 , 1321 , 1365 , 5461 ,
-5549 , 5851 , 6007 , 6111 ,
-4095 , 8191 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 14 step patterns
-//  0 beats 00000000000000
-//  1 beats 10000000000000
-//  2 beats 10000001000000
-//  3 beats 10000100001000
-//  4 beats 10010001001000
-//  5 beats 10010010010010
-//  6 beats 10101001010100
-//  7 beats 10101010101010
-//  8 beats 10101011010101
-//  9 beats 10110110110110
-// 10 beats 11011011101101
-// 11 beats 11101111011110
-// 12 beats 11111101111110
-// 13 beats 11111111111110
-// 14 beats 11111111111111
-// 15 beats 00000000000000
-// 16 beats 00000000000000
-// 17 beats 00000000000000
-// 18 beats 00000000000000
-// 19 beats 00000000000000
-// 20 beats 00000000000000
-// 21 beats 00000000000000
-// 22 beats 00000000000000
-// 23 beats 00000000000000
-// 24 beats 00000000000000
-// 25 beats 00000000000000
-// 26 beats 00000000000000
-// 27 beats 00000000000000
-// 28 beats 00000000000000
-// 29 beats 00000000000000
-// 30 beats 00000000000000
-// 31 beats 00000000000000
-// 32 beats 00000000000000
-0 , 1 , 129 , 1057 ,
-1161 , 4681 , 2709 , 5461 ,
-10965 , 7021 , 11739 , 7927 ,
-8127 , 8191 , 16383 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 15 step patterns
-//  0 beats 000000000000000
-//  1 beats 100000000000000
-//  2 beats 100000010000000
-//  3 beats 100001000010000
-//  4 beats 100010001000100
-//  5 beats 100100100100100
-//  6 beats 101001010010100
-//  7 beats 101010101010100
-//  8 beats 101010101010101
-//  9 beats 101011010110101
-// 10 beats 110110110110110
-// 11 beats 110111011101110
-// 12 beats 111101111011110
-// 13 beats 111111011111101
-// 14 beats 111111111111110
-// 15 beats 111111111111111
-// 16 beats 000000000000000
-// 17 beats 000000000000000
-// 18 beats 000000000000000
-// 19 beats 000000000000000
-// 20 beats 000000000000000
-// 21 beats 000000000000000
-// 22 beats 000000000000000
-// 23 beats 000000000000000
-// 24 beats 000000000000000
-// 25 beats 000000000000000
-// 26 beats 000000000000000
-// 27 beats 000000000000000
-// 28 beats 000000000000000
-// 29 beats 000000000000000
-// 30 beats 000000000000000
-// 31 beats 000000000000000
-// 32 beats 000000000000000
-0 , 1 , 129 , 1057 ,
-4369 , 4681 , 5285 , 5461 ,
-21845 , 22197 , 14043 , 15291 ,
-15855 , 24511 , 16383 , 32767 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 16 step patterns
-//  0 beats 0000000000000000
-//  1 beats 1000000000000000
-//  2 beats 1000000010000000
-//  3 beats 1000010000100000
-//  4 beats 1000100010001000
-//  5 beats 1001001001001000
-//  6 beats 1001001010010010
-//  7 beats 1010100101010010
-//  8 beats 1010101010101010
-//  9 beats 1010101101010110
-// 10 beats 1011011010110110
-// 11 beats 1101101101101101
-// 12 beats 1110111011101110
-// 13 beats 1111011110111101
-// 14 beats 1111111011111110
-// 15 beats 1111111111111110
-// 16 beats 1111111111111111
-// 17 beats 0000000000000000
-// 18 beats 0000000000000000
-// 19 beats 0000000000000000
-// 20 beats 0000000000000000
-// 21 beats 0000000000000000
-// 22 beats 0000000000000000
-// 23 beats 0000000000000000
-// 24 beats 0000000000000000
-// 25 beats 0000000000000000
-// 26 beats 0000000000000000
-// 27 beats 0000000000000000
-// 28 beats 0000000000000000
-// 29 beats 0000000000000000
-// 30 beats 0000000000000000
-// 31 beats 0000000000000000
-// 32 beats 0000000000000000
-0 , 1 , 257 , 1057 ,
-4369 , 4681 , 18761 , 19093 ,
-21845 , 27349 , 28013 , 46811 ,
-30583 , 48623 , 32639 , 32767 ,
-65535 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 17 step patterns
-//  0 beats 00000000000000000
-//  1 beats 10000000000000000
-//  2 beats 10000000100000000
-//  3 beats 10000010000010000
-//  4 beats 10001000100010000
-//  5 beats 10010001001000100
-//  6 beats 10010010010010010
-//  7 beats 10100101001010010
-//  8 beats 10101010101010100
-//  9 beats 10101010101010101
-// 10 beats 10101101011010110
-// 11 beats 10110110110110110
-// 12 beats 11011011101101110
-// 13 beats 11101110111011101
-// 14 beats 11110111110111110
-// 15 beats 11111110111111101
-// 16 beats 11111111111111110
-// 17 beats 11111111111111111
-// 18 beats 00000000000000000
-// 19 beats 00000000000000000
-// 20 beats 00000000000000000
-// 21 beats 00000000000000000
-// 22 beats 00000000000000000
-// 23 beats 00000000000000000
-// 24 beats 00000000000000000
-// 25 beats 00000000000000000
-// 26 beats 00000000000000000
-// 27 beats 00000000000000000
-// 28 beats 00000000000000000
-// 29 beats 00000000000000000
-// 30 beats 00000000000000000
-// 31 beats 00000000000000000
-// 32 beats 00000000000000000
-0 , 1 , 257 , 4161 ,
-4369 , 17545 , 37449 , 38053 ,
-21845 , 87381 , 54965 , 56173 ,
-60891 , 96119 , 64495 , 98175 ,
-65535 , 131071 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 18 step patterns
-//  0 beats 000000000000000000
-//  1 beats 100000000000000000
-//  2 beats 100000000100000000
-//  3 beats 100000100000100000
-//  4 beats 100010000100010000
-//  5 beats 100010010001001000
-//  6 beats 100100100100100100
-//  7 beats 100101001010010100
-//  8 beats 101010100101010100
-//  9 beats 101010101010101010
-// 10 beats 101010101101010101
-// 11 beats 101101011010110101
-// 12 beats 110110110110110110
-// 13 beats 110111011011101101
-// 14 beats 111011101111011101
-// 15 beats 111110111110111110
-// 16 beats 111111110111111110
-// 17 beats 111111111111111110
-// 18 beats 111111111111111111
-// 19 beats 000000000000000000
-// 20 beats 000000000000000000
-// 21 beats 000000000000000000
-// 22 beats 000000000000000000
-// 23 beats 000000000000000000
-// 24 beats 000000000000000000
-// 25 beats 000000000000000000
-// 26 beats 000000000000000000
-// 27 beats 000000000000000000
-// 28 beats 000000000000000000
-// 29 beats 000000000000000000
-// 30 beats 000000000000000000
-// 31 beats 000000000000000000
-// 32 beats 000000000000000000
-0 , 1 , 513 , 4161 ,
-8721 , 18577 , 37449 , 42281 ,
-43605 , 87381 , 174933 , 177581 ,
-112347 , 187835 , 192375 , 128991 ,
-130815 , 131071 , 262143 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 19 step patterns
-//  0 beats 0000000000000000000
-//  1 beats 1000000000000000000
-//  2 beats 1000000001000000000
-//  3 beats 1000001000001000000
-//  4 beats 1000010000100001000
-//  5 beats 1000100010001000100
-//  6 beats 1001001001001001000
-//  7 beats 1001001010010010100
-//  8 beats 1010010101001010100
-//  9 beats 1010101010101010100
-// 10 beats 1010101010101010101
-// 11 beats 1010110101011010101
-// 12 beats 1011011010110110101
-// 13 beats 1101101101101101101
-// 14 beats 1101110111011101110
-// 15 beats 1110111101111011110
-// 16 beats 1111101111101111101
-// 17 beats 1111111101111111101
-// 18 beats 1111111111111111110
-// 19 beats 1111111111111111111
-// 20 beats 0000000000000000000
-// 21 beats 0000000000000000000
-// 22 beats 0000000000000000000
-// 23 beats 0000000000000000000
-// 24 beats 0000000000000000000
-// 25 beats 0000000000000000000
-// 26 beats 0000000000000000000
-// 27 beats 0000000000000000000
-// 28 beats 0000000000000000000
-// 29 beats 0000000000000000000
-// 30 beats 0000000000000000000
-// 31 beats 0000000000000000000
-// 32 beats 0000000000000000000
-0 , 1 , 513 , 4161 ,
-33825 , 69905 , 37449 , 84297 ,
-86693 , 87381 , 349525 , 350901 ,
-355693 , 374491 , 244667 , 253687 ,
-391135 , 392959 , 262143 , 524287 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 20 step patterns
-//  0 beats 00000000000000000000
-//  1 beats 10000000000000000000
-//  2 beats 10000000001000000000
-//  3 beats 10000001000000100000
-//  4 beats 10000100001000010000
-//  5 beats 10001000100010001000
-//  6 beats 10010010001001001000
-//  7 beats 10010010010010010010
-//  8 beats 10100101001010010100
-//  9 beats 10101010010101010010
-// 10 beats 10101010101010101010
-// 11 beats 10101010110101010110
-// 12 beats 10101101011010110101
-// 13 beats 10110110110110110110
-// 14 beats 11011011011101101101
-// 15 beats 11101110111011101110
-// 16 beats 11110111101111011110
-// 17 beats 11111011111101111110
-// 18 beats 11111111101111111110
-// 19 beats 11111111111111111110
-// 20 beats 11111111111111111111
-// 21 beats 00000000000000000000
-// 22 beats 00000000000000000000
-// 23 beats 00000000000000000000
-// 24 beats 00000000000000000000
-// 25 beats 00000000000000000000
-// 26 beats 00000000000000000000
-// 27 beats 00000000000000000000
-// 28 beats 00000000000000000000
-// 29 beats 00000000000000000000
-// 30 beats 00000000000000000000
-// 31 beats 00000000000000000000
-// 32 beats 00000000000000000000
-0 , 1 , 1025 , 16513 ,
-33825 , 69905 , 74825 , 299593 ,
-169125 , 305749 , 349525 , 437077 ,
-710325 , 449389 , 749275 , 489335 ,
-507375 , 520159 , 523775 , 524287 ,
-1048575 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 21 step patterns
-//  0 beats 000000000000000000000
-//  1 beats 100000000000000000000
-//  2 beats 100000000010000000000
-//  3 beats 100000010000001000000
-//  4 beats 100001000010000100000
-//  5 beats 100010001000100010000
-//  6 beats 100100010010001001000
-//  7 beats 100100100100100100100
-//  8 beats 100101001001010010010
-//  9 beats 101010010101001010100
-// 10 beats 101010101010101010100
-// 11 beats 101010101010101010101
-// 12 beats 101010110101011010101
-// 13 beats 101101011011010110110
-// 14 beats 110110110110110110110
-// 15 beats 110110111011011101101
-// 16 beats 111011101110111011101
-// 17 beats 111101111011110111101
-// 18 beats 111111011111101111110
-// 19 beats 111111111011111111101
-// 20 beats 111111111111111111110
-// 21 beats 111111111111111111111
-// 22 beats 000000000000000000000
-// 23 beats 000000000000000000000
-// 24 beats 000000000000000000000
-// 25 beats 000000000000000000000
-// 26 beats 000000000000000000000
-// 27 beats 000000000000000000000
-// 28 beats 000000000000000000000
-// 29 beats 000000000000000000000
-// 30 beats 000000000000000000000
-// 31 beats 000000000000000000000
-// 32 beats 000000000000000000000
-0 , 1 , 1025 , 16513 ,
-33825 , 69905 , 148617 , 299593 ,
-600361 , 346773 , 349525 , 1398101 ,
-1403605 , 896429 , 898779 , 1502683 ,
-1537911 , 1555951 , 1040319 , 1572351 ,
-1048575 , 2097151 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 22 step patterns
-//  0 beats 0000000000000000000000
-//  1 beats 1000000000000000000000
-//  2 beats 1000000000010000000000
-//  3 beats 1000000100000010000000
-//  4 beats 1000010000010000100000
-//  5 beats 1000100001000100001000
-//  6 beats 1000100010010001000100
-//  7 beats 1001001001001001001000
-//  8 beats 1001001001010010010010
-//  9 beats 1010010100101001010010
-// 10 beats 1010101010010101010100
-// 11 beats 1010101010101010101010
-// 12 beats 1010101010110101010101
-// 13 beats 1010110101101011010110
-// 14 beats 1011011011010110110110
-// 15 beats 1101101101101101101101
-// 16 beats 1101110111011011101110
-// 17 beats 1110111011110111011110
-// 18 beats 1111011110111110111101
-// 19 beats 1111110111111011111101
-// 20 beats 1111111111011111111110
-// 21 beats 1111111111111111111110
-// 22 beats 1111111111111111111111
-// 23 beats 0000000000000000000000
-// 24 beats 0000000000000000000000
-// 25 beats 0000000000000000000000
-// 26 beats 0000000000000000000000
-// 27 beats 0000000000000000000000
-// 28 beats 0000000000000000000000
-// 29 beats 0000000000000000000000
-// 30 beats 0000000000000000000000
-// 31 beats 0000000000000000000000
-// 32 beats 0000000000000000000000
-0 , 1 , 2049 , 16513 ,
-67617 , 270865 , 559377 , 299593 ,
-1198665 , 1217701 , 698709 , 1398101 ,
-2796885 , 1758901 , 1796973 , 2995931 ,
-1956795 , 2027383 , 3112431 , 3137471 ,
-2096127 , 2097151 , 4194303 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 23 step patterns
-//  0 beats 00000000000000000000000
-//  1 beats 10000000000000000000000
-//  2 beats 10000000000100000000000
-//  3 beats 10000000100000001000000
-//  4 beats 10000010000010000010000
-//  5 beats 10000100010000100010000
-//  6 beats 10001000100010001000100
-//  7 beats 10010010001001001000100
-//  8 beats 10010010010010010010010
-//  9 beats 10010100101001010010100
-// 10 beats 10101001010100101010010
-// 11 beats 10101010101010101010100
-// 12 beats 10101010101010101010101
-// 13 beats 10101011010101101010110
-// 14 beats 10110101101011010110101
-// 15 beats 10110110110110110110110
-// 16 beats 11011011011101101101110
-// 17 beats 11011101110111011101110
-// 18 beats 11101111011101111011101
-// 19 beats 11110111110111110111110
-// 20 beats 11111101111111011111110
-// 21 beats 11111111110111111111101
-// 22 beats 11111111111111111111110
-// 23 beats 11111111111111111111111
-// 24 beats 00000000000000000000000
-// 25 beats 00000000000000000000000
-// 26 beats 00000000000000000000000
-// 27 beats 00000000000000000000000
-// 28 beats 00000000000000000000000
-// 29 beats 00000000000000000000000
-// 30 beats 00000000000000000000000
-// 31 beats 00000000000000000000000
-// 32 beats 00000000000000000000000
-0 , 1 , 2049 , 65793 ,
-266305 , 279073 , 1118481 , 1123401 ,
-2396745 , 1353001 , 2443925 , 1398101 ,
-5592405 , 3500757 , 5682605 , 3595117 ,
-3895003 , 3914683 , 6156023 , 4127727 ,
-4177855 , 6290431 , 4194303 , 8388607 ,
-0 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 24 step patterns
-//  0 beats 000000000000000000000000
-//  1 beats 100000000000000000000000
-//  2 beats 100000000000100000000000
-//  3 beats 100000001000000010000000
-//  4 beats 100000100000100000100000
-//  5 beats 100001000010000100001000
-//  6 beats 100010001000100010001000
-//  7 beats 100100010010001001000100
-//  8 beats 100100100100100100100100
-//  9 beats 100100101001001010010010
-// 10 beats 101001010010101001010010
-// 11 beats 101010101001010101010010
-// 12 beats 101010101010101010101010
-// 13 beats 101010101011010101010110
-// 14 beats 101011010110101011010110
-// 15 beats 101101101011011010110110
-// 16 beats 110110110110110110110110
-// 17 beats 110110111011011101101110
-// 18 beats 111011101110111011101110
-// 19 beats 111011110111101111011110
-// 20 beats 111110111110111110111110
-// 21 beats 111111101111111011111110
-// 22 beats 111111111110111111111110
-// 23 beats 111111111111111111111110
-// 24 beats 111111111111111111111111
-// 25 beats 000000000000000000000000
-// 26 beats 000000000000000000000000
-// 27 beats 000000000000000000000000
-// 28 beats 000000000000000000000000
-// 29 beats 000000000000000000000000
-// 30 beats 000000000000000000000000
-// 31 beats 000000000000000000000000
-// 32 beats 000000000000000000000000
-0 , 1 , 4097 , 65793 ,
-266305 , 1082401 , 1118481 , 2245769 ,
-2396745 , 4802889 , 4871333 , 4893013 ,
-5592405 , 6991189 , 7034549 , 7171437 ,
-7190235 , 7794139 , 7829367 , 8118007 ,
-8255455 , 8355711 , 8386559 , 8388607 ,
-16777215 , 0 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 25 step patterns
-//  0 beats 0000000000000000000000000
-//  1 beats 1000000000000000000000000
-//  2 beats 1000000000001000000000000
-//  3 beats 1000000010000000100000000
-//  4 beats 1000001000001000001000000
-//  5 beats 1000010000100001000010000
-//  6 beats 1000100010001000100010000
-//  7 beats 1000100100010010001001000
-//  8 beats 1001001001001001001001000
-//  9 beats 1001001001010010010010100
-// 10 beats 1010010100101001010010100
-// 11 beats 1010100101010100101010100
-// 12 beats 1010101010101010101010100
-// 13 beats 1010101010101010101010101
-// 14 beats 1010101101010101101010101
-// 15 beats 1010110101101011010110101
-// 16 beats 1011011011010110110110101
-// 17 beats 1101101101101101101101101
-// 18 beats 1101110110111011011101101
-// 19 beats 1110111011101110111011101
-// 20 beats 1111011110111101111011110
-// 21 beats 1111101111101111101111101
-// 22 beats 1111111011111110111111101
-// 23 beats 1111111111101111111111101
-// 24 beats 1111111111111111111111110
-// 25 beats 1111111111111111111111111
-// 26 beats 0000000000000000000000000
-// 27 beats 0000000000000000000000000
-// 28 beats 0000000000000000000000000
-// 29 beats 0000000000000000000000000
-// 30 beats 0000000000000000000000000
-// 31 beats 0000000000000000000000000
-// 32 beats 0000000000000000000000000
-0 , 1 , 4097 , 65793 ,
-266305 , 1082401 , 1118481 , 2377873 ,
-2396745 , 5392969 , 5412005 , 5581461 ,
-5592405 , 22369621 , 22391509 , 22730421 ,
-22768493 , 23967451 , 24042939 , 24606583 ,
-16236015 , 25032671 , 25132927 , 25163775 ,
-16777215 , 33554431 , 0 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 26 step patterns
-//  0 beats 00000000000000000000000000
-//  1 beats 10000000000000000000000000
-//  2 beats 10000000000001000000000000
-//  3 beats 10000000010000000010000000
-//  4 beats 10000010000001000001000000
-//  5 beats 10000100001000010000100000
-//  6 beats 10001000100001000100010000
-//  7 beats 10001000100100010001001000
-//  8 beats 10010010010001001001001000
-//  9 beats 10010010010010010010010010
-// 10 beats 10010100101001001010010100
-// 11 beats 10100101010010101001010100
-// 12 beats 10101010101001010101010100
-// 13 beats 10101010101010101010101010
-// 14 beats 10101010101011010101010101
-// 15 beats 10101101010110101011010101
-// 16 beats 10110101101011011010110101
-// 17 beats 10110110110110110110110110
-// 18 beats 11011011011011101101101101
-// 19 beats 11011101110110111011101101
-// 20 beats 11101110111011110111011101
-// 21 beats 11110111101111011110111101
-// 22 beats 11111011111011111101111101
-// 23 beats 11111110111111110111111110
-// 24 beats 11111111111101111111111110
-// 25 beats 11111111111111111111111110
-// 26 beats 11111111111111111111111111
-// 27 beats 00000000000000000000000000
-// 28 beats 00000000000000000000000000
-// 29 beats 00000000000000000000000000
-// 30 beats 00000000000000000000000000
-// 31 beats 00000000000000000000000000
-// 32 beats 00000000000000000000000000
-0 , 1 , 8193 , 262657 ,
-532545 , 1082401 , 2236689 , 4753681 ,
-4792905 , 19173961 , 10822953 , 11096741 ,
-11183445 , 22369621 , 44741973 , 44915381 ,
-45462957 , 28760941 , 47937243 , 48094139 ,
-49215351 , 49790447 , 50067423 , 33488767 ,
-33550335 , 33554431 , 67108863 , 0 ,
-0 , 0 , 0 , 0 ,
-0 , // 27 step patterns
-//  0 beats 000000000000000000000000000
-//  1 beats 100000000000000000000000000
-//  2 beats 100000000000010000000000000
-//  3 beats 100000000100000000100000000
-//  4 beats 100000010000001000000100000
-//  5 beats 100001000001000010000010000
-//  6 beats 100010000100010000100010000
-//  7 beats 100010001000100010001000100
-//  8 beats 100100010010010001001001000
-//  9 beats 100100100100100100100100100
-// 10 beats 100100101001001010010010100
-// 11 beats 101001010010100101001010010
-// 12 beats 101010100101010100101010100
-// 13 beats 101010101010101010101010100
-// 14 beats 101010101010101010101010101
-// 15 beats 101010101101010101101010101
-// 16 beats 101011010110101101011010110
-// 17 beats 101101101011011010110110101
-// 18 beats 110110110110110110110110110
-// 19 beats 110110111011011011101101101
-// 20 beats 110111011101110111011101110
-// 21 beats 111011101111011101111011101
-// 22 beats 111101111011111011110111110
-// 23 beats 111110111111011111101111110
-// 24 beats 111111110111111110111111110
-// 25 beats 111111111111011111111111101
-// 26 beats 111111111111111111111111110
-// 27 beats 111111111111111111111111111
-// 28 beats 000000000000000000000000000
-// 29 beats 000000000000000000000000000
-// 30 beats 000000000000000000000000000
-// 31 beats 000000000000000000000000000
-// 32 beats 000000000000000000000000000
-0 , 1 , 8193 , 262657 ,
-2113665 , 4261921 , 4465169 , 17895697 ,
-9577609 , 19173961 , 21580105 , 38966437 ,
-22325845 , 22369621 , 89478485 , 89566037 ,
-56284853 , 91057517 , 57521883 , 95907291 ,
-62634939 , 98496375 , 66026991 , 66580447 ,
-66977535 , 100659199 , 67108863 , 134217727 ,
-0 , 0 , 0 , 0 ,
-0 , // 28 step patterns
-//  0 beats 0000000000000000000000000000
-//  1 beats 1000000000000000000000000000
-//  2 beats 1000000000000010000000000000
-//  3 beats 1000000001000000001000000000
-//  4 beats 1000000100000010000001000000
-//  5 beats 1000001000010000010000100000
-//  6 beats 1000010000100010000100001000
-//  7 beats 1000100010001000100010001000
-//  8 beats 1001000100100010010001001000
-//  9 beats 1001001001001001001001001000
-// 10 beats 1001001001001010010010010010
-// 11 beats 1001010010100101001010010100
-// 12 beats 1010100101010010101001010100
-// 13 beats 1010101010100101010101010010
-// 14 beats 1010101010101010101010101010
-// 15 beats 1010101010101101010101010110
-// 16 beats 1010101101010110101011010101
-// 17 beats 1011010110101101011010110101
-// 18 beats 1011011011011010110110110110
-// 19 beats 1101101101101101101101101101
-// 20 beats 1101101110110111011011101101
-// 21 beats 1110111011101110111011101110
-// 22 beats 1110111101111011101111011110
-// 23 beats 1111011111011110111110111101
-// 24 beats 1111110111111011111101111110
-// 25 beats 1111111101111111101111111101
-// 26 beats 1111111111111011111111111110
-// 27 beats 1111111111111111111111111110
-// 28 beats 1111111111111111111111111111
-// 29 beats 0000000000000000000000000000
-// 30 beats 0000000000000000000000000000
-// 31 beats 0000000000000000000000000000
-// 32 beats 0000000000000000000000000000
-0 , 1 , 16385 , 262657 ,
-2113665 , 4327489 , 17318945 , 17895697 ,
-19022985 , 19173961 , 76698185 , 43296041 ,
-44386965 , 78292309 , 89478485 , 111850837 ,
-179661525 , 181843373 , 115039085 , 191739611 ,
-192343515 , 125269879 , 129883895 , 199195631 ,
-133160895 , 201195263 , 134209535 , 134217727 ,
-268435455 , 0 , 0 , 0 ,
-0 , // 29 step patterns
-//  0 beats 00000000000000000000000000000
-//  1 beats 10000000000000000000000000000
-//  2 beats 10000000000000100000000000000
-//  3 beats 10000000001000000000100000000
-//  4 beats 10000001000000100000010000000
-//  5 beats 10000010000010000010000010000
-//  6 beats 10000100001000010000100001000
-//  7 beats 10001000100010001000100010000
-//  8 beats 10001001000100010010001000100
-//  9 beats 10010010010001001001001000100
-// 10 beats 10010010010010010010010010010
-// 11 beats 10010100100101001001010010010
-// 12 beats 10100101001010100101001010100
-// 13 beats 10101010010101010010101010010
-// 14 beats 10101010101010101010101010100
-// 15 beats 10101010101010101010101010101
-// 16 beats 10101010110101010110101010110
-// 17 beats 10101101011010101101011010101
-// 18 beats 10110101101101011011010110110
-// 19 beats 10110110110110110110110110110
-// 20 beats 11011011011011101101101101110
-// 21 beats 11011101101110111011011101110
-// 22 beats 11101110111011101110111011101
-// 23 beats 11101111011110111101111011110
-// 24 beats 11110111110111110111110111110
-// 25 beats 11111101111110111111011111101
-// 26 beats 11111111011111111101111111110
-// 27 beats 11111111111110111111111111101
-// 28 beats 11111111111111111111111111110
-// 29 beats 11111111111111111111111111111
-// 30 beats 00000000000000000000000000000
-// 31 beats 00000000000000000000000000000
-// 32 beats 00000000000000000000000000000
-0 , 1 , 16385 , 1049601 ,
-2113665 , 17043521 , 34636833 , 17895697 ,
-71600273 , 71901769 , 153391689 , 153692457 ,
-88757413 , 156543573 , 89478485 , 357913941 ,
-223783765 , 359356085 , 229485997 , 230087533 ,
-249263835 , 250469819 , 393705335 , 259776247 ,
-264174575 , 401596351 , 268173055 , 402644991 ,
-268435455 , 536870911 , 0 , 0 ,
-0 , // 30 step patterns
-//  0 beats 000000000000000000000000000000
-//  1 beats 100000000000000000000000000000
-//  2 beats 100000000000000100000000000000
-//  3 beats 100000000010000000001000000000
-//  4 beats 100000010000000100000010000000
-//  5 beats 100000100000100000100000100000
-//  6 beats 100001000010000100001000010000
-//  7 beats 100010001000010001000100001000
-//  8 beats 100010001000100100010001000100
-//  9 beats 100100100010010010001001001000
-// 10 beats 100100100100100100100100100100
-// 11 beats 100100101001001001010010010010
-// 12 beats 101001010010100101001010010100
-// 13 beats 101010010101001010100101010010
-// 14 beats 101010101010100101010101010100
-// 15 beats 101010101010101010101010101010
-// 16 beats 101010101010101101010101010101
-// 17 beats 101010110101011010101101010110
-// 18 beats 101011010110101101011010110101
-// 19 beats 101101101011011011010110110110
-// 20 beats 110110110110110110110110110110
-// 21 beats 110110110111011011011101101101
-// 22 beats 110111011101110110111011101110
-// 23 beats 111011101110111101110111011110
-// 24 beats 111101111011110111101111011110
-// 25 beats 111110111110111110111110111110
-// 26 beats 111111011111101111111011111101
-// 27 beats 111111111011111111101111111110
-// 28 beats 111111111111110111111111111110
-// 29 beats 111111111111111111111111111110
-// 30 beats 111111111111111111111111111111
-// 31 beats 000000000000000000000000000000
-// 32 beats 000000000000000000000000000000
-0 , 1 , 32769 , 1049601 ,
-4227201 , 17043521 , 34636833 , 69345553 ,
-143167761 , 76620873 , 153391689 , 306858313 ,
-173184165 , 312822421 , 178951509 , 357913941 ,
-715838805 , 448096981 , 727373493 , 460025197 ,
-460175067 , 767258331 , 501070779 , 518977399 ,
-519552495 , 528349151 , 803200959 , 536346111 ,
-536854527 , 536870911 , 1073741823 , 0 ,
-0 , // 31 step patterns
-//  0 beats 0000000000000000000000000000000
-//  1 beats 1000000000000000000000000000000
-//  2 beats 1000000000000001000000000000000
-//  3 beats 1000000000100000000010000000000
-//  4 beats 1000000010000000100000001000000
-//  5 beats 1000001000001000001000001000000
-//  6 beats 1000010000100001000010000100000
-//  7 beats 1000100001000100001000100001000
-//  8 beats 1000100010001000100010001000100
-//  9 beats 1001000100100010010001001000100
-// 10 beats 1001001001001001001001001001000
-// 11 beats 1001001001001010010010010010100
-// 12 beats 1001010010100100101001010010010
-// 13 beats 1010010101001010010101001010010
-// 14 beats 1010101001010101010010101010100
-// 15 beats 1010101010101010101010101010100
-// 16 beats 1010101010101010101010101010101
-// 17 beats 1010101011010101010110101010101
-// 18 beats 1010110101011010110101011010110
-// 19 beats 1011010110101101101011010110110
-// 20 beats 1011011011011010110110110110101
-// 21 beats 1101101101101101101101101101101
-// 22 beats 1101101110110111011011101101110
-// 23 beats 1101110111011101110111011101110
-// 24 beats 1110111011110111011110111011110
-// 25 beats 1111011110111101111011110111101
-// 26 beats 1111101111101111101111101111101
-// 27 beats 1111110111111101111111011111110
-// 28 beats 1111111110111111111011111111101
-// 29 beats 1111111111111101111111111111101
-// 30 beats 1111111111111111111111111111110
-// 31 beats 1111111111111111111111111111111
-// 32 beats 0000000000000000000000000000000
-0 , 1 , 32769 , 1049601 ,
-16843009 , 17043521 , 34636833 , 138682897 ,
-286331153 , 287458441 , 153391689 , 345133641 ,
-614802729 , 623530661 , 357739093 , 357913941 ,
-1431655765 , 1432005461 , 900422325 , 917878189 ,
-1457216365 , 1533916891 , 997649883 , 1002159035 ,
-1038020471 , 1593294319 , 1602090975 , 1069531071 ,
-1610087935 , 1610596351 , 1073741823 , 2147483647 ,
-0 , // 32 step patterns
-//  0 beats 00000000000000000000000000000000
-//  1 beats 10000000000000000000000000000000
-//  2 beats 10000000000000001000000000000000
-//  3 beats 10000000000100000000001000000000
-//  4 beats 10000000100000001000000010000000
-//  5 beats 10000010000001000001000000100000
-//  6 beats 10000100001000001000010000100000
-//  7 beats 10000100010000100010000100010000
-//  8 beats 10001000100010001000100010001000
-//  9 beats 10001001000100100010010001001000
-// 10 beats 10010010010010001001001001001000
-// 11 beats 10010010010010010010010010010010
-// 12 beats 10010010100100101001001010010010
-// 13 beats 10100101001010010100101001010010
-// 14 beats 10101001010100101010100101010010
-// 15 beats 10101010101010010101010101010010
-// 16 beats 10101010101010101010101010101010
-// 17 beats 10101010101010110101010101010110
-// 18 beats 10101011010101101010101101010110
-// 19 beats 10101101011010110101101011010110
-// 20 beats 10110110101101101011011010110110
-// 21 beats 10110110110110110110110110110110
-// 22 beats 11011011011011011101101101101101
-// 23 beats 11011101101110110111011011101101
-// 24 beats 11101110111011101110111011101110
-// 25 beats 11101111011101111011101111011101
-// 26 beats 11110111101111011111011110111101
-// 27 beats 11111011111011111101111101111110
-// 28 beats 11111110111111101111111011111110
-// 29 beats 11111111101111111111011111111110
-// 30 beats 11111111111111101111111111111110
-// 31 beats 11111111111111111111111111111110
-// 32 beats 11111111111111111111111111111111
-0 , 1 , 65537 , 4196353 ,
-16843009 , 67641409 , 69272609 , 142885409 ,
-286331153 , 304367761 , 306778697 , 1227133513 ,
-1229539657 , 1246925989 , 1251297941 , 1252693333 ,
-1431655765 , 1789580629 , 1792371413 , 1801115317 ,
-1835887981 , 1840700269 , 3067852507 , 3077496251 ,
-2004318071 , 3151884023 , 3186605551 , 2130442207 ,
-2139062143 , 2146434559 , 2147450879 , 2147483647 ,
-4294967295 ,
-};
-
 bool EuclideanFilter(uint8_t num_steps, uint8_t num_beats, uint8_t rotation, uint32_t clock) {
-  uint32_t pattern = EuclideanPattern(num_steps, num_beats, rotation);
+  uint64_t pattern = EuclideanPattern64(num_steps, num_beats, rotation);
   clock %= num_steps;
-  return static_cast<bool>(pattern & (0x01 << clock)) ;
+  return static_cast<bool>((pattern >> clock) & 0x01);
 }
 
 uint32_t EuclideanPattern(uint8_t num_steps, uint8_t num_beats, uint8_t rotation, uint8_t padding) {
+  if (num_steps > 32) num_steps = 32;
+  return static_cast<uint32_t>(EuclideanPattern64(num_steps, num_beats, rotation, padding));
+}
+
+uint64_t EuclideanPattern64(uint8_t num_steps, uint8_t num_beats, uint8_t rotation, uint8_t padding) {
   if (num_steps < 2) num_steps = 2;
+  if (num_steps > kMaxEuclideanSteps) num_steps = kMaxEuclideanSteps;
   if (num_beats > num_steps) num_beats = num_steps;
 
-  uint32_t pattern = bjorklund_patterns[((num_steps - 2) * 33) + num_beats]; 
+  uint64_t pattern = BjorklundPattern(num_steps, num_beats);
   if (rotation) {
     rotation = rotation % (num_steps + padding);
-    pattern = rotl32(pattern, num_steps + padding, rotation) ;
+    pattern = rotl64(pattern, num_steps + padding, rotation);
   }
   return pattern;
 }
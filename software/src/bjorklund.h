@@ -18,7 +18,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 //
-// Bjorklund (Euclidean) patterns, generated by resources/bjorklund.py
+// Bjorklund (Euclidean) patterns, as generated by res/bjorklund.py but computed
+// on the fly, for up to 64 steps
 
 #ifndef BJORKLUND_H_
 #define BJORKLUND_H_
@@ -48,7 +49,61 @@ inline uint32_t rotl32(uint32_t input, unsigned int length, unsigned int count)
   return (input << count) | (input >> (length - count)); // off-by-ones or parenthesis mismatch likely
 }
 
+inline uint64_t rotl64(uint64_t input, unsigned int length, unsigned int count) __attribute__((always_inline));
+inline uint64_t rotl64(uint64_t input, unsigned int length, unsigned int count) {
+  if (length < 64) input &= ~(~0ULL << length);
+  if (!count) return input;
+  return (input << count) | (input >> (length - count));
+}
+
+static constexpr uint8_t kMaxEuclideanSteps = 64;
+
+// Bjorklund's algorithm as res/bjorklund.py runs it, step i in bit i, rotated
+// so step 0 is a beat. Each level of the recursion is built from the previous
+// two by concatenating bit strings, so the whole thing is a few shifts per
+// level and there are fewer than ten levels at 64 steps.
+constexpr uint64_t BjorklundPattern(uint8_t num_steps, uint8_t num_beats) {
+  if (!num_beats || num_beats > num_steps || num_steps > kMaxEuclideanSteps) return 0;
+
+  // build(level - 2) and build(level - 1): a beat, a rest
+  uint64_t older = 1, old = 0;
+  uint8_t older_length = 1, old_length = 1;
+  uint8_t divisor = num_steps - num_beats;
+  uint8_t remainder = num_beats;
+  uint64_t pattern = 0;
+  uint8_t length = 0;
+  for (uint8_t level = 0; ; ++level) {
+    const bool last = level && remainder <= 1;
+    const uint8_t count = last ? divisor : divisor / remainder;
+    pattern = 0;
+    length = 0;
+    for (uint8_t i = 0; i < count; ++i) {
+      pattern |= old << length;
+      length += old_length;
+    }
+    if (remainder) {
+      pattern |= older << length;
+      length += older_length;
+    }
+    if (last) break;
+
+    const uint8_t next = divisor % remainder;
+    divisor = remainder;
+    remainder = next;
+    older = old; older_length = old_length;
+    old = pattern; old_length = length;
+  }
+
+  // pattern.index(1) rotation
+  uint8_t first = 0;
+  while (!((pattern >> first) & 1)) ++first;
+  if (!first) return pattern;
+  return (pattern >> first) | ((pattern << (num_steps - first)) & (~0ULL >> (64 - num_steps)));
+}
+
 bool EuclideanFilter(uint8_t num_steps, uint8_t num_beats, uint8_t rotation, uint32_t clock);
 uint32_t EuclideanPattern(uint8_t num_steps, uint8_t num_beats, uint8_t rotation, uint8_t padding = 0);
+// As EuclideanPattern, with num_steps + padding up to 64
+uint64_t EuclideanPattern64(uint8_t num_steps, uint8_t num_beats, uint8_t rotation, uint8_t padding = 0);
 
 #endif // BJORKLUND_H_
@@ -45,7 +45,9 @@ void SortScale(Scale &scale) {
 
 void Quantizer::Init() {
   enabled_ = true;
+  requantize_ = false;
   codeword_ = 0;
+  note_number_ = 0;
   transpose_ = 0;
   previous_boundary_ = 0;
   next_boundary_ = 0;
@@ -71,23 +73,38 @@ int32_t Quantizer::Process(int32_t pitch, int32_t root, int32_t transpose) {
     pitch = codeword_;
   } else {
     requantize_ = false;
-    int16_t octave = pitch / span_ - (pitch < 0 ? 1 : 0);
-    int16_t rel_pitch = pitch - span_ * octave;
-
-    int16_t best_distance = 16384;
-    int16_t q = -1;
-    for (int16_t i = 0; i < num_notes_; i++) {
-      int16_t distance = abs(rel_pitch - notes_[i]);
-      if (distance < best_distance) {
-        best_distance = distance;
-        q = i;
+    int16_t octave;
+    int16_t nearest;
+    if (table_ready_) {
+      // octave split by reciprocal; the estimate is high by at most one
+      const uint32_t u = pitch < 0 ? -pitch : pitch;
+      uint32_t oct = (static_cast<uint64_t>(u) * table_->recip) >> 32;
+      int32_t rem = u - oct * span_;
+      if (rem < 0) {
+        --oct;
+        rem += span_;
       }
+      // same cell as pitch / span_ - 1 for negative pitch, so rel_pitch can be span_
+      int32_t rel_pitch = rem;
+      octave = oct;
+      if (pitch < 0) {
+        octave = -octave - 1;
+        rel_pitch = span_ - rem;
+      }
+
+      int r = table_->bucket[rel_pitch >> table_->shift];
+      while (rel_pitch >= table_->run_start[r + 1]) ++r;
+      nearest = table_->run_note[r];
+    } else {
+      octave = pitch / span_ - (pitch < 0 ? 1 : 0);
+      nearest = Nearest(pitch - span_ * octave);
     }
 
-    if (abs(pitch - (octave + 1) * span_ - notes_[0]) < best_distance) {
+    int16_t q = nearest - 1;
+    if (nearest == num_notes_ + 1) {
       octave++;
       q = 0;
-    } else if (abs(pitch - (octave - 1) * span_ - notes_[num_notes_ - 1]) <= best_distance) {
+    } else if (nearest == 0) {
       octave--;
       q = num_notes_ - 1;
     }
@@ -107,12 +124,14 @@ int32_t Quantizer::Process(int32_t pitch, int32_t root, int32_t transpose) {
         (NEIGHBOR_WEIGHT * next_boundary_ + CUR_WEIGHT * codeword_) >> 4;
 
     // apply transpose after setting boundaries
-    q += transpose;
-    octave += q / num_notes_;
-    q %= num_notes_;
-    if (q < 0) {
-      q += num_notes_;
-      octave--;
+    if (transpose) {
+      q += transpose;
+      octave += q / num_notes_;
+      q %= num_notes_;
+      if (q < 0) {
+        q += num_notes_;
+        octave--;
+      }
     }
 
     // apply octave constraint
@@ -134,6 +153,81 @@ int32_t Quantizer::Process(int32_t pitch, int32_t root, int32_t transpose) {
   return pitch;
 }
 
+int16_t Quantizer::Nearest(int32_t rel_pitch) const {
+  int32_t best_distance = 16384;
+  int16_t nearest = 0;
+  for (int16_t i = 0; i < num_notes_; i++) {
+    int32_t distance = abs(rel_pitch - notes_[i]);
+    if (distance < best_distance) {
+      best_distance = distance;
+      nearest = i + 1;
+    }
+  }
+
+  if (abs(rel_pitch - span_ - notes_[0]) < best_distance) {
+    nearest = num_notes_ + 1;
+  } else if (abs(rel_pitch + span_ - notes_[num_notes_ - 1]) <= best_distance) {
+    nearest = 0;
+  }
+  return nearest;
+}
+
+bool Quantizer::BuildTable() {
+  QuantizerTable &t = *table_;
+  t.num_runs = 0;
+  if (!enabled_ || span_ < 2) return false;
+
+  // Candidates in the order Nearest() numbers them
+  const int num_candidates = num_notes_ + 2;
+  int32_t candidate[16 + 2];
+  candidate[0] = notes_[num_notes_ - 1] - span_;
+  for (int i = 0; i < num_notes_; ++i) candidate[i + 1] = notes_[i];
+  candidate[num_notes_ + 1] = notes_[0] + span_;
+
+  // Which of two notes is nearer can only change where rel_pitch reaches
+  // their midpoint, or just passes it. Collect those points; Nearest() is
+  // constant between them.
+  int16_t points[1 + (16 + 2) * (16 + 1)];
+  int num_points = 0;
+  points[num_points++] = 0;
+  for (int a = 0; a < num_candidates; ++a) {
+    for (int b = a + 1; b < num_candidates; ++b) {
+      const int32_t sum = candidate[a] + candidate[b];
+      const int32_t tie = (sum + 1) >> 1; // first point not nearer to the lower
+      const int32_t past = (sum >> 1) + 1; // first point nearer to the higher
+      if (tie > 0 && tie <= span_) points[num_points++] = tie;
+      if (past > 0 && past <= span_) points[num_points++] = past;
+    }
+  }
+  std::sort(points, points + num_points);
+
+  int runs = 0;
+  for (int i = 0; i < num_points; ++i) {
+    if (i && points[i] == points[i - 1]) continue;
+    const int16_t nearest = Nearest(points[i]);
+    if (runs && t.run_note[runs - 1] == nearest) continue;
+    if (runs == QuantizerTable::kMaxRuns) return false;
+    t.run_start[runs] = points[i];
+    t.run_note[runs] = nearest;
+    ++runs;
+  }
+  t.run_start[runs] = span_ + 1; // rel_pitch is at most span_
+
+  uint8_t shift = 0;
+  while ((span_ >> shift) >= QuantizerTable::kBuckets) ++shift;
+  int r = 0;
+  for (int b = 0; b < QuantizerTable::kBuckets; ++b) {
+    const int32_t start = b << shift;
+    while (r + 1 < runs && start >= t.run_start[r + 1]) ++r;
+    t.bucket[b] = r;
+  }
+
+  t.shift = shift;
+  t.recip = 0xffffffffU / span_ + 1;
+  t.num_runs = runs;
+  return true;
+}
+
 int32_t Quantizer::Lookup(int32_t index) const {
   index -= 64;
   int16_t octave = index / num_notes_;
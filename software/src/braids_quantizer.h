@@ -51,10 +51,27 @@ enum OctaveConstraint {
   OCTAVE_CONSTRAINT_LAST
 };
 
+// Optional lookup table for Quantizer. Within one span, the nearest note is
+// constant over a handful of runs of rel_pitch; a coarse bucket index points
+// at the run for the start of each bucket, so requantizing costs a multiply
+// for the octave and a compare or two, instead of a divide and a scan.
+struct QuantizerTable {
+  static constexpr int kBuckets = 64;
+  static constexpr int kMaxRuns = 40;
+
+  uint32_t recip;  // 2^32 / span, rounded up
+  uint8_t shift;   // rel_pitch >> shift is the bucket
+  uint8_t num_runs;
+  uint8_t bucket[kBuckets];
+  int16_t run_start[kMaxRuns + 1];
+  // 0 is the top note an octave down, 1..n are notes_, n+1 the first note an octave up
+  uint8_t run_note[kMaxRuns];
+};
+
 void SortScale(Scale &);
 class Quantizer {
  public:
-  Quantizer() {}
+  Quantizer() : table_(nullptr), table_ready_(false) {}
   ~Quantizer() {}
 
   void Init();
@@ -66,13 +83,28 @@ class Quantizer {
   int32_t Process(int32_t pitch, int32_t root, int32_t transpose);
 
   void Configure(const Scale& scale, uint16_t mask = 0xffff) {
-    num_notes_ = 0;
+    bool changed = (span_ != scale.span);
+    uint8_t num_notes = 0;
     for (uint16_t i = 0; i < scale.num_notes; i++) {
-      if (mask & 1) notes_[num_notes_++] = scale.notes[i];
+      if (mask & 1) {
+        changed = changed || notes_[num_notes] != scale.notes[i];
+        notes_[num_notes++] = scale.notes[i];
+      }
       mask >>= 1;
     }
+    changed = changed || num_notes != num_notes_;
+    num_notes_ = num_notes;
     span_ = scale.span;
-    enabled_ = notes_ != NULL && num_notes_ != 0 && span_ != 0;
+    enabled_ = num_notes_ != 0 && span_ != 0;
+
+    // only rebuild when the notes actually change; some callers reconfigure every tick
+    if (table_ && (changed || !table_ready_)) table_ready_ = BuildTable();
+  }
+
+  // Use a lookup table for requantizing; it's rebuilt by Configure()
+  void AttachTable(QuantizerTable *table) {
+    table_ = table;
+    table_ready_ = BuildTable();
   }
 
   bool enabled() const {
@@ -100,6 +132,8 @@ class Quantizer {
   int16_t ConstrainOctave(int16_t octave) const;
 
  private:
+  QuantizerTable *table_;
+  bool table_ready_;
   bool enabled_;
   int32_t codeword_;
   int32_t transpose_;
@@ -115,6 +149,10 @@ class Quantizer {
   uint16_t note_number_;
   bool requantize_;
 
+  bool BuildTable();
+  // Nearest note to rel_pitch, numbered as QuantizerTable::run_note
+  int16_t Nearest(int32_t rel_pitch) const;
+
   DISALLOW_COPY_AND_ASSIGN(Quantizer);
 };
 
@@ -27,6 +27,11 @@ const float Cn3 = 2.0439497f;
 const float C0 = Cn3 * SemitonesToRatio(3.0f * 12.0f);
 const float C3 = C0 * SemitonesToRatio(3.0f * 12.0f);
 
+// Pitch (1/128 semitones) to Hz, with pitch 0 at C3
+inline float PitchToHz(int pitch) {
+  return PitchToRatio(pitch) * C3;
+}
+
 inline int32_t Clip16(int32_t x) {
   if (x < -32768) {
     return -32768;
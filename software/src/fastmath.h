@@ -0,0 +1,56 @@
+#pragma once
+// Float log2 for control-rate code that would otherwise call libm.
+//
+// A 16-entry table plus a short polynomial: a handful of multiplies and no
+// division, and far closer to the libm result than fastlog2 in
+// extern/fastapprox. Measured maximum errors against double precision (see
+// test/oc_test_fastmath.cpp):
+//
+//   Log2(x), x in [1e-6, 4]           absolute 8e-7
+//   Log2(x), x in [4, 1e6]            absolute 1.2e-6 (float rounding of the sum)
+//
+// against 1.5e-4 for fastlog2. Powers of two are exact, so Log2(1) is 0. Log2
+// of 0 or less returns -128 rather than being checked.
+//
+// The audio-rate conversions in dsputils.h stay on fastapprox, which is the
+// faster of the two on the host; precision isn't what they need.
+
+#include <stdint.h>
+
+namespace fastmath {
+
+static constexpr float kLog2e = 1.442695041f;
+
+// log2(1 + k/16) and 1 / (1 + k/16)
+static constexpr float kLog2Table[16] = {
+  0.000000000f, 0.087462841f, 0.169925001f, 0.247927513f, 0.321928095f, 0.392317423f, 0.459431619f, 0.523561956f,
+  0.584962501f, 0.643856190f, 0.700439718f, 0.754887502f, 0.807354922f, 0.857980995f, 0.906890596f, 0.954196310f
+};
+static constexpr float kInverseTable[16] = {
+  1.000000000f, 0.941176471f, 0.888888889f, 0.842105263f, 0.800000000f, 0.761904762f, 0.727272727f, 0.695652174f,
+  0.666666667f, 0.640000000f, 0.615384615f, 0.592592593f, 0.571428571f, 0.551724138f, 0.533333333f, 0.516129032f
+};
+
+union FloatBits {
+  float f;
+  uint32_t i;
+};
+
+inline float Log2(float x) {
+  if (!(x > 0.0f)) return -128.0f;
+
+  FloatBits v;
+  v.f = x;
+  const int32_t exponent = static_cast<int32_t>((v.i >> 23) & 0xff) - 127;
+  const uint32_t k = (v.i >> 19) & 0x0f;
+  v.i = (v.i & 0x007fffff) | 0x3f800000;
+
+  // log2(1 + t) from the start of the mantissa's sixteenth, t in [0, 1/16),
+  // so powers of two come out exact
+  const float start = 1.0f + k * 0.0625f;
+  const float t = (v.f - start) * kInverseTable[k];
+  const float p = t * (kLog2e + t * (-0.5f * kLog2e + t * ((1.0f / 3.0f) * kLog2e + t * (-0.25f * kLog2e + t * (0.2f * kLog2e)))));
+  return exponent + (kLog2Table[k] + p);
+}
+
+} // namespace fastmath
@@ -35,12 +35,14 @@
 
 #include "extern/stmlib_utils_dsp.h"
 #include "util/util_math.h"
+#include "util/util_simd.h"
 #include "frames_resources.h"
 
 namespace frames {
 
 using namespace std;
 using namespace stmlib;
+using namespace util;
 
 void PolyLfo::Init() {
   freq_range_ = 9;
@@ -50,10 +52,9 @@ void PolyLfo::Init() {
   coupling_ = 0;
   attenuation_ = 58880;
   offset_ = 0 ;
-  freq_div_b_ = freq_div_c_ = freq_div_d_ = POLYLFO_FREQ_MULT_NONE ;
-  b_am_by_a_ = 0 ;
-  c_am_by_b_ = 0 ;
-  d_am_by_c_ = 0 ;
+  std::fill(&freq_div_[0], &freq_div_[kNumChannels], POLYLFO_FREQ_MULT_NONE);
+  std::fill(&xor_mask_[0], &xor_mask_[kNumChannels], 0);
+  std::fill(&am_depth_[0], &am_depth_[kNumChannels], 0);
   phase_reset_flag_ = false;
   sync_counter_ = 0 ;
   sync_ = false;
@@ -61,8 +62,10 @@ void PolyLfo::Init() {
   std::fill(&value_[0], &value_[kNumChannels], 0);
   std::fill(&wt_value_[0], &wt_value_[kNumChannels], 0);
   std::fill(&phase_[0], &phase_[kNumChannels], 0);
+  phase_difference_ = 0;
   last_phase_difference_ = 0;
-  last_phase_difference_ = 0;
+  phase_increment_ch1_ = 0;
+  sync_phase_increment_ = 0;
   pattern_predictor_.Init();
 }
 
@@ -170,32 +173,23 @@ void PolyLfo::Render(int32_t frequency, bool reset_phase, bool tempo_sync, uint8
     }
     
     phase_[0] += phase_increment_ch1_;
-    PolyLfoFreqMultipliers FreqDivs[] = {POLYLFO_FREQ_MULT_NONE, freq_div_b_, freq_div_c_ , freq_div_d_} ;
     for (uint8_t i = 1; i < kNumChannels; ++i) {
-        if (FreqDivs[i] == POLYLFO_FREQ_MULT_NONE) {
+        if (freq_div_[i] == POLYLFO_FREQ_MULT_NONE) {
             phase_[i] += phase_increment_ch1_;
         } else {
-            phase_[i] += multiply_u32xu32_rshift24(phase_increment_ch1_, PolyLfoFreqMultNumerators[FreqDivs[i]]) ;
+            phase_[i] += multiply_u32xu32_rshift24(phase_increment_ch1_, PolyLfoFreqMultNumerators[freq_div_[i]]) ;
         }  
     }
 
     // Advance phasors.
     if (spread_ >= 0) {
       phase_difference_ = static_cast<uint32_t>(spread_) << 15;
-      if (freq_div_b_ == POLYLFO_FREQ_MULT_NONE) {
-        phase_[1] = phase_[0] + phase_difference_;
-      } else {
-        phase_[1] = phase_[1] - last_phase_difference_ + phase_difference_;
-      }
-      if (freq_div_c_ == POLYLFO_FREQ_MULT_NONE) {
-        phase_[2] = phase_[0] + (2 * phase_difference_);
-      } else {
-        phase_[2] = phase_[2] - last_phase_difference_  + phase_difference_;
-      }
-      if (freq_div_d_ == POLYLFO_FREQ_MULT_NONE) {
-        phase_[3] = phase_[0] + (3 * phase_difference_);
-      } else {
-        phase_[3] = phase_[3] - last_phase_difference_  + phase_difference_;
+      for (uint8_t i = 1; i < kNumChannels; ++i) {
+        if (freq_div_[i] == POLYLFO_FREQ_MULT_NONE) {
+          phase_[i] = phase_[0] + (i * phase_difference_);
+        } else {
+          phase_[i] = phase_[i] - last_phase_difference_ + phase_difference_;
+        }
       }
     } else {
       for (uint8_t i = 1; i < kNumChannels; ++i) { 
@@ -210,9 +204,8 @@ void PolyLfo::Render(int32_t frequency, bool reset_phase, bool tempo_sync, uint8
   const uint8_t* sine = &wt_lfo_waveforms[17 * 257];
   
   uint16_t wavetable_index = shape_;
-  uint8_t xor_depths[] = {0, b_xor_a_, c_xor_a_, d_xor_a_ } ;
-  uint8_t am_depths[] = {0, b_am_by_a_, c_am_by_b_, d_am_by_c_ } ;
-  // Wavetable lookup
+  // Wavetable lookup. Coupling reads value_ as the channels before this one
+  // left it, so the channels go in order.
   for (uint8_t i = 0; i < kNumChannels; ++i) {
     uint32_t phase = phase_[i];
     if (coupling_ > 0) {
@@ -221,24 +214,31 @@ void PolyLfo::Render(int32_t frequency, bool reset_phase, bool tempo_sync, uint8
       phase += value_[(i + kNumChannels - 1) % kNumChannels] * -coupling_;
     }
     const uint8_t* a = &wt_lfo_waveforms[(wavetable_index >> 12) * 257];
-    const uint8_t* b = a + 257;
-    wt_value_[i] = Crossfade(a, b, phase, wavetable_index << 4) ;
+    wt_value_[i] = CrossfadeLanes(a, a + 257, phase, wavetable_index << 4);
     value_[i] = Interpolate824(sine, phase);
-    level_[i] = (wt_value_[i] + 32768) >> 8; 
-    // add bit-XOR 
-    uint8_t depth_xor = xor_depths[i];
-    if (depth_xor) {
-      dac_code_[i] = (wt_value_[i] + 32768) ^ (((wt_value_[0] + 32768) >> depth_xor) << depth_xor) ; 
-    } else {
-      dac_code_[i] = wt_value_[i] + 32768; //Keyframer::ConvertToDacCode(value + 32768, 0);
-    }
-    // cross-channel AM
-    if (i>0)
-      dac_code_[i] = (dac_code_[i] * (65535 - (((65535 - dac_code_[i-1]) * am_depths[i]) >> 8))) >> 16;
-    // attenuationand offset
-    dac_code_[i] = ((dac_code_[i] * attenuation_) >> 16) + offset_ ;
     wavetable_index += shape_spread_;
   }
+
+  // Offset binary, level and bit-XOR with A, two channels to a word. AM
+  // runs down the chain, so the second half goes a channel at a time; its
+  // products can pass 2^31, and only their low 16 bits after the shift count.
+  const uint32_t code_a = static_cast<uint16_t>(wt_value_[0] + 32768) * 0x00010001u;
+  uint32_t previous = 0;
+  for (uint8_t i = 0; i < kNumChannels; i += 2) {
+    uint32_t codes = simd::pack16(wt_value_[i], wt_value_[i + 1]) ^ 0x80008000u;
+    level_[i] = codes >> 8;
+    level_[i + 1] = codes >> 24;
+    codes ^= code_a & (xor_mask_[i] | (xor_mask_[i + 1] << 16));
+
+    uint32_t dac_code = codes & 0xffff;
+    if (i > 0)
+      dac_code = (dac_code * (65535 - (((65535 - previous) * am_depth_[i]) >> 8))) >> 16;
+    previous = dac_code_[i] = ((dac_code * attenuation_) >> 16) + offset_;
+
+    dac_code = codes >> 16;
+    dac_code = (dac_code * (65535 - (((65535 - previous) * am_depth_[i + 1]) >> 8))) >> 16;
+    previous = dac_code_[i + 1] = ((dac_code * attenuation_) >> 16) + offset_;
+  }
 }
 
 void PolyLfo::RenderPreview(uint16_t shape, uint16_t *buffer, size_t size) {
@@ -35,6 +35,7 @@
 //#include "stmlib/stmlib.h"
 //#include "frames/keyframer.h"
 #include "peaks_pattern_predictor.h"
+#include "util/util_simd.h"
 
 const uint32_t kSyncCounterMaxTime = 8 * 16667;
 
@@ -177,60 +178,39 @@ class PolyLfo {
   }
 
   inline void set_freq_div_b(PolyLfoFreqMultipliers div) {
-    if (div != freq_div_b_) {
-      freq_div_b_ = div;
-      phase_reset_flag_ = true;
-    }
+    set_freq_div(1, div);
   }
 
   inline void set_freq_div_c(PolyLfoFreqMultipliers div) {
-    if (div != freq_div_c_) {
-      freq_div_c_ = div;
-      phase_reset_flag_ = true;
-    }
+    set_freq_div(2, div);
   }
 
   inline void set_freq_div_d(PolyLfoFreqMultipliers div) {
-    if (div != freq_div_d_) {
-      freq_div_d_ = div;
-      phase_reset_flag_ = true;
-    }
+    set_freq_div(3, div);
   }
 
   inline void set_b_xor_a(uint8_t xor_value) {
-    if (xor_value) {
-      b_xor_a_ = 16 - xor_value ;
-    } else {
-      b_xor_a_ = 0;
-    }
+    set_xor_a(1, xor_value);
   }
 
   inline void set_c_xor_a(uint8_t xor_value) {
-    if (xor_value) {
-      c_xor_a_ = 16 - xor_value ;
-    } else {
-      c_xor_a_ = 0;
-    }
+    set_xor_a(2, xor_value);
   }
 
   inline void set_d_xor_a(uint8_t xor_value) {
-    if (xor_value) {
-      d_xor_a_ = 16 - xor_value ;
-    } else {
-      d_xor_a_ = 0;
-    }
+    set_xor_a(3, xor_value);
   }
 
   inline void set_b_am_by_a(uint8_t am_value) {
-    b_am_by_a_ = (am_value << 1);
+    am_depth_[1] = (am_value << 1);
   }
 
   inline void set_c_am_by_b(uint8_t am_value) {
-    c_am_by_b_ = (am_value << 1);
+    am_depth_[2] = (am_value << 1);
   }
 
   inline void set_d_am_by_c(uint8_t am_value) {
-    d_am_by_c_ = (am_value << 1);
+    am_depth_[3] = (am_value << 1);
   }
 
   inline void set_phase_reset_flag(bool reset) {
@@ -267,6 +247,10 @@ class PolyLfo {
 
   static uint32_t FrequencyToPhaseIncrement(int32_t frequency, uint16_t frq_rng);
 
+  // Crossfade(), with both wavetables interpolated side by side in packed
+  // 16-bit lanes. Same result to the bit.
+  static int16_t CrossfadeLanes(const uint8_t* table_a, const uint8_t* table_b, uint32_t phase, uint16_t balance);
+
 
  private:
   uint16_t freq_range_ ;
@@ -276,17 +260,13 @@ class PolyLfo {
   int16_t coupling_;
   int32_t attenuation_;
   int32_t offset_;
-  PolyLfoFreqMultipliers freq_div_b_;
-  PolyLfoFreqMultipliers freq_div_c_;
-  PolyLfoFreqMultipliers freq_div_d_;
-  uint8_t b_xor_a_ ;
-  uint8_t c_xor_a_ ;
-  uint8_t d_xor_a_ ;
-  uint8_t b_am_by_a_ ;
-  uint8_t c_am_by_b_ ;
-  uint8_t d_am_by_c_ ;
   bool phase_reset_flag_ ;
 
+  // Per-channel settings, by channel; channel A's are fixed at none
+  PolyLfoFreqMultipliers freq_div_[kNumChannels];
+  uint16_t xor_mask_[kNumChannels]; // bits of A's DAC code XORed in
+  uint8_t am_depth_[kNumChannels]; // AM by the channel before
+
   int16_t value_[kNumChannels];
   int16_t wt_value_[kNumChannels];
   uint32_t phase_[kNumChannels];
@@ -302,9 +282,41 @@ class PolyLfo {
   uint32_t phase_difference_ ;
   uint32_t last_phase_difference_ ;
   
+  inline void set_freq_div(uint8_t channel, PolyLfoFreqMultipliers div) {
+    if (div != freq_div_[channel]) {
+      freq_div_[channel] = div;
+      phase_reset_flag_ = true;
+    }
+  }
+
+  // xor_value 1..15 keeps that many low bits of the channel's own code
+  inline void set_xor_a(uint8_t channel, uint8_t xor_value) {
+    xor_mask_[channel] = (xor_value && xor_value < 16) ? (0xffffu << (16 - xor_value)) & 0xffff : 0;
+  }
+
   DISALLOW_COPY_AND_ASSIGN(PolyLfo);
 };
 
+/* static */
+inline int16_t PolyLfo::CrossfadeLanes(const uint8_t* table_a, const uint8_t* table_b, uint32_t phase, uint16_t balance) {
+  // Interpolate824 on both tables at once: a in lane 0, b in lane 1
+  const uint32_t index = phase >> 24;
+  const uint32_t samples = (table_a[index] | (table_a[index + 1] << 8))
+                         | (table_b[index] | (table_b[index + 1] << 8)) << 16;
+  const uint32_t s0 = util::simd::uxtb16(samples);
+  const uint32_t ds = util::simd::ssub16(util::simd::uxtb16_ror8(samples), s0);
+  const int32_t fraction = phase & 0xffffff;
+  const uint32_t ab = util::simd::sadd16((s0 << 8) ^ 0x80008000u,
+                                         util::simd::pack16(util::simd::smulwb(fraction, ds), util::simd::smulwt(fraction, ds)));
+
+  // a + ((b - a) * balance >> 16), as (a * 65536 + (b - a) * balance) >> 16
+  // = ((a + b) * 32768 + (balance - 32768) * (b - a)) >> 16. The sum may
+  // wrap; the low 16 bits of the result don't change.
+  const int32_t s = balance - 32768;
+  const uint32_t sum = static_cast<uint32_t>(util::simd::smuad(ab, 0x00010001u)) << 15;
+  return static_cast<int32_t>(sum - util::simd::smusd(ab, util::simd::pack16(s, s))) >> 16;
+}
+
 }  // namespace frames
 
 #endif  // FRAMES_POLY_LFO_H_
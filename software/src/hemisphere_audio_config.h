@@ -33,8 +33,8 @@ DMAMEM std::tuple<
   FilterFolderApplet<MONO>,
   WavPlayerApplet<MONO>,
   VcaApplet<MONO>,
-  ReverbApplet,
-  BungverbApplet,
+  ReverbApplet<MONO>,
+  BungverbApplet<MONO>,
   UpsampledApplet<MONO>>
   mono_processors_pool[2][NUM_SLOTS - 1];
 DMAMEM std::tuple<
@@ -48,6 +48,8 @@ DMAMEM std::tuple<
   VcaApplet<STEREO>,
   FilterFolderApplet<STEREO>,
   WavPlayerApplet<STEREO>,
+  ReverbApplet<STEREO>,
+  BungverbApplet<STEREO>,
   UpsampledApplet<STEREO>>
   stereo_processors_pool[NUM_SLOTS - 1];
 
@@ -34,6 +34,7 @@
 
 // #include "peaks/drums/svf.h"
 
+#include <stddef.h>
 #include <stdint.h>
 #include "util/util_macros.h"
 
@@ -48,9 +49,13 @@ class ByteBeat {
   ByteBeat() { }
   ~ByteBeat() { }
   
+  static const uint8_t kNumEquations = 16;
+
   void Init();
   uint16_t ProcessSingleSample(uint8_t control);
   uint16_t Clock();
+  // As ProcessSingleSample over a block, with the parameters held
+  void Render(const uint8_t* control, uint16_t* out, size_t size);
  
   void Configure(int32_t* parameter, bool stepmode, bool loopmode) {
       set_equation(parameter[0]);
@@ -66,15 +71,20 @@ class ByteBeat {
       // Quick and dirty log scaling sans LUT
       uint8_t speed_rshift = (speed_ >> 13) + 1;
       if (speed_rshift < 2) speed_rshift = 2 ;
-      bytepitch_ = (65535 - speed_) >> speed_rshift ; 
-      if (bytepitch_ < 1) {
-        bytepitch_ = 1;
+      uint16_t bytepitch = (65535 - speed_) >> speed_rshift ; 
+      if (bytepitch < 1) {
+        bytepitch = 1;
+      }
+      if (bytepitch != bytepitch_) {
+        bytepitch_ = bytepitch;
+        phase_count_ = phase_ % bytepitch_;
       }
   }
 
    inline void set_equation(int32_t equation) {
     equation_ = equation ;
     equation_index_ = equation_ >> 12 ;
+    equation_fn_ = equations_[equation_index_];
   }
 
    inline void set_step_mode(bool stepmode) {
@@ -146,6 +156,17 @@ class ByteBeat {
   }
   
  private:
+  typedef uint16_t (ByteBeat::*EquationFn)() const;
+  typedef void (ByteBeat::*RenderFn)(const uint8_t*, uint16_t*, size_t);
+  static const EquationFn equations_[kNumEquations];
+  static const RenderFn renderers_[kNumEquations];
+
+  // Each equation is its own function; set_equation picks one so there's no
+  // per-sample switch
+  template <uint16_t equation_index> uint16_t Equation() const;
+  template <uint16_t equation_index> void RenderEquation(const uint8_t* control, uint16_t* out, size_t size);
+  inline void Advance(uint8_t control);
+
   uint16_t equation_ ;
   uint16_t speed_;
   uint16_t pitch_;
@@ -162,6 +183,8 @@ class ByteBeat {
 
   uint16_t equation_index_ ;
   uint16_t bytepitch_ ;
+  uint16_t phase_count_ ; // phase_ % bytepitch_
+  EquationFn equation_fn_ ;
   
   DISALLOW_COPY_AND_ASSIGN(ByteBeat);
 };
@@ -0,0 +1,204 @@
+// Copyright 2014 Émilie Gillet.
+// Copyright 2016 Tim Churches
+//
+// Original Author: Émilie Gillet (ol.gillet@gmail.com)
+// Modifications for use of this code in firmare for the Ornament and Crime module:
+// Tim Churches (tim.churches@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+// -----------------------------------------------------------------------------
+//
+// Lorenz and Rössler systems, N at a time.
+//
+// State is kept structure-of-arrays, Q24, and integrated with the same Euler
+// step LorenzGenerator has always used. The engine can step every tick or
+// every 2^n ticks, and interpolates linearly between steps so outputs still
+// move every tick; with a decimation of 1 the outputs are the integrated
+// state itself.
+
+#ifndef STREAMS_ATTRACTOR_ENGINE_H_
+#define STREAMS_ATTRACTOR_ENGINE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "streams_resources.h"
+
+namespace streams {
+
+enum AttractorType {
+  ATTRACTOR_LORENZ,
+  ATTRACTOR_ROSSLER,
+};
+
+enum AttractorAxis {
+  ATTRACTOR_X,
+  ATTRACTOR_Y,
+  ATTRACTOR_Z,
+};
+
+// Multiply precision. 64 is the original arithmetic: Q24 operands and 64-bit
+// products throughout. 32 does every product as a single 32x32->64 multiply
+// (one SMULL on Cortex-M), taking derivatives that can outgrow Q24 in Q20
+// instead. Trajectories then drift apart from the 64-bit ones, as any two
+// chaotic trajectories do, but stay on the same attractor.
+enum AttractorPrecision {
+  ATTRACTOR_PRECISION_32,
+  ATTRACTOR_PRECISION_64,
+};
+
+template <size_t N, AttractorPrecision precision>
+class AttractorEngine {
+public:
+  static constexpr int32_t kSigma = 10.0 * (1 << 24);
+  static constexpr int32_t kBeta = 8.0 / 3.0 * (1 << 24);
+  static constexpr int32_t kRosslerA = 0.1 * (1 << 24);
+  static constexpr int32_t kRosslerB = 0.1 * (1 << 24);
+  static constexpr int32_t kInitialX = 0.1 * (1 << 24);
+  static constexpr uint8_t kMaxDecimationShift = 5;
+
+  // decimation_shift: integrate once every 2^decimation_shift calls to Process()
+  void Init(uint8_t decimation_shift = 0) {
+    decimation_shift_ = decimation_shift > kMaxDecimationShift ? kMaxDecimationShift : decimation_shift;
+    count_ = 0;
+    for (size_t i = 0; i < N; ++i) {
+      type_[i] = ATTRACTOR_LORENZ;
+      dt_[i] = lut_lorenz_rate[0];
+      set_rho(i, 0);
+      Reset(i);
+    }
+  }
+
+  void Configure(size_t i, AttractorType type) {
+    type_[i] = type;
+    Reset(i);
+  }
+
+  void Reset(size_t i) {
+    x_[i] = prev_x_[i] = kInitialX;
+    y_[i] = prev_y_[i] = 0;
+    z_[i] = prev_z_[i] = 0;
+  }
+
+  // rate is 0-255; range (0-5) scales Lorenz time down by 2^(5 - range),
+  // Rössler ignores it
+  void set_rate(size_t i, int32_t rate, uint8_t range) {
+    if (rate < 0) rate = 0;
+    if (rate > 255) rate = 255;
+    dt_[i] = lut_lorenz_rate[rate];
+    if (type_[i] == ATTRACTOR_LORENZ) dt_[i] >>= (5 - range);
+  }
+
+  // Lorenz rho, or Rössler c, from the same 16-bit control
+  void set_rho(size_t i, int16_t rho) {
+    rho_[i] = (rho * (1 << 13)) + 24.0 * (1 << 24);
+    c_[i] = (rho + (6 << 3)) * (1 << 13);
+  }
+
+  // Call once per tick. Steps on the first tick of each period; outputs
+  // then reach the new state on the last.
+  void Process() {
+    if (!count_) {
+      for (size_t i = 0; i < N; ++i) {
+        prev_x_[i] = x_[i];
+        prev_y_[i] = y_[i];
+        prev_z_[i] = z_[i];
+        if (type_[i] == ATTRACTOR_LORENZ) StepLorenz(i);
+        else StepRossler(i);
+      }
+    }
+    count_ = (count_ + 1) & ((1 << decimation_shift_) - 1);
+  }
+
+  // Q24 state, interpolated to the current tick
+  int32_t value(size_t i, AttractorAxis axis) const {
+    const int32_t *cur = axis == ATTRACTOR_X ? x_ : (axis == ATTRACTOR_Y ? y_ : z_);
+    if (!count_) return cur[i];
+    const int32_t *prev = axis == ATTRACTOR_X ? prev_x_ : (axis == ATTRACTOR_Y ? prev_y_ : prev_z_);
+    const int64_t delta = static_cast<int64_t>(cur[i] - prev[i]) * count_;
+    return prev[i] + static_cast<int32_t>(delta >> decimation_shift_);
+  }
+
+  // As LorenzGenerator scales outputs for the DAC: x and y centred on 32769,
+  // z from 0
+  int32_t scaled(size_t i, AttractorAxis axis) const {
+    const int32_t v = value(i, axis);
+    // the Lorenz * 3 wraps for large z, as it always has on the device
+    const int32_t s = type_[i] == ATTRACTOR_LORENZ
+      ? static_cast<int32_t>(static_cast<uint32_t>(v) * 3u) >> 16
+      : v >> 14;
+    return axis == ATTRACTOR_Z ? s : s + 32769;
+  }
+
+private:
+  int32_t x_[N], y_[N], z_[N];
+  int32_t prev_x_[N], prev_y_[N], prev_z_[N];
+  int32_t rho_[N], c_[N];
+  uint32_t dt_[N];
+  uint8_t type_[N];
+  uint8_t decimation_shift_;
+  uint8_t count_;
+
+  // Q24 * Q24 -> Q20, which holds derivatives up to +/-2048
+  static int32_t mul_q20(int32_t a, int32_t b) {
+    return static_cast<int64_t>(a) * b >> 28;
+  }
+
+  void StepLorenz(size_t i) {
+    const int32_t x = x_[i], y = y_[i], z = z_[i];
+    if (precision == ATTRACTOR_PRECISION_64) {
+      const int64_t dt = dt_[i];
+      x_[i] = x + (dt * ((kSigma * static_cast<int64_t>(y - x)) >> 24) >> 24);
+      y_[i] = y + (dt * ((x * (static_cast<int64_t>(rho_[i]) - z) >> 24) - y) >> 24);
+      z_[i] = z + (dt * ((x * static_cast<int64_t>(y) >> 24) - (kBeta * static_cast<int64_t>(z) >> 24)) >> 24);
+    } else {
+      const int32_t dt = dt_[i];
+      const int32_t dx = mul_q20(kSigma, y - x);
+      const int32_t dy = mul_q20(x, rho_[i] - z) - (y >> 4);
+      const int32_t dz = mul_q20(x, y) - mul_q20(kBeta, z);
+      x_[i] = x + (static_cast<int64_t>(dt) * dx >> 20);
+      y_[i] = y + (static_cast<int64_t>(dt) * dy >> 20);
+      z_[i] = z + (static_cast<int64_t>(dt) * dz >> 20);
+    }
+  }
+
+  void StepRossler(size_t i) {
+    const int32_t x = x_[i], y = y_[i], z = z_[i];
+    if (precision == ATTRACTOR_PRECISION_64) {
+      const int64_t dt = dt_[i];
+      x_[i] = x + ((dt * (-y - z)) >> 24);
+      y_[i] = y + ((dt * (x + ((kRosslerA * static_cast<int64_t>(y)) >> 24))) >> 24);
+      z_[i] = z + ((dt * (kRosslerB + ((z * (static_cast<int64_t>(x) - c_[i])) >> 24))) >> 24);
+    } else {
+      const int32_t dt = dt_[i];
+      const int32_t dy = x + static_cast<int32_t>(static_cast<int64_t>(kRosslerA) * y >> 24);
+      const int32_t dz = (kRosslerB >> 4) + mul_q20(z, x - c_[i]);
+      x_[i] = x + (static_cast<int64_t>(dt) * (-y - z) >> 24);
+      y_[i] = y + (static_cast<int64_t>(dt) * dy >> 24);
+      z_[i] = z + (static_cast<int64_t>(dt) * dz >> 20);
+    }
+  }
+};
+
+}  // namespace streams
+
+#endif  // STREAMS_ATTRACTOR_ENGINE_H_
@@ -36,6 +36,7 @@
 #define STREAMS_LORENZ_GENERATOR_H_
 
 #include "util/util_macros.h"
+#include "streams_attractor_engine.h"
 // #include "stmlib/stmlib.h"
 // #include "streams/meta_parameters.h"
 
@@ -71,7 +72,11 @@ enum ELorenzOutputMap {
 
 class LorenzGenerator {
  public:
-  LorenzGenerator() { }
+  LorenzGenerator() {
+    engine_.Init();
+    engine_.Configure(kRossler1, ATTRACTOR_ROSSLER);
+    engine_.Configure(kRossler2, ATTRACTOR_ROSSLER);
+  }
   ~LorenzGenerator() { }
   
   void Init(uint8_t index);
@@ -84,33 +89,29 @@ class LorenzGenerator {
 
  
   inline void set_rho1(int16_t rho) {
-    // rho1_ = ((double)(rho) * (1 << 13)) + 24.0 * (1 << 24) ; // was 12
-    // c1_ = (double)(rho + (6 << 3)) * (1 << 13) ; // was 13
-    rho1_ = (rho * (1 << 13)) + 24.0 * (1 << 24) ; // was 12
-    c1_ = (rho + (6 << 3)) * (1 << 13) ; // was 13
+    engine_.set_rho(kLorenz1, rho);
+    engine_.set_rho(kRossler1, rho);
   }
 
   inline void set_rho2(int16_t rho) {
-    // rho2_ = ((double)(rho) * (1 << 13)) + 24.0 * (1 << 24) ; // was 12
-    // c2_ = (double)(rho + (6 << 3)) * (1 << 13) ; // was 13
-    rho2_ = (rho * (1 << 13)) + 24.0 * (1 << 24) ; // was 12
-    c2_ = (rho + (6 << 3)) * (1 << 13) ; // was 13
+    engine_.set_rho(kLorenz2, rho);
+    engine_.set_rho(kRossler2, rho);
   }
 
   inline void set_out_a(uint8_t out_a) {
-    out_a_ = out_a;
+    out_[0] = out_a;
   }
 
   inline void set_out_b(uint8_t out_b) {
-    out_b_ = out_b;
+    out_[1] = out_b;
   }
 
   inline void set_out_c(uint8_t out_c) {
-    out_c_ = out_c;
+    out_[2] = out_c;
   }
 
   inline void set_out_d(uint8_t out_d) {
-    out_d_ = out_d;
+    out_[3] = out_d;
   }
  
  inline const uint16_t dac_code(uint8_t index) const {
@@ -118,19 +119,27 @@ class LorenzGenerator {
   }
 
  private:
-  int32_t Lx1_, Ly1_, Lz1_;
-  int32_t Rx1_, Ry1_, Rz1_;
-  int32_t Lx2_, Ly2_, Lz2_;
-  int32_t Rx2_, Ry2_, Rz2_;
-
-  uint8_t out_a_, out_b_, out_c_, out_d_ ;
-
-  int64_t sigma_, rho1_, rho2_, beta_, c1_,  c2_ ;
+  // Engine slots, ordered so slot * 3 + axis is the single-axis output
+  enum {
+    kLorenz1,
+    kLorenz2,
+    kRossler1,
+    kRossler2,
+    kNumSystems
+  };
+
+  AttractorEngine<kNumSystems, ATTRACTOR_PRECISION_64> engine_;
+
+  uint8_t out_[kNumChannels];
   
   // O+C
   uint16_t dac_code_[kNumChannels];
  
   uint8_t index_;
+
+  int32_t Scaled(uint8_t output) const {
+    return engine_.scaled(output / 3, static_cast<AttractorAxis>(output % 3));
+  }
   
   DISALLOW_COPY_AND_ASSIGN(LorenzGenerator);
 };
@@ -18,9 +18,7 @@ uint16_t ShapePhase(
                              : WarpPhase((0xffff - phase) << 1, decay_curve);
 }
 
-uint16_t ShapePhase(uint16_t phase, uint16_t shape) {
-  uint32_t att = 0;
-  uint32_t dec = 0;
+static void ShapeCurves(uint16_t shape, uint32_t& att, uint32_t& dec) {
   if (shape < 1 * 65536 / 4) {
     shape *= 4;
     att = 0;
@@ -39,9 +37,31 @@ uint16_t ShapePhase(uint16_t phase, uint16_t shape) {
     att = 65535 - shape;
     dec = shape;
   }
+}
+
+uint16_t ShapePhase(uint16_t phase, uint16_t shape) {
+  uint32_t att = 0;
+  uint32_t dec = 0;
+  ShapeCurves(shape, att, dec);
   return ShapePhase(phase, att, dec);
 }
 
+static void ApplyFold(int16_t fold, TidesLiteSample& sample) {
+  if (fold > 0) {
+    int32_t wf_gain = 2048;
+    wf_gain += fold * (32767 - 1024) >> 14;
+    int32_t wf_balance = fold;
+
+    int32_t original = sample.unipolar;
+    int32_t folded = Interpolate824(wav_unipolar_fold, original * wf_gain) << 1;
+    sample.unipolar = original + ((folded - original) * wf_balance >> 15);
+
+    original = sample.bipolar;
+    folded = Interpolate824(wav_bipolar_fold, original * wf_gain + (1UL << 31));
+    sample.bipolar = original + ((folded - original) * wf_balance >> 15);
+  }
+}
+
 void ProcessSample(
   uint16_t slope,
   uint16_t shape,
@@ -76,17 +96,69 @@ void ProcessSample(
     sample.flags |= FLAG_EOA;
   }
 
-  if (fold > 0) {
-    int32_t wf_gain = 2048;
-    wf_gain += fold * (32767 - 1024) >> 14;
-    int32_t wf_balance = fold;
+  ApplyFold(fold, sample);
+}
 
-    int32_t original = sample.unipolar;
-    int32_t folded = Interpolate824(wav_unipolar_fold, original * wf_gain) << 1;
-    sample.unipolar = original + ((folded - original) * wf_balance >> 15);
+void TidesLiteShaper::SetSlope(uint16_t slope) {
+  slope_ = slope;
+  eoa_ = static_cast<uint32_t>(slope) << 16;
+  slope = slope ? slope : 1;
+  decay_factor_ = (32768 << kSlopeBits) / slope;
+  attack_factor_ = (32768 << kSlopeBits) / (65536 - slope);
+}
 
-    original = sample.bipolar;
-    folded = Interpolate824(wav_bipolar_fold, original * wf_gain + (1UL << 31));
-    sample.bipolar = original + ((folded - original) * wf_balance >> 15);
+void TidesLiteShaper::SetShape(uint16_t shape) {
+  shape_ = shape;
+  uint32_t att = 0;
+  uint32_t dec = 0;
+  ShapeCurves(shape, att, dec);
+  attack_ = MakeCurve(att);
+  decay_ = MakeCurve(dec);
+}
+
+TidesLiteShaper::Curve TidesLiteShaper::MakeCurve(uint16_t curve) {
+  int32_t c = (curve - 32767) >> 8;
+  uint32_t a = 128 * c * c;
+  return { a / max_8, c < 0 };
+}
+
+uint16_t TidesLiteShaper::Warp(uint16_t phase, const Curve& curve) {
+  if (curve.flip) phase = max_16 - phase;
+
+  // as in WarpPhase(), with a / max_8 precomputed
+  const uint32_t n = (max_8 + curve.k) * phase;
+  const uint32_t d = (max_16 + curve.k * phase / max_8) / max_8;
+
+  phase = n / d;
+  if (curve.flip) phase = max_16 - phase;
+  return phase;
+}
+
+void TidesLiteShaper::Process(
+  uint16_t slope,
+  uint16_t shape,
+  int16_t fold,
+  uint32_t phase,
+  TidesLiteSample& sample
+) {
+  if (slope != slope_) SetSlope(slope);
+  if (shape != shape_) SetShape(shape);
+
+  uint32_t skewed_phase;
+  if (phase <= eoa_) {
+    skewed_phase = (phase >> kSlopeBits) * decay_factor_;
+    sample.flags = FLAG_EOR;
+  } else {
+    skewed_phase = ((phase - eoa_) >> kSlopeBits) * attack_factor_;
+    skewed_phase += 1L << 31;
+    sample.flags = FLAG_EOA;
   }
+
+  sample.unipolar = Shape(skewed_phase >> 16);
+  sample.bipolar = Shape(skewed_phase >> 15) >> 1;
+  if (skewed_phase >= (1UL << 31)) {
+    sample.bipolar = -sample.bipolar;
+  }
+
+  ApplyFold(fold, sample);
 }
@@ -222,3 +222,49 @@ void ProcessSample(
   uint32_t phase,
   TidesLiteSample& sample
 );
+
+// Same output as ProcessSample(), bit for bit, but keeps what it can between
+// calls: the slope factors and the warp curves derived from shape are only
+// recomputed when those parameters change. That leaves one divide per warp,
+// which stays a hardware divide; a reciprocal estimate plus the correction
+// needed to stay exact measured slower than UDIV.
+class TidesLiteShaper {
+public:
+  void Init() {
+    slope_ = 0;
+    shape_ = 0;
+    SetSlope(0);
+    SetShape(0);
+  }
+
+  void Process(
+    uint16_t slope,
+    uint16_t shape,
+    int16_t fold,
+    uint32_t phase,
+    TidesLiteSample& sample
+  );
+
+private:
+  struct Curve {
+    uint32_t k; // a / max_8 in WarpPhase()
+    bool flip;
+  };
+
+  uint16_t slope_;
+  uint16_t shape_;
+  uint32_t eoa_;
+  uint32_t decay_factor_;
+  uint32_t attack_factor_;
+  Curve attack_;
+  Curve decay_;
+
+  void SetSlope(uint16_t slope);
+  void SetShape(uint16_t shape);
+  static Curve MakeCurve(uint16_t curve);
+  static uint16_t Warp(uint16_t phase, const Curve& curve);
+  uint16_t Shape(uint16_t phase) const {
+    return phase < (1UL << 15) ? Warp(phase << 1, attack_)
+                               : Warp((0xffff - phase) << 1, decay_);
+  }
+};
@@ -0,0 +1,118 @@
+// Copyright (c) 2018, Jason Justian
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef UTIL_LIFE_H_
+#define UTIL_LIFE_H_
+
+#include <stdint.h>
+
+namespace util {
+
+// Conway's Game of Life on a 64 x kRows toroid. Each row is one word, bit x
+// being column x, and a generation is computed a whole row at a time: the
+// eight neighbours of every cell are the row above, the row itself and the
+// row below rotated by one column each way, summed with bitwise adders.
+template <uint8_t kRows>
+class LifeBoard {
+public:
+  static const uint8_t kWidth = 64;
+  static const uint8_t kHeight = kRows;
+
+  void Clear() {
+    for (uint8_t y = 0; y < kRows; ++y) rows_[y] = 0;
+  }
+
+  void Set(uint8_t x, uint8_t y) {
+    rows_[y] |= uint64_t(1) << x;
+  }
+
+  bool Get(uint8_t x, uint8_t y) const {
+    return (rows_[y] >> x) & 1;
+  }
+
+  uint64_t row(uint8_t y) const {
+    return rows_[y];
+  }
+
+  // Advances one generation in place; returns the number of live cells
+  int Step() {
+    const uint64_t first = rows_[0];
+    uint64_t above = rows_[kRows - 1];
+    uint64_t current = first;
+    int population = 0;
+    for (uint8_t y = 0; y < kRows; ++y) {
+      const uint64_t below = y + 1 < kRows ? rows_[y + 1] : first;
+      rows_[y] = NextRow(above, current, below);
+      population += __builtin_popcountll(rows_[y]);
+      above = current;
+      current = below;
+    }
+    return population;
+  }
+
+  // Live cells less than radius columns and rows from (x, y), not wrapping
+  int CountNear(int x, int y, int radius) const {
+    const int x0 = x - radius + 1 < 0 ? 0 : x - radius + 1;
+    const int x1 = x + radius - 1 > kWidth - 1 ? kWidth - 1 : x + radius - 1;
+    const int y0 = y - radius + 1 < 0 ? 0 : y - radius + 1;
+    const int y1 = y + radius - 1 > kRows - 1 ? kRows - 1 : y + radius - 1;
+    if (x0 > x1) return 0;
+
+    const uint64_t mask = (~uint64_t(0) >> (kWidth - 1 - (x1 - x0))) << x0;
+    int count = 0;
+    for (int row = y0; row <= y1; ++row) count += __builtin_popcountll(rows_[row] & mask);
+    return count;
+  }
+
+private:
+  uint64_t rows_[kRows];
+
+  static uint64_t rotl(uint64_t v) { return (v << 1) | (v >> 63); }
+  static uint64_t rotr(uint64_t v) { return (v >> 1) | (v << 63); }
+
+  static uint64_t NextRow(uint64_t above, uint64_t current, uint64_t below) {
+    // Rows above and below contribute three neighbours each, 0-3 as two bits
+    const uint64_t al = rotl(above), ar = rotr(above);
+    const uint64_t a1 = al ^ above ^ ar;
+    const uint64_t a2 = (al & above) | (ar & (al ^ above));
+    const uint64_t bl = rotl(below), br = rotr(below);
+    const uint64_t b1 = bl ^ below ^ br;
+    const uint64_t b2 = (bl & below) | (br & (bl ^ below));
+    // The row itself two, 0-2
+    const uint64_t cl = rotl(current), cr = rotr(current);
+    const uint64_t c1 = cl ^ cr;
+    const uint64_t c2 = cl & cr;
+
+    // Units of the total, carrying into the twos
+    const uint64_t ones = a1 ^ b1 ^ c1;
+    const uint64_t carry = (a1 & b1) | (c1 & (a1 ^ b1));
+    // The twos column must hold exactly one for a total of 2 or 3
+    const uint64_t t1 = a2 ^ b2 ^ c2;
+    const uint64_t t2 = (a2 & b2) | (c2 & (a2 ^ b2));
+    const uint64_t one_two = (t1 ^ carry) & ~t2;
+
+    // 3 neighbours: born or survives; 2: survives
+    return one_two & (ones | current);
+  }
+};
+
+}  // namespace util
+
+#endif  // UTIL_LIFE_H_
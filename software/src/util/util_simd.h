@@ -0,0 +1,125 @@
+#ifndef UTIL_SIMD_H_
+#define UTIL_SIMD_H_
+
+#include <stdint.h>
+
+// Two 16-bit lanes packed in a uint32_t, lane 0 in the low half. These are
+// the Cortex-M4/M7 DSP instructions; elsewhere, plain C that gives the same
+// bits. Lane adds and subtracts wrap, like the instructions.
+
+namespace util {
+namespace simd {
+
+// (lo & 0xffff) | (hi << 16)
+static inline uint32_t pack16(int32_t lo, int32_t hi) __attribute__((always_inline));
+static inline uint32_t pack16(int32_t lo, int32_t hi) {
+#if defined(__ARM_ARCH_7EM__)
+  uint32_t out;
+  asm("pkhbt %0, %1, %2, lsl #16" : "=r" (out) : "r" (lo), "r" (hi));
+  return out;
+#else
+  return (static_cast<uint32_t>(lo) & 0xffff) | (static_cast<uint32_t>(hi) << 16);
+#endif
+}
+
+static inline int16_t lane0(uint32_t x) { return static_cast<int16_t>(x); }
+static inline int16_t lane1(uint32_t x) { return static_cast<int16_t>(x >> 16); }
+
+// Bytes 0 and 2, zero-extended into the two lanes
+static inline uint32_t uxtb16(uint32_t x) __attribute__((always_inline));
+static inline uint32_t uxtb16(uint32_t x) {
+#if defined(__ARM_ARCH_7EM__)
+  uint32_t out;
+  asm("uxtb16 %0, %1" : "=r" (out) : "r" (x));
+  return out;
+#else
+  return x & 0x00ff00ff;
+#endif
+}
+
+// Bytes 1 and 3, zero-extended into the two lanes
+static inline uint32_t uxtb16_ror8(uint32_t x) __attribute__((always_inline));
+static inline uint32_t uxtb16_ror8(uint32_t x) {
+#if defined(__ARM_ARCH_7EM__)
+  uint32_t out;
+  asm("uxtb16 %0, %1, ror #8" : "=r" (out) : "r" (x));
+  return out;
+#else
+  return (x >> 8) & 0x00ff00ff;
+#endif
+}
+
+static inline uint32_t sadd16(uint32_t a, uint32_t b) __attribute__((always_inline));
+static inline uint32_t sadd16(uint32_t a, uint32_t b) {
+#if defined(__ARM_ARCH_7EM__)
+  uint32_t out;
+  asm("sadd16 %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
+  return out;
+#else
+  return pack16(lane0(a) + lane0(b), lane1(a) + lane1(b));
+#endif
+}
+
+static inline uint32_t ssub16(uint32_t a, uint32_t b) __attribute__((always_inline));
+static inline uint32_t ssub16(uint32_t a, uint32_t b) {
+#if defined(__ARM_ARCH_7EM__)
+  uint32_t out;
+  asm("ssub16 %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
+  return out;
+#else
+  return pack16(lane0(a) - lane0(b), lane1(a) - lane1(b));
+#endif
+}
+
+// (a * lane0(b)) >> 16, with the full 48-bit product
+static inline int32_t smulwb(int32_t a, uint32_t b) __attribute__((always_inline));
+static inline int32_t smulwb(int32_t a, uint32_t b) {
+#if defined(__ARM_ARCH_7EM__)
+  int32_t out;
+  asm("smulwb %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
+  return out;
+#else
+  return static_cast<int32_t>((static_cast<int64_t>(a) * lane0(b)) >> 16);
+#endif
+}
+
+// (a * lane1(b)) >> 16, with the full 48-bit product
+static inline int32_t smulwt(int32_t a, uint32_t b) __attribute__((always_inline));
+static inline int32_t smulwt(int32_t a, uint32_t b) {
+#if defined(__ARM_ARCH_7EM__)
+  int32_t out;
+  asm("smulwt %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
+  return out;
+#else
+  return static_cast<int32_t>((static_cast<int64_t>(a) * lane1(b)) >> 16);
+#endif
+}
+
+// lane0(a) * lane0(b) + lane1(a) * lane1(b)
+static inline int32_t smuad(uint32_t a, uint32_t b) __attribute__((always_inline));
+static inline int32_t smuad(uint32_t a, uint32_t b) {
+#if defined(__ARM_ARCH_7EM__)
+  int32_t out;
+  asm("smuad %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
+  return out;
+#else
+  return static_cast<int32_t>(static_cast<uint32_t>(lane0(a) * lane0(b)) + static_cast<uint32_t>(lane1(a) * lane1(b)));
+#endif
+}
+
+// lane0(a) * lane0(b) - lane1(a) * lane1(b)
+static inline int32_t smusd(uint32_t a, uint32_t b) __attribute__((always_inline));
+static inline int32_t smusd(uint32_t a, uint32_t b) {
+#if defined(__ARM_ARCH_7EM__)
+  int32_t out;
+  asm("smusd %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
+  return out;
+#else
+  return static_cast<int32_t>(static_cast<uint32_t>(lane0(a) * lane0(b)) - static_cast<uint32_t>(lane1(a) * lane1(b)));
+#endif
+}
+
+} // namespace simd
+} // namespace util
+
+#endif // UTIL_SIMD_H_
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+namespace util {
+
+// Phase-locked tempo tracker for incoming clock pulses.
+//
+// An alpha-beta filter (the steady-state form of a constant-velocity Kalman
+// filter) tracks pulse period and phase from every pulse, rather than the
+// last interval alone. Gains start wide open for fast acquisition and
+// narrow over the first max_history pulses. Pulses too far from the
+// prediction are rejected as outliers. A run of raw intervals that agree
+// with each other but not with the estimate means the tempo really changed,
+// and the tracker re-acquires from the latest interval. Up to kMaxDropped
+// missing pulses are bridged as long as the next one lands on the grid;
+// after a longer gap the grid restarts from the next pulse.
+//
+// Times are in fixed-point ticks (kFracBits), free-running and wrapping;
+// only differences are used.
+template <int max_history = 32>
+class TempoTracker {
+public:
+  static constexpr int kFracBits = 8;
+  static constexpr int kReacquireCount = 3; // consistent off-tempo intervals before re-acquiring
+  static constexpr int kMaxDropped = 2; // missing pulses bridged on the grid
+  static constexpr int kLockCount = 8; // pulses accepted before lock is possible
+
+  void Init() {
+    last_time_ = last_interval_ = 0;
+    phase_ = period_ = 0;
+    pulses_ = 0;
+    n_ = 0;
+    changed_ = 0;
+    same_sign_ = 0;
+    last_err_ = 0;
+    jitter_ = 0;
+    locked_ = false;
+  }
+
+  // Returns true if the pulse was used to update the estimate
+  bool Pulse(uint32_t time) {
+    const uint32_t interval = time - last_time_;
+    if (pulses_ < 2) {
+      if (pulses_++) Acquire(time, interval);
+      last_time_ = time;
+      return true;
+    }
+
+    // tempo change?
+    if (!Differs(interval, period_, period_ / 8)) {
+      changed_ = 0;
+    } else if (changed_ && Differs(interval, last_interval_, interval / 8)) {
+      changed_ = 1; // off tempo, but not like the last one: a new run starts here
+    } else if (++changed_ >= kReacquireCount) {
+      Acquire(time, interval);
+      last_time_ = time;
+      return true;
+    }
+    last_interval_ = interval;
+
+    uint32_t predicted = phase_ + period_;
+    int32_t err = static_cast<int32_t>(time - predicted);
+
+    // late by one or more whole periods: missed pulses?
+    if (err > static_cast<int32_t>(period_ / 2)) {
+      const uint32_t missed = (err + period_ / 2) / period_;
+      if (missed > kMaxDropped) {
+        // too long a gap to bridge; pick up the grid again from here
+        phase_ = time;
+        last_time_ = time;
+        return false;
+      }
+      predicted += missed * period_;
+      err = static_cast<int32_t>(time - predicted);
+    }
+
+    if (static_cast<uint32_t>(abs(err)) > period_ / 4) {
+      last_time_ = time;
+      return false;
+    }
+
+    // persistent drift in one direction: tempo is ramping, widen the gains
+    if ((err > 0) == (last_err_ > 0) && static_cast<uint32_t>(abs(err)) > 2 * jitter_) {
+      if (++same_sign_ >= 4 && n_ > 4) n_ = 4;
+    } else {
+      same_sign_ = 0;
+    }
+    last_err_ = err;
+
+    if (n_ < max_history) ++n_;
+    // alpha = 2(2n-1) / n(n+1), beta = 6 / n(n+1), in Q16
+    const int32_t nn = n_ * (n_ + 1);
+    const int32_t alpha = (2 * (2 * n_ - 1) << 16) / nn;
+    const int32_t beta = (6 << 16) / nn;
+
+    phase_ = predicted + static_cast<int32_t>((static_cast<int64_t>(alpha) * err) >> 16);
+    period_ += static_cast<int32_t>((static_cast<int64_t>(beta) * err) >> 16);
+
+    const uint32_t abs_err = abs(err);
+    if (abs_err > jitter_) jitter_ += (abs_err - jitter_) >> 3;
+    else jitter_ -= (jitter_ - abs_err) >> 3;
+
+    locked_ = (n_ >= kLockCount) && (jitter_ < period_ / 16);
+    last_time_ = time;
+    return true;
+  }
+
+  // At least two pulses seen, so there's a period to report
+  bool valid() const { return pulses_ >= 2; }
+  bool locked() const { return locked_; }
+
+  // Filtered time of the most recent pulse
+  uint32_t phase() const { return phase_; }
+  // Estimated time between pulses
+  uint32_t period() const { return period_; }
+  // Smoothed absolute deviation of pulses from the prediction
+  uint32_t jitter() const { return jitter_; }
+
+private:
+  uint32_t last_time_;
+  uint32_t last_interval_;
+  uint32_t phase_;
+  uint32_t period_;
+  uint32_t jitter_;
+  int32_t last_err_;
+  uint8_t pulses_;
+  uint8_t n_;
+  uint8_t changed_;
+  uint8_t same_sign_;
+  bool locked_;
+
+  static bool Differs(uint32_t a, uint32_t b, uint32_t tolerance) {
+    return static_cast<uint32_t>(abs(static_cast<int32_t>(a - b))) > tolerance;
+  }
+
+  void Acquire(uint32_t time, uint32_t interval) {
+    period_ = interval ? interval : 1;
+    last_interval_ = period_;
+    phase_ = time;
+    n_ = 2;
+    changed_ = 0;
+    same_sign_ = 0;
+    jitter_ = period_ / 8;
+    locked_ = false;
+  }
+};
+
+} // namespace util
@@ -86,6 +86,7 @@ public:
             memcpy(&segments[segment_count], &segment, sizeof(segments[segment_count]));
             change_total_time(segments[segment_count].time);
             segment_count++;
+            precompute_segments();
         }
     }
 
@@ -96,6 +97,7 @@ public:
         memcpy(&segments[ix], &segment, sizeof(segments[ix]));
         change_total_time(segments[ix].time); // add
         if (ix == segment_count) segment_count++;
+        precompute_segments();
     }
 
     HS::VOSegment GetSegment(uint8_t ix) {
@@ -191,6 +193,12 @@ private:
     uint16_t scale; // The maximum (and minimum negative) output for this Oscillator
     int16_t offset = 0; // Amount added to each voltage output (e.g., to make it unipolar)
 
+    // Per-segment phase boundaries and divisor reciprocals, so traversal is
+    // multiply and shift only. Rebuilt whenever segments or timing change.
+    uint32_t segment_start_phase[HS::VO_MAX_SEGMENTS + 1]; // [segment_count] is the end of the last
+    uint32_t segment_divisor[HS::VO_MAX_SEGMENTS]; // 1 + (length >> 16)
+    uint32_t segment_reciprocal[HS::VO_MAX_SEGMENTS]; // 2^32 / divisor, rounded down
+
     /*
      * The Oscillator can only oscillate if the following conditions are true:
      *     (1) The frequency must be greater than 0
@@ -218,6 +226,23 @@ private:
         if (total_time != 0) time_unit = 0xffffffff / total_time;
     }
 
+    void precompute_segments() {
+        uint32_t start_time = 0;
+        for (uint8_t i = 0; i < segment_count; ++i) {
+            segment_start_phase[i] = time_unit * start_time;
+            start_time += segments[i].time;
+        }
+        // the last segment always runs to the end of the cycle
+        segment_start_phase[segment_count] = 0xffffffff;
+
+        for (uint8_t i = 0; i < segment_count; ++i) {
+            const uint32_t length = segment_start_phase[i + 1] - segment_start_phase[i];
+            // 1 + so denominator is guaranteed to be greater so we don't hit 65536
+            segment_divisor[i] = 1 + (length >> 16);
+            segment_reciprocal[i] = segment_divisor[i] > 1 ? 0xffffffff / segment_divisor[i] : 0;
+        }
+    }
+
     void find_segment(
         uint32_t phase,
         bool sustain,
@@ -227,14 +252,10 @@ private:
         uint16_t& segment_phase
     ) {
         if (total_time == 0) return; // vector osc hasn't been setup yet so bail
-        uint32_t start_phase = time_unit * segment_start;
-        uint32_t end_phase = segment == segment_count - 1
-            ? 0xffffffff
-            : start_phase + time_unit * segments[segment].time;
         // Note: unless a segment transition has occurred, you won't enter this
         // loop. Even then, it will normally only loop once unless a segment is
         // 0 length or frequency is extremely high
-        while (!(start_phase <= phase && phase <= end_phase)) {
+        while (!(segment_start_phase[segment] <= phase && phase <= segment_start_phase[segment + 1])) {
             if (sustain && segment == segment_count - 2) return;
             segment_start_level = (segments[segment].level - 128) * 256;
             segment_start += segments[segment].time;
@@ -243,21 +264,29 @@ private:
                 segment = 0;
                 segment_start = 0;
             }
-            start_phase = time_unit * segment_start;
-            end_phase = start_phase + time_unit * segments[segment].time;
         }
-        // 1 + so denominator is guaranteed to be greater so we don't hit 65536
-        segment_phase = ((phase - start_phase) / (1 + ((end_phase - start_phase) >> 16)));
+
+        // (phase - start) / divisor, by reciprocal; the estimate is at most one low
+        const uint32_t elapsed = phase - segment_start_phase[segment];
+        const uint32_t divisor = segment_divisor[segment];
+        if (divisor == 1) {
+            segment_phase = elapsed;
+            return;
+        }
+        uint32_t q = (static_cast<uint64_t>(elapsed) * segment_reciprocal[segment]) >> 32;
+        if (elapsed - q * divisor >= divisor) ++q;
+        segment_phase = q;
     }
 
     // Rescales full 16 bit signed valued based on scale and offset
     int16_t rescale(int16_t unscaled) {
         int32_t mult = unscaled * scale;
-        return mult / 32768 + offset;
+        // same as mult / 32768, which rounds toward zero
+        return ((mult + ((mult >> 31) & 32767)) >> 15) + offset;
     }
     
     int16_t update_current() {
-        uint16_t segment_phase;
+        uint16_t segment_phase = 0; // left alone if there are no segments yet
         find_segment(
             phase,
             sustain,
@@ -0,0 +1,18 @@
+#pragma once
+// Host stand-in for the Teensy Audio library umbrella header: the core
+// stream classes and CMSIS fallbacks, none of the library's own objects.
+
+#include "AudioStream.h"
+#include "arm_math.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+
+using std::abs;
+
+template <class T, class L, class H>
+inline T constrain(T x, L lo, H hi) {
+  return x < lo ? lo : (x > hi ? hi : x);
+}
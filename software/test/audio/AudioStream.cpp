@@ -0,0 +1,154 @@
+#include "AudioStream.h"
+
+#include <chrono>
+#include <vector>
+
+AudioStream *AudioStream::first_update = nullptr;
+int AudioStream::memory_used = 0;
+int AudioStream::memory_used_max = 0;
+
+// Set by the Teensy core's startup code; a T4.1 with 8 MB fitted, unless a
+// test says otherwise
+extern "C" {
+uint8_t external_psram_size = 8;
+}
+
+static std::vector<audio_block_t> memory_pool;
+static std::vector<uint16_t> free_blocks;
+
+AudioStream::AudioStream(unsigned char ninput, audio_block_t **iqueue)
+  : num_inputs(ninput)
+  , inputQueue(iqueue) {
+  for (unsigned char i = 0; i < num_inputs; i++) inputQueue[i] = nullptr;
+  // Appended, so streams update in the order they were constructed
+  AudioStream **p = &first_update;
+  while (*p) p = &(*p)->next_update;
+  *p = this;
+}
+
+AudioStream::~AudioStream() {
+  for (AudioStream **p = &first_update; *p; p = &(*p)->next_update) {
+    if (*p == this) {
+      *p = next_update;
+      break;
+    }
+  }
+  for (unsigned char i = 0; i < num_inputs; i++) {
+    if (inputQueue[i]) release(inputQueue[i]);
+    inputQueue[i] = nullptr;
+  }
+}
+
+void AudioStream::initialize_memory(unsigned int num) {
+  memory_pool.assign(num, audio_block_t());
+  free_blocks.clear();
+  for (unsigned int i = num; i > 0; i--) {
+    memory_pool[i - 1].memory_pool_index = static_cast<uint16_t>(i - 1);
+    free_blocks.push_back(static_cast<uint16_t>(i - 1));
+  }
+  memory_used = 0;
+  memory_used_max = 0;
+}
+
+audio_block_t *AudioStream::allocate() {
+  if (free_blocks.empty()) return nullptr;
+  audio_block_t *block = &memory_pool[free_blocks.back()];
+  free_blocks.pop_back();
+  block->ref_count = 1;
+  if (++memory_used > memory_used_max) memory_used_max = memory_used;
+  return block;
+}
+
+void AudioStream::release(audio_block_t *block) {
+  if (block == nullptr) return;
+  if (block->ref_count > 1) {
+    block->ref_count--;
+  } else {
+    block->ref_count = 0;
+    free_blocks.push_back(block->memory_pool_index);
+    memory_used--;
+  }
+}
+
+void AudioStream::transmit(audio_block_t *block, unsigned char index) {
+  for (AudioConnection *c = destination_list; c != nullptr; c = c->next_dest) {
+    if (c->src_index == index && c->dst->inputQueue[c->dest_index] == nullptr) {
+      c->dst->inputQueue[c->dest_index] = block;
+      block->ref_count++;
+    }
+  }
+}
+
+audio_block_t *AudioStream::receiveReadOnly(unsigned int index) {
+  if (index >= num_inputs) return nullptr;
+  audio_block_t *in = inputQueue[index];
+  inputQueue[index] = nullptr;
+  return in;
+}
+
+audio_block_t *AudioStream::receiveWritable(unsigned int index) {
+  audio_block_t *in = receiveReadOnly(index);
+  if (in && in->ref_count > 1) {
+    audio_block_t *p = allocate();
+    if (p) memcpy(p->data, in->data, sizeof(p->data));
+    in->ref_count--;
+    in = p;
+  }
+  return in;
+}
+
+void AudioStream::update_all() {
+  for (AudioStream *p = first_update; p; p = p->next_update) {
+    if (!p->active) continue;
+    const auto start = std::chrono::steady_clock::now();
+    p->update();
+    const auto end = std::chrono::steady_clock::now();
+    p->last_us = std::chrono::duration<float, std::micro>(end - start).count();
+    if (p->last_us > p->max_us) p->max_us = p->last_us;
+    p->total_us += p->last_us;
+    p->updates++;
+  }
+}
+
+int AudioConnection::connect(AudioStream &source, unsigned char source_output, AudioStream &destination, unsigned char destination_input) {
+  if (isConnected) return 1;
+  if (destination_input >= destination.num_inputs) return 2;
+
+  // One source per input, as on the Teensy
+  for (AudioStream *s = AudioStream::first_update; s; s = s->next_update) {
+    for (AudioConnection *c = s->destination_list; c; c = c->next_dest) {
+      if (c->dst == &destination && c->dest_index == destination_input) return 3;
+    }
+  }
+
+  src = &source;
+  dst = &destination;
+  src_index = source_output;
+  dest_index = destination_input;
+  next_dest = nullptr;
+  AudioConnection **p = &source.destination_list;
+  while (*p) p = &(*p)->next_dest;
+  *p = this;
+  source.active = true;
+  destination.active = true;
+  isConnected = true;
+  return 0;
+}
+
+int AudioConnection::disconnect() {
+  if (!isConnected) return 1;
+  for (AudioConnection **p = &src->destination_list; *p; p = &(*p)->next_dest) {
+    if (*p == this) {
+      *p = next_dest;
+      break;
+    }
+  }
+  // A block already queued from this source is dropped
+  audio_block_t *&queued = dst->inputQueue[dest_index];
+  if (queued) {
+    AudioStream::release(queued);
+    queued = nullptr;
+  }
+  isConnected = false;
+  return 0;
+}
@@ -0,0 +1,118 @@
+#pragma once
+// Host stand-in for the Teensy core AudioStream, so the streams in src/Audio
+// can run off-target. Same block and connection semantics as
+// github.com/PaulStoffregen/cores/blob/master/teensy4/AudioStream.h: blocks
+// are reference counted from a fixed pool, transmit() only fills empty input
+// queues, and update_all() runs every active stream in construction order.
+//
+// Instead of cycle counts, each update() is timed with the host clock; see
+// update_us() and friends. processorUsage() and processorUsageMax() give that
+// as a percentage of the block period, as on the Teensy, but of this host.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define AUDIO_BLOCK_SAMPLES 128
+#define AUDIO_SAMPLE_RATE_EXACT 44100.0f
+#define AUDIO_SAMPLE_RATE AUDIO_SAMPLE_RATE_EXACT
+
+typedef struct audio_block_struct {
+  uint8_t ref_count;
+  uint8_t reserved1;
+  uint16_t memory_pool_index;
+  int16_t data[AUDIO_BLOCK_SAMPLES];
+} audio_block_t;
+
+class AudioStream;
+
+class AudioConnection {
+public:
+  AudioConnection() {}
+  AudioConnection(AudioStream &source, AudioStream &destination) {
+    connect(source, 0, destination, 0);
+  }
+  AudioConnection(AudioStream &source, unsigned char source_output, AudioStream &destination, unsigned char destination_input) {
+    connect(source, source_output, destination, destination_input);
+  }
+  ~AudioConnection() {
+    disconnect();
+  }
+  AudioConnection(const AudioConnection &) = delete;
+  AudioConnection &operator=(const AudioConnection &) = delete;
+
+  int connect(AudioStream &source, unsigned char source_output, AudioStream &destination, unsigned char destination_input);
+  int disconnect();
+
+protected:
+  AudioStream *src = nullptr;
+  AudioStream *dst = nullptr;
+  unsigned char src_index = 0;
+  unsigned char dest_index = 0;
+  AudioConnection *next_dest = nullptr;
+  bool isConnected = false;
+
+  friend class AudioStream;
+};
+
+class AudioStream {
+public:
+  AudioStream(unsigned char ninput, audio_block_t **iqueue);
+  virtual ~AudioStream();
+
+  static void initialize_memory(unsigned int num);
+  static void update_all();
+
+  bool isActive() const { return active; }
+
+  // Microseconds spent in the last update(), the most in any one since
+  // the last reset, and the running total over update_count() calls
+  float update_us() const { return last_us; }
+  float update_us_max() const { return max_us; }
+  double update_us_total() const { return total_us; }
+  uint32_t update_count() const { return updates; }
+  float processorUsage() const { return last_us * kPercentPerUs; }
+  float processorUsageMax() const { return max_us * kPercentPerUs; }
+  void processorUsageMaxReset() { max_us = last_us; }
+  void processorUsageReset() {
+    max_us = 0.0f;
+    total_us = 0.0;
+    updates = 0;
+  }
+
+  static int memory_used;
+  static int memory_used_max;
+
+protected:
+  bool active = false;
+  unsigned char num_inputs;
+
+  static audio_block_t *allocate();
+  static void release(audio_block_t *block);
+  void transmit(audio_block_t *block, unsigned char index = 0);
+  audio_block_t *receiveReadOnly(unsigned int index = 0);
+  audio_block_t *receiveWritable(unsigned int index = 0);
+  virtual void update() = 0;
+
+private:
+  static constexpr float kPercentPerUs = 100.0f * AUDIO_SAMPLE_RATE_EXACT / (AUDIO_BLOCK_SAMPLES * 1e6f);
+
+  AudioConnection *destination_list = nullptr;
+  audio_block_t **inputQueue;
+  AudioStream *next_update = nullptr;
+  float last_us = 0.0f;
+  float max_us = 0.0f;
+  double total_us = 0.0;
+  uint32_t updates = 0;
+
+  static AudioStream *first_update;
+
+  friend class AudioConnection;
+};
+
+#define AudioMemory(num) AudioStream::initialize_memory(num)
+#define AudioNoInterrupts()
+#define AudioInterrupts()
+#define AudioMemoryUsage() (AudioStream::memory_used)
+#define AudioMemoryUsageMax() (AudioStream::memory_used_max)
+#define AudioMemoryUsageMaxReset() (AudioStream::memory_used_max = AudioStream::memory_used)
@@ -0,0 +1,51 @@
+#pragma once
+// Host stand-in for the Teensy SD library: files are opened from the host
+// filesystem, relative to the working directory.
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define FILE_READ 0
+
+class File {
+public:
+  File() {}
+  explicit File(FILE *f) : f_(f) {}
+
+  explicit operator bool() const { return f_ != nullptr; }
+
+  int read(void *buf, size_t nbyte) {
+    if (!f_) return -1;
+    return static_cast<int>(fread(buf, 1, nbyte, f_));
+  }
+  bool seek(uint64_t pos) {
+    return f_ && fseek(f_, static_cast<long>(pos), SEEK_SET) == 0;
+  }
+  uint64_t position() {
+    return f_ ? static_cast<uint64_t>(ftell(f_)) : 0;
+  }
+  uint64_t size() {
+    if (!f_) return 0;
+    const long here = ftell(f_);
+    fseek(f_, 0, SEEK_END);
+    const long end = ftell(f_);
+    fseek(f_, here, SEEK_SET);
+    return static_cast<uint64_t>(end);
+  }
+  void close() {
+    if (f_) fclose(f_);
+    f_ = nullptr;
+  }
+
+private:
+  FILE *f_ = nullptr;
+};
+
+class SDClass {
+public:
+  File open(const char *path, uint8_t mode = FILE_READ) {
+    return File(fopen(path, "rb"));
+  }
+};
+
+inline SDClass SD;
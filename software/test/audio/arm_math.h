@@ -0,0 +1,63 @@
+#pragma once
+// Portable fallbacks for the CMSIS-DSP functions used in src/, with the same
+// rounding and saturation as the non-ARM_MATH_ROUNDING Cortex-M builds. Only
+// what the tree calls is here; add to it as streams need more.
+
+#include <stdint.h>
+
+typedef int8_t q7_t;
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+typedef int64_t q63_t;
+typedef float float32_t;
+
+static inline int32_t __SSAT(int32_t val, uint32_t sat) {
+  const int32_t max = (1 << (sat - 1)) - 1;
+  const int32_t min = -max - 1;
+  return val > max ? max : (val < min ? min : val);
+}
+
+static inline void arm_fill_f32(float32_t value, float32_t *pDst, uint32_t blockSize) {
+  for (uint32_t i = 0; i < blockSize; i++) pDst[i] = value;
+}
+
+static inline void arm_add_f32(const float32_t *pSrcA, const float32_t *pSrcB, float32_t *pDst, uint32_t blockSize) {
+  for (uint32_t i = 0; i < blockSize; i++) pDst[i] = pSrcA[i] + pSrcB[i];
+}
+
+static inline void arm_mult_f32(const float32_t *pSrcA, const float32_t *pSrcB, float32_t *pDst, uint32_t blockSize) {
+  for (uint32_t i = 0; i < blockSize; i++) pDst[i] = pSrcA[i] * pSrcB[i];
+}
+
+static inline void arm_scale_f32(const float32_t *pSrc, float32_t scale, float32_t *pDst, uint32_t blockSize) {
+  for (uint32_t i = 0; i < blockSize; i++) pDst[i] = pSrc[i] * scale;
+}
+
+static inline void arm_clip_f32(const float32_t *pSrc, float32_t *pDst, float32_t low, float32_t high, uint32_t numSamples) {
+  for (uint32_t i = 0; i < numSamples; i++) pDst[i] = pSrc[i] > high ? high : (pSrc[i] < low ? low : pSrc[i]);
+}
+
+static inline void arm_q15_to_float(const q15_t *pSrc, float32_t *pDst, uint32_t blockSize) {
+  for (uint32_t i = 0; i < blockSize; i++) pDst[i] = static_cast<float32_t>(pSrc[i]) / 32768.0f;
+}
+
+static inline void arm_float_to_q15(const float32_t *pSrc, q15_t *pDst, uint32_t blockSize) {
+  for (uint32_t i = 0; i < blockSize; i++) pDst[i] = static_cast<q15_t>(__SSAT(static_cast<q31_t>(pSrc[i] * 32768.0f), 16));
+}
+
+static inline void arm_add_q15(const q15_t *pSrcA, const q15_t *pSrcB, q15_t *pDst, uint32_t blockSize) {
+  for (uint32_t i = 0; i < blockSize; i++) pDst[i] = static_cast<q15_t>(__SSAT(pSrcA[i] + pSrcB[i], 16));
+}
+
+static inline void arm_sub_q15(const q15_t *pSrcA, const q15_t *pSrcB, q15_t *pDst, uint32_t blockSize) {
+  for (uint32_t i = 0; i < blockSize; i++) pDst[i] = static_cast<q15_t>(__SSAT(pSrcA[i] - pSrcB[i], 16));
+}
+
+static inline void arm_mult_q15(const q15_t *pSrcA, const q15_t *pSrcB, q15_t *pDst, uint32_t blockSize) {
+  for (uint32_t i = 0; i < blockSize; i++) pDst[i] = static_cast<q15_t>(__SSAT((static_cast<q31_t>(pSrcA[i]) * pSrcB[i]) >> 15, 16));
+}
+
+static inline void arm_scale_q15(const q15_t *pSrc, q15_t scaleFract, int8_t shift, q15_t *pDst, uint32_t blockSize) {
+  const int8_t kShift = 15 - shift;
+  for (uint32_t i = 0; i < blockSize; i++) pDst[i] = static_cast<q15_t>(__SSAT((static_cast<q31_t>(pSrc[i]) * scaleFract) >> kShift, 16));
+}
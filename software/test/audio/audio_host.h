@@ -0,0 +1,111 @@
+#pragma once
+// Offline runner for AudioStream graphs: a source that plays interleaved
+// samples in, a sink that records them, and the loop that drives
+// AudioStream::update_all() one block at a time as the I2S interrupt does on
+// the Teensy.
+
+#include "AudioStream.h"
+#include "wav_file.h"
+
+#include <stdio.h>
+#include <vector>
+
+namespace audio_host {
+
+// Plays wav into one output per channel, then silence so tails render
+template <uint8_t Channels>
+class SourceStream : public AudioStream {
+public:
+  SourceStream() : AudioStream(0, nullptr) {}
+
+  void Play(const WavData *wav) {
+    wav_ = wav;
+    position_ = 0;
+  }
+
+  bool done() const {
+    return wav_ == nullptr || position_ >= wav_->frames();
+  }
+
+  void update() override {
+    for (uint8_t ch = 0; ch < Channels; ++ch) {
+      audio_block_t *block = allocate();
+      if (!block) return;
+      for (size_t i = 0; i < AUDIO_BLOCK_SAMPLES; ++i) {
+        const size_t frame = position_ + i;
+        block->data[i] = wav_ && frame < wav_->frames() && ch < wav_->channels
+          ? wav_->samples[frame * wav_->channels + ch]
+          : 0;
+      }
+      transmit(block, ch);
+      release(block);
+    }
+    position_ += AUDIO_BLOCK_SAMPLES;
+  }
+
+private:
+  const WavData *wav_ = nullptr;
+  size_t position_ = 0;
+};
+
+// Records one input per channel; a missing block is silence, as at the DAC
+template <uint8_t Channels>
+class SinkStream : public AudioStream {
+public:
+  SinkStream() : AudioStream(Channels, inputQueueArray) {}
+
+  WavData wav;
+
+  void Clear() {
+    wav.channels = Channels;
+    wav.samples.clear();
+  }
+
+  void update() override {
+    const size_t start = wav.samples.size();
+    wav.channels = Channels;
+    wav.samples.resize(start + AUDIO_BLOCK_SAMPLES * Channels, 0);
+    for (uint8_t ch = 0; ch < Channels; ++ch) {
+      audio_block_t *block = receiveReadOnly(ch);
+      if (!block) continue;
+      for (size_t i = 0; i < AUDIO_BLOCK_SAMPLES; ++i)
+        wav.samples[start + i * Channels + ch] = block->data[i];
+      release(block);
+    }
+  }
+
+private:
+  audio_block_t *inputQueueArray[Channels];
+};
+
+// Runs whole blocks until the source is exhausted, plus tail_blocks more,
+// calling mainloop() before each as the Teensy's mainloop runs between
+// audio interrupts
+template <uint8_t Channels, typename Mainloop>
+inline size_t Render(SourceStream<Channels> &source, size_t tail_blocks, Mainloop mainloop) {
+  size_t blocks = 0;
+  while (!source.done()) {
+    mainloop();
+    AudioStream::update_all();
+    ++blocks;
+  }
+  for (size_t i = 0; i < tail_blocks; ++i) {
+    mainloop();
+    AudioStream::update_all();
+  }
+  return blocks + tail_blocks;
+}
+
+template <uint8_t Channels>
+inline size_t Render(SourceStream<Channels> &source, size_t tail_blocks = 0) {
+  return Render(source, tail_blocks, [] {});
+}
+
+// One line per stream: mean and worst microseconds per 128-sample block
+inline void PrintUsage(const char *name, const AudioStream &stream) {
+  const uint32_t n = stream.update_count();
+  printf("[ BENCH    ] %-16s %8.2f us/block mean, %8.2f max (%u blocks)\n",
+         name, n ? stream.update_us_total() / n : 0.0, stream.update_us_max(), static_cast<unsigned>(n));
+}
+
+}  // namespace audio_host
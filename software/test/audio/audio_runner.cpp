@@ -0,0 +1,274 @@
+// Streams a WAV file through a chain of the streams in src/Audio, laid out
+// as the applet slots are: a mono stage runs once per channel, a stereo stage
+// once across both. Writes the result and prints the host time each stage
+// took per 128-sample block.
+//
+//   make audio_runner GTEST_DIR=...
+//   build/audio_runner in.wav out.wav [-t tail_secs] stage [stage...]
+//
+// Mono stages:
+//   passthru
+//   vca:<gain>
+//   mixer:<gain>
+//   delay:<secs>[:<feedback>]
+//   reverb:<rt60 secs>
+//   freeverb:<roomsize>[:<damping>]
+//   ladder:<hz>[:<resonance>[:<oversampling>]]
+//   interp:<method 0-3>     input taken at the core ISR rate and upsampled
+//                           back, as CV reaches the Upsampled applet
+// Stereo stages:
+//   freeverb2:<roomsize>[:<damping>]
+//   wav:<file>[:<rate>]     a WAV player mixed in with the input
+//
+// e.g. to size a slot chain of a mono filter into a stereo reverb:
+//   build/audio_runner in.wav out.wav -t 3 ladder:800:0.6 freeverb2:0.8
+
+#include "audio_host.h"
+#include "OC_config.h"
+#include "Audio/AudioDelayExt.h"
+#include "Audio/AudioLadderFilter.h"
+#include "Audio/AudioMixer.h"
+#include "Audio/AudioPassthrough.h"
+#include "Audio/AudioPlayWavStream.h"
+#include "Audio/AudioVCA.h"
+#include "Audio/InterpolatingStream.h"
+#include "Audio/effect_reverb_freeverb.h"
+#include "Audio/effect_reverb_schroeder.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+static const uint8_t kMaxChannels = 2;
+
+// Where a stage's channels go in and come out
+struct Port {
+  AudioStream *stream = nullptr;
+  uint8_t index = 0;
+};
+
+struct Stage {
+  std::string name;
+  // All the stage's streams, in the order they update
+  std::vector<std::unique_ptr<AudioStream>> streams;
+  // Those that run on the Teensy, and so count towards its time
+  std::vector<AudioStream *> timed;
+  // Inside the stage; after streams, so they go first
+  std::vector<std::unique_ptr<AudioConnection>> cables;
+  Port in[kMaxChannels];
+  Port out[kMaxChannels];
+  uint8_t channels = 1;
+  // Called between blocks, as mainloop runs between audio interrupts
+  std::function<void()> mainloop;
+
+  template <typename T>
+  T *Add(T *stream, bool time = true) {
+    streams.emplace_back(stream);
+    if (time) timed.push_back(stream);
+    return stream;
+  }
+
+  template <typename T>
+  T *AddThrough(T *stream) {
+    Add(stream);
+    in[0] = out[0] = { stream, 0 };
+    return stream;
+  }
+};
+
+// Takes its input at the core ISR rate, nearest sample, and pushes it into
+// an InterpolatingStream, as the core ISR pushes CV
+template <typename Interpolator>
+class CorePushStream : public AudioStream {
+public:
+  explicit CorePushStream(Interpolator &to) : AudioStream(1, inputQueueArray), to_(to) {}
+
+  void update() override {
+    audio_block_t *block = receiveReadOnly(0);
+    for (size_t i = 0; i < AUDIO_BLOCK_SAMPLES; ++i) {
+      phase_ += OC_CORE_ISR_FREQ;
+      if (phase_ >= AUDIO_SAMPLE_RATE_EXACT) {
+        phase_ -= AUDIO_SAMPLE_RATE_EXACT;
+        to_.Push(block ? block->data[i] : 0);
+      }
+    }
+    if (block) release(block);
+  }
+
+private:
+  audio_block_t *inputQueueArray[1];
+  Interpolator &to_;
+  float phase_ = 0.0f;
+};
+
+// Builds the stage for spec, or leaves it empty if spec isn't one
+static void MakeStage(const std::string &spec, Stage &stage) {
+  std::vector<float> args;
+  std::string kind = spec;
+  std::string text; // the first argument as given, for paths
+  const size_t colon = spec.find(':');
+  if (colon != std::string::npos) {
+    kind = spec.substr(0, colon);
+    text = spec.substr(colon + 1, spec.find(':', colon + 1) - colon - 1);
+    for (size_t pos = colon; pos != std::string::npos; pos = spec.find(':', pos + 1))
+      args.push_back(strtof(spec.c_str() + pos + 1, nullptr));
+  }
+  auto arg = [&](size_t i, float fallback) { return i < args.size() ? args[i] : fallback; };
+
+  if (kind == "passthru") {
+    stage.AddThrough(new AudioPassthrough<1>());
+  } else if (kind == "vca") {
+    stage.AddThrough(new AudioVCA())->bias(arg(0, 1.0f));
+  } else if (kind == "mixer") {
+    stage.AddThrough(new AudioMixer<1>())->gain(0, arg(0, 1.0f));
+  } else if (kind == "delay") {
+    auto *delay = stage.AddThrough(new AudioDelayExt<>());
+    delay->Acquire();
+    delay->delay(0, arg(0, 0.25f));
+    delay->feedback(0, arg(1, 0.0f));
+  } else if (kind == "reverb") {
+    stage.AddThrough(new AudioEffectReverbSchroeder<>())->setDecayTime(arg(0, 2.5f));
+  } else if (kind == "freeverb") {
+    auto *reverb = stage.AddThrough(new AudioEffectReverbFreeverb<>());
+    reverb->roomsize(arg(0, 0.5f));
+    reverb->damping(arg(1, 0.5f));
+  } else if (kind == "ladder") {
+    auto *ladder = stage.AddThrough(new AudioLadderFilter());
+    ladder->frequency(arg(0, 1000.0f));
+    ladder->resonance(arg(1, 0.0f));
+    ladder->oversampling(static_cast<int>(arg(2, AudioLadderFilter::MAX_OVERSAMPLING)));
+  } else if (kind == "interp") {
+    auto *interp = new InterpolatingStream<>();
+    stage.in[0] = { stage.Add(new CorePushStream<InterpolatingStream<>>(*interp), false), 0 };
+    stage.out[0] = { stage.Add(interp), 0 };
+    interp->Acquire();
+    interp->Method(static_cast<InterpolationMethod>(arg(0, INTERPOLATION_LINEAR)));
+  } else if (kind == "freeverb2") {
+    auto *reverb = stage.Add(new AudioEffectReverbFreeverb<2>());
+    reverb->roomsize(arg(0, 0.5f));
+    reverb->damping(arg(1, 0.5f));
+    stage.channels = 2;
+    for (uint8_t ch = 0; ch < 2; ++ch) stage.in[ch] = stage.out[ch] = { reverb, ch };
+  } else if (kind == "wav") {
+    auto *player = stage.Add(new AudioPlayWavStream());
+    if (!player->open(text.c_str())) {
+      fprintf(stderr, "%s: could not open\n", text.c_str());
+      stage.streams.clear();
+      return;
+    }
+    player->setPlaybackRate(arg(1, 1.0f));
+    player->play();
+    stage.channels = 2;
+    for (uint8_t ch = 0; ch < 2; ++ch) {
+      auto *mixer = stage.Add(new AudioMixer<2>());
+      mixer->gain(0, 1.0f);
+      mixer->gain(1, 1.0f);
+      stage.cables.emplace_back(new AudioConnection(*player, ch, *mixer, 0));
+      stage.in[ch] = { mixer, 1 };
+      stage.out[ch] = { mixer, 0 };
+    }
+    stage.mainloop = [player] { player->prefetch(); };
+  }
+}
+
+int main(int argc, char **argv) {
+  if (argc < 4) {
+    fprintf(stderr, "usage: %s in.wav out.wav [-t tail_secs] stage [stage...]\n", argv[0]);
+    return 1;
+  }
+
+  audio_host::WavData in;
+  if (!audio_host::ReadWav(argv[1], in)) {
+    fprintf(stderr, "%s: not a 16-bit PCM wav file\n", argv[1]);
+    return 1;
+  }
+  if (in.channels > kMaxChannels) {
+    fprintf(stderr, "%s: %u channels, at most %u supported\n", argv[1], in.channels, kMaxChannels);
+    return 1;
+  }
+  if (in.sample_rate != static_cast<uint32_t>(AUDIO_SAMPLE_RATE_EXACT))
+    fprintf(stderr, "warning: %s is %u Hz; processing as %.0f Hz\n", argv[1], in.sample_rate, AUDIO_SAMPLE_RATE_EXACT);
+
+  int arg = 3;
+  float tail_secs = 0.0f;
+  if (arg + 1 < argc && std::string(argv[arg]) == "-t") {
+    tail_secs = strtof(argv[arg + 1], nullptr);
+    arg += 2;
+  }
+
+  AudioMemory(64);
+  audio_host::SourceStream<kMaxChannels> source;
+  std::vector<std::unique_ptr<Stage>> stages;
+  std::vector<Stage *> chains[kMaxChannels];
+  for (int i = arg; i < argc; ++i) {
+    for (uint8_t ch = 0; ch < in.channels; ++ch) {
+      std::unique_ptr<Stage> stage(new Stage());
+      MakeStage(argv[i], *stage);
+      if (stage->streams.empty()) {
+        fprintf(stderr, "unknown stage '%s'\n", argv[i]);
+        return 1;
+      }
+      if (stage->channels == 2) {
+        stage->name = argv[i];
+        for (uint8_t c = 0; c < in.channels; ++c) chains[c].push_back(stage.get());
+        stages.push_back(std::move(stage));
+        break;
+      }
+      stage->name = std::string(ch ? "R " : "L ") + argv[i];
+      chains[ch].push_back(stage.get());
+      stages.push_back(std::move(stage));
+    }
+  }
+  audio_host::SinkStream<kMaxChannels> sink;
+
+  std::vector<std::unique_ptr<AudioConnection>> cables;
+  for (uint8_t ch = 0; ch < in.channels; ++ch) {
+    Port from = { &source, ch };
+    for (Stage *stage : chains[ch]) {
+      const uint8_t c = stage->channels == 2 ? ch : 0;
+      cables.emplace_back(new AudioConnection(*from.stream, from.index, *stage->in[c].stream, stage->in[c].index));
+      from = stage->out[c];
+    }
+    cables.emplace_back(new AudioConnection(*from.stream, from.index, sink, ch));
+  }
+
+  source.Play(&in);
+  sink.Clear();
+  const size_t tail_blocks = static_cast<size_t>(tail_secs * AUDIO_SAMPLE_RATE_EXACT / AUDIO_BLOCK_SAMPLES);
+  const size_t blocks = audio_host::Render(source, tail_blocks, [&] {
+    for (auto &stage : stages)
+      if (stage->mainloop) stage->mainloop();
+  });
+
+  audio_host::WavData out;
+  out.channels = in.channels;
+  out.sample_rate = in.sample_rate;
+  out.samples.reserve(blocks * AUDIO_BLOCK_SAMPLES * in.channels);
+  for (size_t frame = 0; frame < sink.wav.frames(); ++frame)
+    for (uint8_t ch = 0; ch < in.channels; ++ch) out.samples.push_back(sink.wav.samples[frame * kMaxChannels + ch]);
+  if (!audio_host::WriteWav(argv[2], out)) {
+    fprintf(stderr, "%s: could not write\n", argv[2]);
+    return 1;
+  }
+
+  double total = 0.0;
+  for (auto &stage : stages) {
+    double stage_total = 0.0;
+    float stage_max = 0.0f;
+    uint32_t n = 0;
+    for (AudioStream *stream : stage->timed) {
+      stage_total += stream->update_us_total();
+      stage_max += stream->update_us_max();
+      n = std::max(n, stream->update_count());
+    }
+    printf("[ BENCH    ] %-16s %8.2f us/block mean, %8.2f max (%u blocks)\n",
+           stage->name.c_str(), n ? stage_total / n : 0.0, stage_max, static_cast<unsigned>(n));
+    total += stage_total;
+  }
+  printf("[ BENCH    ] %-16s %8.2f us/block mean over %zu blocks, peak %d audio blocks in use\n",
+         "chain", blocks ? total / blocks : 0.0, blocks, AudioMemoryUsageMax());
+  return 0;
+}
@@ -0,0 +1,5 @@
+#pragma once
+// Interrupt masking is a no-op: the host runner is single threaded
+
+#define __disable_irq()
+#define __enable_irq()
@@ -0,0 +1,16 @@
+#pragma once
+// PSRAM allocation on the host is ordinary heap
+
+#include <stdlib.h>
+
+inline void *extmem_calloc(size_t nmemb, size_t size) {
+  return calloc(nmemb, size);
+}
+
+inline void extmem_free(void *ptr) {
+  free(ptr);
+}
+
+inline void *extmem_malloc(size_t size) {
+  return malloc(size);
+}
@@ -0,0 +1,89 @@
+#pragma once
+// Minimal RIFF WAVE reader and writer: 16-bit PCM only, interleaved frames.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace audio_host {
+
+struct WavData {
+  uint16_t channels = 1;
+  uint32_t sample_rate = 44100;
+  std::vector<int16_t> samples; // interleaved
+
+  size_t frames() const {
+    return channels ? samples.size() / channels : 0;
+  }
+};
+
+static inline uint32_t ReadLE(const uint8_t *p, int bytes) {
+  uint32_t v = 0;
+  for (int i = bytes - 1; i >= 0; --i) v = (v << 8) | p[i];
+  return v;
+}
+
+static inline void WriteLE(FILE *f, uint32_t v, int bytes) {
+  for (int i = 0; i < bytes; ++i) fputc((v >> (8 * i)) & 0xff, f);
+}
+
+// Returns false, leaving wav untouched, unless the file is 16-bit PCM
+inline bool ReadWav(const char *path, WavData &wav) {
+  FILE *f = fopen(path, "rb");
+  if (!f) return false;
+  std::vector<uint8_t> bytes;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) bytes.insert(bytes.end(), chunk, chunk + n);
+  fclose(f);
+
+  if (bytes.size() < 12 || memcmp(&bytes[0], "RIFF", 4) || memcmp(&bytes[8], "WAVE", 4)) return false;
+
+  uint16_t channels = 0, bits = 0, format = 0;
+  uint32_t sample_rate = 0;
+  size_t pos = 12;
+  while (pos + 8 <= bytes.size()) {
+    const uint32_t size = ReadLE(&bytes[pos + 4], 4);
+    const size_t body = pos + 8;
+    if (body + size > bytes.size()) return false;
+    if (!memcmp(&bytes[pos], "fmt ", 4) && size >= 16) {
+      format = ReadLE(&bytes[body], 2);
+      channels = ReadLE(&bytes[body + 2], 2);
+      sample_rate = ReadLE(&bytes[body + 4], 4);
+      bits = ReadLE(&bytes[body + 14], 2);
+    } else if (!memcmp(&bytes[pos], "data", 4)) {
+      if (format != 1 || bits != 16 || channels == 0) return false;
+      wav.channels = channels;
+      wav.sample_rate = sample_rate;
+      wav.samples.resize(size / 2);
+      for (size_t i = 0; i < wav.samples.size(); ++i)
+        wav.samples[i] = static_cast<int16_t>(ReadLE(&bytes[body + 2 * i], 2));
+      return true;
+    }
+    pos = body + size + (size & 1);
+  }
+  return false;
+}
+
+inline bool WriteWav(const char *path, const WavData &wav) {
+  FILE *f = fopen(path, "wb");
+  if (!f) return false;
+  const uint32_t data_size = static_cast<uint32_t>(wav.samples.size() * 2);
+  fwrite("RIFF", 1, 4, f);
+  WriteLE(f, 36 + data_size, 4);
+  fwrite("WAVEfmt ", 1, 8, f);
+  WriteLE(f, 16, 4);
+  WriteLE(f, 1, 2);
+  WriteLE(f, wav.channels, 2);
+  WriteLE(f, wav.sample_rate, 4);
+  WriteLE(f, wav.sample_rate * wav.channels * 2, 4);
+  WriteLE(f, wav.channels * 2, 2);
+  WriteLE(f, 16, 2);
+  fwrite("data", 1, 4, f);
+  WriteLE(f, data_size, 4);
+  for (int16_t s : wav.samples) WriteLE(f, static_cast<uint16_t>(s), 2);
+  return fclose(f) == 0;
+}
+
+}  // namespace audio_host
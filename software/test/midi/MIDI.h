@@ -0,0 +1,23 @@
+#pragma once
+// Host stand-in for the FortySevenEffects MIDI library; see midi_host.h
+
+#include "midi_host.h"
+
+class HardwareSerial {};
+
+namespace midi {
+
+typedef HostMIDIPort::MidiType MidiType;
+
+struct DefaultSettings {
+  static const bool UseRunningStatus = false;
+};
+
+template <typename SerialPort>
+class SerialMIDI {};
+
+// Running status is the scheduler's business; the port only records messages
+template <typename Transport, typename Settings = DefaultSettings>
+class MidiInterface : public HostMIDIPort {};
+
+} // namespace midi
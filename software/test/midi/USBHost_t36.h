@@ -0,0 +1,8 @@
+#pragma once
+// Host stand-in for the USBHost_t36 library; see midi_host.h
+
+#include "midi_host.h"
+
+class USBHost {};
+
+class MIDIDevice_BigBuffer : public HostMIDIPort {};
@@ -0,0 +1,11 @@
+// Definitions for the port stand-ins in midi_host.h, with the T4.1's ports
+#include "midi_host.h"
+#include "HSMIDI.h"
+
+usb_midi_class usbMIDI;
+USBHost thisUSB;
+MIDIDevice_BigBuffer usbHostMIDI;
+midi::MidiInterface<midi::SerialMIDI<HardwareSerial>, PhzMIDISettings> MIDI1;
+
+volatile uint32_t host_cycle_count = 0;
+int host_irq_disabled = 0;
@@ -0,0 +1,115 @@
+#pragma once
+// Host stand-ins for the Teensyduino MIDI ports, so HSMIDIQueue.h and
+// HSMIDIOutput.h can run off-target. Every port is a HostMIDIPort: tests
+// queue messages for read() to hand out, and whatever is sent is recorded.
+// Include this before anything from src.
+//
+// The cycle counter only moves when a test moves it, and interrupts are
+// never masked; noInterrupts()/interrupts() just count.
+
+#include <stdint.h>
+#include <deque>
+#include <vector>
+
+struct HostMIDIEvent {
+  uint8_t type, channel, data1, data2;
+  int bend; // sendPitchBend() only
+
+  bool operator==(const HostMIDIEvent &other) const {
+    return type == other.type && channel == other.channel
+      && data1 == other.data1 && data2 == other.data2 && bend == other.bend;
+  }
+};
+
+class HostMIDIPort {
+public:
+  // Message numbers as in usb_midi_class
+  enum MidiType : uint8_t {
+    InvalidType = 0x00,
+    NoteOff = 0x80,
+    NoteOn = 0x90,
+    AfterTouchPoly = 0xA0,
+    ControlChange = 0xB0,
+    ProgramChange = 0xC0,
+    AfterTouchChannel = 0xD0,
+    PitchBend = 0xE0,
+    SystemExclusive = 0xF0,
+    TimeCodeQuarterFrame = 0xF1,
+    SongPosition = 0xF2,
+    SongSelect = 0xF3,
+    TuneRequest = 0xF6,
+    Clock = 0xF8,
+    Start = 0xFA,
+    Continue = 0xFB,
+    Stop = 0xFC,
+    ActiveSensing = 0xFE,
+    SystemReset = 0xFF,
+  };
+
+  std::deque<HostMIDIEvent> incoming; // channel starts at 1, as the libraries give it
+  std::vector<HostMIDIEvent> sent;
+
+  void Clear() {
+    incoming.clear();
+    sent.clear();
+    sysex.clear();
+  }
+
+  // receiving
+  bool read() {
+    if (incoming.empty()) return false;
+    current_ = incoming.front();
+    incoming.pop_front();
+    return true;
+  }
+  uint8_t getType() const { return current_.type; }
+  uint8_t getChannel() const { return current_.channel; }
+  uint8_t getData1() const { return current_.data1; }
+  uint8_t getData2() const { return current_.data2; }
+
+  // sending; usbMIDI and usbHostMIDI take a cable number, MIDI1 doesn't
+  void send(uint8_t type, uint8_t data1, uint8_t data2, uint8_t channel, uint8_t cable = 0) {
+    sent.push_back({type, channel, data1, data2, 0});
+  }
+  void sendPitchBend(int value, uint8_t channel) {
+    sent.push_back({PitchBend, channel, 0, 0, value});
+  }
+  void sendAfterTouch(uint8_t pressure, uint8_t channel) {
+    sent.push_back({AfterTouchChannel, channel, pressure, 0, 0});
+  }
+  void sendRealTime(uint8_t type) {
+    sent.push_back({type, 0, 0, 0, 0});
+  }
+  void sendSysEx(uint32_t length, const uint8_t *data) {
+    sysex.assign(data, data + length);
+  }
+  void send_now() {}
+  uint8_t *getSysExArray() {
+    return sysex.data();
+  }
+
+  std::vector<uint8_t> sysex;
+
+private:
+  HostMIDIEvent current_ = {};
+};
+
+typedef HostMIDIPort usb_midi_class;
+extern usb_midi_class usbMIDI;
+
+extern volatile uint32_t host_cycle_count;
+#define ARM_DWT_CYCCNT host_cycle_count
+
+extern int host_irq_disabled;
+inline void noInterrupts() { ++host_irq_disabled; }
+inline void interrupts() { --host_irq_disabled; }
+
+// HSMIDI.h's MIDIQuantizer defaults to OC_DAC.h's T4 octave offset
+namespace OC {
+struct DAC {
+  static constexpr int kOctaveZero = 3;
+};
+} // namespace OC
+
+template <typename T>
+inline T min(T a, T b) { return b < a ? b : a; }
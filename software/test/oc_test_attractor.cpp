@@ -0,0 +1,235 @@
+#include "gtest/gtest.h"
+#include "streams_attractor_engine.h"
+#include "streams_lorenz_generator.h"
+#include "streams_resources.h"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace streams;
+
+// LorenzGenerator::Process() as it was before the attractor engine, with
+// the output mapping reduced to single axes. Kept as the reference.
+class ReferenceLorenz {
+public:
+  void Init(uint8_t index) {
+    if (index) {
+      Lx2_ = 0.1 * (1 << 24); Ly2_ = 0; Lz2_ = 0;
+      Rx2_ = 0.1 * (1 << 24); Ry2_ = 0; Rz2_ = 0;
+    } else {
+      Lx1_ = 0.1 * (1 << 24); Ly1_ = 0; Lz1_ = 0;
+      Rx1_ = 0.1 * (1 << 24); Ry1_ = 0; Rz1_ = 0;
+    }
+  }
+
+  void set_rho1(int16_t rho) {
+    rho1_ = (rho * (1 << 13)) + 24.0 * (1 << 24);
+    c1_ = (rho + (6 << 3)) * (1 << 13);
+  }
+
+  void set_rho2(int16_t rho) {
+    rho2_ = (rho * (1 << 13)) + 24.0 * (1 << 24);
+    c2_ = (rho + (6 << 3)) * (1 << 13);
+  }
+
+  void Process(int32_t freq1, int32_t freq2, bool reset1, bool reset2, uint8_t freq_range1, uint8_t freq_range2) {
+    const int64_t sigma = 10.0 * (1 << 24);
+    const int64_t beta = 8.0 / 3.0 * (1 << 24);
+    const int64_t a = 0.1 * (1 << 24);
+    const int64_t b = 0.1 * (1 << 24);
+
+    int32_t rate1 = (freq1 >> 8);
+    if (rate1 < 0) rate1 = 0;
+    if (rate1 > 255) rate1 = 255;
+    int32_t rate2 = (freq2 >> 8);
+    if (rate2 < 0) rate2 = 0;
+    if (rate2 > 255) rate2 = 255;
+
+    if (reset1) Init(0);
+    if (reset2) Init(1);
+
+    int64_t Ldt1 = static_cast<int64_t>(lut_lorenz_rate[rate1] >> (5 - freq_range1));
+    int32_t Lx1 = Lx1_ + (Ldt1 * ((sigma * (Ly1_ - Lx1_)) >> 24) >> 24);
+    int32_t Ly1 = Ly1_ + (Ldt1 * ((Lx1_ * (rho1_ - Lz1_) >> 24) - Ly1_) >> 24);
+    int32_t Lz1 = Lz1_ + (Ldt1 * ((Lx1_ * int64_t(Ly1_) >> 24) - (beta * Lz1_ >> 24)) >> 24);
+    Lx1_ = Lx1; Ly1_ = Ly1; Lz1_ = Lz1;
+    out_[0] = ((Lx1 * 3) >> 16) + 32769;
+    out_[1] = ((Ly1 * 3) >> 16) + 32769;
+    out_[2] = ((Lz1 * 3) >> 16);
+
+    int64_t Rdt1 = static_cast<int64_t>(lut_lorenz_rate[rate1] >> 0);
+    int32_t Rx1 = Rx1_ + ((Rdt1 * (-Ry1_ - Rz1_ )) >> 24);
+    int32_t Ry1 = Ry1_ + ((Rdt1 * (Rx1_ + ((a * Ry1_) >> 24))) >> 24);
+    int32_t Rz1 = Rz1_ + ((Rdt1 * (b + ((Rz1_ * (Rx1_ - c1_)) >> 24))) >> 24);
+    Rx1_ = Rx1; Ry1_ = Ry1; Rz1_ = Rz1;
+    out_[6] = (Rx1 >> 14) + 32769;
+    out_[7] = (Ry1 >> 14) + 32769;
+    out_[8] = (Rz1 >> 14);
+
+    int64_t Ldt2 = static_cast<int64_t>(lut_lorenz_rate[rate2] >> (5 - freq_range2));
+    int32_t Lx2 = Lx2_ + (Ldt2 * ((sigma * (Ly2_ - Lx2_)) >> 24) >> 24);
+    int32_t Ly2 = Ly2_ + (Ldt2 * ((Lx2_ * (rho2_ - Lz2_) >> 24) - Ly2_) >> 24);
+    int32_t Lz2 = Lz2_ + (Ldt2 * ((Lx2_ * int64_t(Ly2_) >> 24) - (beta * Lz2_ >> 24)) >> 24);
+    Lx2_ = Lx2; Ly2_ = Ly2; Lz2_ = Lz2;
+    out_[3] = ((Lx2 * 3) >> 16) + 32769;
+    out_[4] = ((Ly2 * 3) >> 16) + 32769;
+    out_[5] = ((Lz2 * 3) >> 16);
+
+    int64_t Rdt2 = static_cast<int64_t>(lut_lorenz_rate[rate2] >> 0);
+    int32_t Rx2 = Rx2_ + ((Rdt2 * (-Ry2_ - Rz2_ )) >> 24);
+    int32_t Ry2 = Ry2_ + ((Rdt2 * (Rx2_ + ((a * Ry2_) >> 24))) >> 24);
+    int32_t Rz2 = Rz2_ + ((Rdt2 * (b + ((Rz2_ * (Rx2_ - c2_)) >> 24))) >> 24);
+    Rx2_ = Rx2; Ry2_ = Ry2; Rz2_ = Rz2;
+    out_[9] = (Rx2 >> 14) + 32769;
+    out_[10] = (Ry2 >> 14) + 32769;
+    out_[11] = (Rz2 >> 14);
+  }
+
+  uint16_t out(uint8_t output) const { return out_[output]; }
+
+private:
+  int32_t Lx1_, Ly1_, Lz1_;
+  int32_t Rx1_, Ry1_, Rz1_;
+  int32_t Lx2_, Ly2_, Lz2_;
+  int32_t Rx2_, Ry2_, Rz2_;
+  int64_t rho1_, rho2_, c1_, c2_;
+  uint16_t out_[12];
+};
+
+static uint32_t NextRandom(uint32_t &seed) {
+  seed = seed * 1664525 + 1013904223;
+  return seed;
+}
+
+// Random settings held for a few thousand ticks each; every single-axis
+// output is checked on every tick.
+TEST(AttractorEngine, LorenzGeneratorMatchesReference) {
+  LorenzGenerator lorenz;
+  ReferenceLorenz ref;
+  lorenz.Init(0); lorenz.Init(1);
+  ref.Init(0); ref.Init(1);
+  uint32_t seed = 3;
+
+  for (int block = 0; block < 200; ++block) {
+    // rho control range as the app produces it
+    const int16_t rho1 = NextRandom(seed) >> 17, rho2 = NextRandom(seed) >> 17;
+    const int32_t freq1 = NextRandom(seed) >> 16, freq2 = NextRandom(seed) >> 16;
+    const uint8_t range1 = NextRandom(seed) % 5, range2 = NextRandom(seed) % 5;
+    lorenz.set_rho1(rho1); lorenz.set_rho2(rho2);
+    ref.set_rho1(rho1); ref.set_rho2(rho2);
+
+    for (int tick = 0; tick < 4000; ++tick) {
+      const bool reset1 = !(NextRandom(seed) >> 20), reset2 = !(NextRandom(seed) >> 20);
+      const uint8_t output = (tick >> 2) % 12;
+      lorenz.set_out_a(output);
+      lorenz.Process(freq1, freq2, reset1, reset2, range1, range2);
+      ref.Process(freq1, freq2, reset1, reset2, range1, range2);
+      ASSERT_EQ(ref.out(output), lorenz.dac_code(0)) << "block " << block << " tick " << tick << " output " << int(output);
+    }
+  }
+}
+
+// The 32-bit path tracks the 64-bit one closely until chaos pulls the two
+// apart, and covers the same range over long runs. Above rate ~200 the Euler
+// step is too coarse for Rössler at low c and both paths wrap int32, so the
+// Rössler range is only compared below that.
+TEST(AttractorEngine, Precision32TracksPrecision64) {
+  for (int rate = 0; rate < 256; rate += 15) {
+    AttractorEngine<4, ATTRACTOR_PRECISION_32> fast;
+    AttractorEngine<4, ATTRACTOR_PRECISION_64> wide;
+    fast.Init(); wide.Init();
+    fast.Configure(2, ATTRACTOR_ROSSLER); fast.Configure(3, ATTRACTOR_ROSSLER);
+    wide.Configure(2, ATTRACTOR_ROSSLER); wide.Configure(3, ATTRACTOR_ROSSLER);
+    for (size_t i = 0; i < 4; ++i) {
+      const int16_t rho = (i & 1) ? 32767 : 0;
+      fast.set_rate(i, rate, 4); wide.set_rate(i, rate, 4);
+      fast.set_rho(i, rho); wide.set_rho(i, rho);
+    }
+
+    int64_t fast_peak[4][3] = {}, wide_peak[4][3] = {};
+    for (int tick = 0; tick < 50000; ++tick) {
+      fast.Process(); wide.Process();
+      for (size_t i = 0; i < 4; ++i) {
+        for (int axis = ATTRACTOR_X; axis <= ATTRACTOR_Z; ++axis) {
+          const int32_t f = fast.value(i, static_cast<AttractorAxis>(axis));
+          const int32_t w = wide.value(i, static_cast<AttractorAxis>(axis));
+          if (tick < 100) {
+            ASSERT_NEAR(w, f, 1 << 12) << "rate " << rate << " system " << i;
+          }
+          fast_peak[i][axis] = std::max<int64_t>(fast_peak[i][axis], abs(f));
+          wide_peak[i][axis] = std::max<int64_t>(wide_peak[i][axis], abs(w));
+        }
+      }
+    }
+    for (size_t i = 0; i < 4; ++i) {
+      if (i >= 2 && rate > 200) continue;
+      for (int axis = ATTRACTOR_X; axis <= ATTRACTOR_Z; ++axis) {
+        EXPECT_NEAR(wide_peak[i][axis], fast_peak[i][axis], wide_peak[i][axis] / 8 + (1 << 20))
+          << "rate " << rate << " system " << i << " axis " << axis;
+      }
+    }
+  }
+}
+
+// Decimated, the engine lands on the full-rate trajectory at every step and
+// interpolates monotonically in between
+TEST(AttractorEngine, DecimationInterpolates) {
+  const uint8_t kShift = 4;
+  AttractorEngine<1, ATTRACTOR_PRECISION_32> full, decimated;
+  full.Init(0);
+  decimated.Init(kShift);
+  full.set_rate(0, 128, 2); decimated.set_rate(0, 128, 2);
+  full.set_rho(0, 8000); decimated.set_rho(0, 8000);
+
+  for (int step = 0; step < 5000; ++step) {
+    const int32_t from = full.value(0, ATTRACTOR_X);
+    full.Process();
+    const int32_t to = full.value(0, ATTRACTOR_X);
+    for (int t = 0; t < (1 << kShift); ++t) {
+      decimated.Process();
+      const int32_t v = decimated.value(0, ATTRACTOR_X);
+      ASSERT_GE(v, std::min(from, to));
+      ASSERT_LE(v, std::max(from, to));
+    }
+    ASSERT_EQ(to, decimated.value(0, ATTRACTOR_X)) << "step " << step;
+  }
+}
+
+// Time per tick for the Lorenz app's four systems, against the reference
+TEST(AttractorEngine, DISABLED_Benchmark) {
+  const int kTicks = 1 << 21;
+  ReferenceLorenz ref;
+  ref.Init(0); ref.Init(1);
+  ref.set_rho1(8000); ref.set_rho2(16000);
+  AttractorEngine<4, ATTRACTOR_PRECISION_64> wide;
+  AttractorEngine<4, ATTRACTOR_PRECISION_32> fast;
+  AttractorEngine<4, ATTRACTOR_PRECISION_32> decimated;
+  wide.Init(); fast.Init(); decimated.Init(4);
+  for (size_t i = 0; i < 4; ++i) {
+    wide.set_rate(i, 200, 2); fast.set_rate(i, 200, 2); decimated.set_rate(i, 200, 2);
+    wide.set_rho(i, 8000); fast.set_rho(i, 8000); decimated.set_rho(i, 8000);
+  }
+
+  int64_t sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < kTicks; ++t) { ref.Process(51200, 51200, false, false, 2, 2); sum += ref.out(t & 3); }
+  auto end = std::chrono::steady_clock::now();
+  const double ref_ns = std::chrono::duration<double, std::nano>(end - start).count() / kTicks;
+
+  AttractorEngine<4, ATTRACTOR_PRECISION_64> *wp = &wide;
+  start = std::chrono::steady_clock::now();
+  for (int t = 0; t < kTicks; ++t) { wp->Process(); sum += wp->scaled(t & 3, ATTRACTOR_X); }
+  end = std::chrono::steady_clock::now();
+  const double wide_ns = std::chrono::duration<double, std::nano>(end - start).count() / kTicks;
+
+  AttractorEngine<4, ATTRACTOR_PRECISION_32> *engines[] = { &fast, &decimated };
+  double ns[2];
+  for (int e = 0; e < 2; ++e) {
+    start = std::chrono::steady_clock::now();
+    for (int t = 0; t < kTicks; ++t) { engines[e]->Process(); sum += engines[e]->scaled(t & 3, ATTRACTOR_X); }
+    end = std::chrono::steady_clock::now();
+    ns[e] = std::chrono::duration<double, std::nano>(end - start).count() / kTicks;
+  }
+  printf("[ BENCH    ] (%lld) reference %.1f ns, engine 64-bit %.1f ns, 32-bit %.1f ns, 32-bit / 16 %.1f ns\n",
+         static_cast<long long>(sum & 1), ref_ns, wide_ns, ns[0], ns[1]);
+}
@@ -0,0 +1,1227 @@
+#include "gtest/gtest.h"
+#include "audio_host.h"
+#include "Audio/AudioDelayExt.h"
+#include "Audio/AudioLadderFilter.h"
+#include "Audio/AudioMixer.h"
+#include "Audio/AudioPassthrough.h"
+#include "Audio/InterpolatingStream.h"
+#include "Audio/AudioPlayWavStream.h"
+#include "Audio/AudioVCA.h"
+#include "Audio/WavSamplePool.h"
+#include "Audio/effect_reverb_freeverb.h"
+#include "Audio/effect_reverb_schroeder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <sys/time.h>
+#include <unistd.h>
+
+static audio_host::WavData Sine(size_t frames, uint16_t channels, float amplitude = 12000.0f) {
+  audio_host::WavData wav;
+  wav.channels = channels;
+  for (size_t i = 0; i < frames; ++i)
+    for (uint16_t ch = 0; ch < channels; ++ch)
+      wav.samples.push_back(static_cast<int16_t>(amplitude * sinf(6.2831853f * (220.0f * (ch + 1)) * i / AUDIO_SAMPLE_RATE_EXACT)));
+  return wav;
+}
+
+// Inverts its input in place, to check copy-on-write of shared blocks
+class InvertStream : public AudioStream {
+public:
+  InvertStream() : AudioStream(1, inputQueueArray) {}
+  void update() override {
+    audio_block_t *block = receiveWritable();
+    if (!block) return;
+    for (int16_t &s : block->data) s = static_cast<int16_t>(-s - 1);
+    transmit(block);
+    release(block);
+  }
+
+private:
+  audio_block_t *inputQueueArray[1];
+};
+
+TEST(AudioHost, PassthroughIsExact) {
+  AudioMemory(16);
+  const audio_host::WavData in = Sine(10 * AUDIO_BLOCK_SAMPLES, 2);
+  audio_host::SourceStream<2> source;
+  AudioPassthrough<2> thru;
+  audio_host::SinkStream<2> sink;
+  AudioConnection c0(source, 0, thru, 0), c1(source, 1, thru, 1);
+  AudioConnection c2(thru, 0, sink, 0), c3(thru, 1, sink, 1);
+
+  source.Play(&in);
+  sink.Clear();
+  EXPECT_EQ(10u, audio_host::Render(source));
+  EXPECT_EQ(in.samples, sink.wav.samples);
+  EXPECT_EQ(0, AudioMemoryUsage());
+  EXPECT_EQ(2, AudioMemoryUsageMax());
+}
+
+// Streams update in construction order, so one upstream of its source runs a
+// block late, as on the Teensy
+TEST(AudioHost, UpdateOrderLatency) {
+  AudioMemory(16);
+  const audio_host::WavData in = Sine(4 * AUDIO_BLOCK_SAMPLES, 1);
+  audio_host::SinkStream<1> sink;
+  audio_host::SourceStream<1> source;
+  AudioConnection c(source, 0, sink, 0);
+
+  source.Play(&in);
+  sink.Clear();
+  audio_host::Render(source, 1);
+  ASSERT_EQ(5u * AUDIO_BLOCK_SAMPLES, sink.wav.samples.size());
+  for (size_t i = 0; i < AUDIO_BLOCK_SAMPLES; ++i) EXPECT_EQ(0, sink.wav.samples[i]);
+  for (size_t i = 0; i < in.samples.size(); ++i) EXPECT_EQ(in.samples[i], sink.wav.samples[i + AUDIO_BLOCK_SAMPLES]);
+}
+
+TEST(AudioHost, SharedBlocksCopiedOnWrite) {
+  AudioMemory(16);
+  const audio_host::WavData in = Sine(3 * AUDIO_BLOCK_SAMPLES, 1);
+  audio_host::SourceStream<1> source;
+  InvertStream invert;
+  audio_host::SinkStream<2> sink;
+  AudioConnection c0(source, 0, invert, 0), c1(source, 0, sink, 0), c2(invert, 0, sink, 1);
+
+  source.Play(&in);
+  sink.Clear();
+  audio_host::Render(source);
+  for (size_t i = 0; i < in.frames(); ++i) {
+    EXPECT_EQ(in.samples[i], sink.wav.samples[2 * i]);
+    EXPECT_EQ(-in.samples[i] - 1, sink.wav.samples[2 * i + 1]);
+  }
+  EXPECT_EQ(0, AudioMemoryUsage());
+}
+
+TEST(AudioHost, DisconnectReleasesQueuedBlock) {
+  AudioMemory(4);
+  const audio_host::WavData in = Sine(AUDIO_BLOCK_SAMPLES, 1);
+  audio_host::SourceStream<1> source;
+  audio_host::SinkStream<1> sink;
+  AudioConnection c;
+  EXPECT_EQ(2, c.connect(source, 0, sink, 1));
+  EXPECT_EQ(0, c.connect(source, 0, sink, 0));
+  AudioConnection again;
+  EXPECT_EQ(3, again.connect(source, 0, sink, 0));
+
+  source.Play(&in);
+  AudioStream::update_all();
+  EXPECT_EQ(0, AudioMemoryUsage());
+  c.disconnect();
+  EXPECT_EQ(0, again.connect(source, 0, sink, 0));
+}
+
+TEST(AudioHost, VcaAndMixerGain) {
+  AudioMemory(16);
+  const audio_host::WavData in = Sine(8 * AUDIO_BLOCK_SAMPLES, 1);
+  audio_host::SourceStream<1> source;
+  AudioVCA vca;
+  AudioMixer<1> mixer;
+  audio_host::SinkStream<2> sink;
+  AudioConnection c0(source, 0, vca, 0), c1(source, 0, mixer, 0);
+  AudioConnection c2(vca, 0, sink, 0), c3(mixer, 0, sink, 1);
+  vca.bias(0.5f);
+  mixer.gain(0, 0.25f);
+
+  source.Play(&in);
+  sink.Clear();
+  audio_host::Render(source);
+  for (size_t i = 0; i < in.frames(); ++i) {
+    EXPECT_NEAR(in.samples[i] * 0.5f, sink.wav.samples[2 * i], 1.0f);
+    EXPECT_NEAR(in.samples[i] * 0.25f, sink.wav.samples[2 * i + 1], 1.0f);
+  }
+}
+
+// The constant gain fast paths: unity hands the block on untouched, zero
+// sends nothing, and a CV block at level 0 is released rather than held
+TEST(AudioHost, VcaAndMixerFastPaths) {
+  AudioMemory(16);
+  const audio_host::WavData in = Sine(4 * AUDIO_BLOCK_SAMPLES, 2);
+  const struct { float vca_bias, vca_level, gain0, gain1; bool silent; } cases[] = {
+    { 1.0f, 0.0f, 1.0f, 0.0f, false },
+    { 0.0f, 0.0f, 0.0f, 0.0f, true },
+    { -0.5f, 0.0f, 0.0f, 0.0f, true }, // rectified
+  };
+  for (const auto &c : cases) {
+    audio_host::SourceStream<2> source;
+    AudioVCA vca;
+    AudioMixer<2> mixer;
+    audio_host::SinkStream<2> sink;
+    AudioConnection c0(source, 0, vca, 0), c1(source, 1, vca, 1);
+    AudioConnection c2(source, 0, mixer, 0), c3(source, 1, mixer, 1);
+    AudioConnection c4(vca, 0, sink, 0), c5(mixer, 0, sink, 1);
+    vca.bias(c.vca_bias);
+    vca.level(c.vca_level);
+    vca.rectify(true);
+    mixer.gain(0, c.gain0);
+    mixer.gain(1, c.gain1);
+
+    source.Play(&in);
+    sink.Clear();
+    audio_host::Render(source);
+    for (size_t i = 0; i < in.frames(); ++i) {
+      const int16_t expected = c.silent ? 0 : in.samples[2 * i];
+      ASSERT_EQ(expected, sink.wav.samples[2 * i]) << i;
+      ASSERT_EQ(expected, sink.wav.samples[2 * i + 1]) << i;
+    }
+    EXPECT_EQ(0, AudioMemoryUsage());
+  }
+}
+
+// The block kernels AudioVCA and AudioMixer run on the M7, here in their
+// portable form, against the float path they stand in for
+TEST(AudioHost, Q15KernelsMatchFloat) {
+  uint32_t seed = 3;
+  auto next = [&seed] {
+    seed = seed * 1664525 + 1013904223;
+    return static_cast<int16_t>(seed >> 16);
+  };
+  for (int run = 0; run < 200; ++run) {
+    int16_t signal[AUDIO_BLOCK_SAMPLES], cv[AUDIO_BLOCK_SAMPLES], other[AUDIO_BLOCK_SAMPLES];
+    for (size_t i = 0; i < AUDIO_BLOCK_SAMPLES; ++i) {
+      signal[i] = next();
+      cv[i] = next();
+      other[i] = next();
+    }
+    const float level = next() / 8192.0f, bias = next() / 16384.0f;
+    const bool rectify = run & 1;
+
+    float signal_f32[AUDIO_BLOCK_SAMPLES], cv_f32[AUDIO_BLOCK_SAMPLES], other_f32[AUDIO_BLOCK_SAMPLES];
+    arm_q15_to_float(signal, signal_f32, AUDIO_BLOCK_SAMPLES);
+    arm_q15_to_float(cv, cv_f32, AUDIO_BLOCK_SAMPLES);
+    arm_q15_to_float(other, other_f32, AUDIO_BLOCK_SAMPLES);
+
+    float product[AUDIO_BLOCK_SAMPLES], sum[AUDIO_BLOCK_SAMPLES];
+    for (size_t i = 0; i < AUDIO_BLOCK_SAMPLES; ++i) {
+      float mod = bias + level * cv_f32[i];
+      if (rectify && mod < 0.0f) mod = 0.0f;
+      product[i] = mod * signal_f32[i];
+      sum[i] = level * signal_f32[i] + bias * other_f32[i];
+    }
+    int16_t expected[AUDIO_BLOCK_SAMPLES], actual[AUDIO_BLOCK_SAMPLES];
+    arm_float_to_q15(product, expected, AUDIO_BLOCK_SAMPLES);
+    q15::Modulate(signal, cv, q15::GainToQ16(bias), q15::GainToQ16(level), rectify, actual, AUDIO_BLOCK_SAMPLES);
+    for (size_t i = 0; i < AUDIO_BLOCK_SAMPLES; ++i)
+      ASSERT_NEAR(expected[i], actual[i], 2) << "modulate, run " << run << " @" << i;
+
+    for (size_t i = 0; i < AUDIO_BLOCK_SAMPLES; ++i) product[i] = bias * signal_f32[i];
+    arm_float_to_q15(product, expected, AUDIO_BLOCK_SAMPLES);
+    q15::Scale(signal, q15::GainToQ16(bias), actual, AUDIO_BLOCK_SAMPLES);
+    for (size_t i = 0; i < AUDIO_BLOCK_SAMPLES; ++i)
+      ASSERT_NEAR(expected[i], actual[i], 1) << "scale, run " << run << " @" << i;
+
+    int32_t acc[AUDIO_BLOCK_SAMPLES];
+    q15::MixInto(acc, signal, q15::GainToQ16(level), true, AUDIO_BLOCK_SAMPLES);
+    q15::MixInto(acc, other, q15::GainToQ16(bias), false, AUDIO_BLOCK_SAMPLES);
+    q15::Saturate(acc, actual, AUDIO_BLOCK_SAMPLES);
+    arm_float_to_q15(sum, expected, AUDIO_BLOCK_SAMPLES);
+    // 1 LSB per term, and 1 more as the float path truncates towards zero
+    for (size_t i = 0; i < AUDIO_BLOCK_SAMPLES; ++i)
+      ASSERT_NEAR(expected[i], actual[i], 3) << "mix, run " << run << " @" << i;
+  }
+}
+
+// Not a pass/fail test; block cost of the q15 kernels and the float path
+// they replace on the M7. On x86 the float path vectorises, so this says
+// little about the Teensy; its slot CPU readout does.
+TEST(AudioHost, DISABLED_Q15KernelsBenchmark) {
+  const int kBlocks = 100000;
+  int16_t signal[AUDIO_BLOCK_SAMPLES], cv[AUDIO_BLOCK_SAMPLES], out[AUDIO_BLOCK_SAMPLES];
+  for (size_t i = 0; i < AUDIO_BLOCK_SAMPLES; ++i) {
+    signal[i] = static_cast<int16_t>(i * 251);
+    cv[i] = static_cast<int16_t>(i * 97);
+  }
+  volatile int16_t sink = 0;
+  auto time = [&](auto f) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int b = 0; b < kBlocks; ++b) {
+      f();
+      sink = out[b & (AUDIO_BLOCK_SAMPLES - 1)];
+      signal[b & (AUDIO_BLOCK_SAMPLES - 1)] ^= 1;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / kBlocks;
+  };
+  const double q15_vca = time([&] {
+    q15::Modulate(signal, cv, q15::GainToQ16(0.5f), q15::GainToQ16(0.5f), false, out, AUDIO_BLOCK_SAMPLES);
+  });
+  const double float_vca = time([&] {
+    float s[AUDIO_BLOCK_SAMPLES], m[AUDIO_BLOCK_SAMPLES], c[AUDIO_BLOCK_SAMPLES];
+    arm_q15_to_float(signal, s, AUDIO_BLOCK_SAMPLES);
+    arm_fill_f32(0.5f, m, AUDIO_BLOCK_SAMPLES);
+    arm_q15_to_float(cv, c, AUDIO_BLOCK_SAMPLES);
+    arm_scale_f32(c, 0.5f, c, AUDIO_BLOCK_SAMPLES);
+    arm_add_f32(c, m, m, AUDIO_BLOCK_SAMPLES);
+    arm_mult_f32(m, s, s, AUDIO_BLOCK_SAMPLES);
+    arm_float_to_q15(s, out, AUDIO_BLOCK_SAMPLES);
+  });
+  (void)sink;
+  printf("[ BENCH    ] vca with cv: float %.3f us/block, q15 %.3f us/block\n", float_vca, q15_vca);
+}
+
+// Long taps are read from a staged copy and short ones from the buffer as it
+// is being written; both should be plain delays when nothing moves
+TEST(AudioHost, DelayTapsAreExact) {
+  AudioMemory(16);
+  const audio_host::WavData in = Sine(40 * AUDIO_BLOCK_SAMPLES, 1);
+  audio_host::SourceStream<1> source;
+  AudioDelayExt<3> delay;
+  audio_host::SinkStream<3> sink;
+  AudioConnection c0(source, 0, delay, 0);
+  AudioConnection c1(delay, 0, sink, 0), c2(delay, 1, sink, 1), c3(delay, 2, sink, 2);
+  delay.Acquire();
+  const float secs[3] = { 0.0005f, 0.01f, 0.09f };
+  for (int tap = 0; tap < 3; ++tap) {
+    delay.delay(tap, secs[tap]);
+    delay.feedback(tap, 0.0f);
+  }
+
+  source.Play(&in);
+  sink.Clear();
+  audio_host::Render(source);
+  for (int tap = 0; tap < 3; ++tap) {
+    const size_t back = static_cast<size_t>(secs[tap] * AUDIO_SAMPLE_RATE);
+    for (size_t i = back; i < in.frames(); ++i)
+      ASSERT_EQ(in.samples[i - back], sink.wav.samples[3 * i + tap]) << "tap " << tap << " @" << i;
+  }
+  delay.Release();
+}
+
+// Stands in for the control ISR: a timer signal that moves the delay while
+// update() may be running
+static AudioDelayExt<1>* preempted_delay = nullptr;
+static volatile sig_atomic_t in_delay_update = 0;
+static volatile int preempted_updates = 0;
+static volatile int preempt_ticks = 0;
+
+static void PreemptDelay(int) {
+  if (in_delay_update) preempted_updates = preempted_updates + 1;
+  preempt_ticks = preempt_ticks + 1;
+  const float secs = preempt_ticks % 2 ? preempted_delay->MIN_DELAY_SECS : 0.003f;
+  if (preempt_ticks % 4 < 2) preempted_delay->cf_delay(0, secs);
+  else preempted_delay->delay(0, secs);
+}
+
+class PreemptedDelay : public AudioDelayExt<1> {
+public:
+  // Short, so the write head is often near the end where a wrapped read
+  // index would run off it
+  PreemptedDelay() : AudioDelayExt<1>(3 * AUDIO_BLOCK_SAMPLES) {}
+
+  void update() override {
+    in_delay_update = 1;
+    AudioDelayExt<1>::update();
+    in_delay_update = 0;
+  }
+};
+
+// Long taps are staged at the start of a block; moving them to the shortest
+// delay mid-block must not read past what has been written
+TEST(AudioHost, DelayChangedDuringUpdate) {
+  const int kPreempted = 2000;
+  AudioMemory(16);
+  const audio_host::WavData in = Sine(AUDIO_BLOCK_SAMPLES, 1);
+  audio_host::SourceStream<1> source;
+  PreemptedDelay delay;
+  audio_host::SinkStream<1> sink;
+  AudioConnection c0(source, 0, delay, 0), c1(delay, 0, sink, 0);
+  delay.Acquire();
+  delay.feedback(0, 0.0f);
+  delay.delay(0, 0.003f);
+  preempted_delay = &delay;
+
+  struct sigaction action = {};
+  action.sa_handler = PreemptDelay;
+  sigaction(SIGALRM, &action, nullptr);
+  struct itimerval timer = {{0, 20}, {0, 20}};
+  setitimer(ITIMER_REAL, &timer, nullptr);
+  int peak = 0;
+  for (int block = 0; block < 2000000 && preempted_updates < kPreempted; ++block) {
+    source.Play(&in);
+    sink.Clear();
+    AudioStream::update_all();
+    for (int16_t s : sink.wav.samples) peak = std::max(peak, std::abs(s));
+  }
+  timer = {};
+  setitimer(ITIMER_REAL, &timer, nullptr);
+  signal(SIGALRM, SIG_DFL);
+  EXPECT_GE(preempted_updates, kPreempted);
+  // At most the two sides of a crossfade at full level
+  EXPECT_LE(peak, 2 * 12000);
+  delay.Release();
+}
+
+TEST(AudioHost, WavRoundTrip) {
+  const audio_host::WavData in = Sine(1000, 2);
+  char path[] = "/tmp/oc_test_audio_hostXXXXXX";
+  const int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  close(fd);
+  ASSERT_TRUE(audio_host::WriteWav(path, in));
+  audio_host::WavData out;
+  ASSERT_TRUE(audio_host::ReadWav(path, out));
+  remove(path);
+  EXPECT_EQ(in.channels, out.channels);
+  EXPECT_EQ(in.sample_rate, out.sample_rate);
+  EXPECT_EQ(in.samples, out.samples);
+}
+
+// A file of distinct frames, long enough to cycle the prefetch ring
+static std::string TempRamp(size_t frames, uint16_t channels, audio_host::WavData &wav) {
+  wav.channels = channels;
+  wav.samples.clear();
+  for (size_t i = 0; i < frames; ++i)
+    for (uint16_t ch = 0; ch < channels; ++ch)
+      wav.samples.push_back(static_cast<int16_t>(i * 7 + ch * 1000));
+  char path[] = "/tmp/oc_test_wav_streamXXXXXX";
+  const int fd = mkstemp(path);
+  close(fd);
+  audio_host::WriteWav(path, wav);
+  return path;
+}
+
+// mainloop prefetching between audio interrupts
+static void RunBlocks(AudioPlayWavStream &player, size_t blocks, bool prefetch = true) {
+  for (size_t b = 0; b < blocks; ++b) {
+    if (prefetch) player.prefetch();
+    AudioStream::update_all();
+  }
+}
+
+TEST(AudioHost, WavStreamIsExact) {
+  AudioMemory(16);
+  audio_host::WavData wav;
+  const std::string path = TempRamp(3 * WavStream::RING_FRAMES + 77, 2, wav);
+  AudioPlayWavStream player;
+  audio_host::SinkStream<2> sink;
+  AudioConnection left(player, 0, sink, 0);
+  AudioConnection right(player, 1, sink, 1);
+
+  ASSERT_TRUE(player.open(path.c_str()));
+  EXPECT_EQ(wav.frames(), player.lengthFrames());
+  player.play();
+  const size_t blocks = wav.frames() / AUDIO_BLOCK_SAMPLES + 2;
+  RunBlocks(player, blocks);
+  EXPECT_FALSE(player.isPlaying());
+  EXPECT_EQ(0u, player.underruns());
+  ASSERT_GE(sink.wav.samples.size(), wav.samples.size());
+  for (size_t i = 0; i < wav.samples.size(); ++i)
+    ASSERT_EQ(wav.samples[i], sink.wav.samples[i]) << "@" << i;
+  for (size_t i = wav.samples.size(); i < sink.wav.samples.size(); ++i)
+    ASSERT_EQ(0, sink.wav.samples[i]) << "past the end @" << i;
+
+  player.close();
+  remove(path.c_str());
+  EXPECT_EQ(0, AudioMemoryUsage());
+}
+
+TEST(AudioHost, WavStreamCueIsResident) {
+  AudioMemory(16);
+  audio_host::WavData wav;
+  const std::string path = TempRamp(2 * WavStream::RING_FRAMES, 1, wav);
+  AudioPlayWavStream player;
+  audio_host::SinkStream<2> sink;
+  AudioConnection left(player, 0, sink, 0);
+  AudioConnection right(player, 1, sink, 1);
+  ASSERT_TRUE(player.open(path.c_str()));
+
+  // Play well past the cue, then move it there and jump back, with no card
+  // reads until the cache runs out
+  player.play();
+  RunBlocks(player, 100);
+  const uint32_t cue = 1000;
+  player.setPlayStart(cue);
+  player.retrigger();
+  sink.Clear();
+  const size_t cached_blocks = WavStream::CUE_FRAMES / AUDIO_BLOCK_SAMPLES;
+  RunBlocks(player, cached_blocks, false);
+  EXPECT_EQ(0u, player.underruns());
+  for (size_t i = 0; i < cached_blocks * AUDIO_BLOCK_SAMPLES; ++i) {
+    // Mono comes out of both sides
+    ASSERT_EQ(wav.samples[cue + i], sink.wav.samples[2 * i]) << "@" << i;
+    ASSERT_EQ(wav.samples[cue + i], sink.wav.samples[2 * i + 1]) << "@" << i;
+  }
+
+  // Starved of prefetch past the cache and the old window, it misses
+  RunBlocks(player, 4, false);
+  EXPECT_EQ(4u, player.underruns());
+
+  // and recovers once mainloop catches up
+  player.resetUnderruns();
+  RunBlocks(player, 8);
+  EXPECT_LE(player.underruns(), 1u);
+  player.resetUnderruns();
+  RunBlocks(player, 8);
+  EXPECT_EQ(0u, player.underruns());
+
+  player.close();
+  remove(path.c_str());
+  EXPECT_EQ(0, AudioMemoryUsage());
+}
+
+// Without PSRAM the buffers come from the internal heap, so are smaller, but
+// still play every frame
+TEST(AudioHost, WavStreamWithoutPsram) {
+  audio_host::WavData wav;
+  const std::string path = TempRamp(3 * WavStream::INTERNAL_RING_FRAMES + 77, 2, wav);
+  const uint8_t psram = external_psram_size;
+  external_psram_size = 0;
+  WavStream stream;
+  const bool opened = stream.Open(path.c_str());
+  external_psram_size = psram;
+  ASSERT_TRUE(opened);
+  EXPECT_EQ(uint32_t{WavStream::INTERNAL_RING_FRAMES}, stream.RingFrames());
+
+  int16_t frame[2];
+  for (uint32_t f = 0; f < wav.frames(); ++f) {
+    stream.Prefetch(f, true);
+    ASSERT_TRUE(stream.Read(f, frame)) << "@" << f;
+    ASSERT_EQ(wav.samples[2 * f], frame[0]) << "@" << f;
+    ASSERT_EQ(wav.samples[2 * f + 1], frame[1]) << "@" << f;
+  }
+  for (uint32_t f = wav.frames(); f-- > 0;) {
+    stream.Prefetch(f, false);
+    ASSERT_TRUE(stream.Read(f, frame)) << "backwards @" << f;
+    ASSERT_EQ(wav.samples[2 * f], frame[0]) << "backwards @" << f;
+  }
+
+  WavStream with_psram;
+  ASSERT_TRUE(with_psram.Open(path.c_str()));
+  EXPECT_EQ(uint32_t{WavStream::RING_FRAMES}, with_psram.RingFrames());
+  remove(path.c_str());
+}
+
+TEST(AudioHost, WavStreamRates) {
+  AudioMemory(16);
+  audio_host::WavData wav;
+  const std::string path = TempRamp(2 * WavStream::RING_FRAMES + 300, 1, wav);
+  AudioPlayWavStream player;
+  audio_host::SinkStream<1> sink;
+  AudioConnection left(player, 0, sink, 0);
+  ASSERT_TRUE(player.open(path.c_str()));
+  const size_t frames = wav.frames();
+
+  // Backwards, from the end
+  player.setPlaybackRate(-1.0f);
+  player.play();
+  RunBlocks(player, frames / AUDIO_BLOCK_SAMPLES + 2);
+  EXPECT_FALSE(player.isPlaying());
+  EXPECT_EQ(0u, player.underruns());
+  for (size_t i = 0; i < frames; ++i)
+    ASSERT_EQ(wav.samples[frames - 1 - i], sink.wav.samples[i]) << "@" << i;
+
+  // Half speed lands on every frame and halfway between
+  sink.Clear();
+  player.setPlaybackRate(0.5f);
+  player.play();
+  RunBlocks(player, frames / AUDIO_BLOCK_SAMPLES);
+  EXPECT_EQ(0u, player.underruns());
+  for (size_t i = 0; i + 1 < sink.wav.samples.size() / 2; ++i) {
+    ASSERT_EQ(wav.samples[i], sink.wav.samples[2 * i]) << "@" << i;
+    ASSERT_NEAR((wav.samples[i] + wav.samples[i + 1]) / 2.0f, sink.wav.samples[2 * i + 1], 1.0f) << "@" << i;
+  }
+
+  player.close();
+  remove(path.c_str());
+  EXPECT_EQ(0, AudioMemoryUsage());
+}
+
+// Numbered files in a scratch directory, made the working directory as the
+// card root
+class WavPoolTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_NE(nullptr, getcwd(cwd, sizeof(cwd)));
+    ASSERT_NE(nullptr, mkdtemp(dir));
+    ASSERT_EQ(0, chdir(dir));
+    for (int f = 0; f < FILES; ++f) {
+      files[f].channels = 1 + f % 2;
+      for (size_t i = 0; i < WavStream::RING_FRAMES; ++i)
+        for (uint16_t ch = 0; ch < files[f].channels; ++ch)
+          files[f].samples.push_back(static_cast<int16_t>(f * 1000 + i * 3 + ch));
+      char name[8];
+      WavSamplePool::FileName(f, name);
+      ASSERT_TRUE(audio_host::WriteWav(name, files[f]));
+    }
+  }
+  void TearDown() override {
+    for (int f = 0; f < FILES; ++f) {
+      char name[8];
+      WavSamplePool::FileName(f, name);
+      remove(name);
+    }
+    EXPECT_EQ(0, chdir(cwd));
+    rmdir(dir);
+  }
+
+  static const int FILES = 4;
+  audio_host::WavData files[FILES];
+  char cwd[4096];
+  char dir[32] = "/tmp/oc_test_wav_poolXXXXXX";
+};
+
+TEST_F(WavPoolTest, HitsAndMisses) {
+  WavSamplePool pool(3);
+  const WavSamplePool::Sample *s = pool.Acquire(1);
+  ASSERT_NE(nullptr, s);
+  EXPECT_EQ(2, s->info.channels);
+  EXPECT_EQ(WavSamplePool::HEAD_FRAMES, s->frames);
+  for (size_t i = 0; i < s->frames * 2; ++i)
+    ASSERT_EQ(files[1].samples[i], s->data[i]) << "@" << i;
+  pool.Release(s);
+  EXPECT_EQ(s, pool.Acquire(1));
+  pool.Release(s);
+  EXPECT_EQ(50, pool.HitPercent());
+
+  // A missing file is remembered, and is a hit next time
+  EXPECT_EQ(nullptr, pool.Acquire(42));
+  EXPECT_TRUE(pool.Contains(42));
+  EXPECT_EQ(nullptr, pool.Acquire(42));
+  EXPECT_EQ(50, pool.HitPercent());
+}
+
+TEST_F(WavPoolTest, LeastRecentlyUsedGoesFirst) {
+  WavSamplePool pool(2);
+  const WavSamplePool::Sample *a = pool.Acquire(0);
+  pool.Release(pool.Acquire(1));
+  // 0 is older, but held
+  pool.Release(pool.Acquire(2));
+  EXPECT_TRUE(pool.Contains(0));
+  EXPECT_FALSE(pool.Contains(1));
+  EXPECT_TRUE(pool.Contains(2));
+  pool.Release(a);
+  pool.Release(pool.Acquire(2));
+  pool.Release(pool.Acquire(3));
+  EXPECT_FALSE(pool.Contains(0));
+  EXPECT_TRUE(pool.Contains(2));
+  EXPECT_TRUE(pool.Contains(3));
+
+  // With nothing free, there's nowhere to put it
+  WavSamplePool none(0);
+  EXPECT_EQ(nullptr, none.Acquire(0));
+  EXPECT_FALSE(none.Preload(0));
+}
+
+TEST_F(WavPoolTest, PreloadInBackground) {
+  WavSamplePool pool(4);
+  EXPECT_TRUE(pool.Preload(2));
+  EXPECT_FALSE(pool.Preload(3)); // one at a time
+  EXPECT_TRUE(pool.Busy());
+  EXPECT_FALSE(pool.Contains(2));
+  int passes = 0;
+  while (pool.Busy()) {
+    pool.Service();
+    ++passes;
+  }
+  EXPECT_EQ(static_cast<int>(WavSamplePool::HEAD_FRAMES / WavStream::CHUNK_FRAMES / WavStream::CHUNKS_PER_PREFETCH), passes);
+  EXPECT_TRUE(pool.Contains(2));
+  pool.Release(pool.Acquire(2));
+  EXPECT_EQ(100, pool.HitPercent());
+
+  // Asking for one mid-load finishes it, but isn't a hit
+  EXPECT_TRUE(pool.Preload(3));
+  pool.Service();
+  const WavSamplePool::Sample *s = pool.Acquire(3);
+  ASSERT_NE(nullptr, s);
+  EXPECT_FALSE(pool.Busy());
+  EXPECT_EQ(WavSamplePool::HEAD_FRAMES, s->frames);
+  EXPECT_EQ(50, pool.HitPercent());
+  pool.Release(s);
+}
+
+TEST_F(WavPoolTest, StreamPlaysFromPool) {
+  AudioMemory(16);
+  WavSamplePool pool(2);
+  AudioPlayWavStream player;
+  audio_host::SinkStream<2> sink;
+  AudioConnection left(player, 0, sink, 0);
+  AudioConnection right(player, 1, sink, 1);
+
+  for (int f : {3, 0}) {
+    const WavSamplePool::Sample *s = pool.Acquire(f);
+    ASSERT_NE(nullptr, s);
+    char name[8];
+    WavSamplePool::FileName(f, name);
+    ASSERT_TRUE(player.open(name, s->info, s->data, s->frames));
+    sink.Clear();
+    player.play();
+    RunBlocks(player, files[f].frames() / AUDIO_BLOCK_SAMPLES);
+    EXPECT_EQ(0u, player.underruns());
+    const uint16_t ch = files[f].channels;
+    for (size_t i = 0; i < files[f].frames(); ++i)
+      ASSERT_EQ(files[f].samples[i * ch + ch - 1], sink.wav.samples[2 * i + 1]) << "file " << f << " @" << i;
+    player.close();
+    pool.Release(s);
+  }
+  EXPECT_EQ(0, AudioMemoryUsage());
+}
+
+// A ramp pushed at a core ISR rate a little off nominal, as the two clocks
+// would be; the ramp makes the read position, and so the latency, readable
+// straight off the output
+TEST(AudioHost, InterpolatingStreamLatency) {
+  AudioMemory(16);
+  const double input_rate = OC_CORE_ISR_FREQ * 1.002;
+  for (InterpolationMethod m : {INTERPOLATION_LINEAR, INTERPOLATION_HERMITE, INTERPOLATION_POLYPHASE}) {
+    InterpolatingStream<> stream;
+    audio_host::SinkStream<1> sink;
+    AudioConnection c(stream, 0, sink, 0);
+    stream.Method(m);
+    stream.Acquire();
+    uint32_t pushed = 1;
+    const int blocks = 1000;
+    int wild = 0;
+    float max_lag = 0.0f;
+    for (int b = 0; b < blocks; ++b) {
+      const double now = b * AUDIO_BLOCK_SAMPLES / AUDIO_SAMPLE_RATE_EXACT;
+      while (pushed < now * input_rate) {
+        stream.Push(static_cast<int16_t>(pushed * 4));
+        ++pushed;
+      }
+      AudioStream::update_all();
+      if (b < 500) continue; // settling
+      // At the block's last sample, which is one step short of the target
+      const int16_t last = sink.wav.samples.back();
+      const float lag = static_cast<int16_t>((pushed - 1) * 4 - last) / 4.0f;
+      const float expected = stream.LatencySamples() + input_rate / AUDIO_SAMPLE_RATE_EXACT;
+      if (fabsf(lag - expected) > 1.0f) ++wild;
+      else max_lag = std::max(max_lag, lag);
+    }
+    // Only where the ramp wraps
+    EXPECT_LE(wild, 2) << "method " << m;
+    // No further behind than the float version's 0..1.25 samples
+    if (m == INTERPOLATION_LINEAR) {
+      EXPECT_LE(max_lag, 1.25f);
+    }
+    EXPECT_NEAR(input_rate / AUDIO_SAMPLE_RATE_EXACT, stream.Ratio(), 0.001) << "method " << m;
+    stream.Release();
+  }
+  EXPECT_EQ(0, AudioMemoryUsage());
+}
+
+// With the core ISR held off, the last value is held rather than dropping
+// to silence, and the stream carries on from where it was after
+TEST(AudioHost, InterpolatingStreamHoldsWhenStarved) {
+  AudioMemory(16);
+  InterpolatingStream<> stream;
+  audio_host::SinkStream<1> sink;
+  AudioConnection c(stream, 0, sink, 0);
+  stream.Method(INTERPOLATION_LINEAR);
+  stream.Acquire();
+  uint32_t pushed = 1;
+  for (int b = 0; b < 60; ++b) {
+    const bool starved = b >= 40 && b < 43;
+    while (!starved && pushed < b * AUDIO_BLOCK_SAMPLES * OC_CORE_ISR_FREQ / AUDIO_SAMPLE_RATE_EXACT) {
+      stream.Push(static_cast<int16_t>(pushed * 4));
+      ++pushed;
+    }
+    if (starved) pushed = b * AUDIO_BLOCK_SAMPLES * OC_CORE_ISR_FREQ / AUDIO_SAMPLE_RATE_EXACT;
+    const int16_t last = sink.wav.samples.empty() ? 0 : sink.wav.samples.back();
+    AudioStream::update_all();
+    ASSERT_EQ(size_t((b + 1) * AUDIO_BLOCK_SAMPLES), sink.wav.samples.size()) << b;
+    if (starved) {
+      for (size_t i = b * AUDIO_BLOCK_SAMPLES; i < sink.wav.samples.size(); ++i)
+        ASSERT_EQ(last, sink.wav.samples[i]) << b;
+    }
+  }
+  stream.Release();
+}
+
+TEST(AudioHost, InterpolatingStreamKeepsDC) {
+  AudioMemory(16);
+  for (InterpolationMethod m : {INTERPOLATION_ZOH, INTERPOLATION_LINEAR, INTERPOLATION_HERMITE, INTERPOLATION_POLYPHASE}) {
+    InterpolatingStream<> stream;
+    audio_host::SinkStream<1> sink;
+    AudioConnection c(stream, 0, sink, 0);
+    stream.Method(m);
+    stream.Acquire();
+    uint32_t pushed = 1;
+    for (int b = 0; b < 50; ++b) {
+      while (pushed < b * AUDIO_BLOCK_SAMPLES * OC_CORE_ISR_FREQ / AUDIO_SAMPLE_RATE_EXACT) {
+        stream.Push(-12345);
+        ++pushed;
+      }
+      AudioStream::update_all();
+    }
+    for (size_t i = sink.wav.samples.size() / 2; i < sink.wav.samples.size(); ++i)
+      ASSERT_EQ(-12345, sink.wav.samples[i]) << "method " << m << " @" << i;
+    stream.Release();
+  }
+}
+
+// Cost of each interpolation method per block on this host
+TEST(AudioHost, DISABLED_InterpolatingStreamBenchmark) {
+  AudioMemory(16);
+  const char *names[] = {"interp ZOH", "interp linear", "interp hermite", "interp sinc"};
+  for (InterpolationMethod m : {INTERPOLATION_ZOH, INTERPOLATION_LINEAR, INTERPOLATION_HERMITE, INTERPOLATION_POLYPHASE}) {
+    InterpolatingStream<> stream;
+    audio_host::SinkStream<1> sink;
+    AudioConnection c(stream, 0, sink, 0);
+    stream.Method(m);
+    stream.Acquire();
+    uint32_t pushed = 1;
+    for (int b = 0; b < 2000; ++b) {
+      while (pushed < b * AUDIO_BLOCK_SAMPLES * OC_CORE_ISR_FREQ / AUDIO_SAMPLE_RATE_EXACT) {
+        stream.Push(static_cast<int16_t>(20000 * sinf(pushed * 0.05f)));
+        ++pushed;
+      }
+      AudioStream::update_all();
+      if (b % 100 == 0) sink.Clear();
+    }
+    audio_host::PrintUsage(names[m], stream);
+    stream.Release();
+  }
+}
+
+// The update()s the reverbs had before CombReverb.h: the Teensy Audio
+// library's mono AudioEffectFreeverb, and the float AudioEffectReverbSchroeder.
+// To check the shared network against and to time it.
+class TeensyFreeverb : public AudioStream {
+public:
+  TeensyFreeverb() : AudioStream(1, inputQueueArray) {
+    memset(comb, 0, sizeof(comb));
+    memset(allpass, 0, sizeof(allpass));
+    roomsize(0.5f);
+    damping(0.5f);
+  }
+  void roomsize(float n) {
+    combfeedback = static_cast<int>(n * 9175.04f) + 22937;
+  }
+  void damping(float n) {
+    combdamp1 = static_cast<int>(n * 13107.2f);
+    combdamp2 = 32768 - combdamp1;
+  }
+
+  void update() override {
+    static const audio_block_t zeroblock = {};
+    const audio_block_t *block = receiveReadOnly(0);
+    if (!block) block = &zeroblock;
+    audio_block_t *out = allocate();
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+      const int16_t input = sat16(block->data[i] * 8738, 17);
+      int32_t sum = 0;
+      for (int c = 0; c < 8; ++c) {
+        const int16_t bufout = comb[c][comb_ix[c]];
+        sum += bufout;
+        comb_filter[c] = sat16(bufout * combdamp2 + comb_filter[c] * combdamp1, 15);
+        comb[c][comb_ix[c]] = sat16(input + sat16(comb_filter[c] * combfeedback, 15), 0);
+        if (++comb_ix[c] >= COMB_LEN[c]) comb_ix[c] = 0;
+      }
+      int16_t output = sat16(sum * 31457, 17);
+      for (int a = 0; a < 4; ++a) {
+        const int16_t bufout = allpass[a][ap_ix[a]];
+        allpass[a][ap_ix[a]] = output + (bufout >> 1);
+        output = sat16(bufout - output, 1);
+        if (++ap_ix[a] >= AP_LEN[a]) ap_ix[a] = 0;
+      }
+      out->data[i] = sat16(output * 30, 0);
+    }
+    transmit(out);
+    release(out);
+    if (block != &zeroblock) release(const_cast<audio_block_t *>(block));
+  }
+
+private:
+  static constexpr uint16_t COMB_LEN[8] = {1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617};
+  static constexpr uint16_t AP_LEN[4] = {556, 441, 341, 225};
+  static int16_t sat16(int32_t n, int rshift) {
+    n = n >> rshift;
+    if (n > 32767) return 32767;
+    if (n < -32768) return -32768;
+    return n;
+  }
+  audio_block_t *inputQueueArray[1];
+  int16_t comb[8][1617];
+  int16_t allpass[4][556];
+  uint16_t comb_ix[8] = {0};
+  uint16_t ap_ix[4] = {0};
+  int16_t comb_filter[8] = {0};
+  int combfeedback, combdamp1, combdamp2;
+};
+
+class FloatSchroeder : public AudioStream {
+public:
+  FloatSchroeder() : AudioStream(1, inputQueueArray) {
+    memset(comb, 0, sizeof(comb));
+    memset(allpass, 0, sizeof(allpass));
+    setDecayTime(2.5f);
+    setDamping(0.5f);
+  }
+  void setDecayTime(float seconds) {
+    float avg = 0.0f;
+    for (int l : COMB_LEN) avg += l;
+    avg /= 8;
+    feedback = std::min(expf((-3.0f * avg / 44100.0f) / seconds), 0.9999f);
+  }
+  void setDamping(float d) {
+    damp1 = d;
+    damp2 = 1.0f - d;
+  }
+
+  void update() override {
+    audio_block_t *in = receiveReadOnly(0);
+    if (!in) return;
+    audio_block_t *out = allocate();
+    for (int n = 0; n < AUDIO_BLOCK_SAMPLES; ++n) {
+      const float x = in->data[n] * (1.0f / 32768.0f);
+      float sum = 0.0f;
+      for (int i = 0; i < 8; ++i) {
+        const float y = comb[i][comb_ix[i]];
+        store[i] = store[i] * damp2 + y * damp1;
+        comb[i][comb_ix[i]] = x + feedback * store[i];
+        if (++comb_ix[i] >= COMB_LEN[i]) comb_ix[i] = 0;
+        sum += y;
+      }
+      float ap = sum / 8;
+      for (int i = 0; i < 4; ++i) {
+        const float bufout = allpass[i][ap_ix[i]];
+        const float z = ap - 0.5f * bufout;
+        allpass[i][ap_ix[i]] = z;
+        if (++ap_ix[i] >= AP_LEN[i]) ap_ix[i] = 0;
+        ap = bufout + z * 0.5f;
+      }
+      out->data[n] = static_cast<int16_t>(std::max(-32768.0f, std::min(ap * 0.6f * 32767.0f, 32767.0f)));
+    }
+    transmit(out);
+    release(out);
+    release(in);
+  }
+
+private:
+  static constexpr int COMB_LEN[8] = {1319, 1493, 1559, 1613, 1747, 1873, 2017, 2153};
+  static constexpr int AP_LEN[4] = {221, 75, 366, 556};
+  audio_block_t *inputQueueArray[1];
+  float comb[8][2153];
+  float allpass[4][556];
+  uint16_t comb_ix[8] = {0};
+  uint16_t ap_ix[4] = {0};
+  float store[8] = {0};
+  float feedback, damp1, damp2;
+};
+
+// A burst of noise, then silence for the tail to ring out in
+static audio_host::WavData NoiseBurst(size_t frames, size_t burst) {
+  audio_host::WavData wav;
+  wav.channels = 1;
+  uint32_t seed = 12345;
+  for (size_t i = 0; i < frames; ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    wav.samples.push_back(i < burst ? static_cast<int16_t>(static_cast<int32_t>(seed) >> 18) : 0);
+  }
+  return wav;
+}
+
+// One full-scale sample, then silence
+static audio_host::WavData Impulse(size_t frames) {
+  audio_host::WavData wav;
+  wav.channels = 1;
+  wav.samples.assign(frames, 0);
+  wav.samples[0] = 32767;
+  return wav;
+}
+
+// Of b against a, over [from, to) of both channels of a stereo sink
+static void CompareResponses(const audio_host::WavData &wav, size_t from, size_t to, double &rms_a, double &rms_err, double &correlation) {
+  double aa = 0.0, bb = 0.0, ab = 0.0, ee = 0.0;
+  for (size_t i = from; i < to; ++i) {
+    const double a = wav.samples[2 * i], b = wav.samples[2 * i + 1];
+    aa += a * a;
+    bb += b * b;
+    ab += a * b;
+    ee += (a - b) * (a - b);
+  }
+  rms_a = sqrt(aa / (to - from));
+  rms_err = sqrt(ee / (to - from));
+  correlation = ab / sqrt(aa * bb);
+}
+
+TEST(AudioHost, FreeverbMatchesTeensy) {
+  AudioMemory(16);
+  const audio_host::WavData in = NoiseBurst(345 * AUDIO_BLOCK_SAMPLES, 20 * AUDIO_BLOCK_SAMPLES); // 1 s
+  for (float room : {0.2f, 0.5f, 0.9f}) {
+    audio_host::SourceStream<1> source;
+    std::unique_ptr<TeensyFreeverb> reference(new TeensyFreeverb());
+    std::unique_ptr<AudioEffectReverbFreeverb<>> reverb(new AudioEffectReverbFreeverb<>());
+    audio_host::SinkStream<2> sink;
+    AudioConnection c0(source, 0, *reference, 0), c1(source, 0, *reverb, 0);
+    AudioConnection c2(*reference, 0, sink, 0), c3(*reverb, 0, sink, 1);
+    reference->roomsize(room);
+    reverb->roomsize(room);
+
+    source.Play(&in);
+    sink.Clear();
+    audio_host::Render(source);
+    double rms, err, corr;
+    CompareResponses(sink.wav, 0, in.frames(), rms, err, corr);
+    printf("[ BENCH    ] freeverb room %.1f: rms %.0f, error rms %.2f, correlation %.6f\n", room, rms, err, corr);
+    // Rounded differently, as CombReverb.h explains, so not bit exact
+    EXPECT_GT(rms, 500.0);
+    EXPECT_LT(err, rms * 0.06);
+    EXPECT_GT(corr, 0.998);
+    EXPECT_EQ(0, AudioMemoryUsage());
+  }
+}
+
+// Bungverb's A/B: impulse and noise burst responses against the float
+// network it had before CombReverb.h
+TEST(AudioHost, SchroederMatchesFloat) {
+  AudioMemory(16);
+  const audio_host::WavData inputs[] = {
+    Impulse(690 * AUDIO_BLOCK_SAMPLES), // 2 s
+    NoiseBurst(690 * AUDIO_BLOCK_SAMPLES, 20 * AUDIO_BLOCK_SAMPLES),
+  };
+  const char *names[] = { "impulse", "burst" };
+  const struct { float decay, damping; } cases[] = { {0.5f, 0.2f}, {2.5f, 0.5f}, {8.0f, 0.8f} };
+  for (int input = 0; input < 2; ++input) {
+    const audio_host::WavData &in = inputs[input];
+    for (const auto &c : cases) {
+      audio_host::SourceStream<1> source;
+      std::unique_ptr<FloatSchroeder> reference(new FloatSchroeder());
+      std::unique_ptr<AudioEffectReverbSchroeder<>> reverb(new AudioEffectReverbSchroeder<>());
+      audio_host::SinkStream<2> sink;
+      AudioConnection c0(source, 0, *reference, 0), c1(source, 0, *reverb, 0);
+      AudioConnection c2(*reference, 0, sink, 0), c3(*reverb, 0, sink, 1);
+      reference->setDecayTime(c.decay);
+      reference->setDamping(c.damping);
+      reverb->setDecayTime(c.decay);
+      reverb->setDamping(c.damping);
+
+      source.Play(&in);
+      sink.Clear();
+      audio_host::Render(source);
+      double rms, err, corr;
+      CompareResponses(sink.wav, 0, in.frames(), rms, err, corr);
+      printf("[ BENCH    ] schroeder %s %.1f s: rms %.1f, error rms %.2f, correlation %.6f\n", names[input], c.decay, rms, err, corr);
+      // q15 lines against float ones: a few LSBs of rounding throughout,
+      // which is most of an impulse's tail of tens of LSBs
+      if (input == 0) {
+        EXPECT_LT(err, 10.0);
+        EXPECT_GT(corr, 0.97);
+      } else {
+        EXPECT_LT(err, rms * 0.1);
+        EXPECT_GT(corr, 0.995);
+      }
+      EXPECT_EQ(0, AudioMemoryUsage());
+    }
+  }
+}
+
+// The right network's longer lines decorrelate it from the left, at about the
+// same level
+TEST(AudioHost, StereoReverbIsDecorrelated) {
+  AudioMemory(16);
+  const audio_host::WavData in = NoiseBurst(345 * AUDIO_BLOCK_SAMPLES, 20 * AUDIO_BLOCK_SAMPLES);
+  audio_host::SourceStream<1> source;
+  std::unique_ptr<AudioEffectReverbFreeverb<2>> reverb(new AudioEffectReverbFreeverb<2>());
+  audio_host::SinkStream<2> sink;
+  AudioConnection c0(source, 0, *reverb, 0), c1(source, 0, *reverb, 1);
+  AudioConnection c2(*reverb, 0, sink, 0), c3(*reverb, 1, sink, 1);
+
+  source.Play(&in);
+  sink.Clear();
+  audio_host::Render(source);
+  double rms_l, err, corr;
+  CompareResponses(sink.wav, 0, in.frames(), rms_l, err, corr);
+  double rms_r, unused;
+  audio_host::WavData swapped = sink.wav;
+  for (size_t i = 0; i < swapped.frames(); ++i) std::swap(swapped.samples[2 * i], swapped.samples[2 * i + 1]);
+  CompareResponses(swapped, 0, in.frames(), rms_r, unused, unused);
+  printf("[ BENCH    ] stereo freeverb: rms %.0f / %.0f, correlation %.3f\n", rms_l, rms_r, corr);
+  EXPECT_NEAR(1.0, rms_r / rms_l, 0.2);
+  EXPECT_LT(fabs(corr), 0.5);
+  EXPECT_EQ(0, AudioMemoryUsage());
+}
+
+// The shared comb network against the code it replaced
+TEST(AudioHost, DISABLED_CombReverbBenchmark) {
+  AudioMemory(32);
+  const audio_host::WavData in = Sine(690 * AUDIO_BLOCK_SAMPLES, 1);
+  audio_host::SourceStream<1> source;
+  std::unique_ptr<TeensyFreeverb> teensy(new TeensyFreeverb());
+  std::unique_ptr<AudioEffectReverbFreeverb<>> freeverb(new AudioEffectReverbFreeverb<>());
+  std::unique_ptr<FloatSchroeder> old_schroeder(new FloatSchroeder());
+  std::unique_ptr<AudioEffectReverbSchroeder<>> schroeder(new AudioEffectReverbSchroeder<>());
+  std::unique_ptr<AudioEffectReverbSchroeder<2>> stereo(new AudioEffectReverbSchroeder<2>());
+  AudioStream *streams[] = { teensy.get(), freeverb.get(), old_schroeder.get(), schroeder.get(), stereo.get() };
+  std::unique_ptr<AudioConnection> cables[6];
+  for (int i = 0; i < 5; ++i) cables[i].reset(new AudioConnection(source, 0, *streams[i], 0));
+  cables[5].reset(new AudioConnection(source, 0, *stereo, 1));
+
+  source.Play(&in);
+  audio_host::Render(source);
+  EXPECT_EQ(0, AudioMemoryUsage());
+
+  audio_host::PrintUsage("freeverb teensy", *teensy);
+  audio_host::PrintUsage("freeverb q15", *freeverb);
+  audio_host::PrintUsage("schroeder float", *old_schroeder);
+  audio_host::PrintUsage("schroeder q15", *schroeder);
+  audio_host::PrintUsage("schroeder q15 st", *stereo);
+}
+
+// Level of one frequency in a run of a sink's samples, by Goertzel
+static double ToneLevel(const audio_host::WavData &wav, size_t from, size_t to, float hz) {
+  const double w = 2.0 * M_PI * hz / AUDIO_SAMPLE_RATE_EXACT;
+  double s1 = 0.0, s2 = 0.0;
+  for (size_t i = from; i < to; ++i) {
+    const double s = wav.samples[i] + 2.0 * cos(w) * s1 - s2;
+    s2 = s1;
+    s1 = s;
+  }
+  return sqrt(s1 * s1 + s2 * s2 - 2.0 * cos(w) * s1 * s2) * 2.0 / (to - from);
+}
+
+static audio_host::WavData Tone(size_t frames, float hz, float amplitude) {
+  audio_host::WavData wav;
+  wav.channels = 1;
+  for (size_t i = 0; i < frames; ++i)
+    wav.samples.push_back(static_cast<int16_t>(amplitude * sinf(6.2831853f * hz * i / AUDIO_SAMPLE_RATE_EXACT)));
+  return wav;
+}
+
+static audio_host::WavData RunLadder(const audio_host::WavData &in, int os, float cutoff, float res, float drive, LadderSaturation sat = LADDER_SATURATION_RATIONAL) {
+  audio_host::SourceStream<1> source;
+  AudioLadderFilter ladder;
+  audio_host::SinkStream<1> sink;
+  AudioConnection c0(source, 0, ladder, 0), c1(ladder, 0, sink, 0);
+  ladder.oversampling(os);
+  ladder.saturation(sat);
+  ladder.frequency(cutoff);
+  ladder.resonance(res);
+  ladder.inputDrive(drive);
+  ladder.passbandGain(0.0f);
+  source.Play(&in);
+  sink.Clear();
+  audio_host::Render(source);
+  return sink.wav;
+}
+
+TEST(AudioHost, LadderPassesAndStops) {
+  AudioMemory(16);
+  const size_t frames = 100 * AUDIO_BLOCK_SAMPLES;
+  for (int os : {1, 2}) {
+    const double pass = ToneLevel(RunLadder(Tone(frames, 100.0f, 3000.0f), os, 1000.0f, 0.0f, 1.0f), frames / 2, frames, 100.0f);
+    const double stop = ToneLevel(RunLadder(Tone(frames, 8000.0f, 3000.0f), os, 1000.0f, 0.0f, 1.0f), frames / 2, frames, 8000.0f);
+    printf("[ BENCH    ] ladder %dx: 100 Hz %.0f, 8 kHz %.1f of 3000\n", os, pass, stop);
+    EXPECT_NEAR(3000.0, pass, 300.0) << os << "x";
+    EXPECT_LT(stop, 3.0) << os << "x";
+    EXPECT_EQ(0, AudioMemoryUsage());
+  }
+}
+
+// Driven hard, the saturator's third harmonic of 9 kHz is at 27 kHz, which
+// folds back to 17.1 kHz unless the filter runs fast enough to remove it
+TEST(AudioHost, LadderOversamplingReducesAliasing) {
+  AudioMemory(16);
+  const size_t frames = 100 * AUDIO_BLOCK_SAMPLES;
+  const audio_host::WavData in = Tone(frames, 9000.0f, 30000.0f);
+  double alias[2];
+  for (int shift = 0; shift < 2; ++shift) {
+    const audio_host::WavData out = RunLadder(in, 1 << shift, 8000.0f, 0.0f, 4.0f);
+    alias[shift] = ToneLevel(out, frames / 2, frames, 17100.0f) / ToneLevel(out, frames / 2, frames, 9000.0f);
+    printf("[ BENCH    ] ladder %dx: alias at %.1f dB\n", 1 << shift, 20.0 * log10(alias[shift]));
+  }
+  // At 2x it is down to how well the four poles remove 27 kHz
+  EXPECT_LT(alias[1], alias[0] * 0.2);
+}
+
+// Rings on from a kick at full resonance, at any setting, and stays in range
+TEST(AudioHost, LadderSelfOscillates) {
+  AudioMemory(16);
+  const audio_host::WavData in = NoiseBurst(100 * AUDIO_BLOCK_SAMPLES, AUDIO_BLOCK_SAMPLES);
+  for (int os : {1, 2}) {
+    for (LadderSaturation sat : {LADDER_SATURATION_RATIONAL, LADDER_SATURATION_POLYNOMIAL}) {
+      const audio_host::WavData out = RunLadder(in, os, 1000.0f, 1.8f, 1.0f, sat);
+      const double ring = ToneLevel(out, out.frames() - 20 * AUDIO_BLOCK_SAMPLES, out.frames(), 1000.0f);
+      double peak = 0.0;
+      for (int16_t s : out.samples) peak = std::max(peak, fabs(s));
+      EXPECT_GT(ring, 1000.0) << os << "x " << sat;
+      EXPECT_LT(peak, 32767.0) << os << "x " << sat;
+    }
+  }
+}
+
+// Block cost at each oversampling and saturator, with the cutoff swept so
+// the coefficients move every block
+TEST(AudioHost, DISABLED_LadderBenchmark) {
+  AudioMemory(32);
+  const audio_host::WavData in = Sine(690 * AUDIO_BLOCK_SAMPLES, 1, 20000.0f);
+  const char *names[2][2] = {
+    {"ladder 1x tanh", "ladder 2x tanh"},
+    {"ladder 1x cubic", "ladder 2x cubic"},
+  };
+  for (LadderSaturation sat : {LADDER_SATURATION_RATIONAL, LADDER_SATURATION_POLYNOMIAL}) {
+    for (int shift = 0; shift < 2; ++shift) {
+      audio_host::SourceStream<1> source;
+      AudioLadderFilter ladder;
+      audio_host::SinkStream<1> sink;
+      AudioConnection c0(source, 0, ladder, 0), c1(ladder, 0, sink, 0);
+      ladder.oversampling(1 << shift);
+      ladder.saturation(sat);
+      ladder.resonance(1.2f);
+      ladder.inputDrive(2.0f);
+      source.Play(&in);
+      for (size_t b = 0; !source.done(); ++b) {
+        ladder.frequency(200.0f + (b % 100) * 50.0f);
+        AudioStream::update_all();
+        if (b % 100 == 0) sink.Clear();
+      }
+      audio_host::PrintUsage(names[sat][shift], ladder);
+    }
+  }
+}
+
+// A delay into a reverb on each side, as two mono slot chains would be, and
+// the time each stream takes per block on this host
+TEST(AudioHost, DISABLED_Benchmark) {
+  AudioMemory(32);
+  const audio_host::WavData in = Sine(690 * AUDIO_BLOCK_SAMPLES, 2); // 2 seconds
+  audio_host::SourceStream<2> source;
+  AudioVCA vca[2];
+  AudioDelayExt<> delay[2];
+  std::unique_ptr<AudioEffectReverbSchroeder<>> reverb[2] = {
+    std::unique_ptr<AudioEffectReverbSchroeder<>>(new AudioEffectReverbSchroeder<>()),
+    std::unique_ptr<AudioEffectReverbSchroeder<>>(new AudioEffectReverbSchroeder<>()),
+  };
+  AudioMixer<2> mixer[2];
+  audio_host::SinkStream<2> sink;
+
+  std::unique_ptr<AudioConnection> cables[12];
+  for (int ch = 0; ch < 2; ++ch) {
+    vca[ch].bias(0.8f);
+    delay[ch].Acquire();
+    delay[ch].delay(0, 0.3f);
+    delay[ch].feedback(0, 0.4f);
+    mixer[ch].gain(0, 0.7f);
+    mixer[ch].gain(1, 0.3f);
+    cables[ch * 6 + 0].reset(new AudioConnection(source, ch, vca[ch], 0));
+    cables[ch * 6 + 1].reset(new AudioConnection(vca[ch], 0, delay[ch], 0));
+    cables[ch * 6 + 2].reset(new AudioConnection(delay[ch], 0, *reverb[ch], 0));
+    cables[ch * 6 + 3].reset(new AudioConnection(vca[ch], 0, mixer[ch], 0));
+    cables[ch * 6 + 4].reset(new AudioConnection(*reverb[ch], 0, mixer[ch], 1));
+    cables[ch * 6 + 5].reset(new AudioConnection(mixer[ch], 0, sink, ch));
+  }
+
+  source.Play(&in);
+  sink.Clear();
+  const size_t blocks = audio_host::Render(source);
+  EXPECT_EQ(in.samples.size(), sink.wav.samples.size());
+  EXPECT_EQ(0, AudioMemoryUsage());
+
+  audio_host::PrintUsage("vca", vca[0]);
+  audio_host::PrintUsage("delay", delay[0]);
+  audio_host::PrintUsage("reverb", *reverb[0]);
+  audio_host::PrintUsage("mixer", mixer[0]);
+  double total = 0.0;
+  for (int ch = 0; ch < 2; ++ch)
+    total += vca[ch].update_us_total() + delay[ch].update_us_total() + reverb[ch]->update_us_total() + mixer[ch].update_us_total();
+  printf("[ BENCH    ] both chains %.2f us/block of the %.0f us block period, peak %d blocks\n",
+         total / blocks, 1e6f * AUDIO_BLOCK_SAMPLES / AUDIO_SAMPLE_RATE_EXACT, AudioMemoryUsageMax());
+
+  for (int ch = 0; ch < 2; ++ch) delay[ch].Release();
+}
@@ -0,0 +1,307 @@
+#include "gtest/gtest.h"
+#include "bjorklund.h"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+// The pattern table bjorklund.cpp used to hold, as res/bjorklund.py wrote it:
+// 33 entries (0-32 beats) per length, lengths 2-32
+static const uint32_t bjorklund_patterns[] = {
+  // 2 steps
+  0x00000000, 0x00000001, 0x00000003, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 3 steps
+  0x00000000, 0x00000001, 0x00000003, 0x00000007, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 4 steps
+  0x00000000, 0x00000001, 0x00000005, 0x00000007, 0x0000000f, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 5 steps
+  0x00000000, 0x00000001, 0x00000005, 0x00000015, 0x0000000f, 0x0000001f, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 6 steps
+  0x00000000, 0x00000001, 0x00000009, 0x00000015, 0x0000001b, 0x0000001f, 0x0000003f, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 7 steps
+  0x00000000, 0x00000001, 0x00000009, 0x00000015, 0x00000055, 0x0000005b, 0x0000003f, 0x0000007f,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 8 steps
+  0x00000000, 0x00000001, 0x00000011, 0x00000049, 0x00000055, 0x0000006d, 0x00000077, 0x0000007f,
+  0x000000ff, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 9 steps
+  0x00000000, 0x00000001, 0x00000011, 0x00000049, 0x00000055, 0x00000155, 0x000000db, 0x00000177,
+  0x000000ff, 0x000001ff, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 10 steps
+  0x00000000, 0x00000001, 0x00000021, 0x00000049, 0x000000a5, 0x00000155, 0x000002b5, 0x000002db,
+  0x000001ef, 0x000001ff, 0x000003ff, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 11 steps
+  0x00000000, 0x00000001, 0x00000021, 0x00000111, 0x00000249, 0x00000155, 0x00000555, 0x0000036d,
+  0x000003bb, 0x000005ef, 0x000003ff, 0x000007ff, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 12 steps
+  0x00000000, 0x00000001, 0x00000041, 0x00000111, 0x00000249, 0x000004a5, 0x00000555, 0x000006b5,
+  0x000006db, 0x00000777, 0x000007df, 0x000007ff, 0x00000fff, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 13 steps
+  0x00000000, 0x00000001, 0x00000041, 0x00000111, 0x00000249, 0x00000529, 0x00000555, 0x00001555,
+  0x000015ad, 0x000016db, 0x00001777, 0x000017df, 0x00000fff, 0x00001fff, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 14 steps
+  0x00000000, 0x00000001, 0x00000081, 0x00000421, 0x00000489, 0x00001249, 0x00000a95, 0x00001555,
+  0x00002ad5, 0x00001b6d, 0x00002ddb, 0x00001ef7, 0x00001fbf, 0x00001fff, 0x00003fff, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 15 steps
+  0x00000000, 0x00000001, 0x00000081, 0x00000421, 0x00001111, 0x00001249, 0x000014a5, 0x00001555,
+  0x00005555, 0x000056b5, 0x000036db, 0x00003bbb, 0x00003def, 0x00005fbf, 0x00003fff, 0x00007fff,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 16 steps
+  0x00000000, 0x00000001, 0x00000101, 0x00000421, 0x00001111, 0x00001249, 0x00004949, 0x00004a95,
+  0x00005555, 0x00006ad5, 0x00006d6d, 0x0000b6db, 0x00007777, 0x0000bdef, 0x00007f7f, 0x00007fff,
+  0x0000ffff, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 17 steps
+  0x00000000, 0x00000001, 0x00000101, 0x00001041, 0x00001111, 0x00004489, 0x00009249, 0x000094a5,
+  0x00005555, 0x00015555, 0x0000d6b5, 0x0000db6d, 0x0000eddb, 0x00017777, 0x0000fbef, 0x00017f7f,
+  0x0000ffff, 0x0001ffff, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 18 steps
+  0x00000000, 0x00000001, 0x00000201, 0x00001041, 0x00002211, 0x00004891, 0x00009249, 0x0000a529,
+  0x0000aa55, 0x00015555, 0x0002ab55, 0x0002b5ad, 0x0001b6db, 0x0002ddbb, 0x0002ef77, 0x0001f7df,
+  0x0001feff, 0x0001ffff, 0x0003ffff, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 19 steps
+  0x00000000, 0x00000001, 0x00000201, 0x00001041, 0x00008421, 0x00011111, 0x00009249, 0x00014949,
+  0x000152a5, 0x00015555, 0x00055555, 0x00055ab5, 0x00056d6d, 0x0005b6db, 0x0003bbbb, 0x0003def7,
+  0x0005f7df, 0x0005feff, 0x0003ffff, 0x0007ffff, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 20 steps
+  0x00000000, 0x00000001, 0x00000401, 0x00004081, 0x00008421, 0x00011111, 0x00012449, 0x00049249,
+  0x000294a5, 0x0004aa55, 0x00055555, 0x0006ab55, 0x000ad6b5, 0x0006db6d, 0x000b6edb, 0x00077777,
+  0x0007bdef, 0x0007efdf, 0x0007fdff, 0x0007ffff, 0x000fffff, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 21 steps
+  0x00000000, 0x00000001, 0x00000401, 0x00004081, 0x00008421, 0x00011111, 0x00024489, 0x00049249,
+  0x00092929, 0x00054a95, 0x00055555, 0x00155555, 0x00156ad5, 0x000dadad, 0x000db6db, 0x0016eddb,
+  0x00177777, 0x0017bdef, 0x000fdfbf, 0x0017fdff, 0x000fffff, 0x001fffff, 0x00000000, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 22 steps
+  0x00000000, 0x00000001, 0x00000801, 0x00004081, 0x00010821, 0x00042211, 0x00088911, 0x00049249,
+  0x00124a49, 0x001294a5, 0x000aa955, 0x00155555, 0x002aad55, 0x001ad6b5, 0x001b6b6d, 0x002db6db,
+  0x001ddbbb, 0x001eef77, 0x002f7def, 0x002fdfbf, 0x001ffbff, 0x001fffff, 0x003fffff, 0x00000000,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 23 steps
+  0x00000000, 0x00000001, 0x00000801, 0x00010101, 0x00041041, 0x00044221, 0x00111111, 0x00112449,
+  0x00249249, 0x0014a529, 0x00254a95, 0x00155555, 0x00555555, 0x00356ad5, 0x0056b5ad, 0x0036db6d,
+  0x003b6edb, 0x003bbbbb, 0x005deef7, 0x003efbef, 0x003fbfbf, 0x005ffbff, 0x003fffff, 0x007fffff,
+  0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 24 steps
+  0x00000000, 0x00000001, 0x00001001, 0x00010101, 0x00041041, 0x00108421, 0x00111111, 0x00224489,
+  0x00249249, 0x00494949, 0x004a54a5, 0x004aa955, 0x00555555, 0x006aad55, 0x006b56b5, 0x006d6d6d,
+  0x006db6db, 0x0076eddb, 0x00777777, 0x007bdef7, 0x007df7df, 0x007f7f7f, 0x007ff7ff, 0x007fffff,
+  0x00ffffff, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 25 steps
+  0x00000000, 0x00000001, 0x00001001, 0x00010101, 0x00041041, 0x00108421, 0x00111111, 0x00244891,
+  0x00249249, 0x00524a49, 0x005294a5, 0x00552a95, 0x00555555, 0x01555555, 0x0155aad5, 0x015ad6b5,
+  0x015b6b6d, 0x016db6db, 0x016eddbb, 0x01777777, 0x00f7bdef, 0x017df7df, 0x017f7f7f, 0x017ff7ff,
+  0x00ffffff, 0x01ffffff, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 26 steps
+  0x00000000, 0x00000001, 0x00002001, 0x00040201, 0x00082041, 0x00108421, 0x00222111, 0x00488911,
+  0x00492249, 0x01249249, 0x00a52529, 0x00a952a5, 0x00aaa555, 0x01555555, 0x02aab555, 0x02ad5ab5,
+  0x02b5b5ad, 0x01b6db6d, 0x02db76db, 0x02dddbbb, 0x02eef777, 0x02f7bdef, 0x02fbf7df, 0x01feff7f,
+  0x01ffefff, 0x01ffffff, 0x03ffffff, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 27 steps
+  0x00000000, 0x00000001, 0x00002001, 0x00040201, 0x00204081, 0x00410821, 0x00442211, 0x01111111,
+  0x00922489, 0x01249249, 0x01494949, 0x025294a5, 0x0154aa55, 0x01555555, 0x05555555, 0x0556ab55,
+  0x035ad6b5, 0x056d6d6d, 0x036db6db, 0x05b76ddb, 0x03bbbbbb, 0x05deef77, 0x03ef7def, 0x03f7efdf,
+  0x03fdfeff, 0x05ffefff, 0x03ffffff, 0x07ffffff, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 28 steps
+  0x00000000, 0x00000001, 0x00004001, 0x00040201, 0x00204081, 0x00420841, 0x01084421, 0x01111111,
+  0x01224489, 0x01249249, 0x04925249, 0x0294a529, 0x02a54a95, 0x04aaa555, 0x05555555, 0x06aab555,
+  0x0ab56ad5, 0x0ad6b5ad, 0x06db5b6d, 0x0b6db6db, 0x0b76eddb, 0x07777777, 0x07bddef7, 0x0bdf7bef,
+  0x07efdfbf, 0x0bfdfeff, 0x07ffdfff, 0x07ffffff, 0x0fffffff, 0x00000000, 0x00000000, 0x00000000,
+  0x00000000,
+  // 29 steps
+  0x00000000, 0x00000001, 0x00004001, 0x00100401, 0x00204081, 0x01041041, 0x02108421, 0x01111111,
+  0x04448891, 0x04492249, 0x09249249, 0x09292929, 0x054a54a5, 0x0954aa55, 0x05555555, 0x15555555,
+  0x0d56ab55, 0x156b56b5, 0x0dadadad, 0x0db6db6d, 0x0edb76db, 0x0eedddbb, 0x17777777, 0x0f7bdef7,
+  0x0fbefbef, 0x17efdfbf, 0x0ffbfeff, 0x17ffdfff, 0x0fffffff, 0x1fffffff, 0x00000000, 0x00000000,
+  0x00000000,
+  // 30 steps
+  0x00000000, 0x00000001, 0x00008001, 0x00100401, 0x00408081, 0x01041041, 0x02108421, 0x04222111,
+  0x08889111, 0x04912449, 0x09249249, 0x124a4949, 0x0a5294a5, 0x12a54a95, 0x0aaa9555, 0x15555555,
+  0x2aaad555, 0x1ab56ad5, 0x2b5ad6b5, 0x1b6b6d6d, 0x1b6db6db, 0x2dbb6edb, 0x1dddbbbb, 0x1eeef777,
+  0x1ef7bdef, 0x1f7df7df, 0x2fdfdfbf, 0x1ff7fdff, 0x1fffbfff, 0x1fffffff, 0x3fffffff, 0x00000000,
+  0x00000000,
+  // 31 steps
+  0x00000000, 0x00000001, 0x00008001, 0x00100401, 0x01010101, 0x01041041, 0x02108421, 0x08442211,
+  0x11111111, 0x11224489, 0x09249249, 0x14925249, 0x24a52529, 0x252a52a5, 0x1552aa55, 0x15555555,
+  0x55555555, 0x555aab55, 0x35ab5ab5, 0x36b5b5ad, 0x56db5b6d, 0x5b6db6db, 0x3b76eddb, 0x3bbbbbbb,
+  0x3ddeef77, 0x5ef7bdef, 0x5f7df7df, 0x3fbfbfbf, 0x5ff7fdff, 0x5fffbfff, 0x3fffffff, 0x7fffffff,
+  0x00000000,
+  // 32 steps
+  0x00000000, 0x00000001, 0x00010001, 0x00400801, 0x01010101, 0x04082041, 0x04210421, 0x08844221,
+  0x11111111, 0x12244891, 0x12491249, 0x49249249, 0x49494949, 0x4a5294a5, 0x4a954a95, 0x4aaa9555,
+  0x55555555, 0x6aaad555, 0x6ad56ad5, 0x6b5ad6b5, 0x6d6d6d6d, 0x6db6db6d, 0xb6dbb6db, 0xb76eddbb,
+  0x77777777, 0xbbddeef7, 0xbdefbdef, 0x7efbf7df, 0x7f7f7f7f, 0x7feffdff, 0x7fff7fff, 0x7fffffff,
+  0xffffffff,
+};
+
+// rotl32 as the Cortex-M compiles it: register shifts of 32 give 0
+static uint32_t ReferenceRotl32(uint32_t input, unsigned int length, unsigned int count) {
+  if (length < 32) input &= ~(0xffffffffU << length);
+  const uint32_t left = input << count;
+  const uint32_t right = (length - count) < 32 ? input >> (length - count) : 0;
+  return left | right;
+}
+
+static uint32_t ReferenceEuclideanPattern(uint8_t num_steps, uint8_t num_beats, uint8_t rotation, uint8_t padding) {
+  if (num_steps < 2) num_steps = 2;
+  if (num_beats > num_steps) num_beats = num_steps;
+  uint32_t pattern = bjorklund_patterns[((num_steps - 2) * 33) + num_beats];
+  if (rotation) {
+    rotation = rotation % (num_steps + padding);
+    pattern = ReferenceRotl32(pattern, num_steps + padding, rotation);
+  }
+  return pattern;
+}
+
+// res/bjorklund.py, for lengths beyond the table
+static std::vector<int> ReferenceBjorklund(int pulses, int steps) {
+  std::vector<int> pattern, counts, remainders;
+  int divisor = steps - pulses;
+  remainders.push_back(pulses);
+  int level = 0;
+  while (true) {
+    counts.push_back(divisor / remainders[level]);
+    remainders.push_back(divisor % remainders[level]);
+    divisor = remainders[level];
+    level = level + 1;
+    if (remainders[level] <= 1) break;
+  }
+  counts.push_back(divisor);
+
+  std::function<void(int)> build = [&](int l) {
+    if (l == -1) {
+      pattern.push_back(0);
+    } else if (l == -2) {
+      pattern.push_back(1);
+    } else {
+      for (int i = 0; i < counts[l]; ++i) build(l - 1);
+      if (remainders[l] != 0) build(l - 2);
+    }
+  };
+  build(level);
+
+  size_t i = 0;
+  while (!pattern[i]) ++i;
+  std::vector<int> rotated(pattern.begin() + i, pattern.end());
+  rotated.insert(rotated.end(), pattern.begin(), pattern.begin() + i);
+  return rotated;
+}
+
+static_assert(BjorklundPattern(16, 4) == 0x1111, "generated at compile time");
+static_assert(BjorklundPattern(8, 0) == 0, "no beats");
+
+TEST(Bjorklund, MatchesTable) {
+  for (int steps = 0; steps <= 32; ++steps) {
+    for (int beats = 0; beats <= 40; ++beats) {
+      for (int padding = 0; padding <= 32 - std::max(steps, 2); ++padding) {
+        for (int rotation = 0; rotation < 256; ++rotation) {
+          ASSERT_EQ(ReferenceEuclideanPattern(steps, beats, rotation, padding), EuclideanPattern(steps, beats, rotation, padding))
+            << "steps " << steps << " beats " << beats << " rotation " << rotation << " padding " << padding;
+        }
+      }
+    }
+  }
+}
+
+TEST(Bjorklund, MatchesAlgorithmTo64Steps) {
+  for (int steps = 2; steps <= 64; ++steps) {
+    EXPECT_EQ(0u, BjorklundPattern(steps, 0));
+    for (int beats = 1; beats <= steps; ++beats) {
+      const std::vector<int> expected = ReferenceBjorklund(beats, steps);
+      uint64_t mask = 0;
+      for (int i = 0; i < steps; ++i) mask |= uint64_t(expected[i]) << i;
+      ASSERT_EQ(mask, BjorklundPattern(steps, beats)) << "steps " << steps << " beats " << beats;
+      ASSERT_EQ(mask, EuclideanPattern64(steps, beats, 0));
+    }
+  }
+}
+
+// Bits rotated past the padded length are left above it, as rotl32 always
+// has; only the first steps + padding bits are checked.
+TEST(Bjorklund, RotatesAndPadsTo64Steps) {
+  for (int steps = 2; steps <= 64; ++steps) {
+    for (int padding = 0; padding <= 64 - steps; padding += 3) {
+      const int length = steps + padding;
+      for (int beats = 0; beats <= steps; beats += 5) {
+        const uint64_t pattern = EuclideanPattern64(steps, beats, 0, padding);
+        for (int rotation = 0; rotation < 256; ++rotation) {
+          const uint64_t rotated = EuclideanPattern64(steps, beats, rotation, padding);
+          for (int i = 0; i < length; ++i) {
+            ASSERT_EQ((pattern >> i) & 1, (rotated >> ((i + rotation) % length)) & 1)
+              << "steps " << steps << " beats " << beats << " rotation " << rotation << " padding " << padding;
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(Bjorklund, Filter) {
+  for (int steps = 2; steps <= 64; ++steps) {
+    const uint64_t pattern = EuclideanPattern64(steps, steps / 3, 1);
+    for (uint32_t clock = 0; clock < 200; ++clock)
+      ASSERT_EQ(static_cast<bool>((pattern >> (clock % steps)) & 1), EuclideanFilter(steps, steps / 3, 1, clock));
+  }
+}
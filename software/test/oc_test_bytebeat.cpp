@@ -0,0 +1,395 @@
+#include "gtest/gtest.h"
+#include "peaks_bytebeat.h"
+
+#include <chrono>
+#include <csetjmp>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <vector>
+
+using peaks::CONTROL_GATE_RISING;
+
+// peaks::ByteBeat's state and per-sample switch as they were
+struct ReferenceByteBeat {
+  uint16_t equation_;
+  uint16_t speed_;
+  uint16_t pitch_;
+  uint8_t p0_;
+  uint8_t p1_;
+  uint8_t p2_;
+  uint16_t last_sample_;
+  uint32_t t_;
+  uint32_t phase_;
+  uint32_t loop_start_;
+  uint32_t loop_end_;
+  bool stepmode_;
+  bool loopmode_;
+  uint16_t equation_index_;
+  uint16_t bytepitch_;
+
+  void Init() {
+    equation_ = 0;
+    speed_ = 32678;
+    pitch_ = 1;
+    loopmode_ = false;
+    loop_start_ = 0;
+    loop_end_ = 255 << 24;
+    phase_ = 0;
+    t_ = 0;
+    p0_ = 127;
+    p1_ = 127;
+    p2_ = 127;
+    stepmode_ = false;
+    last_sample_ = 13;
+  }
+
+  void Configure(int32_t* parameter, bool stepmode, bool loopmode) {
+    equation_ = parameter[0];
+    equation_index_ = equation_ >> 12;
+    speed_ = parameter[1];
+    p0_ = parameter[2] >> 8;
+    p1_ = parameter[3] >> 8;
+    p2_ = parameter[4] >> 8;
+    loop_start_ = static_cast<uint32_t>((parameter[5] << 16) + (parameter[6] << 8) + parameter[7]);
+    loop_end_ = static_cast<uint32_t>((parameter[8] << 16) + (parameter[9] << 8) + parameter[10]);
+    pitch_ = parameter[11] >> 8;
+    stepmode_ = stepmode;
+    loopmode_ = loopmode;
+    uint8_t speed_rshift = (speed_ >> 13) + 1;
+    if (speed_rshift < 2) speed_rshift = 2;
+    bytepitch_ = (65535 - speed_) >> speed_rshift;
+    if (bytepitch_ < 1) {
+      bytepitch_ = 1;
+    }
+  }
+
+  // out of line, as it was in its own translation unit
+  __attribute__((noinline)) uint16_t ProcessSingleSample(uint8_t control) {
+
+    uint16_t sample = 0;
+   
+    if (control & CONTROL_GATE_RISING) {
+      if (stepmode_) {
+        ++t_ ;
+      } else {
+        phase_ = 0;
+        if (loopmode_) {
+          t_ = loop_start_ ;
+        } else {
+          t_ = 0 ;
+        }
+      }
+    }
+
+    if (!stepmode_) {
+      ++phase_ ; 
+    }    
+  
+    if (loopmode_ && (t_ < loop_start_ || t_ > loop_end_)) {
+       t_ = loop_start_ ;
+       phase_ = 0 ;
+    }
+
+    if (!stepmode_ && (phase_ % bytepitch_ == 0)) ++t_; 
+  // These equations push the boundaries of precedence comprehension.
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wparentheses"
+    uint8_t pitch = pitch_ ;
+    uint8_t p0 = p0_ ;
+    uint8_t p1 = p1_ ;
+    uint8_t p2 = p2_ ;
+      switch (equation_index_) {
+          case 0: // hope - pitch OK
+            // from http://royal-paw.com/2012/01/bytebeats-in-c-and-python-generative-symphonies-from-extremely-small-programs/
+            // (atmospheric, hopeful)
+            // sample = ( ( ((t_*3) & ((t_*pitch)>>10)) | ((t_*p0) & ((t_*pitch)>>10)) | ((t_*10) & (((t_*pitch)>>8)*p1) & p2) ) & 0xFF);
+            // sample = ( ( ((t_*3) & ((t_*pitch)>>10)) | ((t_*p0) & ((t_*pitch)>>10)) | ((t_*10) & ((t_>>8)*p1) & p2) ) & 0xFF);
+            sample = ( ( (((t_*pitch)*3) & (t_>>10)) | (((t_*pitch)*p0) & (t_>>10)) | ((t_*10) & ((t_>>8)*p1) & p2) ) & 0xFF);
+            break;
+          case 1: // love - pitch OK
+            // equation by stephth via https://www.youtube.com/watch?v=tCRPUv8V22o at 3:38
+            sample = (((((t_*pitch)*p0) & (t_>>4)) | ((t_*p2) & (t_>>7)) | ((t_*p1) & (t_>>10))) & 0xFF);
+            break;
+          case 2: // life - pitch OK
+            // This one is the second one listed at from http://xifeng.weebly.com/bytebeats.html
+            sample = ((( ((((((t_*pitch) >> p0) | (t_*pitch)) | ((t_*pitch) >> p0)) * p2) & ((5 * (t_*pitch)) | ((t_*pitch) >> p2)) ) | ((t_*pitch) ^ (t_ % p1)) ) & 0xFF));
+            break;
+         case 3:// age - pitch disabled
+            // Arp rotator (equation 9 from Equation Composer Ptah bank)
+            sample = (((t_)>>(p2>>4))&((t_)<<3)/((t_)*p1*((t_)>>11)%(3+(((t_)>>(16-(p0>>4)))%22))));
+            break ;
+          case 4: // clysm - pitch almost no effect
+            //  BitWiz Transplant via Equation Composer Ptah bank 
+            sample = ((t_*pitch)-(((t_*pitch)&p0)*p1-1668899)*(((t_*pitch)>>15)%15*(t_*pitch)))>>(((t_*pitch)>>12)%16)>>(p2%15);
+            break ;
+          case 5: // monk - pitch OK
+            // Vocaliser from Equation Composer Khepri bank         
+            sample = (((t_*pitch)%p0>>2)&p1)*(t_>>(p2>>5));
+            break;
+          case 6: // NERV - horrible!
+            // Chewie from Equation Composer Khepri bank         
+            sample = (p0-(((p2+1)/(t_*pitch))^p0|(t_*pitch)^922+p0))*(p2+1)/p0*(((t_*pitch)+p1)>>p1%19);
+            break;
+          case 7: // Trurl - pitch OK
+            // Tinbot from Equation Composer Sobek bank   
+            sample = ((t_*pitch)/(40+p0)*((t_*pitch)+(t_*pitch)|4-(p1+20)))+((t_*pitch)*(p2>>5));
+            break;
+          case 8: // Pirx  - pitch OK
+            // My Loud Friend from Equation Composer Ptah bank   
+            sample = ((((t_*pitch)>>((p0>>12)%12))%(t_>>((p1%12)+1))-(t_>>((t_>>(p2%10))%12)))/((t_>>((p0>>2)%15))%15))<<4;
+            break;
+          case 9: //Snaut
+            // GGT2 from Equation Composer Ptah bank
+            // sample = ((p0|(t_>>(t_>>13)%14))*((t_>>(p0%12))-p1&249))>>((t_>>13)%6)>>((p2>>4)%12);
+            // "A bit high-frequency, but keeper anyhow" from Equation Composer Khepri bank.
+            sample = ((t_*pitch)+last_sample_+p1/p0)%(p0|(t_*pitch)+p2);
+             break;
+          case 10: // Hari
+            // The Signs, from Equation Composer Ptah bank
+            sample = ((0&(251&((t_*pitch)/(100+p0))))|((last_sample_/(t_*pitch)|((t_*pitch)/(100*(p1+1))))*((t_*pitch)|p2)));
+            break;
+          case 11: // Kris - pitch OK
+           // Light Reactor from Equation Composer Ptah bank
+            sample = (((t_*pitch)>>3)*(p0-643|(325%t_|p1)&t_)-((t_>>6)*35/p2%t_))>>6;
+            break;
+          case 12: // Tichy
+            sample = (t_*pitch_)>>7 & t_>>7 | t_>>8;
+            // Alpha from Equation Composer Khepri bank
+            // sample = ((((t_*pitch)^(p0>>3)-456)*(p1+1))/((((t_*pitch)>>(p2>>3))%14)+1))+((t_*pitch)*((182>>((t_*pitch)>>15)%16))&1) ;
+            break;
+          case 13: // Bregg - pitch OK
+            // Hooks, from Equation Composer Khepri bank.
+            sample = ((t_*pitch)&(p0+2))-(t_/p1)/last_sample_/p2;
+            break;            
+          case 14: // Avon - pitch OK
+            // Widerange from Equation Composer Khepri bank
+            sample = (((p0^((t_*pitch)>>(p1>>3)))-(t_>>(p2>>2))-t_%(t_&p1)));
+            break;        
+          case 15: // Orac
+            // Abducted, from Equation Composer Ptah bank
+            sample = (p0+(t_*pitch)>>p1%12)|((last_sample_%(p0+(t_*pitch)>>p0%4))+11+p2^t_)>>(p2>>12);
+            break;
+          default:
+            sample = 0 ;
+            break;          
+    }
+  #pragma GCC diagnostic pop
+    last_sample_ = sample ;
+    return sample << 8 ;
+  }
+};
+
+// Several equations divide by t, by parameters or by the last sample. The
+// Cortex-M returns 0 for those, x86 raises SIGFPE; both implementations run
+// the same expressions so they must trap on the same samples.
+static sigjmp_buf fpe_jump;
+
+static void OnFpe(int) {
+  siglongjmp(fpe_jump, 1);
+}
+
+template <typename F>
+static bool Guarded(F f) {
+  if (sigsetjmp(fpe_jump, 1)) return false;
+  f();
+  return true;
+}
+
+class ByteBeatTest : public ::testing::Test {
+public:
+  virtual void SetUp() {
+    previous_ = signal(SIGFPE, OnFpe);
+  }
+  virtual void TearDown() {
+    signal(SIGFPE, previous_);
+  }
+
+private:
+  void (*previous_)(int);
+};
+
+static uint32_t NextRandom(uint32_t &seed) {
+  seed = seed * 1664525 + 1013904223;
+  return seed;
+}
+
+// Parameters as the apps produce them: settings scaled to 16 bits, plus CV
+static void RandomParameters(uint32_t &seed, int equation, int32_t *s) {
+  s[0] = equation << 12 | (NextRandom(seed) >> 20);
+  for (int i = 1; i < 12; ++i) s[i] = NextRandom(seed) >> 16;
+  // the loop mostly within reach
+  s[5] = s[6] = 0;
+  s[8] = 0;
+  s[9] = NextRandom(seed) >> 30;
+  // the app's defaults now and again: p0 small enough to divide by zero
+  if (!(NextRandom(seed) >> 30)) s[2] = NextRandom(seed) >> 24;
+}
+
+TEST_F(ByteBeatTest, MatchesReference) {
+  uint32_t seed = 7;
+  int traps = 0;
+  for (int equation = 0; equation < 16; ++equation) {
+    for (int run = 0; run < 24; ++run) {
+      ReferenceByteBeat ref;
+      peaks::ByteBeat bytebeat;
+      ref.Init();
+      bytebeat.Init();
+      const bool stepmode = !(run & 3), loopmode = run & 1;
+
+      int32_t s[12];
+      RandomParameters(seed, equation, s);
+      for (int tick = 0; tick < 3000; ++tick) {
+        if (!(NextRandom(seed) >> 24)) RandomParameters(seed, equation, s);
+        if (!(tick & 63)) s[1] = NextRandom(seed) >> 16; // speed sweeps
+        const uint8_t control = (NextRandom(seed) >> 26) ? 0 : CONTROL_GATE_RISING;
+
+        ref.Configure(s, stepmode, loopmode);
+        bytebeat.Configure(s, stepmode, loopmode);
+        uint16_t expected = 0, actual = 0;
+        const bool ref_ok = Guarded([&] { expected = ref.ProcessSingleSample(control); });
+        const bool ok = Guarded([&] { actual = bytebeat.ProcessSingleSample(control); });
+        traps += !ref_ok;
+        ASSERT_EQ(ref_ok, ok) << "equation " << equation << " run " << run << " tick " << tick;
+        ASSERT_EQ(expected, actual) << "equation " << equation << " run " << run << " tick " << tick;
+        ASSERT_EQ(ref.t_, bytebeat.get_t());
+        ASSERT_EQ(ref.phase_, bytebeat.get_phase());
+        ASSERT_EQ(ref.last_sample_, bytebeat.get_last_sample());
+      }
+    }
+  }
+  EXPECT_GT(traps, 0); // the division paths were exercised
+}
+
+TEST_F(ByteBeatTest, ClockMatchesReference) {
+  for (int equation = 0; equation < 16; ++equation) {
+    ReferenceByteBeat ref;
+    peaks::ByteBeat bytebeat;
+    ref.Init();
+    bytebeat.Init();
+    ref.equation_index_ = equation;
+    bytebeat.set_equation(equation << 12);
+    for (int i = 0; i < 5000; ++i) {
+      uint16_t expected = 0, actual = 0;
+      const bool ref_ok = Guarded([&] { ref.stepmode_ = true; expected = ref.ProcessSingleSample(CONTROL_GATE_RISING); });
+      const bool ok = Guarded([&] { actual = bytebeat.Clock(); });
+      ASSERT_EQ(ref_ok, ok);
+      ASSERT_EQ(expected, actual) << "equation " << equation << " step " << i;
+    }
+  }
+}
+
+TEST_F(ByteBeatTest, RenderMatchesProcessSingleSample) {
+  const size_t kBlockSize = 64;
+  uint32_t seed = 11;
+  int blocks = 0;
+  for (int equation = 0; equation < 16; ++equation) {
+    for (int run = 0; run < 8; ++run) {
+      peaks::ByteBeat single, block;
+      single.Init();
+      block.Init();
+      int32_t s[12];
+      RandomParameters(seed, equation, s);
+      const bool stepmode = run & 2, loopmode = run & 1;
+      single.Configure(s, stepmode, loopmode);
+      block.Configure(s, stepmode, loopmode);
+
+      for (int b = 0; b < 100; ++b) {
+        uint8_t control[kBlockSize];
+        uint16_t expected[kBlockSize], actual[kBlockSize];
+        for (auto &c : control) c = (NextRandom(seed) >> 27) ? 0 : CONTROL_GATE_RISING;
+        if (!Guarded([&] { for (size_t i = 0; i < kBlockSize; ++i) expected[i] = single.ProcessSingleSample(control[i]); })) break;
+        ASSERT_TRUE(Guarded([&] { block.Render(control, actual, kBlockSize); }));
+        for (size_t i = 0; i < kBlockSize; ++i)
+          ASSERT_EQ(expected[i], actual[i]) << "equation " << equation << " block " << b << " sample " << i;
+        ASSERT_EQ(single.get_t(), block.get_t());
+        ++blocks;
+      }
+    }
+  }
+  EXPECT_GT(blocks, 16 * 8 * 10);
+}
+
+// Not a pass/fail test; prints the time per tick for four channels: the
+// switch and the kernels a sample at a time, as BitBeat runs them, and a
+// block of four for one channel per tick, as the ByteBeat app does
+TEST_F(ByteBeatTest, DISABLED_Benchmark) {
+  const int kTicks = 200000;
+  // equations that don't divide by zero with these parameters
+  const int equations[4] = { 0, 1, 5, 12 };
+  int32_t s[12] = { 0, 40000, 30000, 20000, 50000, 0, 0, 0, 0, 255, 255, 1 << 8 };
+
+  double ns[3];
+  uint32_t sums[3] = { 0, 0, 0 };
+  {
+    ReferenceByteBeat refs[4];
+    for (auto &r : refs) r.Init();
+    const auto start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < kTicks; ++tick) {
+      for (int ch = 0; ch < 4; ++ch) {
+        s[0] = equations[ch] << 12;
+        refs[ch].Configure(s, false, false);
+        sums[0] += refs[ch].ProcessSingleSample(0);
+      }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    ns[0] = std::chrono::duration<double, std::nano>(end - start).count() / kTicks;
+  }
+  {
+    peaks::ByteBeat bytebeats[4];
+    for (auto &b : bytebeats) b.Init();
+    const auto start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < kTicks; ++tick) {
+      for (int ch = 0; ch < 4; ++ch) {
+        s[0] = equations[ch] << 12;
+        bytebeats[ch].Configure(s, false, false);
+        sums[1] += bytebeats[ch].ProcessSingleSample(0);
+      }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    ns[1] = std::chrono::duration<double, std::nano>(end - start).count() / kTicks;
+  }
+  {
+    const int kBlockSize = 4;
+    peaks::ByteBeat bytebeats[4];
+    for (auto &b : bytebeats) b.Init();
+    const uint8_t control[kBlockSize] = { 0 };
+    uint16_t out[kBlockSize];
+    const auto start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < kTicks; ++tick) {
+      const int ch = tick & 3;
+      s[0] = equations[ch] << 12;
+      bytebeats[ch].Configure(s, false, false);
+      bytebeats[ch].Render(control, out, kBlockSize);
+      for (auto o : out) sums[2] += o;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    ns[2] = std::chrono::duration<double, std::nano>(end - start).count() / kTicks;
+  }
+  EXPECT_EQ(sums[0], sums[1]);
+  EXPECT_EQ(sums[0], sums[2]);
+  printf("[ BENCH    ] 4 channels per tick: switch %.1f ns, kernels %.1f ns, blocks %.1f ns\n", ns[0], ns[1], ns[2]);
+}
+
+// Init() leaves a ByteBeat that can run before the first Configure(): the
+// apps' ISR may get there first. Built over zeroes, the old Init() left
+// bytepitch_ at 0 and the first sample divided by it.
+TEST(ByteBeat, RunsBeforeConfigure) {
+  alignas(peaks::ByteBeat) static uint8_t memory[2][sizeof(peaks::ByteBeat)];
+  std::memset(memory[0], 0x00, sizeof(peaks::ByteBeat));
+  std::memset(memory[1], 0xA5, sizeof(peaks::ByteBeat));
+  peaks::ByteBeat *bytebeat[2];
+  for (int i = 0; i < 2; ++i) {
+    bytebeat[i] = new (memory[i]) peaks::ByteBeat;
+    bytebeat[i]->Init();
+    EXPECT_EQ(0u, bytebeat[i]->get_eqn_num());
+  }
+
+  for (int n = 0; n < 4096; ++n) {
+    const uint8_t control = (n % 500) == 0 ? peaks::CONTROL_GATE_RISING : 0;
+    ASSERT_EQ(bytebeat[0]->ProcessSingleSample(control), bytebeat[1]->ProcessSingleSample(control)) << n;
+    ASSERT_EQ(bytebeat[0]->get_t(), bytebeat[1]->get_t()) << n;
+  }
+  EXPECT_GT(bytebeat[0]->get_t(), 0u);
+}
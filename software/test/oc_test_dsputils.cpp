@@ -0,0 +1,16 @@
+#include "gtest/gtest.h"
+#include "dsputils.h"
+
+#include <cmath>
+
+// Pitch 0 is C3 and an octave is 12 << 7, within the fastapprox error
+TEST(DspUtils, PitchToHz) {
+  EXPECT_NEAR(130.81f, PitchToHz(0), 0.02f);
+  EXPECT_NEAR(261.63f, PitchToHz(12 << 7), 0.05f);
+  EXPECT_NEAR(440.0f, PitchToHz(21 << 7), 0.1f);
+
+  for (int pitch = -6 * (12 << 7); pitch <= 6 * (12 << 7); pitch += 37) {
+    const float expected = 130.8128f * std::exp2(pitch / (12.0f * 128.0f));
+    EXPECT_NEAR(expected, PitchToHz(pitch), expected * 1e-4f) << pitch;
+  }
+}
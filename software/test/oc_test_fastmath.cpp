@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+#include "fastmath.h"
+#include "extern/fastapprox/fastlog.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// Worst error of f against a double reference over [lo, hi], relative or
+// absolute
+template <typename F, typename R>
+static double MaxError(F f, R reference, double lo, double hi, bool relative, int steps = 1000003) {
+  double worst = 0.0;
+  for (int i = 0; i <= steps; ++i) {
+    const float x = static_cast<float>(lo + (hi - lo) * i / steps);
+    const double expected = reference(static_cast<double>(x));
+    double error = std::fabs(f(x) - expected);
+    if (relative) error /= std::fabs(expected);
+    if (error > worst) worst = error;
+  }
+  return worst;
+}
+
+// The bounds documented in fastmath.h
+TEST(FastMath, Accuracy) {
+  const double log2_small = MaxError(fastmath::Log2, [](double x) { return std::log2(x); }, 1e-6, 4.0, false);
+  const double log2_large = MaxError(fastmath::Log2, [](double x) { return std::log2(x); }, 4.0, 1e6, false);
+
+  printf("[ ERROR    ] log2 %.2g / %.2g\n", log2_small, log2_large);
+  EXPECT_LT(log2_small, 8e-7);
+  EXPECT_LT(log2_large, 1.2e-6);
+}
+
+TEST(FastMath, Limits) {
+  EXPECT_EQ(0.0f, fastmath::Log2(1.0f));
+  EXPECT_EQ(10.0f, fastmath::Log2(1024.0f));
+  EXPECT_EQ(-128.0f, fastmath::Log2(0.0f));
+  EXPECT_EQ(-128.0f, fastmath::Log2(-1.0f));
+
+  // monotonic across table segment boundaries
+  float last = fastmath::Log2(0.5f);
+  for (float x = 0.5f; x < 2.0f; x += 1.0f / 4096) {
+    const float v = fastmath::Log2(x);
+    EXPECT_GE(v, last) << x;
+    last = v;
+  }
+}
+
+// ns per call for libm, extern/fastapprox and fastmath, with the worst error
+// of the fastapprox version for comparison
+TEST(FastMath, DISABLED_Benchmark) {
+  const int kCount = 1 << 20;
+  std::vector<float> xs(kCount);
+  uint32_t seed = 1;
+  for (auto &x : xs) {
+    seed = seed * 1664525 + 1013904223;
+    x = static_cast<float>(seed >> 8) / (1 << 24) * 20.0f - 10.0f;
+  }
+
+  auto time = [&](float (*f)(float)) {
+    volatile float sink = 0.0f;
+    float sum = 0.0f;
+    const auto start = std::chrono::steady_clock::now();
+    for (float x : xs) sum += f(x);
+    const auto end = std::chrono::steady_clock::now();
+    sink = sum;
+    (void)sink;
+    return std::chrono::duration<double, std::nano>(end - start).count() / kCount;
+  };
+
+  const double libm_log2 = time([](float x) { return log2f(std::fabs(x) + 1e-3f); });
+  const double fastapprox_log2 = time([](float x) { return fastlog2(std::fabs(x) + 1e-3f); });
+  const double fastmath_log2 = time([](float x) { return fastmath::Log2(std::fabs(x) + 1e-3f); });
+
+  const double fastapprox_log2_error = MaxError([](float x) { return fastlog2(x); }, [](double x) { return std::log2(x); }, 1e-3, 16.0, false);
+
+  printf("[ BENCH    ] log2: libm %.2f ns, fastapprox %.2f ns (error %.2g), fastmath %.2f ns\n",
+         libm_log2, fastapprox_log2, fastapprox_log2_error, fastmath_log2);
+}
@@ -0,0 +1,167 @@
+#include "gtest/gtest.h"
+#include "util/util_life.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#define GOL_ABS(X) ((X) < 0 ? -(X) : (X))
+
+// GameOfLife's board and generation step as they were, one cell at a time.
+// GOL_ABS was unparenthesised, so GOL_ABS(tx - x) was never >= 8 for x > tx
+// and the local count took in everything below and right of the window; the
+// 15 x 15 window it was scaled for is what's compared here.
+struct ReferenceLife {
+  uint64_t board[80];
+  int global_density;
+  int local_density;
+
+  void ProcessGameBoard(int tx, int ty) {
+    uint64_t next_gen[80];
+    global_density = 0;
+    local_density = 0;
+    for (int y = 0; y < 40; y++) {
+      next_gen[y * 2] = 0;
+      next_gen[y * 2 + 1] = 0;
+      for (int x = 0; x < 64; x++) {
+        bool live = ValueAtCell(x, y);
+        int ln = CountLiveNeighborsAt(x, y);
+        if (((ln == 2 || ln == 3) && live) || (ln == 3 && !live)) {
+          int i = y * 2;
+          int xb = x;
+          if (x > 31) {
+            i += 1;
+            xb -= 32;
+          }
+          next_gen[i] = next_gen[i] | (0x01 << xb);
+          global_density++;
+          if (GOL_ABS(tx - x) < 8 && GOL_ABS(ty - y) < 8) local_density++;
+        }
+      }
+    }
+    memcpy(&board, &next_gen, sizeof(next_gen));
+  }
+
+  int CountLiveNeighborsAt(int x, int y) {
+    int count = 0;
+    for (int nx = -1; nx < 2; nx++)
+      for (int ny = -1; ny < 2; ny++)
+        if (!(nx == 0 && ny == 0)) count += ValueAtCell(x + nx, y + ny);
+    return count;
+  }
+
+  bool ValueAtCell(int x, int y) {
+    if (x > 63) x -= 64;
+    if (x < 0) x += 64;
+    if (y > 39) y -= 40;
+    if (y < 0) y += 40;
+    int i = y * 2;
+    if (x > 31) {
+      i += 1;
+      x -= 32;
+    }
+    return ((board[i] >> x) & 0x01);
+  }
+
+  void AddToBoard(int x, int y) {
+    int i = y * 2;
+    int xb = x;
+    if (x > 31) {
+      i += 1;
+      xb -= 32;
+    }
+    board[i] = board[i] | (0x01 << xb);
+  }
+};
+
+static uint32_t NextRandom(uint32_t &seed) {
+  seed = seed * 1664525 + 1013904223;
+  return seed;
+}
+
+static void ExpectSameBoard(ReferenceLife &ref, const util::LifeBoard<40> &board) {
+  for (int y = 0; y < 40; ++y)
+    for (int x = 0; x < 64; ++x)
+      ASSERT_EQ(ref.ValueAtCell(x, y), board.Get(x, y)) << "x " << x << " y " << y;
+}
+
+TEST(LifeBoard, MatchesReference) {
+  for (uint32_t seed = 1; seed <= 40; ++seed) {
+    ReferenceLife ref;
+    util::LifeBoard<40> board;
+    memset(ref.board, 0, sizeof(ref.board));
+    board.Clear();
+
+    // density from sparse to crowded across seeds
+    uint32_t s = seed;
+    const int cells = 40 + seed * 40;
+    for (int i = 0; i < cells; ++i) {
+      const int x = NextRandom(s) >> 26, y = (NextRandom(s) >> 16) % 40;
+      ref.AddToBoard(x, y);
+      board.Set(x, y);
+    }
+
+    for (int gen = 0; gen < 200; ++gen) {
+      const int tx = NextRandom(s) >> 26, ty = (NextRandom(s) >> 16) % 40;
+      ref.ProcessGameBoard(tx, ty);
+      const int population = board.Step();
+      ASSERT_EQ(ref.global_density, population) << "seed " << seed << " gen " << gen;
+      ASSERT_EQ(ref.local_density, board.CountNear(tx, ty, 8)) << "seed " << seed << " gen " << gen;
+      ExpectSameBoard(ref, board);
+      if (::testing::Test::HasFatalFailure()) return;
+
+      // drawing in, as Gate(1) does between clocks
+      if (!(NextRandom(s) >> 29)) {
+        const int x = NextRandom(s) >> 26, y = (NextRandom(s) >> 16) % 40;
+        ref.AddToBoard(x, y);
+        board.Set(x, y);
+      }
+    }
+  }
+}
+
+// A glider wraps off the bottom and right edges and keeps going
+TEST(LifeBoard, GliderWraps) {
+  util::LifeBoard<40> board;
+  board.Clear();
+  board.Set(62, 38); board.Set(63, 39); board.Set(61, 0); board.Set(62, 0); board.Set(63, 0);
+  for (int gen = 0; gen < 4 * 40; ++gen) EXPECT_EQ(5, board.Step());
+  // 40 cells diagonally, so 40 columns along mod 64
+  EXPECT_TRUE(board.Get(63 - 64 + 40, 0));
+}
+
+// Time per generation, board against reference
+TEST(LifeBoard, DISABLED_Benchmark) {
+  const int kGenerations = 2000;
+  ReferenceLife ref;
+  util::LifeBoard<40> board;
+  memset(ref.board, 0, sizeof(ref.board));
+  board.Clear();
+  uint32_t s = 5;
+  for (int i = 0; i < 800; ++i) {
+    const int x = NextRandom(s) >> 26, y = (NextRandom(s) >> 16) % 40;
+    ref.AddToBoard(x, y);
+    board.Set(x, y);
+  }
+
+  int64_t sums[2] = { 0, 0 };
+  double us[2];
+  auto start = std::chrono::steady_clock::now();
+  for (int gen = 0; gen < kGenerations; ++gen) {
+    ref.ProcessGameBoard(32, 20);
+    sums[0] += ref.global_density + ref.local_density;
+  }
+  auto end = std::chrono::steady_clock::now();
+  us[0] = std::chrono::duration<double, std::micro>(end - start).count() / kGenerations;
+
+  start = std::chrono::steady_clock::now();
+  for (int gen = 0; gen < kGenerations; ++gen) {
+    sums[1] += board.Step();
+    sums[1] += board.CountNear(32, 20, 8);
+  }
+  end = std::chrono::steady_clock::now();
+  us[1] = std::chrono::duration<double, std::micro>(end - start).count() / kGenerations;
+
+  EXPECT_EQ(sums[0], sums[1]);
+  printf("[ BENCH    ] generation: per cell %.2f us, bit-parallel %.3f us\n", us[0], us[1]);
+}
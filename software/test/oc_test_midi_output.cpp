@@ -0,0 +1,164 @@
+#include "gtest/gtest.h"
+#include "midi_host.h"
+#include "HSMIDIOutput.h"
+
+#include <vector>
+
+static constexpr uint8_t kUSB = 1 << HS::MIDI_PORT_USB;
+static constexpr uint8_t kDIN = 1 << HS::MIDI_PORT_DIN;
+
+class MIDIOutSchedulerTest : public ::testing::Test {
+public:
+  virtual void SetUp() {
+    usbMIDI.Clear();
+    usbHostMIDI.Clear();
+    MIDI1.Clear();
+    out_.Init();
+  }
+
+  static int Count(const std::vector<HostMIDIEvent> &sent, uint8_t type) {
+    int n = 0;
+    for (auto &e : sent) n += (e.type == type);
+    return n;
+  }
+
+protected:
+  HS::MIDIOutScheduler out_;
+};
+
+// Only the latest CC per channel and number, bend and aftertouch per channel
+// go out each tick, on every port
+TEST_F(MIDIOutSchedulerTest, CoalescesContinuousUpdates) {
+  out_.SendCC(0, 1, 10);
+  out_.SendCC(0, 1, 20);
+  out_.SendCC(0, 2, 30); // another CC#
+  out_.SendCC(1, 1, 40); // another channel
+  out_.SendPitchBend(0, 100);
+  out_.SendPitchBend(0, -200);
+  out_.SendAfterTouch(3, 5);
+  out_.SendAfterTouch(3, 6);
+  EXPECT_EQ(3u, out_.coalesced_count);
+  out_.Flush();
+
+  for (HostMIDIPort *port : {(HostMIDIPort *)&usbMIDI, (HostMIDIPort *)&usbHostMIDI, (HostMIDIPort *)&MIDI1}) {
+    const std::vector<HostMIDIEvent> expected = {
+      {HS::HEM_MIDI_PITCHBEND, 1, 0, 0, -200},
+      {HS::HEM_MIDI_AFTERTOUCH_CHANNEL, 4, 6, 0, 0},
+      {HS::HEM_MIDI_CC, 1, 1, 20, 0},
+      {HS::HEM_MIDI_CC, 1, 2, 30, 0},
+      {HS::HEM_MIDI_CC, 2, 1, 40, 0},
+    };
+    EXPECT_EQ(expected, port->sent);
+  }
+
+  // sent means cleared; a new tick starts over
+  usbMIDI.Clear();
+  out_.Flush();
+  EXPECT_TRUE(usbMIDI.sent.empty());
+
+  // a different port for the same CC widens the slot, it isn't a replacement
+  out_.SendCC(0, 1, 50, kUSB);
+  out_.SendCC(0, 1, 60, kDIN);
+  EXPECT_EQ(3u, out_.coalesced_count);
+  out_.Flush();
+  ASSERT_EQ(1u, usbMIDI.sent.size());
+  EXPECT_EQ(60, usbMIDI.sent[0].data2);
+  EXPECT_EQ(5u, usbHostMIDI.sent.size()); // from the first tick only
+}
+
+// With every CC slot taken, further CCs queue with the notes, uncoalesced
+TEST_F(MIDIOutSchedulerTest, CCSlotsFull) {
+  const int slots = HS::MIDIOutScheduler::kCCSlots;
+  for (int i = 0; i < slots + 2; ++i) out_.SendCC(0, i, i, kUSB);
+  out_.SendCC(0, slots, 99, kUSB);
+  out_.Flush();
+  EXPECT_EQ(slots + 3, Count(usbMIDI.sent, HS::HEM_MIDI_CC));
+  EXPECT_EQ(0u, out_.coalesced_count);
+}
+
+// A full note queue sends straight away rather than dropping anything
+TEST_F(MIDIOutSchedulerTest, NoteQueueOverflow) {
+  const int size = HS::MIDIOutScheduler::kNoteQueueSize;
+  const int extra = 8;
+  for (int i = 0; i < size + extra; ++i) out_.SendNoteOn(0, i, 100);
+  EXPECT_EQ(uint32_t(extra), out_.overflow_count);
+  // the overflow went out at once, on DIN too regardless of its budget
+  ASSERT_EQ(size_t(extra), usbMIDI.sent.size());
+  EXPECT_EQ(size_t(extra), MIDI1.sent.size());
+  EXPECT_EQ(size, usbMIDI.sent[0].data1);
+
+  out_.Flush();
+  ASSERT_EQ(size_t(size + extra), usbMIDI.sent.size());
+  ASSERT_EQ(size_t(size + extra), usbHostMIDI.sent.size());
+  for (int i = 0; i < size; ++i) EXPECT_EQ(i, usbMIDI.sent[extra + i].data1);
+
+  // there's room again once DIN has caught up
+  for (int tick = 0; tick < 10000 && MIDI1.sent.size() < size_t(size + extra); ++tick) out_.Flush();
+  ASSERT_EQ(size_t(size + extra), MIDI1.sent.size());
+  usbMIDI.Clear();
+  out_.SendNoteOff(0, 0, 0);
+  EXPECT_TRUE(usbMIDI.sent.empty());
+  EXPECT_EQ(uint32_t(extra), out_.overflow_count);
+}
+
+// DIN never gets more bytes than 31.25 kbaud allows, on top of the initial
+// burst; USB isn't held up by it, and nothing is lost or reordered
+TEST_F(MIDIOutSchedulerTest, DinByteBudget) {
+  const int64_t per_tick = HS::MIDIOutScheduler::kDinBytesPerTick;
+  const int64_t burst = HS::MIDIOutScheduler::kDinBurstBytes;
+  const int notes = 24;
+  // alternating channels, so no running status: 3 bytes each
+  for (int i = 0; i < notes; ++i) out_.SendNoteOn(i & 1, i, 100);
+  out_.SendCC(0, 7, 100);
+
+  out_.Flush();
+  EXPECT_EQ(notes + 1, int(usbMIDI.sent.size()));
+  EXPECT_EQ(5u, MIDI1.sent.size()); // 15 of the 16 burst bytes
+
+  int ticks = 1;
+  while (MIDI1.sent.size() < size_t(notes + 1) && ticks < 10000) {
+    out_.Flush();
+    ++ticks;
+    EXPECT_LE(int64_t(MIDI1.sent.size()) * (3 << 16), burst + ticks * per_tick);
+    // notes go first; the CC waits for the queue to empty
+    if (MIDI1.sent.size() < size_t(notes)) {
+      EXPECT_EQ(0, Count(MIDI1.sent, HS::HEM_MIDI_CC));
+    }
+  }
+  ASSERT_EQ(size_t(notes + 1), MIDI1.sent.size());
+  // and no slower than the budget: 3 bytes every 16 ticks
+  EXPECT_LE(ticks, 1 + (notes - 5 + 1) * 16 + 1);
+  for (int i = 0; i < notes; ++i) {
+    EXPECT_EQ(i, MIDI1.sent[i].data1);
+    EXPECT_EQ(1 + (i & 1), MIDI1.sent[i].channel);
+  }
+  EXPECT_EQ(HS::HEM_MIDI_CC, MIDI1.sent[notes].type);
+  EXPECT_EQ(notes + 1, int(usbMIDI.sent.size())); // USB got each once
+}
+
+// Repeated status bytes are left out on DIN, and zero-velocity Note Off
+// goes as Note On to keep the status running
+TEST_F(MIDIOutSchedulerTest, RunningStatus) {
+  for (int i = 0; i < 6; ++i) {
+    out_.SendNoteOn(2, 60 + i, 100, kDIN);
+    out_.SendNoteOff(2, 60 + i, 0, kDIN);
+  }
+  out_.Flush();
+  // 3 bytes, then 2 each: 7 messages fit in the 16 byte burst, not 5
+  ASSERT_EQ(7u, MIDI1.sent.size());
+  EXPECT_EQ(7, Count(MIDI1.sent, HS::HEM_MIDI_NOTE_ON));
+  EXPECT_EQ(0, MIDI1.sent[1].data2);
+  EXPECT_TRUE(usbMIDI.sent.empty());
+
+  // a Note Off with velocity keeps its own status, so each costs the full 3
+  MIDI1.Clear();
+  out_.Init();
+  for (int i = 0; i < 6; ++i) {
+    out_.SendNoteOn(2, 60 + i, 100, kDIN);
+    out_.SendNoteOff(2, 60 + i, 64, kDIN);
+  }
+  out_.Flush();
+  ASSERT_EQ(5u, MIDI1.sent.size());
+  EXPECT_EQ(HS::HEM_MIDI_NOTE_OFF, MIDI1.sent[1].type);
+  EXPECT_EQ(64, MIDI1.sent[1].data2);
+}
@@ -0,0 +1,137 @@
+#include "gtest/gtest.h"
+#include "midi_host.h"
+#include "HSMIDIQueue.h"
+
+#include <vector>
+
+class MIDIInputQueueTest : public ::testing::Test {
+public:
+  virtual void SetUp() {
+    usbMIDI.Clear();
+    usbHostMIDI.Clear();
+    MIDI1.Clear();
+    host_cycle_count = 0;
+    queue_.Init();
+  }
+
+  // channel is 1-based, as the ports give it
+  static HostMIDIEvent Note(uint8_t channel, uint8_t note) {
+    return {HS::HEM_MIDI_NOTE_ON, channel, note, 100, 0};
+  }
+
+  std::vector<HS::TimedMIDIMessage> DrainAll(int budget = HS::MIDIInputQueue::kBudgetPerTick) {
+    std::vector<HS::TimedMIDIMessage> got;
+    queue_.Drain([&got](const HS::TimedMIDIMessage &m) { got.push_back(m); }, budget);
+    return got;
+  }
+
+protected:
+  HS::MIDIInputQueue queue_;
+};
+
+// Arrival order, port and read time survive the trip through the ring
+TEST_F(MIDIInputQueueTest, KeepsOrderPortAndTime) {
+  usbMIDI.incoming.push_back(Note(1, 60));
+  usbMIDI.incoming.push_back(Note(2, 61));
+  host_cycle_count = 1000;
+  queue_.Poll();
+  MIDI1.incoming.push_back(Note(3, 62));
+  usbHostMIDI.incoming.push_back(Note(4, 63));
+  host_cycle_count = 2000;
+  queue_.Poll(true);
+  EXPECT_EQ(0, host_irq_disabled);
+  ASSERT_EQ(4u, queue_.pending());
+
+  const std::vector<HS::TimedMIDIMessage> got = DrainAll();
+  ASSERT_EQ(4u, got.size());
+  const uint8_t notes[] = {60, 61, 63, 62}; // Poll() reads USB, then host, then DIN
+  const uint8_t ports[] = {HS::MIDI_PORT_USB, HS::MIDI_PORT_USB, HS::MIDI_PORT_HOST, HS::MIDI_PORT_DIN};
+  const uint32_t cycles[] = {1000, 1000, 2000, 2000};
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(notes[i], got[i].msg.data1);
+    EXPECT_EQ(ports[i], got[i].port);
+    EXPECT_EQ(cycles[i], got[i].cycles);
+  }
+  EXPECT_EQ(0u, queue_.pending());
+}
+
+// A full ring leaves the rest waiting in the port, and counts it
+TEST_F(MIDIInputQueueTest, FullQueueLeavesMessagesInPort) {
+  const size_t size = HS::MIDIInputQueue::kSize;
+  const size_t extra = 5;
+  for (size_t i = 0; i < size + extra; ++i)
+    usbMIDI.incoming.push_back(Note(1, i & 0x7F));
+  queue_.Poll();
+  EXPECT_EQ(size, queue_.pending());
+  EXPECT_EQ(extra, usbMIDI.incoming.size());
+  EXPECT_GT(queue_.overflow_count, 0u);
+
+  size_t drained = 0;
+  while (queue_.pending()) drained += DrainAll().size();
+  queue_.Poll();
+  EXPECT_EQ(extra, queue_.pending());
+  EXPECT_TRUE(usbMIDI.incoming.empty());
+
+  // nothing dropped, nothing reordered
+  const std::vector<HS::TimedMIDIMessage> rest = DrainAll();
+  for (size_t i = 0; i < rest.size(); ++i)
+    EXPECT_EQ((drained + i) & 0x7F, rest[i].msg.data1);
+}
+
+// Drain() hands out at most its budget per call, and leaves the rest queued
+TEST_F(MIDIInputQueueTest, DrainBudget) {
+  const int count = HS::MIDIInputQueue::kBudgetPerTick * 2 + 7;
+  for (int i = 0; i < count; ++i) usbMIDI.incoming.push_back(Note(1, i));
+  queue_.Poll();
+  ASSERT_EQ(size_t(count), queue_.pending());
+
+  EXPECT_EQ(size_t(HS::MIDIInputQueue::kBudgetPerTick), DrainAll().size());
+  EXPECT_EQ(size_t(count - HS::MIDIInputQueue::kBudgetPerTick), queue_.pending());
+  EXPECT_EQ(4u, DrainAll(4).size());
+
+  std::vector<HS::TimedMIDIMessage> rest = DrainAll();
+  EXPECT_EQ(size_t(HS::MIDIInputQueue::kBudgetPerTick), rest.size());
+  EXPECT_EQ(HS::MIDIInputQueue::kBudgetPerTick + 4, rest[0].msg.data1);
+  rest = DrainAll();
+  ASSERT_EQ(3u, rest.size());
+  EXPECT_EQ(count - 1, rest.back().msg.data1);
+  EXPECT_TRUE(DrainAll().empty());
+}
+
+// After a SysEx, its port isn't read again until the handler has had it;
+// the other ports carry on
+TEST_F(MIDIInputQueueTest, SysExHoldsItsPort) {
+  usbMIDI.incoming.push_back(Note(1, 60));
+  usbMIDI.incoming.push_back({HS::HEM_MIDI_SYSEX, 0, 7, 0, 0});
+  usbMIDI.incoming.push_back(Note(1, 61));
+  usbHostMIDI.incoming.push_back(Note(1, 70));
+  queue_.Poll();
+  EXPECT_EQ(3u, queue_.pending());
+  EXPECT_EQ(1u, usbMIDI.incoming.size());
+
+  // still held: the SysEx hasn't been handled
+  usbHostMIDI.incoming.push_back(Note(1, 71));
+  queue_.Poll();
+  EXPECT_EQ(4u, queue_.pending());
+  EXPECT_EQ(1u, usbMIDI.incoming.size());
+
+  // handling only the note ahead of it isn't enough
+  EXPECT_EQ(1u, DrainAll(1).size());
+  queue_.Poll();
+  EXPECT_EQ(1u, usbMIDI.incoming.size());
+
+  // the handler sees the SysEx while the port still has nothing newer
+  bool saw_sysex = false;
+  queue_.Drain([&saw_sysex](const HS::TimedMIDIMessage &m) {
+    if (m.msg.message == HS::HEM_MIDI_SYSEX) {
+      saw_sysex = true;
+      EXPECT_EQ(1u, usbMIDI.incoming.size());
+    }
+  });
+  EXPECT_TRUE(saw_sysex);
+  queue_.Poll();
+  EXPECT_TRUE(usbMIDI.incoming.empty());
+  const std::vector<HS::TimedMIDIMessage> rest = DrainAll();
+  ASSERT_EQ(1u, rest.size());
+  EXPECT_EQ(61, rest[0].msg.data1);
+}
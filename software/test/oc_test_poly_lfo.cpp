@@ -0,0 +1,260 @@
+#include "gtest/gtest.h"
+#include "frames_poly_lfo.h"
+#include "frames_resources.h"
+#include "extern/stmlib_utils_dsp.h"
+#include "util/util_math.h"
+
+#include <chrono>
+#include <new>
+#include <string.h>
+
+using namespace frames;
+
+static uint32_t NextRandom(uint32_t &seed) {
+  seed = seed * 1664525 + 1013904223;
+  return seed;
+}
+
+template <typename Lfo>
+static void RandomSettings(Lfo &lfo, uint32_t &seed) {
+  lfo.set_freq_range(NextRandom(seed) % 12);
+  lfo.set_shape(NextRandom(seed) >> 16);
+  lfo.set_shape_spread(NextRandom(seed) >> 16);
+  lfo.set_spread(NextRandom(seed) >> 16);
+  lfo.set_coupling(NextRandom(seed) >> 16);
+  lfo.set_attenuation(NextRandom(seed) >> 16);
+  lfo.set_offset((NextRandom(seed) >> 16) & 0x0fff);
+  const PolyLfoFreqMultipliers div = static_cast<PolyLfoFreqMultipliers>((NextRandom(seed) >> 16) % POLYLFO_FREQ_MULT_LAST);
+  lfo.set_freq_div_b((NextRandom(seed) >> 30) ? POLYLFO_FREQ_MULT_NONE : div);
+  lfo.set_freq_div_c((NextRandom(seed) >> 31) ? POLYLFO_FREQ_MULT_NONE : div);
+  lfo.set_freq_div_d((NextRandom(seed) >> 31) ? div : POLYLFO_FREQ_MULT_NONE);
+  lfo.set_b_xor_a((NextRandom(seed) >> 16) % 17);
+  lfo.set_c_xor_a((NextRandom(seed) >> 16) % 9);
+  lfo.set_d_xor_a((NextRandom(seed) >> 16) % 9);
+  lfo.set_b_am_by_a((NextRandom(seed) >> 16) % 128);
+  lfo.set_c_am_by_b((NextRandom(seed) >> 16) % 128);
+  lfo.set_d_am_by_c((NextRandom(seed) >> 16) % 128);
+  lfo.set_sync(!(NextRandom(seed) >> 30));
+}
+
+// PolyLfo's channel state and wavetable stage as they were before the
+// per-channel settings became arrays and the crossfade went to packed lanes
+class ReferenceLfo {
+public:
+  void Init() {
+    memset(static_cast<void *>(this), 0, sizeof(*this));
+    freq_range_ = 9;
+    attenuation_ = 58880;
+    freq_div_b_ = freq_div_c_ = freq_div_d_ = POLYLFO_FREQ_MULT_NONE;
+    pattern_predictor_.Init();
+  }
+  void set_freq_range(uint16_t r) { freq_range_ = r; }
+  void set_shape(uint16_t shape) { shape_ = shape; }
+  void set_shape_spread(uint16_t s) { shape_spread_ = static_cast<int16_t>(s - 32767) >> 1; }
+  void set_spread(uint16_t spread) {
+    if (spread < 32768) {
+      int32_t x = spread - 32768;
+      spread_ = (x + 3 * -(x * x >> 15)) >> 2;
+    } else {
+      spread_ = spread - 32768;
+    }
+  }
+  void set_coupling(uint16_t coupling) {
+    int32_t x = coupling - 32768;
+    int32_t scaled = x * x >> 15;
+    scaled = x > 0 ? scaled : -scaled;
+    coupling_ = (((x + 3 * scaled) >> 2) >> 4) * 10;
+  }
+  void set_attenuation(uint16_t a) { attenuation_ = a; }
+  void set_offset(int16_t o) { offset_ = o; }
+  void set_freq_div_b(PolyLfoFreqMultipliers d) { if (d != freq_div_b_) { freq_div_b_ = d; phase_reset_flag_ = true; } }
+  void set_freq_div_c(PolyLfoFreqMultipliers d) { if (d != freq_div_c_) { freq_div_c_ = d; phase_reset_flag_ = true; } }
+  void set_freq_div_d(PolyLfoFreqMultipliers d) { if (d != freq_div_d_) { freq_div_d_ = d; phase_reset_flag_ = true; } }
+  void set_b_xor_a(uint8_t x) { b_xor_a_ = x ? 16 - x : 0; }
+  void set_c_xor_a(uint8_t x) { c_xor_a_ = x ? 16 - x : 0; }
+  void set_d_xor_a(uint8_t x) { d_xor_a_ = x ? 16 - x : 0; }
+  void set_b_am_by_a(uint8_t am) { b_am_by_a_ = am << 1; }
+  void set_c_am_by_b(uint8_t am) { c_am_by_b_ = am << 1; }
+  void set_d_am_by_c(uint8_t am) { d_am_by_c_ = am << 1; }
+  void set_sync(bool sync) { sync_ = sync; }
+  uint8_t level(uint8_t i) const { return level_[i]; }
+  uint16_t dac_code(uint8_t i) const { return dac_code_[i]; }
+
+  // out of line, like PolyLfo::Render, so the benchmark compares like with like
+  __attribute__((noinline)) void Render(int32_t frequency, bool reset_phase, bool tempo_sync, uint8_t freq_mult) {
+    ++sync_counter_;
+    if (tempo_sync && sync_) {
+      if (sync_counter_ < kSyncCounterMaxTime) {
+        uint32_t period = 0;
+        if (sync_counter_ < 167) {
+          period = (3 * period_ + sync_counter_) >> 2;
+          tempo_sync = false;
+        } else {
+          period = pattern_predictor_.Predict(sync_counter_);
+        }
+        if (period != period_) {
+          period_ = period;
+          sync_phase_increment_ = 0xffffffff / period_;
+        }
+      }
+      sync_counter_ = 0;
+    }
+
+    if (reset_phase || phase_reset_flag_) {
+      memset(phase_, 0, sizeof(phase_));
+      phase_reset_flag_ = false;
+    } else {
+      phase_increment_ch1_ = sync_ ? sync_phase_increment_ : PolyLfo::FrequencyToPhaseIncrement(frequency, freq_range_);
+      if (freq_mult < 0xFF) {
+        phase_increment_ch1_ = (freq_mult < 0x3) ? (phase_increment_ch1_ >> (0x3 - freq_mult)) : phase_increment_ch1_ << (freq_mult - 0x2);
+      }
+      phase_[0] += phase_increment_ch1_;
+      PolyLfoFreqMultipliers FreqDivs[] = {POLYLFO_FREQ_MULT_NONE, freq_div_b_, freq_div_c_, freq_div_d_};
+      for (uint8_t i = 1; i < kNumChannels; ++i) {
+        if (FreqDivs[i] == POLYLFO_FREQ_MULT_NONE) phase_[i] += phase_increment_ch1_;
+        else phase_[i] += multiply_u32xu32_rshift24(phase_increment_ch1_, PolyLfoFreqMultNumerators[FreqDivs[i]]);
+      }
+      if (spread_ >= 0) {
+        phase_difference_ = static_cast<uint32_t>(spread_) << 15;
+        for (uint8_t i = 1; i < kNumChannels; ++i) {
+          if (FreqDivs[i] == POLYLFO_FREQ_MULT_NONE) phase_[i] = phase_[0] + i * phase_difference_;
+          else phase_[i] = phase_[i] - last_phase_difference_ + phase_difference_;
+        }
+      } else {
+        for (uint8_t i = 1; i < kNumChannels; ++i) phase_[i] -= i * (phase_increment_ch1_ >> 16) * spread_;
+      }
+      last_phase_difference_ = phase_difference_;
+    }
+
+    const uint8_t* sine = &wt_lfo_waveforms[17 * 257];
+    uint16_t wavetable_index = shape_;
+    uint8_t xor_depths[] = {0, b_xor_a_, c_xor_a_, d_xor_a_};
+    uint8_t am_depths[] = {0, b_am_by_a_, c_am_by_b_, d_am_by_c_};
+    for (uint8_t i = 0; i < kNumChannels; ++i) {
+      uint32_t phase = phase_[i];
+      if (coupling_ > 0) phase += value_[(i + 1) % kNumChannels] * coupling_;
+      else phase += value_[(i + kNumChannels - 1) % kNumChannels] * -coupling_;
+      const uint8_t* a = &wt_lfo_waveforms[(wavetable_index >> 12) * 257];
+      wt_value_[i] = stmlib::Crossfade(a, a + 257, phase, wavetable_index << 4);
+      value_[i] = stmlib::Interpolate824(sine, phase);
+      level_[i] = (wt_value_[i] + 32768) >> 8;
+      uint8_t depth_xor = xor_depths[i];
+      if (depth_xor) dac_code_[i] = (wt_value_[i] + 32768) ^ (((wt_value_[0] + 32768) >> depth_xor) << depth_xor);
+      else dac_code_[i] = wt_value_[i] + 32768;
+      if (i > 0) dac_code_[i] = (dac_code_[i] * (65535 - (((65535 - dac_code_[i-1]) * am_depths[i]) >> 8))) >> 16;
+      dac_code_[i] = ((dac_code_[i] * attenuation_) >> 16) + offset_;
+      wavetable_index += shape_spread_;
+    }
+  }
+
+private:
+  uint16_t freq_range_, shape_;
+  int16_t shape_spread_, coupling_;
+  int32_t spread_, attenuation_, offset_;
+  PolyLfoFreqMultipliers freq_div_b_, freq_div_c_, freq_div_d_;
+  uint8_t b_xor_a_, c_xor_a_, d_xor_a_, b_am_by_a_, c_am_by_b_, d_am_by_c_;
+  bool phase_reset_flag_, sync_;
+  int16_t value_[kNumChannels], wt_value_[kNumChannels];
+  uint32_t phase_[kNumChannels], phase_increment_ch1_;
+  uint8_t level_[kNumChannels];
+  uint16_t dac_code_[kNumChannels];
+  uint32_t sync_counter_, period_, sync_phase_increment_, phase_difference_, last_phase_difference_;
+  stmlib::PatternPredictor<32, 8> pattern_predictor_;
+};
+
+// Init() sets everything Render() reads: two LFOs built over different
+// garbage give the same output, tempo sync and phase locking included
+TEST(PolyLfo, InitSetsAllState) {
+  alignas(PolyLfo) static uint8_t memory[2][sizeof(PolyLfo)];
+  memset(memory[0], 0x00, sizeof(PolyLfo));
+  memset(memory[1], 0xA5, sizeof(PolyLfo));
+  PolyLfo *lfo[2];
+  for (int i = 0; i < 2; ++i) {
+    lfo[i] = new (memory[i]) PolyLfo;
+    lfo[i]->Init();
+  }
+
+  uint32_t seed[2] = {7, 7};
+  for (int block = 0; block < 200; ++block) {
+    for (int i = 0; i < 2; ++i) RandomSettings(*lfo[i], seed[i]);
+    const int32_t frequency = NextRandom(seed[0]) >> 16;
+    NextRandom(seed[1]);
+    for (int tick = 0; tick < 500; ++tick) {
+      const bool tempo_sync = (tick % 200) == 199;
+      for (int i = 0; i < 2; ++i) lfo[i]->Render(frequency, false, tempo_sync, 0xff);
+      for (uint8_t ch = 0; ch < kNumChannels; ++ch) {
+        ASSERT_EQ(lfo[0]->dac_code(ch), lfo[1]->dac_code(ch)) << "block " << block << " tick " << tick;
+      }
+    }
+  }
+}
+
+// The packed crossfade against stmlib's, over every pair of tables, a spread
+// of phases around each sample and the full range of balance
+TEST(PolyLfo, CrossfadeLanesMatchesCrossfade) {
+  uint32_t seed = 3;
+  for (int table = 0; table < 17; ++table) {
+    const uint8_t *a = &wt_lfo_waveforms[table * 257];
+    for (int i = 0; i < 20000; ++i) {
+      const uint32_t phase = NextRandom(seed);
+      const uint16_t balance = (i & 1) ? NextRandom(seed) >> 16 : (NextRandom(seed) >> 28) * 4369;
+      ASSERT_EQ(stmlib::Crossfade(a, a + 257, phase, balance), PolyLfo::CrossfadeLanes(a, a + 257, phase, balance))
+          << "table " << table << " phase " << phase << " balance " << balance;
+    }
+  }
+}
+
+// Render() gives the same levels and DAC codes, to the bit, as it did before
+// the packed path, for random settings including tempo sync, frequency
+// ratios, XOR, AM and both signs of coupling and spread
+TEST(PolyLfo, MatchesReference) {
+  static PolyLfo lfo;
+  static ReferenceLfo reference;
+  lfo.Init();
+  reference.Init();
+
+  uint32_t seed[3] = {11, 11, 5};
+  for (int block = 0; block < 500; ++block) {
+    RandomSettings(lfo, seed[0]);
+    RandomSettings(reference, seed[1]);
+    const int32_t frequency = NextRandom(seed[2]) >> 16;
+    const uint8_t freq_mult = (NextRandom(seed[2]) >> 29) ? 0xff : (NextRandom(seed[2]) >> 16) % 7;
+    for (int tick = 0; tick < 200; ++tick) {
+      const bool tempo_sync = (tick % 150) == 149;
+      const bool reset = (NextRandom(seed[2]) >> 22) == 0;
+      lfo.Render(frequency, reset, tempo_sync, freq_mult);
+      reference.Render(frequency, reset, tempo_sync, freq_mult);
+      for (uint8_t ch = 0; ch < kNumChannels; ++ch) {
+        ASSERT_EQ(reference.dac_code(ch), lfo.dac_code(ch)) << "block " << block << " tick " << tick << " ch " << int(ch);
+        ASSERT_EQ(reference.level(ch), lfo.level(ch)) << "block " << block << " tick " << tick << " ch " << int(ch);
+      }
+    }
+  }
+}
+
+// ns per Render() on this host, before and after
+TEST(PolyLfo, DISABLED_Benchmark) {
+  static PolyLfo lfo;
+  static ReferenceLfo reference;
+  lfo.Init();
+  reference.Init();
+  uint32_t seed[2] = {9, 9};
+  RandomSettings(lfo, seed[0]);
+  RandomSettings(reference, seed[1]);
+
+  const int kTicks = 1 << 20;
+  uint32_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kTicks; ++i) {
+    reference.Render(20000, false, false, 0xff);
+    sink += reference.dac_code(i & 3);
+  }
+  const double ref_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / kTicks;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kTicks; ++i) {
+    lfo.Render(20000, false, false, 0xff);
+    sink += lfo.dac_code(i & 3);
+  }
+  const double lfo_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / kTicks;
+  printf("[ BENCH    ] Render: reference %.1f ns, packed %.1f ns (%u)\n", ref_ns, lfo_ns, sink & 1);
+}
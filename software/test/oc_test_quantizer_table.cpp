@@ -0,0 +1,124 @@
+#include "gtest/gtest.h"
+#include "braids_quantizer.h"
+#include "braids_quantizer_scales.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+static const int32_t kOctave = 12 << 7;
+static const size_t kNumScales = sizeof(braids::scales) / sizeof(braids::scales[0]);
+
+// Pitch sequence mixing slow sweeps (mostly hysteresis hits) with jumps
+// (mostly requantizes), over a range of several octaves either side of 0.
+static std::vector<int32_t> TestPitches() {
+  std::vector<int32_t> pitches;
+  for (int32_t p = -6 * kOctave; p <= 6 * kOctave; p += 13)
+    pitches.push_back(p);
+  uint32_t seed = 12345;
+  for (int i = 0; i < 5000; ++i) {
+    seed = seed * 1664525 + 1013904223;
+    pitches.push_back(static_cast<int32_t>(seed >> 16) % (12 * kOctave) - 6 * kOctave);
+  }
+  // negative exact multiples of the span land on the top of the cell below
+  for (int o = -6; o <= 6; ++o) {
+    pitches.push_back(o * kOctave);
+    pitches.push_back(o * kOctave - 1);
+    pitches.push_back(o * kOctave + 1);
+  }
+  return pitches;
+}
+
+class QuantizerTableTest : public ::testing::Test {
+public:
+  virtual void SetUp() {
+    scan_.Init();
+    lut_.Init();
+    lut_.AttachTable(&table_);
+  }
+
+  void Configure(const braids::Scale &scale, uint16_t mask) {
+    scan_.Configure(scale, mask);
+    lut_.Configure(scale, mask);
+  }
+
+protected:
+  braids::Quantizer scan_;
+  braids::Quantizer lut_;
+  braids::QuantizerTable table_;
+};
+
+TEST_F(QuantizerTableTest, MatchesScanAllScales) {
+  const std::vector<int32_t> pitches = TestPitches();
+  const uint16_t masks[] = { 0xffff, 0x0001, 0x8001, 0x0ab5, 0x5555, 0xaaaa, 0x1248, 0x7fff, 0x0100 };
+
+  for (size_t s = 0; s < kNumScales; ++s) {
+    for (uint16_t mask : masks) {
+      Configure(braids::scales[s], mask);
+      ASSERT_EQ(scan_.enabled(), lut_.enabled());
+      if (!lut_.enabled()) continue;
+
+      for (int32_t transpose = -3; transpose <= 3; transpose += 3) {
+        scan_.Requantize();
+        lut_.Requantize();
+        for (int32_t pitch : pitches) {
+          ASSERT_EQ(scan_.Process(pitch, 0, transpose), lut_.Process(pitch, 0, transpose))
+            << "scale " << s << " mask " << mask << " pitch " << pitch << " transpose " << transpose;
+          ASSERT_EQ(scan_.GetLatestNoteNumber(), lut_.GetLatestNoteNumber());
+        }
+      }
+    }
+  }
+}
+
+TEST_F(QuantizerTableTest, MatchesScanUnsortedAndDuplicateNotes) {
+  const braids::Scale odd = { kOctave, 6, { 700, 0, 700, 1500, 128, 1535 } };
+  const std::vector<int32_t> pitches = TestPitches();
+
+  Configure(odd, 0xffff);
+  for (int32_t pitch : pitches)
+    ASSERT_EQ(scan_.Process(pitch, 64, 0), lut_.Process(pitch, 64, 0)) << "pitch " << pitch;
+}
+
+TEST_F(QuantizerTableTest, RebuildsOnConfigure) {
+  Configure(braids::scales[2], 0xffff);
+  const int32_t chromatic = lut_.Process(kOctave + 130);
+
+  Configure(braids::scales[2], 0x0001);
+  lut_.Requantize();
+  scan_.Requantize();
+  EXPECT_EQ(scan_.Process(kOctave + 130), lut_.Process(kOctave + 130));
+  EXPECT_NE(chromatic, lut_.Process(kOctave + 130));
+}
+
+// Time per Process() with and without the table
+TEST_F(QuantizerTableTest, DISABLED_Benchmark) {
+  const std::vector<int32_t> pitches = TestPitches();
+  const int kRepeats = 50;
+
+  size_t widest = 0;
+  for (size_t s = 0; s < kNumScales; ++s)
+    if (braids::scales[s].num_notes > braids::scales[widest].num_notes) widest = s;
+
+  for (size_t s : { size_t(2), widest }) {
+    Configure(braids::scales[s], 0xffff);
+
+    double ns[2];
+    int64_t sums[2] = { 0, 0 };
+    braids::Quantizer *qs[2] = { &scan_, &lut_ };
+    for (int i = 0; i < 2; ++i) {
+      const auto start = std::chrono::steady_clock::now();
+      for (int r = 0; r < kRepeats; ++r) {
+        for (int32_t pitch : pitches) {
+          qs[i]->Requantize(); // measure the requantize path, not the hysteresis hit
+          sums[i] += qs[i]->Process(pitch, 0, 0);
+        }
+      }
+      const auto end = std::chrono::steady_clock::now();
+      ns[i] = std::chrono::duration<double, std::nano>(end - start).count() / (kRepeats * pitches.size());
+    }
+    EXPECT_EQ(sums[0], sums[1]);
+    printf("[ BENCH    ] scale %2zu (%2zu notes): scan %.1f ns, table %.1f ns\n",
+           s, braids::scales[s].num_notes, ns[0], ns[1]);
+  }
+}
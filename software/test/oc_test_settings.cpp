@@ -24,7 +24,7 @@ SETTINGS_DECLARE(TestPackU4EvenSettings, 3) {
 
 TEST(TestSettings,TestPackU4Even)
 {
-  EXPECT_EQ(5, TestPackU4EvenSettings::storageSize());
+  EXPECT_EQ(5U, TestPackU4EvenSettings::storageSize());
 
   TestPackU4EvenSettings settings;
   settings.InitDefaults();
@@ -56,7 +56,7 @@ SETTINGS_DECLARE(TestPackU4OddSettings, 2) {
 
 TEST(TestSettings,TestPackU4Odd)
 {
-  EXPECT_EQ(5, TestPackU4OddSettings::storageSize());
+  EXPECT_EQ(5U, TestPackU4OddSettings::storageSize());
 
   TestPackU4OddSettings settings;
   settings.InitDefaults();
@@ -86,7 +86,7 @@ SETTINGS_DECLARE(TestPackU4OddEndSettings, 2) {
 
 TEST(TestSettings,TestPackU4OddEnd)
 {
-  EXPECT_EQ(5, TestPackU4OddSettings::storageSize());
+  EXPECT_EQ(5U, TestPackU4OddSettings::storageSize());
 
   TestPackU4OddEndSettings settings;
   settings.InitDefaults();
@@ -0,0 +1,181 @@
+#include "gtest/gtest.h"
+#include "util/util_tempo_tracker.h"
+
+#include <cmath>
+
+using Tracker = util::TempoTracker<32>;
+
+static constexpr uint32_t kPeriod = 1000 << Tracker::kFracBits;
+
+static uint32_t NextRandom(uint32_t &seed) {
+  seed = seed * 1664525 + 1013904223;
+  return seed;
+}
+
+// +/- range, roughly uniform
+static int32_t Jitter(uint32_t &seed, int32_t range) {
+  return static_cast<int32_t>(NextRandom(seed) >> 16) % (2 * range + 1) - range;
+}
+
+static double RelativeError(uint32_t period, uint32_t expected) {
+  return std::fabs(static_cast<double>(period) - expected) / expected;
+}
+
+class TempoTrackerTest : public ::testing::Test {
+public:
+  virtual void SetUp() {
+    tracker_.Init();
+    time_ = 0xFFFF0000u; // wraps during the test
+  }
+
+  // An exact clock, from wherever time_ is
+  void Lock(int pulses = 16) {
+    for (int i = 0; i < pulses; ++i) {
+      tracker_.Pulse(time_);
+      time_ += kPeriod;
+    }
+    ASSERT_TRUE(tracker_.locked());
+    ASSERT_EQ(kPeriod, tracker_.period());
+  }
+
+protected:
+  Tracker tracker_;
+  uint32_t time_;
+};
+
+// From nothing, two pulses give a period; lock comes with kLockCount pulses
+// of a steady clock, and not before
+TEST_F(TempoTrackerTest, ColdStart) {
+  EXPECT_FALSE(tracker_.valid());
+  EXPECT_TRUE(tracker_.Pulse(time_));
+  EXPECT_FALSE(tracker_.valid());
+  time_ += kPeriod;
+  EXPECT_TRUE(tracker_.Pulse(time_));
+  EXPECT_TRUE(tracker_.valid());
+  EXPECT_EQ(kPeriod, tracker_.period());
+  EXPECT_EQ(time_, tracker_.phase());
+
+  for (int pulse = 3; pulse <= 12; ++pulse) {
+    time_ += kPeriod;
+    EXPECT_TRUE(tracker_.Pulse(time_));
+    EXPECT_EQ(pulse >= Tracker::kLockCount, tracker_.locked()) << "pulse " << pulse;
+  }
+  EXPECT_EQ(kPeriod, tracker_.period());
+  EXPECT_EQ(time_, tracker_.phase());
+}
+
+// With +/-2% jitter on every pulse, the period settles well inside that and
+// the tracker still locks
+TEST_F(TempoTrackerTest, ColdStartWithJitter) {
+  uint32_t seed = 1;
+  const int32_t range = kPeriod / 50;
+  int locked_at = 0;
+  for (int pulse = 1; pulse <= 64; ++pulse) {
+    EXPECT_TRUE(tracker_.Pulse(time_ + Jitter(seed, range)));
+    if (!locked_at && tracker_.locked()) locked_at = pulse;
+    time_ += kPeriod;
+  }
+  EXPECT_GT(locked_at, 0);
+  EXPECT_LE(locked_at, 16);
+  EXPECT_TRUE(tracker_.locked());
+  EXPECT_LT(RelativeError(tracker_.period(), kPeriod), 0.002);
+  EXPECT_LT(tracker_.jitter(), static_cast<uint32_t>(range));
+}
+
+// A stray pulse between beats is rejected and doesn't move the estimate
+TEST_F(TempoTrackerTest, RejectsOutliers) {
+  Lock();
+  const uint32_t phase = tracker_.phase();
+  for (const uint32_t offset : {kPeriod / 3, kPeriod / 2, 2 * kPeriod / 3}) {
+    EXPECT_FALSE(tracker_.Pulse(phase + offset)) << offset;
+    EXPECT_EQ(kPeriod, tracker_.period());
+    EXPECT_EQ(phase, tracker_.phase());
+  }
+  // the beat itself is still expected on time
+  EXPECT_TRUE(tracker_.Pulse(time_));
+  EXPECT_EQ(kPeriod, tracker_.period());
+  EXPECT_EQ(time_, tracker_.phase());
+  EXPECT_TRUE(tracker_.locked());
+}
+
+// One or two missing pulses are bridged: the next one lands on the grid and
+// updates the estimate as usual
+TEST_F(TempoTrackerTest, BridgesMissedPulses) {
+  Lock();
+  for (int missed = 1; missed <= Tracker::kMaxDropped; ++missed) {
+    time_ += missed * kPeriod;
+    EXPECT_TRUE(tracker_.Pulse(time_)) << missed;
+    EXPECT_EQ(kPeriod, tracker_.period());
+    EXPECT_EQ(time_, tracker_.phase());
+    EXPECT_TRUE(tracker_.locked());
+    time_ += kPeriod;
+    EXPECT_TRUE(tracker_.Pulse(time_));
+    time_ += kPeriod;
+  }
+}
+
+// A longer gap isn't bridged, but the clock is picked up again at the same
+// tempo from the first pulse after it
+TEST_F(TempoTrackerTest, LongGap) {
+  Lock();
+  time_ += (Tracker::kMaxDropped + 1) * kPeriod;
+  EXPECT_FALSE(tracker_.Pulse(time_));
+  EXPECT_EQ(kPeriod, tracker_.period());
+  EXPECT_EQ(time_, tracker_.phase());
+  for (int i = 0; i < 4; ++i) {
+    time_ += kPeriod;
+    EXPECT_TRUE(tracker_.Pulse(time_));
+    EXPECT_EQ(time_, tracker_.phase());
+  }
+  EXPECT_EQ(kPeriod, tracker_.period());
+}
+
+// A tempo change is taken as one after kReacquireCount intervals that agree
+// with each other, and not before; lock follows again
+TEST_F(TempoTrackerTest, ReacquiresNewTempo) {
+  for (const uint32_t period : {kPeriod * 3 / 4, kPeriod * 5 / 4, kPeriod * 3 / 2, kPeriod / 2}) {
+    tracker_.Init();
+    Lock();
+    time_ -= kPeriod; // time_ is the last pulse
+    for (int i = 1; i < Tracker::kReacquireCount; ++i) {
+      time_ += period;
+      tracker_.Pulse(time_);
+      EXPECT_NE(period, tracker_.period()) << period << " after " << i;
+    }
+    time_ += period;
+    EXPECT_TRUE(tracker_.Pulse(time_)) << period;
+    EXPECT_EQ(period, tracker_.period());
+    EXPECT_EQ(time_, tracker_.phase());
+    EXPECT_FALSE(tracker_.locked());
+
+    for (int i = 0; i < Tracker::kLockCount; ++i) {
+      time_ += period;
+      EXPECT_TRUE(tracker_.Pulse(time_));
+    }
+    EXPECT_TRUE(tracker_.locked()) << period;
+    EXPECT_EQ(period, tracker_.period());
+  }
+}
+
+// Two off-tempo intervals that disagree with each other start the count over
+TEST_F(TempoTrackerTest, InconsistentIntervalsDontReacquire) {
+  Lock();
+  time_ -= kPeriod;
+  for (int i = 0; i < 4 * Tracker::kReacquireCount; ++i) {
+    time_ += (i & 1) ? kPeriod * 3 / 4 : kPeriod * 5 / 4;
+    tracker_.Pulse(time_);
+    EXPECT_LT(RelativeError(tracker_.period(), kPeriod), 0.05) << i;
+  }
+}
+
+// A ramp is followed, with a lag of some beats' worth of ramp
+TEST_F(TempoTrackerTest, FollowsRamp) {
+  Lock();
+  uint32_t period = kPeriod;
+  for (int i = 0; i < 200; ++i) {
+    period += kPeriod / 1000; // +0.1% per beat, up 20% overall
+    time_ += period;
+    EXPECT_TRUE(tracker_.Pulse(time_)) << i;
+  }
+  EXPECT_LT(RelativeError(tracker_.period(), period), 0.02);
+}
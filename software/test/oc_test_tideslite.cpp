@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+#include "tideslite.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+static uint32_t NextRandom(uint32_t &seed) {
+  seed = seed * 1664525 + 1013904223;
+  return seed;
+}
+
+static void ExpectSameSample(const TidesLiteSample &a, const TidesLiteSample &b) {
+  ASSERT_EQ(a.unipolar, b.unipolar);
+  ASSERT_EQ(a.bipolar, b.bipolar);
+  ASSERT_EQ(a.flags, b.flags);
+}
+
+// Every slope, with shape and phase swept, against ProcessSample()
+TEST(TidesLiteShaper, MatchesProcessSample) {
+  TidesLiteShaper shaper;
+  shaper.Init();
+  uint32_t seed = 1;
+
+  for (uint32_t slope = 0; slope < 65536; slope += 61) {
+    for (uint32_t shape = 0; shape < 65536; shape += 1021) {
+      for (int i = 0; i < 16; ++i) {
+        const uint32_t phase = NextRandom(seed);
+        const int16_t fold = (i & 3) ? 0 : (NextRandom(seed) >> 17);
+        TidesLiteSample expected, actual;
+        ProcessSample(slope, shape, fold, phase, expected);
+        shaper.Process(slope, shape, fold, phase, actual);
+        ExpectSameSample(expected, actual);
+      }
+    }
+  }
+}
+
+// The warp curve, exhaustively: every curve and every phase a ramp produces
+TEST(TidesLiteShaper, WarpExhaustive) {
+  TidesLiteShaper shaper;
+  shaper.Init();
+
+  // slope 32768 sends phase straight through, so a ramp walks every
+  // ShapePhase() input; each shape value picks a different curve pair
+  for (uint32_t shape = 0; shape < 65536; shape += 64) {
+    for (uint32_t p = 0; p < 65536; ++p) {
+      const uint32_t phase = p << 16;
+      TidesLiteSample expected, actual;
+      ProcessSample(32768, shape, 0, phase, expected);
+      shaper.Process(32768, shape, 0, phase, actual);
+      ASSERT_EQ(expected.unipolar, actual.unipolar) << "shape " << shape << " phase " << phase;
+      ASSERT_EQ(expected.bipolar, actual.bipolar) << "shape " << shape << " phase " << phase;
+    }
+  }
+}
+
+// Time per sample, with fixed and with modulated parameters
+TEST(TidesLiteShaper, DISABLED_Benchmark) {
+  const int kSamples = 1 << 20;
+  std::vector<uint32_t> phases(kSamples);
+  uint32_t seed = 7;
+  for (auto &p : phases) p = NextRandom(seed);
+
+  for (int modulated = 0; modulated < 2; ++modulated) {
+    TidesLiteShaper shaper;
+    shaper.Init();
+    int64_t sums[2] = { 0, 0 };
+    double ns[2];
+    for (int pass = 0; pass < 2; ++pass) {
+      const auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < kSamples; ++i) {
+        const uint16_t slope = modulated ? (i >> 4) * 7 : 20000;
+        const uint16_t shape = modulated ? (i >> 4) * 13 : 40000;
+        TidesLiteSample s;
+        if (pass) shaper.Process(slope, shape, 0, phases[i], s);
+        else ProcessSample(slope, shape, 0, phases[i], s);
+        sums[pass] += s.unipolar + s.bipolar;
+      }
+      const auto end = std::chrono::steady_clock::now();
+      ns[pass] = std::chrono::duration<double, std::nano>(end - start).count() / kSamples;
+    }
+    EXPECT_EQ(sums[0], sums[1]);
+    printf("[ BENCH    ] %s parameters: ProcessSample %.2f ns, TidesLiteShaper %.2f ns\n",
+           modulated ? "modulated" : "fixed", ns[0], ns[1]);
+  }
+}
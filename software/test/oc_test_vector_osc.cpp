@@ -0,0 +1,122 @@
+#include "gtest/gtest.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define DMAMEM
+template <class T, class L, class H>
+inline T constrain(T x, L lo, H hi) {
+  return x < lo ? lo : (x > hi ? hi : x);
+}
+
+#include "vector_osc/HSVectorOscillator.h"
+
+static uint32_t NextRandom(uint32_t &seed) {
+  seed = seed * 1664525 + 1013904223;
+  return seed;
+}
+
+// A cycling VectorOscillator as it was before the segment tables: boundaries
+// worked out and divided by on every call. The last segment runs to the top
+// of the cycle however it's reached, as it does now.
+class DividingVectorOscillator {
+public:
+  void Init(const VOSegment *segments_, uint8_t count, uint16_t scale_, int16_t offset_, uint32_t increment) {
+    memcpy(segments, segments_, count * sizeof(VOSegment));
+    segment_count = count;
+    int total_time = 0;
+    for (uint8_t i = 0; i < count; ++i) total_time += segments[i].time;
+    time_unit = 0xffffffff / total_time;
+    scale = scale_;
+    offset = offset_;
+    phase_increment = increment;
+    segment_index = 0;
+    segment_time = 0;
+    segment_start_level = (segments[segment_count - 1].level - 128) * 256;
+    phase = 0;
+  }
+
+  int32_t Next() {
+    phase += phase_increment;
+    uint16_t segment_phase;
+    find_segment(phase, segment_index, segment_time, segment_start_level, segment_phase);
+    return rescale(InterpLinear16(segment_start_level, (segments[segment_index].level - 128) * 255, segment_phase));
+  }
+
+  int32_t Phase(int degrees) {
+    uint8_t segment = 0, segment_start = 0;
+    uint16_t segment_phase = 0;
+    int16_t ignored = 0;
+    find_segment(0xffffffff / 3600 * degrees, segment, segment_start, ignored, segment_phase);
+    const int start = segments[segment == 0 ? segment_count - 1 : segment - 1].level - 128;
+    const int end = segments[segment].level - 128;
+    return rescale(InterpLinear16(start * 256, end * 256, segment_phase));
+  }
+
+private:
+  VOSegment segments[HS::VO_MAX_SEGMENTS];
+  uint8_t segment_count;
+  uint32_t time_unit, phase, phase_increment;
+  uint16_t scale;
+  int16_t offset;
+  uint8_t segment_index, segment_time;
+  int16_t segment_start_level;
+
+  uint32_t end_phase(uint8_t segment, uint32_t start_phase) const {
+    return segment == segment_count - 1 ? 0xffffffff : start_phase + time_unit * segments[segment].time;
+  }
+
+  void find_segment(uint32_t phase, uint8_t &segment, uint8_t &segment_start, int16_t &start_level, uint16_t &segment_phase) {
+    uint32_t start_phase = time_unit * segment_start;
+    uint32_t end = end_phase(segment, start_phase);
+    while (!(start_phase <= phase && phase <= end)) {
+      start_level = (segments[segment].level - 128) * 256;
+      segment_start += segments[segment].time;
+      if (++segment >= segment_count) segment = segment_start = 0;
+      start_phase = time_unit * segment_start;
+      end = end_phase(segment, start_phase);
+    }
+    segment_phase = (phase - start_phase) / (1 + ((end - start_phase) >> 16));
+  }
+
+  int16_t rescale(int16_t unscaled) const {
+    return (unscaled * scale) / 32768 + offset;
+  }
+};
+
+// 3000 random cycling waveforms, zero-length segments included, at rates
+// from sub-audio to several segments per sample
+TEST(VectorOscillator, MatchesDividingReference) {
+  uint32_t seed = 1;
+  for (int waveform = 0; waveform < 3000; ++waveform) {
+    const uint8_t count = 2 + NextRandom(seed) % (HS::VO_MAX_SEGMENTS - 1);
+    VOSegment segments[HS::VO_MAX_SEGMENTS];
+    int total_time = 0;
+    for (uint8_t i = 0; i < count; ++i) {
+      segments[i].level = NextRandom(seed) >> 24;
+      segments[i].time = (NextRandom(seed) >> 24) % 21; // 0..20
+      total_time += segments[i].time;
+    }
+    if (!total_time) segments[0].time = 1;
+
+    const uint16_t scale = 1 + (NextRandom(seed) >> 16) % 7680;
+    const int16_t offset = (NextRandom(seed) & 1) ? scale : 0;
+    const uint32_t increment = NextRandom(seed) >> (NextRandom(seed) % 24);
+
+    VectorOscillator osc;
+    for (uint8_t i = 0; i < count; ++i) osc.SetSegment(segments[i]);
+    osc.SetScale(scale);
+    osc.Offset(offset);
+    osc.SetPhaseIncrement(increment);
+    osc.Start();
+    DividingVectorOscillator reference;
+    reference.Init(segments, count, scale, offset, increment);
+
+    for (int i = 0; i < 512; ++i) {
+      ASSERT_EQ(reference.Next(), osc.Next()) << "waveform " << waveform << ", sample " << i;
+    }
+    for (int degrees = 0; degrees <= 3600; degrees += 37) {
+      ASSERT_EQ(reference.Phase(degrees), osc.Phase(degrees)) << "waveform " << waveform << ", " << degrees;
+    }
+  }
+}